@@ -0,0 +1,136 @@
+/*
+ * Copyright 2024 GhostFragment
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include <chemist/fragmenting/fragmented_nuclei.hpp>
+#include <vector>
+
+namespace ghostfragment {
+
+/** @brief Maps atoms to the caps anchored on them.
+ *
+ *  FragmentedNuclei stores the caps of all fragments in a single cap set.
+ *  Cap @f$c@f$ belongs to a fragment if the fragment contains the anchor of
+ *  @f$c@f$ but not the atom @f$c@f$ replaces. Finding the caps of a fragment
+ *  by filtering the cap set is O(number of caps), so doing it for every
+ *  subsystem is O(number of subsystems times number of caps).
+ *
+ *  CapIndex sorts the caps by anchor once (O(number of caps)) and stores the
+ *  result in a compressed sparse row layout. Finding the caps of a fragment
+ *  then only looks at the caps anchored on the fragment's atoms, so assembling
+ *  the capped nuclei of all subsystems costs O(total number of caps used).
+ */
+class CapIndex {
+public:
+    /// Type of the fragments whose caps are indexed
+    using fragmented_nuclei =
+      chemist::fragmenting::FragmentedNuclei<chemist::Nuclei>;
+
+    /// Type of the set of caps
+    using cap_set_type = typename fragmented_nuclei::cap_set_type;
+
+    /// Type of the atom indices making up a fragment
+    using nucleus_index_set = typename fragmented_nuclei::nucleus_index_set;
+
+    /// Type used for indexing and offsets
+    using size_type = std::size_t;
+
+    /// Type of a list of offsets (into cap_set_type or the CSR arrays)
+    using index_list_type = std::vector<size_type>;
+
+    /// Creates an index with no caps
+    CapIndex() : m_offsets_(1, 0) {}
+
+    /** @brief Indexes the caps in @p caps.
+     *
+     *  @param[in] caps The caps to index. The index stores offsets into
+     *                  @p caps, so it is only valid for @p caps (or a copy).
+     *
+     *  @throw std::bad_alloc if allocating the index fails. Strong throw
+     *                        guarantee.
+     */
+    explicit CapIndex(const cap_set_type& caps);
+
+    /** @brief Indexes the caps of @p frags.
+     *
+     *  Same as CapIndex(frags.cap_set()).
+     */
+    explicit CapIndex(const fragmented_nuclei& frags) :
+      CapIndex(frags.cap_set()) {}
+
+    /// The number of indexed caps
+    size_type size() const noexcept { return m_caps_.size(); }
+
+    /** @brief The caps anchored on atom @p atom.
+     *
+     *  @param[in] atom The offset of an atom in the supersystem.
+     *
+     *  @return The offsets (in the cap set) of the caps whose anchor is
+     *          @p atom, in increasing order. Empty if there are none.
+     *
+     *  @throw std::bad_alloc if allocating the result fails. Strong throw
+     *                        guarantee.
+     */
+    index_list_type anchored_on(size_type atom) const;
+
+    /** @brief The caps needed by the fragment containing atoms @p frag.
+     *
+     *  @param[in] frag The atoms in the fragment.
+     *
+     *  @return The offsets (in the cap set) of the caps anchored on an atom
+     *          in @p frag which replace an atom not in @p frag, in increasing
+     *          order.
+     *
+     *  @throw std::bad_alloc if allocating the result fails. Strong throw
+     *                        guarantee.
+     */
+    index_list_type caps(const nucleus_index_set& frag) const;
+
+    /** @brief The caps needed by the @p i -th fragment of @p frags.
+     *
+     *  Same as caps(frags.nuclear_indices(i)). @p frags should be the object
+     *  this index was built from.
+     */
+    index_list_type caps(const fragmented_nuclei& frags, size_type i) const {
+        return caps(frags.nuclear_indices(i));
+    }
+
+    /// Two indices are equal if they index the same caps the same way
+    bool operator==(const CapIndex& rhs) const noexcept {
+        return m_offsets_ == rhs.m_offsets_ && m_caps_ == rhs.m_caps_ &&
+               m_replaced_ == rhs.m_replaced_;
+    }
+
+private:
+    /// m_caps_[m_offsets_[a], m_offsets_[a + 1]) are the caps anchored on a
+    index_list_type m_offsets_;
+
+    /// The offset of each cap in the cap set, grouped by anchor
+    index_list_type m_caps_;
+
+    /// The atom each cap in m_caps_ replaces
+    index_list_type m_replaced_;
+};
+
+/** @brief Determines if two CapIndex instances are different.
+ *
+ *  @relates CapIndex
+ */
+inline bool operator!=(const CapIndex& lhs, const CapIndex& rhs) {
+    return !(lhs == rhs);
+}
+
+} // namespace ghostfragment
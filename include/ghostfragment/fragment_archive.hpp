@@ -0,0 +1,253 @@
+/*
+ * Copyright 2024 GhostFragment
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include <chemist/fragmenting/fragmented_nuclei.hpp>
+#include <cstdint>
+#include <filesystem>
+#include <ghostfragment/nuclear_graph.hpp>
+#include <memory>
+#include <vector>
+
+namespace ghostfragment {
+namespace detail_ {
+class FragmentArchivePIMPL;
+}
+
+/** @brief A read-only, memory-mapped file holding fragmentation results.
+ *
+ *  Fragmenting a large system (finding the connectivity, forming and capping
+ *  the fragments, and computing the weights) only needs to be done once. The
+ *  results can then be written to an archive with FragmentArchive::write (or
+ *  the Archive Writer module) and reused by many later jobs.
+ *
+ *  The archive is a header followed by flat arrays:
+ *
+ *  - the nuclei (atomic numbers, masses, x, y, and z coordinates, and names),
+ *  - fragment membership in compressed sparse row (CSR) layout: offsets()[i]
+ *    is where the atoms of fragment i start in members(),
+ *  - the caps (anchor, replaced atom, and cap nuclei),
+ *  - the weight of each fragment, and
+ *  - the nodes (in CSR layout) and edges of a NuclearGraph, if one was
+ *    written.
+ *
+ *  Integers are stored as 64-bit unsigned integers and every array starts on
+ *  an 8-byte boundary, so opening an archive maps the file and points into it;
+ *  nothing is parsed or copied. The arrays are validated when the archive is
+ *  opened (e.g., all atom indices are in range), so accessors never need to
+ *  check them. The chemist objects (fragments, graph) are only assembled when
+ *  asked for.
+ *
+ *  The byte order and layout are those of the machine which wrote the archive.
+ *  Archives are versioned; opening an archive from a different version (or
+ *  written with a different byte order) throws.
+ */
+class FragmentArchive {
+public:
+    /// Type of the fragments stored in the archive
+    using fragmented_nuclei =
+      chemist::fragmenting::FragmentedNuclei<chemist::Nuclei>;
+
+    /// Type of the supersystem of the fragments
+    using nuclei_type = typename fragmented_nuclei::supersystem_type;
+
+    /// Type of the fragment weights
+    using weight_container = std::vector<double>;
+
+    /// Type used for paths
+    using path_type = std::filesystem::path;
+
+    /// Type used for indices and offsets, in memory and on disk
+    using size_type = std::uint64_t;
+
+    /// Bumped whenever the layout of an archive changes
+    static constexpr std::uint32_t format_version = 1;
+
+    /// A read-only view of an array in the archive
+    template<typename T>
+    class const_array_view {
+    public:
+        /// Type of a read-only iterator over the array
+        using const_iterator = const T*;
+
+        const_array_view() noexcept = default;
+        const_array_view(const T* data, size_type n) noexcept :
+          m_data_(data), m_size_(n) {}
+        const_iterator begin() const noexcept { return m_data_; }
+        const_iterator end() const noexcept { return m_data_ + m_size_; }
+        const T* data() const noexcept { return m_data_; }
+        size_type size() const noexcept { return m_size_; }
+        bool empty() const noexcept { return m_size_ == 0; }
+        const T& operator[](size_type i) const noexcept { return m_data_[i]; }
+
+    private:
+        const T* m_data_  = nullptr;
+        size_type m_size_ = 0;
+    };
+
+    /// Type of a view of an array of indices
+    using const_index_view = const_array_view<size_type>;
+
+    /// Type of a view of an array of floating-point values
+    using const_double_view = const_array_view<double>;
+
+    /** @brief Writes @p frags and their @p weights to the file @p path.
+     *
+     *  @param[in] path Where to write the archive. If it exists, it is
+     *                  replaced in one step once the new archive is complete,
+     *                  so archives which are already open are not affected.
+     *  @param[in] frags The fragments (and caps) to write.
+     *  @param[in] weights The weight of each fragment in @p frags.
+     *
+     *  @throw std::runtime_error if @p weights and @p frags differ in size, if
+     *                            a cap has more than one nucleus, or if the
+     *                            file can not be written.
+     */
+    static void write(const path_type& path, const fragmented_nuclei& frags,
+                      const weight_container& weights);
+
+    /** @brief Writes @p frags, their @p weights, and @p graph to @p path.
+     *
+     *  Same as the three argument overload, except that the nodes and edges
+     *  of @p graph are also written. The nodes of @p graph must be formed
+     *  from the supersystem of @p frags.
+     *
+     *  @throw std::runtime_error if the three argument overload would, or if
+     *                            the supersystem of @p graph differs from
+     *                            that of @p frags.
+     */
+    static void write(const path_type& path, const fragmented_nuclei& frags,
+                      const weight_container& weights,
+                      const NuclearGraph& graph);
+
+    /** @brief Maps the archive in the file @p path.
+     *
+     *  @throw std::runtime_error if the file can not be mapped, or if it is not
+     *                            a valid archive of the current version.
+     */
+    explicit FragmentArchive(const path_type& path);
+
+    /// Archives own their mapping, so they can be moved, but not copied
+    FragmentArchive(FragmentArchive&& other) noexcept;
+
+    /// Releases the mapping of this archive and takes that of @p rhs
+    FragmentArchive& operator=(FragmentArchive&& rhs) noexcept;
+
+    /// Unmaps the file
+    ~FragmentArchive() noexcept;
+
+    /// The number of nuclei in the supersystem
+    size_type natoms() const noexcept;
+
+    /// The atomic number of each nucleus
+    const_index_view atomic_numbers() const noexcept;
+
+    /// The x, y, and z coordinates of each nucleus
+    ///@{
+    const_double_view x() const noexcept;
+    const_double_view y() const noexcept;
+    const_double_view z() const noexcept;
+    ///@}
+
+    /// The number of fragments
+    size_type size() const noexcept;
+
+    /// Where the atoms of each fragment start in members()
+    const_index_view offsets() const noexcept;
+
+    /// The atoms of all fragments, stored contiguously
+    const_index_view members() const noexcept;
+
+    /** @brief The atoms in the @p i -th fragment.
+     *
+     *  @throw std::out_of_range if @p i is not in the range [0, size()).
+     *                           Strong throw guarantee.
+     */
+    const_index_view fragment(size_type i) const;
+
+    /// The number of caps
+    size_type ncaps() const noexcept;
+
+    /// The weight of each fragment
+    const_double_view weights() const noexcept;
+
+    /// The number of nodes in the graph (0 if no graph was written)
+    size_type nodes_size() const noexcept;
+
+    /// The edges of the graph as (node, node) pairs, stored contiguously
+    const_index_view edges() const noexcept;
+
+    /** @brief Assembles the nuclei of the supersystem.
+     *
+     *  @throw std::bad_alloc if allocating the nuclei fails. Strong throw
+     *                        guarantee.
+     */
+    nuclei_type nuclei() const;
+
+    /** @brief Does @p nuclei have the elements and coordinates in the archive?
+     *
+     *  Coordinates are compared exactly, as the archive is only meaningful
+     *  for the exact geometry it was written for.
+     */
+    template<typename NucleiType>
+    bool is_supersystem(const NucleiType& nuclei) const;
+
+    /** @brief Assembles the fragments and caps.
+     *
+     *  @param[in] supersystem The nuclei to use as the supersystem. Should be
+     *                         the same as nuclei(); passing them in avoids
+     *                         assembling them again.
+     *
+     *  @throw std::runtime_error if the archive refers to more nuclei than
+     *                            @p supersystem has. Strong throw guarantee.
+     */
+    fragmented_nuclei fragments(nuclei_type supersystem) const;
+
+    /// Same as fragments(nuclei())
+    fragmented_nuclei fragments() const { return fragments(nuclei()); }
+
+    /// Copies the weights into a container (see also weights())
+    weight_container weight_list() const;
+
+    /** @brief Assembles the graph (see fragments(nuclei_type)).
+     *
+     *  @throw std::runtime_error if the archive refers to more nuclei than
+     *                            @p supersystem has. Strong throw guarantee.
+     */
+    NuclearGraph graph(nuclei_type supersystem) const;
+
+private:
+    /// The mapping and where each array starts in it
+    std::unique_ptr<detail_::FragmentArchivePIMPL> m_pimpl_;
+};
+
+template<typename NucleiType>
+bool FragmentArchive::is_supersystem(const NucleiType& nuclei) const {
+    if(nuclei.size() != natoms()) return false;
+    const auto Zs = atomic_numbers();
+    const auto xs = x();
+    const auto ys = y();
+    const auto zs = z();
+    for(size_type i = 0; i < natoms(); ++i) {
+        const auto nucleus_i = nuclei[i];
+        if(nucleus_i.Z() != Zs[i] || nucleus_i.x() != xs[i] ||
+           nucleus_i.y() != ys[i] || nucleus_i.z() != zs[i])
+            return false;
+    }
+    return true;
+}
+
+} // namespace ghostfragment
@@ -0,0 +1,156 @@
+/*
+ * Copyright 2024 GhostFragment
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include <cstddef>
+#include <ostream>
+#include <set>
+#include <utility>
+#include <vector>
+
+namespace ghostfragment {
+
+/** @brief The bonds each fragment broke, grouped by fragment.
+ *
+ *  When a fragment is formed, every bond between an atom in the fragment (the
+ *  anchor) and an atom outside of it (the replaced atom) is broken.
+ *  FragmentBrokenBonds records those bonds per fragment using a compressed
+ *  sparse row (CSR) layout: the bonds of all fragments are stored
+ *  contiguously, fragment by fragment, and offsets()[i] is where the bonds of
+ *  fragment i start (offsets()[i + 1] is where they end). Looking up the
+ *  bonds of a fragment is thus O(1) and iterating over them is O(the number
+ *  of bonds the fragment broke).
+ *
+ *  Within a fragment, bonds are sorted by anchor and then by replaced atom.
+ *  The same bond may appear in several fragments.
+ */
+class FragmentBrokenBonds {
+public:
+    /// Type used for indexing and offsets
+    using size_type = std::size_t;
+
+    /// Type of a broken bond, (anchor, replaced atom)
+    using bond_type = std::pair<size_type, size_type>;
+
+    /// Type of the container holding the bonds of all fragments
+    using bond_list_type = std::vector<bond_type>;
+
+    /// Type of the container holding where each fragment's bonds start
+    using offset_list_type = std::vector<size_type>;
+
+    /// Type of a read-only iterator over bonds
+    using const_iterator = typename bond_list_type::const_iterator;
+
+    /// Type of the set of unique bonds (same type as pt::BrokenBonds returns)
+    using bond_set_type = std::set<bond_type>;
+
+    /// A read-only view of the bonds broken by a single fragment
+    class const_bond_range {
+    public:
+        const_bond_range(const_iterator b, const_iterator e) :
+          m_begin_(b), m_end_(e) {}
+        const_iterator begin() const noexcept { return m_begin_; }
+        const_iterator end() const noexcept { return m_end_; }
+        size_type size() const noexcept { return m_end_ - m_begin_; }
+        bool empty() const noexcept { return m_begin_ == m_end_; }
+        const bond_type& operator[](size_type i) const { return m_begin_[i]; }
+
+    private:
+        const_iterator m_begin_;
+        const_iterator m_end_;
+    };
+
+    /// Creates an instance with no fragments
+    FragmentBrokenBonds() : m_offsets_(1, 0) {}
+
+    /** @brief Creates an instance from the CSR arrays.
+     *
+     *  @param[in] offsets Where the bonds of each fragment start in @p bonds.
+     *                     Must have one more element than there are
+     *                     fragments, start at 0, be non-decreasing, and end at
+     *                     the size of @p bonds.
+     *  @param[in] bonds The broken bonds of each fragment, stored contiguously.
+     *
+     *  @throw std::runtime_error if @p offsets is not consistent with
+     *                            @p bonds. Strong throw guarantee.
+     */
+    FragmentBrokenBonds(offset_list_type offsets, bond_list_type bonds);
+
+    /// The number of fragments
+    size_type size() const noexcept { return m_offsets_.size() - 1; }
+
+    /// The total number of broken bonds, counting repeats across fragments
+    size_type nbonds() const noexcept { return m_bonds_.size(); }
+
+    /** @brief Returns the bonds broken by the @p i -th fragment.
+     *
+     *  @param[in] i The fragment whose bonds are wanted.
+     *
+     *  @return A view of the bonds broken by fragment @p i.
+     *
+     *  @throw std::out_of_range if @p i is not in the range [0, size()).
+     *                           Strong throw guarantee.
+     */
+    const_bond_range bonds(size_type i) const;
+
+    /// The CSR offsets
+    const offset_list_type& offsets() const noexcept { return m_offsets_; }
+
+    /// The bonds of all fragments, stored contiguously
+    const bond_list_type& bond_list() const noexcept { return m_bonds_; }
+
+    /** @brief The set of unique broken bonds.
+     *
+     *  @return The bonds broken by any fragment, without repeats. This is the
+     *          result pt::BrokenBonds would have returned.
+     *
+     *  @throw std::bad_alloc if there is a problem allocating the set. Strong
+     *                        throw guarantee.
+     */
+    bond_set_type unique_bonds() const;
+
+    /// Two instances are equal if they hold the same bonds per fragment
+    bool operator==(const FragmentBrokenBonds& rhs) const noexcept {
+        return m_offsets_ == rhs.m_offsets_ && m_bonds_ == rhs.m_bonds_;
+    }
+
+    /// Prints the bonds of each fragment, one fragment per line
+    void print(std::ostream& os) const;
+
+private:
+    /// Where the bonds of each fragment start
+    offset_list_type m_offsets_;
+
+    /// The bonds of each fragment
+    bond_list_type m_bonds_;
+};
+
+inline std::ostream& operator<<(std::ostream& os,
+                                const FragmentBrokenBonds& bonds) {
+    bonds.print(os);
+    return os;
+}
+
+/** @brief Determines if two FragmentBrokenBonds instances are different.
+ *
+ *  @relates FragmentBrokenBonds
+ */
+inline bool operator!=(const FragmentBrokenBonds& lhs,
+                       const FragmentBrokenBonds& rhs) {
+    return !(lhs == rhs);
+}
+
+} // namespace ghostfragment
@@ -23,5 +23,7 @@
  *  used by downstream projects.
  */
 
+#include <ghostfragment/fragment_archive.hpp>
+#include <ghostfragment/fragment_broken_bonds.hpp>
 #include <ghostfragment/load_modules.hpp>
 #include <ghostfragment/nuclear_graph.hpp>
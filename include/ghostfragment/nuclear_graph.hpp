@@ -17,6 +17,7 @@
 #pragma once
 #include <chemist/fragmenting/fragmented_nuclei.hpp>
 #include <chemist/topology/connectivity_table.hpp>
+#include <memory>
 
 namespace ghostfragment {
 namespace detail_ {
@@ -48,6 +49,7 @@ class NuclearGraphPIMPL;
  *  defined. In this case, the partitions are the nodes and the connectivity
  *  defines the edges.
  *
+ *  Copies of a NuclearGraph share its state, supersystem included.
  */
 class NuclearGraph {
 public:
@@ -106,14 +108,18 @@ public:
      */
     NuclearGraph(fragmented_nuclei nodes, connectivity_type edges);
 
-    /** @brief Makes a deep copy of another instance.
+    /** @brief Makes a copy of another instance.
+     *
+     *  The state of a NuclearGraph can not be modified after construction, so
+     *  copies share it (including the supersystem) instead of duplicating it.
+     *  Copying is thus O(1), which matters because graphs are copied into and
+     *  out of pluginplay's cache.
      *
      *  @param[in] other The instance we are copying.
      *
-     *  @throw std::bad_alloc if there is a problem copying @p other 's state.
-     *                        Strong throw guarantee.
+     *  @throw None No throw guarantee.
      */
-    NuclearGraph(const NuclearGraph& other);
+    NuclearGraph(const NuclearGraph& other) noexcept;
 
     /** @brief Creates a new instance by taking ownership of another instance's
      *         state.
@@ -125,17 +131,17 @@ public:
      */
     NuclearGraph(NuclearGraph&& other) noexcept;
 
-    /** @brief Overwrites this instance's state with a deep copy of @p rhs's
-     *         state.
+    /** @brief Overwrites this instance's state with a copy of @p rhs's state.
+     *
+     *  As with the copy ctor, the state is shared, not duplicated.
      *
      *  @param[in] rhs The instance whose state is being copied.
      *
      *  @return The current instance after overwriting its state.
      *
-     *  @throw std::bad_alloc if there is a problem copying @p rhs's state.
-     *                        Strong throw guarantee.
+     *  @throw None No throw guarantee.
      */
-    NuclearGraph& operator=(const NuclearGraph& rhs);
+    NuclearGraph& operator=(const NuclearGraph& rhs) noexcept;
 
     /** @brief Overwrite's this instance's state by taking ownership of another
      *         instance's state.
@@ -269,8 +275,8 @@ private:
     /// Type of the class holding the state
     using pimpl_type = detail_::NuclearGraphPIMPL;
 
-    /// Type of a modifiable pointer to the state
-    using pimpl_ptr = std::unique_ptr<pimpl_type>;
+    /// Type of a pointer to the (shared, read-only) state
+    using pimpl_ptr = std::shared_ptr<const pimpl_type>;
 
     /// The class's actual state.
     pimpl_ptr m_pimpl_;
@@ -17,6 +17,7 @@
 #pragma once
 #include <chemist/fragmenting/fragmented_nuclei.hpp>
 #include <chemist/topology/connectivity_table.hpp>
+#include <ghostfragment/cap_index.hpp>
 #include <ghostfragment/property_types/topology/broken_bonds.hpp>
 #include <simde/simde.hpp>
 
@@ -31,25 +32,38 @@ namespace ghostfragment::pt {
 struct CappedFragmentsTraits {
     using frags_type = chemist::fragmenting::FragmentedNuclei<chemist::Nuclei>;
     using broken_bonds_type = BrokenBondsTraits::result_type;
+    using connectivity_type = chemist::topology::ConnectivityTable;
     using result_type       = frags_type;
+    using cap_index_type    = CapIndex;
 };
 
+/** @brief Property type for modules which cap the broken bonds of fragments.
+ *
+ *  Besides the capped fragments, these modules return a CapIndex of their cap
+ *  set. Capping is where the caps are produced, so the index is built there
+ *  once and consumers (e.g., the FragmentBasedMethod driver) use it to find
+ *  the caps of each fragment without rescanning the cap set.
+ */
 DECLARE_PROPERTY_TYPE(CappedFragments);
 
 PROPERTY_TYPE_INPUTS(CappedFragments) {
     using traits_type = CappedFragmentsTraits;
-    using input0_type = typename traits_type::frags_type;
+    using input0_type = const typename traits_type::frags_type&;
     using input1_type = const typename traits_type::broken_bonds_type&;
+    using input2_type = const typename traits_type::connectivity_type&;
     return pluginplay::declare_input()
       .add_field<input0_type>("Fragments to cap")
-      .template add_field<input1_type>("System connectivity");
+      .template add_field<input1_type>("Broken bonds")
+      .template add_field<input2_type>("Atomic connectivity");
 }
 
 PROPERTY_TYPE_RESULTS(CappedFragments) {
     using traits_type = CappedFragmentsTraits;
     using result_type = typename traits_type::result_type;
-    return pluginplay::declare_result().add_field<result_type>(
-      "Capped Fragments");
+    using index_type  = typename traits_type::cap_index_type;
+    return pluginplay::declare_result()
+      .add_field<result_type>("Capped Fragments")
+      .template add_field<index_type>("Cap index");
 }
 
 } // namespace ghostfragment::pt
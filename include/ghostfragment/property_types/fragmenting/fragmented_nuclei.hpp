@@ -25,7 +25,13 @@ struct FragmentedNucleiTraits {
     /// Expected input type of the molecular system
     using system_type = chemist::ChemicalSystem;
 
-    /// How the fragmented system is returned.
+    /** @brief How the fragmented system is returned.
+     *
+     *  chemist::FragmentedNuclei stores its supersystem by value, so every
+     *  result of this property type owns a full copy of the nuclei. Sharing
+     *  one supersystem between results needs FragmentedNuclei to support
+     *  shared (or view) storage first.
+     */
     using result_type = chemist::fragmenting::FragmentedNuclei<chemist::Nuclei>;
 };
 
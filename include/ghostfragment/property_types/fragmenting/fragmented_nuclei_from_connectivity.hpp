@@ -0,0 +1,58 @@
+/*
+ * Copyright 2024 GhostFragment
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include <chemist/topology/connectivity_table.hpp>
+#include <ghostfragment/property_types/fragmenting/fragmented_nuclei.hpp>
+
+namespace ghostfragment::pt {
+
+/// Types associated with the FragmentedNucleiFromConnectivity PT
+struct FragmentedNucleiFromConnectivityTraits : FragmentedNucleiTraits {
+    /// Type of the atomic connectivity
+    using connectivity_type = chemist::topology::ConnectivityTable;
+};
+
+/** @brief Property type for modules which fragment Nuclei objects using the
+ *         atomic connectivity of the system.
+ *
+ *  Many fragmentation methods need to know which nuclei are bonded. Rather
+ *  than having each such module compute the connectivity (possibly several
+ *  times per calculation), modules satisfying this property type are handed
+ *  the already computed connectivity.
+ */
+DECLARE_PROPERTY_TYPE(FragmentedNucleiFromConnectivity);
+
+PROPERTY_TYPE_INPUTS(FragmentedNucleiFromConnectivity) {
+    using traits_type = FragmentedNucleiFromConnectivityTraits;
+    using system_type = typename traits_type::system_type;
+    using input0_type = chemist::ChemicalSystemView<const system_type>;
+    using input1_type = const typename traits_type::connectivity_type&;
+
+    return pluginplay::declare_input()
+      .add_field<input0_type>("System to fragment")
+      .template add_field<input1_type>("Atomic connectivity");
+}
+
+PROPERTY_TYPE_RESULTS(FragmentedNucleiFromConnectivity) {
+    using traits_type = FragmentedNucleiFromConnectivityTraits;
+    using result_type = traits_type::result_type;
+
+    return pluginplay::declare_result().add_field<result_type>(
+      "Fragmented Nuclei");
+}
+
+} // namespace ghostfragment::pt
@@ -29,7 +29,7 @@ struct IntersectionTraits {
 DECLARE_PROPERTY_TYPE(Intersections);
 
 PROPERTY_TYPE_INPUTS(Intersections) {
-    using input0_type = typename IntersectionTraits::input_type;
+    using input0_type = const typename IntersectionTraits::input_type&;
     return pluginplay::declare_input().add_field<input0_type>(
       "Fragments to find intersections of");
 }
@@ -0,0 +1,50 @@
+/*
+ * Copyright 2024 GhostFragment
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include <ghostfragment/property_types/fragmenting/nuclear_graph_to_fragments.hpp>
+
+namespace ghostfragment::pt {
+
+struct NuclearGraphToNMersTraits : NuclearGraphToFragmentsTraits {
+    /// Type used to specify the n-mer size
+    using n_type = unsigned short;
+};
+
+/** @brief Property type for modules which make n-mers from a NuclearGraph.
+ *
+ *  Unlike NuclearGraphToFragments, the n-mer size is an input of the property
+ *  type. It is therefore part of the memoization key and a single module
+ *  instance can be used (and cached) for every n.
+ */
+DECLARE_PROPERTY_TYPE(NuclearGraphToNMers);
+
+PROPERTY_TYPE_INPUTS(NuclearGraphToNMers) {
+    using graph_type = const NuclearGraphToNMersTraits::graph_type&;
+    using n_type     = NuclearGraphToNMersTraits::n_type;
+
+    return pluginplay::declare_input()
+      .add_field<graph_type>("Molecular Graph")
+      .template add_field<n_type>("n");
+}
+
+PROPERTY_TYPE_RESULTS(NuclearGraphToNMers) {
+    using fragment_type = NuclearGraphToNMersTraits::fragment_type;
+
+    return pluginplay::declare_result().add_field<fragment_type>("Fragments");
+}
+
+} // namespace ghostfragment::pt
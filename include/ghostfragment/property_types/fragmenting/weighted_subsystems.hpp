@@ -0,0 +1,56 @@
+/*
+ * Copyright 2024 GhostFragment
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include <chemist/fragmenting/fragmented_nuclei.hpp>
+#include <pluginplay/pluginplay.hpp>
+#include <vector>
+
+namespace ghostfragment::pt {
+
+struct WeightedSubsystemsTraits {
+    using fragments_type =
+      chemist::fragmenting::FragmentedNuclei<chemist::Nuclei>;
+    using weight_type      = double;
+    using weight_container = std::vector<weight_type>;
+};
+
+/** @brief Property type for modules which go from fragments straight to the
+ *         weighted subsystems of a fragment-based method.
+ *
+ *  Modules satisfying this property type are given the fragments (without
+ *  intersections). They return the subsystems which contribute to the
+ *  fragment-based expansion, i.e., the subsystems with nonzero weights, and
+ *  the weight of each. The i-th weight goes with the i-th subsystem.
+ */
+DECLARE_PROPERTY_TYPE(WeightedSubsystems);
+
+PROPERTY_TYPE_INPUTS(WeightedSubsystems) {
+    using fragments_type = typename WeightedSubsystemsTraits::fragments_type;
+    using input0_type    = const fragments_type&;
+    return pluginplay::declare_input().add_field<input0_type>("Fragments");
+}
+
+PROPERTY_TYPE_RESULTS(WeightedSubsystems) {
+    using traits_type      = WeightedSubsystemsTraits;
+    using fragments_type   = typename traits_type::fragments_type;
+    using weight_container = typename traits_type::weight_container;
+    return pluginplay::declare_result()
+      .add_field<fragments_type>("Subsystems")
+      .template add_field<weight_container>("Weights");
+}
+
+} // namespace ghostfragment::pt
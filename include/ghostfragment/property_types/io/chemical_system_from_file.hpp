@@ -0,0 +1,42 @@
+/*
+ * Copyright 2024 GhostFragment
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include <chemist/chemist.hpp>
+#include <pluginplay/pluginplay.hpp>
+#include <string>
+
+namespace ghostfragment::pt {
+
+struct ChemicalSystemFromFileTraits {
+    using path_type   = std::string;
+    using result_type = chemist::ChemicalSystem;
+};
+
+DECLARE_PROPERTY_TYPE(ChemicalSystemFromFile);
+
+PROPERTY_TYPE_INPUTS(ChemicalSystemFromFile) {
+    using path_type = typename ChemicalSystemFromFileTraits::path_type;
+    return pluginplay::declare_input().add_field<path_type>("Path");
+}
+
+PROPERTY_TYPE_RESULTS(ChemicalSystemFromFile) {
+    using result_type = ChemicalSystemFromFileTraits::result_type;
+    return pluginplay::declare_result().add_field<result_type>(
+      "Chemical system");
+}
+
+} // namespace ghostfragment::pt
@@ -0,0 +1,58 @@
+/*
+ * Copyright 2024 GhostFragment
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include <chemist/chemist.hpp>
+#include <pluginplay/pluginplay.hpp>
+#include <set>
+#include <utility>
+
+namespace ghostfragment::pt {
+
+struct BondChangesTraits {
+    using input_type    = chemist::Molecule;
+    using conns_type    = chemist::topology::ConnectivityTable;
+    using size_type     = std::size_t;
+    using bond_type     = std::pair<size_type, size_type>;
+    using bond_set_type = std::set<bond_type>;
+};
+
+/** @brief Property type for modules which follow the bonds of a trajectory.
+ *
+ *  Modules satisfying this property type are given the frames of a trajectory
+ *  one at a time. For each frame they return the connectivity of the frame
+ *  along with the bonds which formed and broke since the previous frame (the
+ *  previous call to the module). The "ConnectivityTable" result is the same as
+ *  that of the ConnectivityTable property type.
+ */
+DECLARE_PROPERTY_TYPE(BondChanges);
+
+PROPERTY_TYPE_INPUTS(BondChanges) {
+    using molecule_type = typename BondChangesTraits::input_type;
+    using input_type    = chemist::MoleculeView<const molecule_type>;
+    return pluginplay::declare_input().add_field<input_type>("Molecule");
+}
+
+PROPERTY_TYPE_RESULTS(BondChanges) {
+    using conns_type    = BondChangesTraits::conns_type;
+    using bond_set_type = BondChangesTraits::bond_set_type;
+    return pluginplay::declare_result()
+      .add_field<conns_type>("ConnectivityTable")
+      .template add_field<bond_set_type>("Formed Bonds")
+      .template add_field<bond_set_type>("Broken Bonds");
+}
+
+} // namespace ghostfragment::pt
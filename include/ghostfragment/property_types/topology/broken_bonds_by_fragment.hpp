@@ -0,0 +1,54 @@
+/*
+ * Copyright 2024 GhostFragment
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include <chemist/fragmenting/fragmented_nuclei.hpp>
+#include <ghostfragment/fragment_broken_bonds.hpp>
+#include <pluginplay/pluginplay.hpp>
+
+namespace ghostfragment::pt {
+
+struct BrokenBondsByFragmentTraits {
+    using fragments_type =
+      chemist::fragmenting::FragmentedNuclei<chemist::Nuclei>;
+    using conns_type  = chemist::topology::ConnectivityTable;
+    using size_type   = typename fragments_type::size_type;
+    using result_type = FragmentBrokenBonds;
+    using bond_type   = typename result_type::bond_type;
+};
+
+/** @brief Determines the bonds each fragment broke.
+ *
+ *  Unlike BrokenBonds, which returns the set of all broken bonds, modules
+ *  satisfying this property type record which fragment broke which bond.
+ */
+DECLARE_PROPERTY_TYPE(BrokenBondsByFragment);
+
+PROPERTY_TYPE_INPUTS(BrokenBondsByFragment) {
+    using input0_type = const BrokenBondsByFragmentTraits::fragments_type&;
+    using input1_type = const BrokenBondsByFragmentTraits::conns_type&;
+    return pluginplay::declare_input()
+      .add_field<input0_type>("Fragments")
+      .template add_field<input1_type>("Connections");
+}
+
+PROPERTY_TYPE_RESULTS(BrokenBondsByFragment) {
+    using result_type = BrokenBondsByFragmentTraits::result_type;
+    return pluginplay::declare_result().add_field<result_type>(
+      "Broken Bonds By Fragment");
+}
+
+} // namespace ghostfragment::pt
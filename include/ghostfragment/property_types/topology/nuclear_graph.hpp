@@ -16,13 +16,15 @@
 
 #pragma once
 #include <chemist/chemical_system/chemical_system.hpp>
+#include <chemist/topology/connectivity_table.hpp>
 #include <ghostfragment/nuclear_graph.hpp>
 
 namespace ghostfragment::pt {
 
 struct NuclearGraphTraits {
-    using input_type  = chemist::ChemicalSystem;
-    using result_type = ghostfragment::NuclearGraph;
+    using input_type        = chemist::ChemicalSystem;
+    using connectivity_type = chemist::topology::ConnectivityTable;
+    using result_type       = ghostfragment::NuclearGraph;
 };
 
 /** @brief Property type for forming a nuclear graph
@@ -32,14 +34,21 @@ struct NuclearGraphTraits {
  *  satisfy this property type are responsible for taking a ChemicalSystem and
  *  creating a nuclear graph from it (essentially the module must break the
  *  Molecule into nodes and assign connectivity to the nodes).
+ *
+ *  The atomic connectivity of the ChemicalSystem is also an input. It is
+ *  computed once by the caller so that modules satisfying this property type
+ *  (and their submodules) do not need to recompute it.
  */
 DECLARE_PROPERTY_TYPE(NuclearGraph);
 
 PROPERTY_TYPE_INPUTS(NuclearGraph) {
     using chemical_system_type = typename NuclearGraphTraits::input_type;
     using input_type = chemist::ChemicalSystemView<const chemical_system_type>;
+    using conns_type = const typename NuclearGraphTraits::connectivity_type&;
 
-    return pluginplay::declare_input().add_field<input_type>("Chemical System");
+    return pluginplay::declare_input()
+      .add_field<input_type>("Chemical System")
+      .template add_field<conns_type>("Connectivity");
 }
 
 PROPERTY_TYPE_RESULTS(NuclearGraph) {
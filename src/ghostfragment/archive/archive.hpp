@@ -0,0 +1,40 @@
+/*
+ * Copyright 2024 GhostFragment
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include <simde/simde.hpp>
+
+namespace ghostfragment::archive {
+
+/// Input holding the path to the fragment archive
+inline constexpr auto path_key = "archive path";
+
+DECLARE_MODULE(ArchivedFragments);
+DECLARE_MODULE(ArchivedWeights);
+DECLARE_MODULE(ArchiveWriter);
+
+inline void load_modules(pluginplay::ModuleManager& mm) {
+    mm.add_module<ArchivedFragments>("Archived Fragments");
+    mm.add_module<ArchivedWeights>("Archived Weights");
+    mm.add_module<ArchiveWriter>("Archive Writer");
+}
+
+inline void set_defaults(pluginplay::ModuleManager& mm) {
+    mm.change_submod("Archive Writer", "Weighted subsystem former",
+                     "GMBE Subsystems");
+}
+
+} // namespace ghostfragment::archive
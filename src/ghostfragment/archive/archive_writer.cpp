@@ -0,0 +1,74 @@
+/*
+ * Copyright 2024 GhostFragment
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "archive.hpp"
+#include <ghostfragment/fragment_archive.hpp>
+#include <ghostfragment/property_types/fragmenting/weighted_subsystems.hpp>
+
+namespace ghostfragment::archive {
+
+using my_pt = pt::WeightedSubsystems;
+
+namespace {
+const auto mod_desc = R"(
+Archive Writer
+--------------
+
+Writes the subsystems of a fragment-based method and their weights to a
+fragment archive (see FragmentArchive), so that later jobs can read them back
+instead of computing them again.
+
+This module runs the "Weighted subsystem former" submodule (by default GMBE
+Subsystems), writes its results to the archive, and returns them unchanged. To
+write an archive, set "weighted subsystems" of the Fragment Based Method to
+true and use this module as its "Weighted subsystem former". To reuse the
+archive, use Archived Fragments as the "Fragmenter" of the
+FragmentedChemicalSystem Driver and Archived Weights as the "Weighter" of the
+Fragment Based Method.
+
+An existing archive at the path is replaced once the new one is complete, so
+jobs which are reading the old archive are not affected.
+)";
+}
+
+MODULE_CTOR(ArchiveWriter) {
+    description(mod_desc);
+    satisfies_property_type<my_pt>();
+
+    add_input<std::string>(path_key).set_description(
+      "Path to write the fragment archive to");
+
+    add_submodule<my_pt>("Weighted subsystem former");
+}
+
+MODULE_RUN(ArchiveWriter) {
+    auto& logger        = get_runtime().logger();
+    const auto& [frags] = my_pt::unwrap_inputs(inputs);
+    const auto& path    = inputs.at(path_key).value<std::string>();
+
+    auto& former_mod = submods.at("Weighted subsystem former");
+
+    // The archive is only written if forming the subsystems succeeds
+    const auto& [subsystems, weights] = former_mod.run_as<my_pt>(frags);
+    FragmentArchive::write(path, subsystems, weights);
+    logger.debug("Wrote " + std::to_string(subsystems.size()) +
+                 " subsystems to " + path + ".");
+
+    auto rv = results();
+    return my_pt::wrap_results(rv, subsystems, weights);
+}
+
+} // namespace ghostfragment::archive
@@ -0,0 +1,65 @@
+/*
+ * Copyright 2024 GhostFragment
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "archive.hpp"
+#include <ghostfragment/fragment_archive.hpp>
+#include <ghostfragment/property_types/fragmenting/fragmented_nuclei.hpp>
+
+namespace ghostfragment::archive {
+
+using my_pt = pt::FragmentedNuclei;
+
+namespace {
+const auto mod_desc = R"(
+Archived Fragments
+------------------
+
+Reads the fragments (and caps) of a chemical system from a fragment archive
+(see FragmentArchive, or the Archive Writer module for writing one as part of a
+calculation) instead of computing them. To reuse an archive in a
+fragment-based method, use this module as the "Fragmenter" of the
+FragmentedChemicalSystem Driver and Archived Weights as the "Weighter" of the
+Fragment Based Method.
+
+The archive must have been written for the same elements and coordinates as
+the input chemical system; otherwise an error is raised.
+)";
+}
+
+MODULE_CTOR(ArchivedFragments) {
+    description(mod_desc);
+    satisfies_property_type<my_pt>();
+
+    add_input<std::string>(path_key).set_description(
+      "Path to the fragment archive");
+}
+
+MODULE_RUN(ArchivedFragments) {
+    const auto& [sys] = my_pt::unwrap_inputs(inputs);
+    const auto& path  = inputs.at(path_key).value<std::string>();
+    const auto mol    = sys.molecule();
+    const auto nuclei = mol.nuclei();
+
+    FragmentArchive archive(path);
+    if(!archive.is_supersystem(nuclei))
+        throw std::runtime_error("Fragment archive " + path +
+                                 " was written for a different system");
+
+    auto rv = results();
+    return my_pt::wrap_results(rv, archive.fragments(nuclei.as_nuclei()));
+}
+
+} // namespace ghostfragment::archive
@@ -0,0 +1,68 @@
+/*
+ * Copyright 2024 GhostFragment
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "archive.hpp"
+#include <algorithm>
+#include <ghostfragment/fragment_archive.hpp>
+#include <ghostfragment/property_types/fragmenting/fragment_weights.hpp>
+
+namespace ghostfragment::archive {
+
+using my_pt = pt::FragmentWeights;
+
+namespace {
+const auto mod_desc = R"(
+Archived Weights
+----------------
+
+Reads the weights of the fragments from a fragment archive (see
+FragmentArchive) instead of computing them. The input fragments must be the
+fragments in the archive (e.g., those returned by Archived Fragments);
+otherwise an error is raised.
+)";
+}
+
+MODULE_CTOR(ArchivedWeights) {
+    description(mod_desc);
+    satisfies_property_type<my_pt>();
+
+    add_input<std::string>(path_key).set_description(
+      "Path to the fragment archive");
+}
+
+MODULE_RUN(ArchivedWeights) {
+    const auto& [frags] = my_pt::unwrap_inputs(inputs);
+    const auto& path    = inputs.at(path_key).value<std::string>();
+    const auto& nuclei_frags =
+      frags.fragmented_molecule().fragmented_nuclei();
+
+    FragmentArchive archive(path);
+    bool same = nuclei_frags.size() == archive.size();
+    for(std::size_t i = 0; same && i < archive.size(); ++i) {
+        const auto indices = nuclei_frags.nuclear_indices(i);
+        const auto corr    = archive.fragment(i);
+        same = std::equal(indices.begin(), indices.end(), corr.begin(),
+                          corr.end());
+    }
+    if(!same)
+        throw std::runtime_error("Fragment archive " + path +
+                                 " was written for different fragments");
+
+    auto rv = results();
+    return my_pt::wrap_results(rv, archive.weight_list());
+}
+
+} // namespace ghostfragment::archive
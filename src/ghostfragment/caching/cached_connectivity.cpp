@@ -0,0 +1,72 @@
+/*
+ * Copyright 2024 GhostFragment
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "caching.hpp"
+#include "load_or_compute.hpp"
+#include <ghostfragment/property_types/topology/connectivity_table.hpp>
+
+namespace ghostfragment::caching {
+
+using my_pt       = pt::ConnectivityTable;
+using result_type = typename pt::ConnectivityTableTraits::result_type;
+
+namespace {
+const auto conns_desc = R"(
+Cached Connectivity
+-------------------
+
+Wraps a module which computes the atomic connectivity and stores its results in
+an on-disk cache. The entries are keyed by the elements and coordinates of the
+molecule, and by the configuration of the wrapped module: its description and
+the values of its inputs (e.g., the bond tolerance), recursively including its
+submodules. When a later job (possibly a different process) asks for the
+connectivity of the same molecule with the same configuration, it is read from
+the cache instead of being recomputed.
+)";
+
+constexpr auto conns_tag = "connectivity";
+} // namespace
+
+MODULE_CTOR(CachedConnectivity) {
+    description(conns_desc);
+    satisfies_property_type<my_pt>();
+
+    add_input<std::string>(directory_key)
+      .set_description("Directory of the on-disk cache")
+      .set_default(std::string(default_directory));
+
+    add_submodule<my_pt>("Connectivity");
+}
+
+MODULE_RUN(CachedConnectivity) {
+    auto& logger      = get_runtime().logger();
+    const auto& [mol] = my_pt::unwrap_inputs(inputs);
+
+    DiskCache cache(inputs.at(directory_key).value<std::string>());
+    Hasher h;
+    hash_snapshot(h, topology::NucleiSnapshot(mol));
+
+    auto& conn_mod = submods.at("Connectivity");
+    auto conns     = load_or_compute(
+      cache, conns_tag, conn_mod.value(), h,
+      [](BinaryReader& r) { return deserialize_connectivity(r); },
+      [&]() { return result_type(conn_mod.run_as<my_pt>(mol)); }, logger);
+
+    auto rv = results();
+    return my_pt::wrap_results(rv, std::move(conns));
+}
+
+} // namespace ghostfragment::caching
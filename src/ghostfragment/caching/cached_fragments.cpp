@@ -0,0 +1,77 @@
+/*
+ * Copyright 2024 GhostFragment
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "caching.hpp"
+#include "load_or_compute.hpp"
+#include <ghostfragment/property_types/fragmenting/fragmented_nuclei.hpp>
+
+namespace ghostfragment::caching {
+
+using my_pt       = pt::FragmentedNuclei;
+using result_type = typename pt::FragmentedNucleiTraits::result_type;
+
+namespace {
+const auto frags_desc = R"(
+Cached Fragments
+----------------
+
+Wraps a module which fragments a chemical system (by default the Fragment
+Driver) and stores its results in an on-disk cache. The entries are keyed by the
+elements and coordinates, charge, and multiplicity of the chemical system, and
+by the configuration of the fragmenter: the description and inputs (e.g., the
+n-mer size) of it and, recursively, of its submodules (e.g., the capping
+method). The fragments, intersections, and caps are stored; the nuclei come
+from the input chemical system.
+)";
+
+constexpr auto frags_tag = "fragments";
+} // namespace
+
+MODULE_CTOR(CachedFragments) {
+    description(frags_desc);
+    satisfies_property_type<my_pt>();
+
+    add_input<std::string>(directory_key)
+      .set_description("Directory of the on-disk cache")
+      .set_default(std::string(default_directory));
+
+    add_submodule<my_pt>("Fragmenter");
+}
+
+MODULE_RUN(CachedFragments) {
+    auto& logger      = get_runtime().logger();
+    const auto& [sys] = my_pt::unwrap_inputs(inputs);
+    const auto mol    = sys.molecule();
+
+    DiskCache cache(inputs.at(directory_key).value<std::string>());
+    Hasher h;
+    hash_snapshot(h, topology::NucleiSnapshot(mol));
+    h.update(std::int64_t(mol.charge()));
+    h.update(std::uint64_t(mol.multiplicity()));
+
+    auto& frag_mod = submods.at("Fragmenter");
+    auto frags     = load_or_compute(
+      cache, frags_tag, frag_mod.value(), h,
+      [&](BinaryReader& r) {
+          return deserialize_fragments(r, mol.nuclei().as_nuclei());
+      },
+      [&]() { return result_type(frag_mod.run_as<my_pt>(sys)); }, logger);
+
+    auto rv = results();
+    return my_pt::wrap_results(rv, std::move(frags));
+}
+
+} // namespace ghostfragment::caching
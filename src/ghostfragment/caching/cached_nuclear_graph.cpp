@@ -0,0 +1,75 @@
+/*
+ * Copyright 2024 GhostFragment
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "caching.hpp"
+#include "load_or_compute.hpp"
+#include <ghostfragment/property_types/topology/nuclear_graph.hpp>
+
+namespace ghostfragment::caching {
+
+using my_pt       = pt::NuclearGraph;
+using result_type = typename pt::NuclearGraphTraits::result_type;
+
+namespace {
+const auto graph_desc = R"(
+Cached Nuclear Graph
+--------------------
+
+Wraps a module which forms the nuclear graph and stores its results in an
+on-disk cache. The entries are keyed by the elements and coordinates of the
+chemical system, the atomic connectivity, and the description and inputs of
+the graph maker and, recursively, of its submodules. Only the nodes and edges
+are stored, the nuclei come from the input chemical system.
+)";
+
+constexpr auto graph_tag = "nuclear_graph";
+} // namespace
+
+MODULE_CTOR(CachedNuclearGraph) {
+    description(graph_desc);
+    satisfies_property_type<my_pt>();
+
+    add_input<std::string>(directory_key)
+      .set_description("Directory of the on-disk cache")
+      .set_default(std::string(default_directory));
+
+    add_submodule<my_pt>("Graph maker");
+}
+
+MODULE_RUN(CachedNuclearGraph) {
+    auto& logger                  = get_runtime().logger();
+    const auto& [chem_sys, conns] = my_pt::unwrap_inputs(inputs);
+    const auto mol                = chem_sys.molecule();
+
+    DiskCache cache(inputs.at(directory_key).value<std::string>());
+    Hasher h;
+    hash_snapshot(h, topology::NucleiSnapshot(mol));
+    hash_connectivity(h, conns);
+
+    auto& graph_mod = submods.at("Graph maker");
+    auto graph      = load_or_compute(
+      cache, graph_tag, graph_mod.value(), h,
+      [&](BinaryReader& r) {
+          return deserialize_graph(r, mol.nuclei().as_nuclei());
+      },
+      [&]() { return result_type(graph_mod.run_as<my_pt>(chem_sys, conns)); },
+      logger);
+
+    auto rv = results();
+    return my_pt::wrap_results(rv, std::move(graph));
+}
+
+} // namespace ghostfragment::caching
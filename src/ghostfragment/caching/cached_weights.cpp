@@ -0,0 +1,73 @@
+/*
+ * Copyright 2024 GhostFragment
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "caching.hpp"
+#include "load_or_compute.hpp"
+#include <ghostfragment/property_types/fragmenting/fragment_weights.hpp>
+
+namespace ghostfragment::caching {
+
+using my_pt       = pt::FragmentWeights;
+using result_type = typename pt::FragmentWeightsTraits::weight_container;
+
+namespace {
+const auto weights_desc = R"(
+Cached Weights
+--------------
+
+Wraps a module which computes the weights of the subsystems (by default the GMBE
+weights) and stores its results in an on-disk cache. The entries are keyed by
+the elements and coordinates of the supersystem, the subsystems (and their
+caps), and the description and inputs of the weighter and, recursively, of its
+submodules.
+)";
+
+constexpr auto weights_tag = "weights";
+} // namespace
+
+MODULE_CTOR(CachedWeights) {
+    description(weights_desc);
+    satisfies_property_type<my_pt>();
+
+    add_input<std::string>(directory_key)
+      .set_description("Directory of the on-disk cache")
+      .set_default(std::string(default_directory));
+
+    add_submodule<my_pt>("Weighter");
+}
+
+MODULE_RUN(CachedWeights) {
+    auto& logger        = get_runtime().logger();
+    const auto& [frags] = my_pt::unwrap_inputs(inputs);
+    const auto& nuclei_frags =
+      frags.fragmented_molecule().fragmented_nuclei();
+
+    DiskCache cache(inputs.at(directory_key).value<std::string>());
+    Hasher h;
+    hash_snapshot(h, topology::NucleiSnapshot(nuclei_frags.supersystem()));
+    hash_fragments(h, nuclei_frags);
+
+    auto& weight_mod = submods.at("Weighter");
+    auto weights     = load_or_compute(
+      cache, weights_tag, weight_mod.value(), h,
+      [](BinaryReader& r) { return deserialize_weights(r); },
+      [&]() { return result_type(weight_mod.run_as<my_pt>(frags)); }, logger);
+
+    auto rv = results();
+    return my_pt::wrap_results(rv, std::move(weights));
+}
+
+} // namespace ghostfragment::caching
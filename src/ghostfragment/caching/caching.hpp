@@ -0,0 +1,47 @@
+/*
+ * Copyright 2024 GhostFragment
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include <simde/simde.hpp>
+
+namespace ghostfragment::caching {
+
+/// Input holding the directory of the on-disk cache
+inline constexpr auto directory_key = "cache directory";
+
+/// Default for directory_key
+inline constexpr auto default_directory = ".ghostfragment_cache";
+
+DECLARE_MODULE(CachedConnectivity);
+DECLARE_MODULE(CachedNuclearGraph);
+DECLARE_MODULE(CachedFragments);
+DECLARE_MODULE(CachedWeights);
+
+inline void load_modules(pluginplay::ModuleManager& mm) {
+    mm.add_module<CachedConnectivity>("Cached Connectivity");
+    mm.add_module<CachedNuclearGraph>("Cached Nuclear Graph");
+    mm.add_module<CachedFragments>("Cached Fragments");
+    mm.add_module<CachedWeights>("Cached Weights");
+}
+
+inline void set_defaults(pluginplay::ModuleManager& mm) {
+    mm.change_submod("Cached Connectivity", "Connectivity", "Covalent Radius");
+    mm.change_submod("Cached Nuclear Graph", "Graph maker", "Nuclear Graph");
+    mm.change_submod("Cached Fragments", "Fragmenter", "Fragment Driver");
+    mm.change_submod("Cached Weights", "Weighter", "GMBE Weights");
+}
+
+} // namespace ghostfragment::caching
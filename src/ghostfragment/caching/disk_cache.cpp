@@ -0,0 +1,112 @@
+/*
+ * Copyright 2024 GhostFragment
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "disk_cache.hpp"
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <stdexcept>
+
+namespace ghostfragment::caching {
+namespace {
+
+using magic_type = std::array<char, 8>;
+
+constexpr magic_type magic{'G', 'F', 'C', 'A', 'C', 'H', 'E', '\0'};
+
+// Layout of the header preceding the payload of every entry
+struct Header {
+    magic_type magic;
+    std::uint32_t version;
+    std::uint32_t padding;
+    std::uint64_t nbytes;
+    std::uint64_t checksum;
+};
+
+std::uint64_t checksum(const DiskCache::buffer_type& payload) {
+    Hasher h(false);
+    h.update(payload.data(), payload.size());
+    return h.value();
+}
+
+std::string to_hex(std::uint64_t value) {
+    constexpr auto digits = "0123456789abcdef";
+    std::string hex(16, '0');
+    for(auto i = 16; i > 0; --i, value >>= 4) hex[i - 1] = digits[value & 0xF];
+    return hex;
+}
+
+} // namespace
+
+DiskCache::path_type DiskCache::path(const std::string& tag,
+                                     key_type key) const {
+    return m_root_ / (tag + "-" + to_hex(key) + ".bin");
+}
+
+std::optional<DiskCache::buffer_type> DiskCache::load(const std::string& tag,
+                                                      key_type key) const {
+    std::ifstream file(path(tag, key), std::ios::binary);
+    if(!file) return std::nullopt;
+
+    Header header;
+    if(!file.read(reinterpret_cast<char*>(&header), sizeof(Header)))
+        return std::nullopt;
+    if(header.magic != magic || header.version != format_version)
+        return std::nullopt;
+
+    buffer_type payload(header.nbytes);
+    if(!file.read(payload.data(), payload.size())) return std::nullopt;
+    if(checksum(payload) != header.checksum) return std::nullopt;
+    return payload;
+}
+
+void DiskCache::store(const std::string& tag, key_type key,
+                      const buffer_type& payload) const {
+    const auto final_path = path(tag, key);
+    std::error_code error;
+    std::filesystem::create_directories(m_root_, error);
+    if(error)
+        throw std::runtime_error("Could not create cache directory " +
+                                 m_root_.string() + ": " + error.message());
+
+    // Unique temporary name so concurrent writers don't clobber each other
+    std::random_device rd;
+    auto tmp_path = final_path;
+    tmp_path += ".tmp" + to_hex((std::uint64_t(rd()) << 32) | rd());
+
+    Header header{magic, format_version, 0, payload.size(), checksum(payload)};
+    {
+        std::ofstream file(tmp_path, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+        file.write(payload.data(), payload.size());
+        if(!file) {
+            file.close();
+            std::filesystem::remove(tmp_path, error);
+            throw std::runtime_error("Could not write cache entry " +
+                                     tmp_path.string());
+        }
+    }
+
+    std::filesystem::rename(tmp_path, final_path, error);
+    if(error) {
+        std::filesystem::remove(tmp_path, error);
+        throw std::runtime_error("Could not write cache entry " +
+                                 final_path.string());
+    }
+}
+
+} // namespace ghostfragment::caching
@@ -0,0 +1,88 @@
+/*
+ * Copyright 2024 GhostFragment
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include "hasher.hpp"
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace ghostfragment::caching {
+
+/** @brief A content-addressed cache of binary blobs in a local directory.
+ *
+ *  Each entry is identified by a tag (what kind of result it holds, e.g.,
+ *  "connectivity") and a key (the hash of everything the result depends on).
+ *  Entry (tag, key) lives in the file `<root>/<tag>-<key as hex>.bin` and
+ *  consists of a small header (magic number, format version, payload size,
+ *  and payload checksum) followed by the payload.
+ *
+ *  Entries are written to a temporary file which is then renamed, so
+ *  concurrent jobs sharing a cache directory never see partially written
+ *  entries. Entries which are missing, from a different format version, or
+ *  fail the checksum are treated as cache misses.
+ */
+class DiskCache {
+public:
+    /// Type used for paths
+    using path_type = std::filesystem::path;
+
+    /// Type of the key of an entry
+    using key_type = Hasher::hash_type;
+
+    /// Type of the payload of an entry
+    using buffer_type = std::vector<char>;
+
+    /// Bumped whenever the layout of an entry (or of a payload) changes
+    static constexpr std::uint32_t format_version = 2;
+
+    /** @brief Creates a cache rooted at @p root.
+     *
+     *  The directory is created the first time an entry is stored.
+     */
+    explicit DiskCache(path_type root) : m_root_(std::move(root)) {}
+
+    /// The directory holding the entries
+    const path_type& root() const noexcept { return m_root_; }
+
+    /// The file holding entry (@p tag, @p key)
+    path_type path(const std::string& tag, key_type key) const;
+
+    /** @brief Reads entry (@p tag, @p key).
+     *
+     *  @return The payload of the entry, or std::nullopt if there is no valid
+     *          entry.
+     *
+     *  @throw std::bad_alloc if allocating the payload fails. Strong throw
+     *                        guarantee.
+     */
+    std::optional<buffer_type> load(const std::string& tag, key_type key) const;
+
+    /** @brief Writes entry (@p tag, @p key), overwriting any existing entry.
+     *
+     *  @throw std::runtime_error if the entry can not be written. The cache is
+     *                            left unchanged.
+     */
+    void store(const std::string& tag, key_type key,
+               const buffer_type& payload) const;
+
+private:
+    /// The directory holding the entries
+    path_type m_root_;
+};
+
+} // namespace ghostfragment::caching
@@ -0,0 +1,158 @@
+/*
+ * Copyright 2024 GhostFragment
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include "../topology/nuclei_snapshot.hpp"
+#include <cstdint>
+#include <string>
+#include <type_traits>
+
+namespace ghostfragment::caching {
+
+/** @brief Computes the 64-bit FNV-1a hash of a stream of bytes.
+ *
+ *  Entries of the on-disk cache are addressed by the hash of everything the
+ *  cached result depends on (coordinates, elements, module inputs, etc.).
+ *  Hasher accumulates that hash. FNV-1a is not cryptographic, it is used
+ *  because it is simple, fast, and stable across platforms and processes
+ *  (unlike std::hash).
+ *
+ *  Because distinct inputs can collide, Hasher also keeps a copy of every byte
+ *  it was given (the "key material"). Cache entries store the material next
+ *  to the result and compare it on load, so a collision is a miss rather than
+ *  a wrong result.
+ */
+class Hasher {
+public:
+    /// Type of the hash
+    using hash_type = std::uint64_t;
+
+    /// Hasher which records the key material
+    Hasher() = default;
+
+    /** @brief Hasher which records the key material only if @p record is true.
+     *
+     *  Checksums of large buffers don't need the material and would double
+     *  the memory they use if it were kept.
+     */
+    explicit Hasher(bool record) : m_record_(record) {}
+
+    /// Adds @p nbytes bytes starting at @p data to the hash
+    void update(const void* data, std::size_t nbytes) {
+        const auto* bytes = static_cast<const unsigned char*>(data);
+        if(m_record_)
+            m_material_.append(static_cast<const char*>(data), nbytes);
+        for(std::size_t i = 0; i < nbytes; ++i) {
+            m_state_ ^= bytes[i];
+            m_state_ *= prime;
+        }
+    }
+
+    /// Adds the bytes of an arithmetic value to the hash
+    template<typename T>
+    std::enable_if_t<std::is_arithmetic_v<T>> update(T value) {
+        update(&value, sizeof(T));
+    }
+
+    /// Adds a string (and its length, so "ab"+"c" != "a"+"bc") to the hash
+    void update(const std::string& value) {
+        update(std::uint64_t(value.size()));
+        update(value.data(), value.size());
+    }
+
+    /// The hash of everything added so far
+    hash_type value() const noexcept { return m_state_; }
+
+    /// Every byte added so far, in order (empty if not recording)
+    const std::string& material() const noexcept { return m_material_; }
+
+private:
+    /// FNV-1a parameters for 64-bit hashes
+    static constexpr hash_type offset_basis = 14695981039346656037ull;
+    static constexpr hash_type prime        = 1099511628211ull;
+
+    /// The hash so far
+    hash_type m_state_ = offset_basis;
+
+    /// Whether to record the key material
+    bool m_record_ = true;
+
+    /// The bytes hashed so far (if recording)
+    std::string m_material_;
+};
+
+/** @brief Adds the elements and coordinates of @p snapshot to @p h.
+ *
+ *  Results of the topology and fragmenting modules depend on the atomic
+ *  numbers and positions of the nuclei, which is exactly what NucleiSnapshot
+ *  holds.
+ */
+inline void hash_snapshot(Hasher& h, const topology::NucleiSnapshot& snapshot) {
+    using coord_type  = typename topology::NucleiSnapshot::coord_type;
+    const auto n      = snapshot.size();
+    const auto nbytes = n * sizeof(coord_type);
+    h.update(std::uint64_t(n));
+    for(std::size_t i = 0; i < n; ++i) h.update(std::uint64_t(snapshot.Z()[i]));
+    h.update(snapshot.x().data(), nbytes);
+    h.update(snapshot.y().data(), nbytes);
+    h.update(snapshot.z().data(), nbytes);
+}
+
+/** @brief Adds the number of atoms and the bonds of @p conns to @p h.
+ *
+ *  @tparam ConnectivityType Expected to be a chemist ConnectivityTable.
+ */
+template<typename ConnectivityType>
+void hash_connectivity(Hasher& h, const ConnectivityType& conns) {
+    h.update(std::uint64_t(conns.natoms()));
+    const auto bonds = conns.bonds();
+    h.update(std::uint64_t(bonds.size()));
+    for(const auto& bond : bonds) {
+        h.update(std::uint64_t(bond[0]));
+        h.update(std::uint64_t(bond[1]));
+    }
+}
+
+/** @brief Adds the fragments in @p frags (but not their supersystem) to @p h.
+ *
+ *  @tparam FragmentsType Expected to be a specialization of FragmentedNuclei.
+ */
+template<typename FragmentsType>
+void hash_fragments(Hasher& h, const FragmentsType& frags) {
+    h.update(std::uint64_t(frags.size()));
+    for(std::size_t i = 0; i < frags.size(); ++i) {
+        const auto indices = frags.nuclear_indices(i);
+        h.update(std::uint64_t(indices.size()));
+        for(const auto j : indices) h.update(std::uint64_t(j));
+    }
+
+    const auto& caps = frags.cap_set();
+    h.update(std::uint64_t(caps.size()));
+    for(const auto& cap : caps) {
+        h.update(std::uint64_t(cap.get_anchor_index()));
+        h.update(std::uint64_t(cap.get_replaced_index()));
+        h.update(std::uint64_t(cap.size()));
+        for(std::size_t i = 0; i < cap.size(); ++i) {
+            const auto nucleus = cap.at(i);
+            h.update(std::uint64_t(nucleus.Z()));
+            h.update(double(nucleus.x()));
+            h.update(double(nucleus.y()));
+            h.update(double(nucleus.z()));
+        }
+    }
+}
+
+} // namespace ghostfragment::caching
@@ -0,0 +1,112 @@
+/*
+ * Copyright 2024 GhostFragment
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include "disk_cache.hpp"
+#include "module_key.hpp"
+#include "serialization.hpp"
+#include <exception>
+#include <utility>
+
+namespace ghostfragment::caching {
+
+/** @brief Reads the entry of @p cache keyed by @p key, or computes and stores
+ *         it.
+ *
+ *  This is the body shared by the cached wrapper modules. Each entry holds
+ *  the key material of @p key followed by the serialized result. An entry is
+ *  only used if its key material equals that of @p key; otherwise (a hash
+ *  collision, or an entry written by a different version) it is treated as a
+ *  miss and overwritten. Failing to store the result (e.g., because the
+ *  directory is read-only or the disk is full, or because the result can not
+ *  be serialized) is not an error: the failure is logged as a warning and the
+ *  computed result is returned.
+ *
+ *  @tparam ReadFxn Callable taking a BinaryReader& and returning the result.
+ *  @tparam ComputeFxn Callable taking no arguments and returning the result.
+ *  @tparam LoggerType The type of the logger.
+ *
+ *  @param[in] cache The cache to use.
+ *  @param[in] tag The kind of result.
+ *  @param[in] key Has hashed everything the result depends on.
+ *  @param[in] read Used to read the result on a cache hit.
+ *  @param[in] compute Used to compute the result on a cache miss.
+ *  @param[in] logger Where to report hits and misses.
+ *
+ *  @return The result, either read from @p cache or computed.
+ *
+ *  @throw std::exception Any exception thrown by @p read or @p compute is
+ *                        propagated. Strong throw guarantee (nothing has been
+ *                        stored).
+ */
+template<typename ReadFxn, typename ComputeFxn, typename LoggerType>
+auto load_or_compute(const DiskCache& cache, const std::string& tag,
+                     const Hasher& key, ReadFxn&& read, ComputeFxn&& compute,
+                     LoggerType& logger) {
+    const auto entry = cache.path(tag, key.value()).string();
+    if(auto payload = cache.load(tag, key.value())) {
+        BinaryReader r(*payload);
+        if(r.read_string() == key.material()) {
+            auto result = read(r);
+            logger.debug("Loaded " + tag + " from " + entry + ".");
+            return result;
+        }
+        logger.debug("Key of " + entry + " does not match, recomputing.");
+    }
+
+    auto result = compute();
+    try {
+        BinaryWriter w;
+        w.write(key.material());
+        serialize(w, result);
+        cache.store(tag, key.value(), w.buffer());
+        logger.debug("Stored " + tag + " in " + entry + ".");
+    } catch(const std::exception& e) {
+        logger.warn("Could not store " + tag + " in " + entry + ": " +
+                    e.what());
+    }
+    return result;
+}
+
+/** @brief Adds the configuration of @p wrapped to @p key, then calls the
+ *         overload above.
+ *
+ *  The cached wrapper modules use this overload so that a change to any
+ *  input of the module they wrap (or of its submodules) is a miss. If
+ *  @p wrapped can not be hashed (see hash_module) the result is computed and
+ *  not cached, and a warning says so.
+ *
+ *  @param[in] wrapped The module @p compute runs.
+ *  @param[in] key Has hashed the property type inputs of @p wrapped.
+ *
+ *  See the overload above for the remaining parameters, the return, and the
+ *  exceptions.
+ */
+template<typename ReadFxn, typename ComputeFxn, typename LoggerType>
+auto load_or_compute(const DiskCache& cache, const std::string& tag,
+                     const pluginplay::Module& wrapped, Hasher key,
+                     ReadFxn&& read, ComputeFxn&& compute,
+                     LoggerType& logger) {
+    if(!hash_module(key, wrapped)) {
+        logger.warn("The module computing " + tag +
+                    " has an input which can not be hashed, not caching.");
+        return compute();
+    }
+    return load_or_compute(cache, tag, key, std::forward<ReadFxn>(read),
+                           std::forward<ComputeFxn>(compute), logger);
+}
+
+} // namespace ghostfragment::caching
@@ -0,0 +1,116 @@
+/*
+ * Copyright 2024 GhostFragment
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "module_key.hpp"
+#include <chemist/chemist.hpp>
+#include <ghostfragment/property_types/fragmenting/nuclear_graph_to_nmers.hpp>
+#include <vector>
+
+namespace ghostfragment::caching {
+namespace {
+
+using n_type       = pt::NuclearGraphToNMersTraits::n_type;
+using nucleus_type = typename chemist::Nuclei::value_type;
+
+// Tags written before each value so values of different types can't collide
+enum class InputKind : std::uint8_t {
+    unset,
+    boolean,
+    integer,
+    unsigned_integer,
+    real,
+    string,
+    reals,
+    nucleus
+};
+
+// If input holds a T, adds its kind and value (via add) to h
+template<typename T, typename AddFxn>
+bool try_hash(Hasher& h, const pluginplay::ModuleInput& input, InputKind kind,
+              AddFxn&& add) {
+    try {
+        const auto value = input.value<T>();
+        h.update(std::uint8_t(kind));
+        add(value);
+        return true;
+    } catch(const std::bad_alloc&) {
+        throw;
+    } catch(const std::exception&) {
+        // Not a T
+        return false;
+    }
+}
+
+bool hash_input(Hasher& h, const pluginplay::ModuleInput& input) {
+    if(!input.has_value()) {
+        h.update(std::uint8_t(InputKind::unset));
+        return true;
+    }
+
+    auto boolean      = [&](bool value) { h.update(std::uint8_t(value)); };
+    auto signed_int   = [&](auto value) { h.update(std::int64_t(value)); };
+    auto unsigned_int = [&](auto value) { h.update(std::uint64_t(value)); };
+    auto real         = [&](double value) { h.update(value); };
+    auto string       = [&](const std::string& value) { h.update(value); };
+    auto reals        = [&](const std::vector<double>& value) {
+        h.update(std::uint64_t(value.size()));
+        for(const auto x : value) h.update(x);
+    };
+    auto nucleus = [&](const nucleus_type& value) {
+        h.update(value.name());
+        h.update(std::uint64_t(value.Z()));
+        h.update(double(value.mass()));
+        h.update(double(value.x()));
+        h.update(double(value.y()));
+        h.update(double(value.z()));
+    };
+
+    return try_hash<bool>(h, input, InputKind::boolean, boolean) ||
+           try_hash<int>(h, input, InputKind::integer, signed_int) ||
+           try_hash<n_type>(h, input, InputKind::unsigned_integer,
+                            unsigned_int) ||
+           try_hash<std::size_t>(h, input, InputKind::unsigned_integer,
+                                 unsigned_int) ||
+           try_hash<double>(h, input, InputKind::real, real) ||
+           try_hash<std::string>(h, input, InputKind::string, string) ||
+           try_hash<std::vector<double>>(h, input, InputKind::reals, reals) ||
+           try_hash<nucleus_type>(h, input, InputKind::nucleus, nucleus);
+}
+
+} // namespace
+
+bool hash_module(Hasher& h, const pluginplay::Module& mod) {
+    h.update(mod.has_description() ? mod.description() : std::string{});
+
+    const auto& inputs = mod.inputs();
+    h.update(std::uint64_t(inputs.size()));
+    for(const auto& [key, input] : inputs) {
+        h.update(key);
+        if(!hash_input(h, input)) return false;
+    }
+
+    const auto& submods = mod.submods();
+    h.update(std::uint64_t(submods.size()));
+    for(const auto& [key, submod] : submods) {
+        h.update(key);
+        h.update(std::uint8_t(submod.has_module()));
+        if(submod.has_module() && !hash_module(h, submod.value()))
+            return false;
+    }
+    return true;
+}
+
+} // namespace ghostfragment::caching
@@ -0,0 +1,50 @@
+/*
+ * Copyright 2024 GhostFragment
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include "hasher.hpp"
+#include <pluginplay/pluginplay.hpp>
+
+namespace ghostfragment::caching {
+
+/** @brief Adds everything that configures @p mod to @p h.
+ *
+ *  The result of a module depends on its property type inputs, which the
+ *  cached wrappers hash themselves, and on how the module is configured. This
+ *  function hashes the latter: the description of @p mod (which identifies
+ *  the algorithm), the name and value of every one of its inputs, and,
+ *  recursively, the same for every submodule it calls. Changing, e.g., the
+ *  bond tolerance of the connectivity module or swapping the module used for
+ *  capping therefore changes the hash.
+ *
+ *  Inputs are hashed by value, which requires knowing their types. The types
+ *  used by the GhostFragment modules are known (bool, integers, double,
+ *  std::string, std::vector<double>, and nuclei); an input of any other type
+ *  makes @p mod unhashable.
+ *
+ *  @param[in,out] h The hasher to add @p mod to.
+ *  @param[in] mod The module to hash.
+ *
+ *  @return True if every input of @p mod and its submodules was hashed and
+ *          false otherwise. If false, the state of @p h is unspecified and it
+ *          must not be used as a cache key.
+ *
+ *  @throw std::bad_alloc if recording the key material fails. Weak throw
+ *                        guarantee.
+ */
+bool hash_module(Hasher& h, const pluginplay::Module& mod);
+
+} // namespace ghostfragment::caching
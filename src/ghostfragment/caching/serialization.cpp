@@ -0,0 +1,154 @@
+/*
+ * Copyright 2024 GhostFragment
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "serialization.hpp"
+
+namespace ghostfragment::caching {
+namespace {
+
+using size_type    = std::uint64_t;
+using nucleus_type = typename nuclei_type::value_type;
+using cap_type     = typename fragments_type::cap_set_type::value_type;
+
+// Writes a list of indices as its length followed by the indices
+template<typename IndexSetType>
+void write_indices(BinaryWriter& w, const IndexSetType& indices) {
+    w.write(size_type(indices.size()));
+    for(const auto i : indices) w.write(size_type(i));
+}
+
+// Reads a nucleus index, checking that it is less than n
+std::size_t read_index(BinaryReader& r, std::size_t n) {
+    const auto index = r.read<size_type>();
+    if(index < n) return index;
+    throw std::runtime_error("Cache entry refers to nucleus " +
+                             std::to_string(index) + ", but there are only " +
+                             std::to_string(n));
+}
+
+// Reads a list of indices written by write_indices, checking each is < n
+std::vector<std::size_t> read_indices(BinaryReader& r, std::size_t n) {
+    const auto n_indices = r.read<size_type>();
+    std::vector<std::size_t> indices;
+    for(size_type i = 0; i < n_indices; ++i)
+        indices.push_back(read_index(r, n));
+    return indices;
+}
+
+// Reads the index sets of fragments/nodes and adds them to frags
+void read_fragments(BinaryReader& r, fragments_type& frags) {
+    const auto n_atoms = frags.supersystem().size();
+    const auto n_frags = r.read<size_type>();
+    for(size_type i = 0; i < n_frags; ++i) {
+        const auto indices = read_indices(r, n_atoms);
+        frags.insert(indices.begin(), indices.end());
+    }
+}
+
+} // namespace
+
+void serialize(BinaryWriter& w, const connectivity_type& conns) {
+    w.write(size_type(conns.natoms()));
+    const auto bonds = conns.bonds();
+    w.write(size_type(bonds.size()));
+    for(const auto& bond : bonds) {
+        w.write(size_type(bond[0]));
+        w.write(size_type(bond[1]));
+    }
+}
+
+connectivity_type deserialize_connectivity(BinaryReader& r) {
+    const auto n_atoms = r.read<size_type>();
+    const auto n_bonds = r.read<size_type>();
+    connectivity_type conns(n_atoms);
+    for(size_type i = 0; i < n_bonds; ++i) {
+        const auto atom_i = r.read<size_type>();
+        const auto atom_j = r.read<size_type>();
+        conns.add_bond(atom_i, atom_j);
+    }
+    return conns;
+}
+
+void serialize(BinaryWriter& w, const fragments_type& frags) {
+    w.write(size_type(frags.size()));
+    for(std::size_t i = 0; i < frags.size(); ++i)
+        write_indices(w, frags.nuclear_indices(i));
+
+    const auto& caps = frags.cap_set();
+    w.write(size_type(caps.size()));
+    for(const auto& cap : caps) {
+        if(cap.size() != 1)
+            throw std::runtime_error("Only single-nucleus caps can be cached");
+        w.write(size_type(cap.get_anchor_index()));
+        w.write(size_type(cap.get_replaced_index()));
+        const auto nucleus = cap.at(0);
+        w.write(std::string(nucleus.name()));
+        w.write(size_type(nucleus.Z()));
+        w.write(double(nucleus.mass()));
+        w.write(double(nucleus.x()));
+        w.write(double(nucleus.y()));
+        w.write(double(nucleus.z()));
+    }
+}
+
+fragments_type deserialize_fragments(BinaryReader& r, nuclei_type supersystem) {
+    fragments_type frags(std::move(supersystem));
+    read_fragments(r, frags);
+
+    const auto n_atoms = frags.supersystem().size();
+    const auto n_caps  = r.read<size_type>();
+    for(size_type i = 0; i < n_caps; ++i) {
+        const auto anchor   = read_index(r, n_atoms);
+        const auto replaced = read_index(r, n_atoms);
+        const auto name     = r.read_string();
+        const auto Z        = r.read<size_type>();
+        const auto mass     = r.read<double>();
+        const auto x        = r.read<double>();
+        const auto y        = r.read<double>();
+        const auto z        = r.read<double>();
+        nucleus_type nucleus(name, Z, mass, x, y, z);
+        frags.add_cap(cap_type(anchor, replaced, nucleus));
+    }
+    return frags;
+}
+
+void serialize(BinaryWriter& w, const NuclearGraph& graph) {
+    w.write(size_type(graph.nodes_size()));
+    for(std::size_t i = 0; i < graph.nodes_size(); ++i)
+        write_indices(w, graph.node_indices(i));
+    serialize(w, graph.edges());
+}
+
+NuclearGraph deserialize_graph(BinaryReader& r, nuclei_type supersystem) {
+    fragments_type nodes(std::move(supersystem));
+    read_fragments(r, nodes);
+    auto edges = deserialize_connectivity(r);
+    return NuclearGraph(std::move(nodes), std::move(edges));
+}
+
+void serialize(BinaryWriter& w, const weights_type& weights) {
+    w.write(size_type(weights.size()));
+    for(const auto c_i : weights) w.write(c_i);
+}
+
+weights_type deserialize_weights(BinaryReader& r) {
+    const auto n = r.read<size_type>();
+    weights_type weights;
+    for(size_type i = 0; i < n; ++i) weights.push_back(r.read<double>());
+    return weights;
+}
+
+} // namespace ghostfragment::caching
@@ -0,0 +1,163 @@
+/*
+ * Copyright 2024 GhostFragment
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include <chemist/fragmenting/fragmented_nuclei.hpp>
+#include <chemist/topology/connectivity_table.hpp>
+#include <cstdint>
+#include <cstring>
+#include <ghostfragment/nuclear_graph.hpp>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace ghostfragment::caching {
+
+/// Appends values to a binary buffer in the machine's native byte order
+class BinaryWriter {
+public:
+    /// Type of the buffer
+    using buffer_type = std::vector<char>;
+
+    /// Appends the bytes of a trivially copyable value
+    template<typename T>
+    void write(const T& value) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        const auto* p = reinterpret_cast<const char*>(&value);
+        m_buffer_.insert(m_buffer_.end(), p, p + sizeof(T));
+    }
+
+    /// Appends the length and then the characters of @p value
+    void write(const std::string& value) {
+        write(std::uint64_t(value.size()));
+        m_buffer_.insert(m_buffer_.end(), value.begin(), value.end());
+    }
+
+    /// The bytes written so far
+    const buffer_type& buffer() const noexcept { return m_buffer_; }
+
+private:
+    /// The bytes written so far
+    buffer_type m_buffer_;
+};
+
+/// Reads values written by a BinaryWriter back out of a buffer
+class BinaryReader {
+public:
+    /// Type of the buffer
+    using buffer_type = BinaryWriter::buffer_type;
+
+    /// Reads from @p buffer, which must outlive the reader
+    explicit BinaryReader(const buffer_type& buffer) noexcept :
+      m_data_(buffer.data()), m_size_(buffer.size()) {}
+
+    /** @brief Reads the next value as a @p T.
+     *
+     *  @throw std::runtime_error if fewer than sizeof(T) bytes remain. Strong
+     *                            throw guarantee.
+     */
+    template<typename T>
+    T read() {
+        static_assert(std::is_trivially_copyable_v<T>);
+        assert_available_(sizeof(T));
+        T value;
+        std::memcpy(&value, m_data_ + m_offset_, sizeof(T));
+        m_offset_ += sizeof(T);
+        return value;
+    }
+
+    /// Reads a string written by BinaryWriter::write(const std::string&)
+    std::string read_string() {
+        const auto n = read<std::uint64_t>();
+        assert_available_(n);
+        std::string value(m_data_ + m_offset_, n);
+        m_offset_ += n;
+        return value;
+    }
+
+    /// Have all of the bytes been read?
+    bool done() const noexcept { return m_offset_ == m_size_; }
+
+private:
+    /// Throws if there are not @p n more bytes to read
+    void assert_available_(std::size_t n) const {
+        if(n <= m_size_ - m_offset_) return;
+        throw std::runtime_error("Cache entry is truncated");
+    }
+
+    /// The buffer being read
+    const char* m_data_;
+
+    /// The size of the buffer
+    std::size_t m_size_;
+
+    /// How many bytes have been read so far
+    std::size_t m_offset_ = 0;
+};
+
+/// Type of the atomic connectivity
+using connectivity_type = chemist::topology::ConnectivityTable;
+
+/// Type of the fragments
+using fragments_type = chemist::fragmenting::FragmentedNuclei<chemist::Nuclei>;
+
+/// Type of the supersystem of the fragments
+using nuclei_type = chemist::Nuclei;
+
+/// Type of the fragment weights
+using weights_type = std::vector<double>;
+
+/// Writes the number of atoms and the bonds of @p conns
+void serialize(BinaryWriter& w, const connectivity_type& conns);
+
+/// Reads a connectivity table written by serialize
+connectivity_type deserialize_connectivity(BinaryReader& r);
+
+/** @brief Writes the fragments and caps of @p frags.
+ *
+ *  The supersystem is NOT written. It is part of the key of the cache entry,
+ *  and is thus available when the entry is read.
+ *
+ *  @throw std::runtime_error if a cap has more than one nucleus. Strong
+ *                            throw guarantee.
+ */
+void serialize(BinaryWriter& w, const fragments_type& frags);
+
+/** @brief Reads fragments written by serialize.
+ *
+ *  @param[in] r The reader to read from.
+ *  @param[in] supersystem The supersystem of the fragments.
+ *
+ *  @throw std::runtime_error if the entry refers to nuclei not in
+ *                            @p supersystem or is truncated. Strong throw
+ *                            guarantee.
+ */
+fragments_type deserialize_fragments(BinaryReader& r, nuclei_type supersystem);
+
+/// Writes the nodes (not the supersystem) and edges of @p graph
+void serialize(BinaryWriter& w, const NuclearGraph& graph);
+
+/// Reads a graph written by serialize (see deserialize_fragments)
+NuclearGraph deserialize_graph(BinaryReader& r, nuclei_type supersystem);
+
+/// Writes the fragment weights
+void serialize(BinaryWriter& w, const weights_type& weights);
+
+/// Reads fragment weights written by serialize
+weights_type deserialize_weights(BinaryReader& r);
+
+} // namespace ghostfragment::caching
@@ -0,0 +1,70 @@
+/*
+ * Copyright 2024 GhostFragment
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <ghostfragment/cap_index.hpp>
+
+namespace ghostfragment {
+
+CapIndex::CapIndex(const cap_set_type& caps) : m_offsets_(1, 0) {
+    const size_type n_caps = caps.size();
+
+    // Step 1. Count the caps on each anchor
+    for(size_type c = 0; c < n_caps; ++c) {
+        const size_type anchor = caps[c].get_anchor_index();
+        if(anchor + 2 > m_offsets_.size()) m_offsets_.resize(anchor + 2, 0);
+        ++m_offsets_[anchor + 1];
+    }
+    for(size_type a = 1; a < m_offsets_.size(); ++a)
+        m_offsets_[a] += m_offsets_[a - 1];
+
+    // Step 2. Scatter the caps (keeps them in cap set order per anchor)
+    m_caps_.resize(n_caps);
+    m_replaced_.resize(n_caps);
+    index_list_type fill(m_offsets_.begin(), m_offsets_.end() - 1);
+    for(size_type c = 0; c < n_caps; ++c) {
+        const size_type k = fill[caps[c].get_anchor_index()]++;
+        m_caps_[k]        = c;
+        m_replaced_[k]    = caps[c].get_replaced_index();
+    }
+}
+
+typename CapIndex::index_list_type CapIndex::anchored_on(size_type atom) const {
+    if(atom + 1 >= m_offsets_.size()) return index_list_type{};
+    auto begin = m_caps_.begin();
+    return index_list_type(begin + m_offsets_[atom],
+                           begin + m_offsets_[atom + 1]);
+}
+
+typename CapIndex::index_list_type CapIndex::caps(
+  const nucleus_index_set& frag) const {
+    const bool is_sorted = std::is_sorted(frag.begin(), frag.end());
+    auto in_frag         = [&](size_type atom) {
+        if(is_sorted) return std::binary_search(frag.begin(), frag.end(), atom);
+        return std::find(frag.begin(), frag.end(), atom) != frag.end();
+    };
+
+    index_list_type rv;
+    for(const size_type anchor : frag) {
+        if(anchor + 1 >= m_offsets_.size()) continue;
+        for(auto k = m_offsets_[anchor]; k < m_offsets_[anchor + 1]; ++k)
+            if(!in_frag(m_replaced_[k])) rv.push_back(m_caps_[k]);
+    }
+    std::sort(rv.begin(), rv.end());
+    return rv;
+}
+
+} // namespace ghostfragment
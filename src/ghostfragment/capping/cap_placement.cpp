@@ -0,0 +1,106 @@
+/*
+ * Copyright 2024 GhostFragment
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "cap_placement.hpp"
+#include <cmath>
+#include <stdexcept>
+
+namespace ghostfragment::capping {
+
+void CapBatch::compute_ratios(CapRule rule, atomic_number_type cap_Z,
+                              const topology::BondLengthTable* bond_lengths) {
+    const auto n      = size();
+    const auto& sigma = m_snapshot_->radius();
+    const auto& Z     = m_snapshot_->Z();
+    auto* t           = m_ratio_.data();
+
+    switch(rule) {
+        case CapRule::at_atom: {
+            for(size_type i = 0; i < n; ++i) t[i] = 1.0;
+            break;
+        }
+        case CapRule::covalent_ratio: {
+            const auto sigma_c = topology::covalent_radius(cap_Z);
+            for(size_type i = 0; i < n; ++i) {
+                const auto sigma_a = sigma[m_anchor_[i]];
+                const auto sigma_b = sigma[m_replaced_[i]];
+                t[i]               = (sigma_a + sigma_c) / (sigma_a + sigma_b);
+            }
+            break;
+        }
+        case CapRule::average_length: {
+            if(bond_lengths == nullptr)
+                throw std::runtime_error("Placing caps at the average bond "
+                                         "length requires a BondLengthTable");
+            const auto& x = m_snapshot_->x();
+            const auto& y = m_snapshot_->y();
+            const auto& z = m_snapshot_->z();
+            for(size_type i = 0; i < n; ++i) {
+                const auto a  = m_anchor_[i];
+                const auto b  = m_replaced_[i];
+                const auto r0 = bond_lengths->average(Z[a], cap_Z);
+                if(!m_cell_) {
+                    t[i] = r0 / m_snapshot_->distance(a, b);
+                    continue;
+                }
+                auto dx = x[b] - x[a];
+                auto dy = y[b] - y[a];
+                auto dz = z[b] - z[a];
+                m_cell_->minimum_image(dx, dy, dz);
+                t[i] = r0 / std::sqrt(dx * dx + dy * dy + dz * dz);
+            }
+            break;
+        }
+    }
+}
+
+void CapBatch::place() noexcept {
+    const auto n  = size();
+    const auto* x = m_snapshot_->x().data();
+    const auto* y = m_snapshot_->y().data();
+    const auto* z = m_snapshot_->z().data();
+    const auto* a = m_anchor_.data();
+    const auto* b = m_replaced_.data();
+    const auto* t = m_ratio_.data();
+    auto* cap_x   = m_x_.data();
+    auto* cap_y   = m_y_.data();
+    auto* cap_z   = m_z_.data();
+
+    if(m_cell_) {
+        // B may be across a face of the cell, so step from A along the
+        // minimum image of A->B instead
+        for(size_type i = 0; i < n; ++i) {
+            auto dx = x[b[i]] - x[a[i]];
+            auto dy = y[b[i]] - y[a[i]];
+            auto dz = z[b[i]] - z[a[i]];
+            m_cell_->minimum_image(dx, dy, dz);
+            cap_x[i] = x[a[i]] + t[i] * dx;
+            cap_y[i] = y[a[i]] + t[i] * dy;
+            cap_z[i] = z[a[i]] + t[i] * dz;
+        }
+        return;
+    }
+
+    // N.B. (1 - t) * r_A + t * r_B puts the cap exactly on B when t == 1
+    for(size_type i = 0; i < n; ++i) {
+        const auto s = 1.0 - t[i];
+        cap_x[i]     = s * x[a[i]] + t[i] * x[b[i]];
+        cap_y[i]     = s * y[a[i]] + t[i] * y[b[i]];
+        cap_z[i]     = s * z[a[i]] + t[i] * z[b[i]];
+    }
+}
+
+} // namespace ghostfragment::capping
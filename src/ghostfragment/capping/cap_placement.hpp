@@ -0,0 +1,232 @@
+/*
+ * Copyright 2024 GhostFragment
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include "../topology/bond_length_table.hpp"
+#include "../topology/unit_cell.hpp"
+#include <ghostfragment/cap_index.hpp>
+#include <optional>
+#include <vector>
+
+namespace ghostfragment::capping {
+
+/// The rules for placing a cap along the broken bond A-B it replaces
+enum class CapRule {
+    /// The cap sits on top of atom B
+    at_atom,
+    /// A-cap is to A-B as the typical A-cap bond is to the typical A-B bond
+    covalent_ratio,
+    /// A-cap is the average A-cap bond length in the supersystem
+    average_length
+};
+
+/** @brief Computes the positions of the caps for a batch of broken bonds.
+ *
+ *  All of the cappers in GhostFragment put the cap for broken bond A-B (A is
+ *  the anchor, i.e., in the fragment, and B is the atom being replaced) at
+ *
+ *  @f[
+ *     \mathbf{r}_{cap} = (1 - t)\mathbf{r}_A + t\mathbf{r}_B
+ *  @f]
+ *
+ *  and only differ in how they choose @f$t@f$ (the CapRule). CapBatch stores
+ *  the broken bonds, the ratios, and the resulting cap coordinates as
+ *  contiguous arrays so that each step is a single tight loop over all of the
+ *  broken bonds.
+ *
+ *  For a periodic system the bond A-B may cross a face of the unit cell, in
+ *  which case B's coordinates are those of the wrong image. Given the cell,
+ *  the batch instead uses @f$\mathbf{r}_{cap} = \mathbf{r}_A + t\mathbf{d}@f$,
+ *  where @f$\mathbf{d}@f$ is the minimum image of
+ *  @f$\mathbf{r}_B - \mathbf{r}_A@f$. Like the connectivity, this assumes
+ *  every bond is shorter than half the narrowest width of the cell.
+ *
+ *  Usage is:
+ *  1. Create the batch from the broken bonds,
+ *  2. Call compute_ratios() with the rule,
+ *  3. Call place() to compute the coordinates,
+ *  4. Call add_caps() to add the caps to the fragments (and index them).
+ */
+class CapBatch {
+public:
+    /// Type of the geometry the batch works with
+    using snapshot_type = topology::NucleiSnapshot;
+
+    /// Type used for offsets
+    using size_type = snapshot_type::size_type;
+
+    /// Type of an atomic number
+    using atomic_number_type = snapshot_type::atomic_number_type;
+
+    /// Type of the arrays of offsets
+    using index_array = std::vector<size_type>;
+
+    /// Type of the arrays of floating-point values
+    using coord_array = snapshot_type::coord_array;
+
+    /** @brief Creates a batch for the bonds in @p broken_bonds.
+     *
+     *  @tparam BondSetType A container of broken bonds. Each element must be
+     *                      a pair-like object whose first element is the
+     *                      anchor and whose second element is the replaced
+     *                      atom.
+     *
+     *  @param[in] snapshot The geometry of the supersystem. The batch holds a
+     *                      reference to it.
+     *  @param[in] broken_bonds The bonds to cap.
+     *
+     *  @throw std::bad_alloc if allocating the arrays fails. Strong throw
+     *                        guarantee.
+     */
+    template<typename BondSetType>
+    CapBatch(const snapshot_type& snapshot, const BondSetType& broken_bonds);
+
+    /** @brief Creates a batch for the bonds of a periodic system.
+     *
+     *  @tparam BondSetType See the non-periodic constructor.
+     *
+     *  @param[in] snapshot The nuclei in the unit cell. The batch holds a
+     *                      reference to it.
+     *  @param[in] broken_bonds The bonds to cap. A bond may join a nucleus to
+     *                          a periodic image of another.
+     *  @param[in] cell The unit cell. The batch holds a copy of it.
+     *
+     *  @throw std::bad_alloc if allocating the arrays fails. Strong throw
+     *                        guarantee.
+     */
+    template<typename BondSetType>
+    CapBatch(const snapshot_type& snapshot, const BondSetType& broken_bonds,
+             const topology::UnitCell& cell);
+
+    /// The number of caps in the batch
+    size_type size() const noexcept { return m_anchor_.size(); }
+
+    /// The anchor of each cap
+    const index_array& anchors() const noexcept { return m_anchor_; }
+
+    /// The atom each cap replaces
+    const index_array& replaced() const noexcept { return m_replaced_; }
+
+    /// Where along its broken bond each cap goes (set by compute_ratios)
+    const coord_array& ratios() const noexcept { return m_ratio_; }
+
+    /// The cap coordinates (set by place)
+    ///@{
+    const coord_array& x() const noexcept { return m_x_; }
+    const coord_array& y() const noexcept { return m_y_; }
+    const coord_array& z() const noexcept { return m_z_; }
+    ///@}
+
+    /** @brief Determines where along each broken bond the caps go.
+     *
+     *  @param[in] rule How to choose the position.
+     *  @param[in] cap_Z The atomic number of the cap. Not used by
+     *                   CapRule::at_atom.
+     *  @param[in] bond_lengths The average bond lengths of the supersystem.
+     *                          Only used (and required) by
+     *                          CapRule::average_length.
+     *
+     *  @throw std::runtime_error if @p rule is CapRule::average_length and
+     *                            @p bond_lengths is a nullptr. Strong throw
+     *                            guarantee.
+     */
+    void compute_ratios(
+      CapRule rule, atomic_number_type cap_Z = 1,
+      const topology::BondLengthTable* bond_lengths = nullptr);
+
+    /// Computes the cap coordinates from the ratios
+    void place() noexcept;
+
+    /** @brief Adds the caps to @p frags and indexes the result.
+     *
+     *  @tparam FragmentsType The type of the fragments. Expected to be a
+     *                        specialization of FragmentedNuclei.
+     *  @tparam NucleusType The type of the cap.
+     *
+     *  @param[in,out] frags The fragments to add the caps to.
+     *  @param[in] cap The nucleus to use as a template for the caps (only its
+     *                 coordinates are changed).
+     *
+     *  @return The CapIndex of the cap set of @p frags, including any caps it
+     *          had before this call.
+     */
+    template<typename FragmentsType, typename NucleusType>
+    CapIndex add_caps(FragmentsType& frags, const NucleusType& cap) const;
+
+private:
+    /// The geometry of the supersystem
+    const snapshot_type* m_snapshot_;
+
+    /// The anchor and replaced atoms
+    index_array m_anchor_;
+    index_array m_replaced_;
+
+    /// The unit cell, if the system is periodic
+    std::optional<topology::UnitCell> m_cell_;
+
+    /// The ratio for each cap
+    coord_array m_ratio_;
+
+    /// The cap coordinates
+    coord_array m_x_;
+    coord_array m_y_;
+    coord_array m_z_;
+};
+
+// -----------------------------------------------------------------------------
+// -- Inline implementations
+// -----------------------------------------------------------------------------
+
+template<typename BondSetType>
+CapBatch::CapBatch(const snapshot_type& snapshot,
+                   const BondSetType& broken_bonds) :
+  m_snapshot_(&snapshot) {
+    const auto n = broken_bonds.size();
+    m_anchor_.reserve(n);
+    m_replaced_.reserve(n);
+    for(const auto& [anchor, replaced] : broken_bonds) {
+        m_anchor_.push_back(anchor);
+        m_replaced_.push_back(replaced);
+    }
+    m_ratio_.resize(n, 1.0);
+    m_x_.resize(n);
+    m_y_.resize(n);
+    m_z_.resize(n);
+}
+
+template<typename BondSetType>
+CapBatch::CapBatch(const snapshot_type& snapshot,
+                   const BondSetType& broken_bonds,
+                   const topology::UnitCell& cell) :
+  CapBatch(snapshot, broken_bonds) {
+    m_cell_.emplace(cell);
+}
+
+template<typename FragmentsType, typename NucleusType>
+CapIndex CapBatch::add_caps(FragmentsType& frags,
+                           const NucleusType& cap) const {
+    using cap_type = typename FragmentsType::cap_set_type::value_type;
+    NucleusType new_cap(cap);
+    for(size_type i = 0; i < size(); ++i) {
+        new_cap.coord(0) = m_x_[i];
+        new_cap.coord(1) = m_y_[i];
+        new_cap.coord(2) = m_z_[i];
+        frags.add_cap(cap_type(m_anchor_[i], m_replaced_[i], new_cap));
+    }
+    return CapIndex(frags.cap_set());
+}
+
+} // namespace ghostfragment::capping
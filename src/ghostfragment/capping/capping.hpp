@@ -29,8 +29,6 @@ inline void load_modules(pluginplay::ModuleManager& mm) {
     mm.add_module<WeightedDistance>("Weighted Distance");
 }
 
-inline void set_defaults(pluginplay::ModuleManager& mm) {
-    mm.change_submod("DCLC Capping", "Connectivity", "Covalent Radius");
-}
+inline void set_defaults(pluginplay::ModuleManager&) {}
 
 } // namespace ghostfragment::capping
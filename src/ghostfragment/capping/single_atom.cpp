@@ -14,8 +14,12 @@
  * limitations under the License.
  */
 
+#include "cap_placement.hpp"
 #include "capping.hpp"
 #include <ghostfragment/property_types/fragmenting/capped_fragments.hpp>
+#include <optional>
+#include <tuple>
+#include <vector>
 
 using my_pt        = ghostfragment::pt::CappedFragments;
 using traits_type  = ghostfragment::pt::CappedFragmentsTraits;
@@ -34,11 +38,12 @@ This module closes off the valencies of the input fragments using single
 nuclei. More specifically for each bond A-B, such that atom A is in the
 fragment, and atom B is not, a nucleus (default is a hydrogen nucleus) will be
 added to the fragment. By default the added nucleus will be placed at the
-location of B.
+location of B. For a periodic system (i.e., if lattice vectors are given) it is
+placed at the image of B nearest to A.
 
-The inputs to this module are fragments and the . In general these inputs are
-non-disjoint, for this reason we choose to establish connectivity at an
-atomic level.
+The inputs to this module are the fragments and their broken bonds. The atomic
+connectivity, which the property type also provides, is not used since each
+cap only depends on the bond it replaces.
 
 #. Generate atomic connectivity
 #. Determine caps we need
@@ -54,25 +59,31 @@ MODULE_CTOR(SingleAtom) {
     add_input<nucleus_type>("capping nucleus")
       .set_description("nucleus to use as the cap")
       .set_default(nucleus_type{"H", 1ul, 1837.289, 0.0, 0.0, 0.0});
+    add_input<std::vector<double>>(topology::lattice_key)
+      .set_description(topology::lattice_desc)
+      .set_default(std::vector<double>{});
 }
 
 MODULE_RUN(SingleAtom) {
-    using cap_type = typename frags_type::cap_set_type::value_type;
-
-    auto&& [frags, broken_bonds] = my_pt::unwrap_inputs(inputs);
+    // Each cap only depends on its broken bond, so the connectivity is unused
+    const auto& ins          = my_pt::unwrap_inputs(inputs);
+    const auto& frags        = std::get<0>(ins);
+    const auto& broken_bonds = std::get<1>(ins);
     auto cap = inputs.at("capping nucleus").value<nucleus_type>();
+    const auto& lattice =
+      inputs.at(topology::lattice_key).value<std::vector<double>>();
 
-    for(const auto& [atom_i, atom_j] : broken_bonds) {
-        // Make the cap
-        nucleus_type new_cap(cap);
-        for(nucleus_type::size_type j = 0; j < 3; ++j)
-            new_cap.coord(j) = frags.supersystem()[atom_j].coord(j);
-
-        // Add the cap to the set of caps for this fragment
-        frags.add_cap(cap_type(atom_i, atom_j, new_cap));
-    }
+    // Put each cap on top of (the nearest image of) the atom it replaces
+    const topology::NucleiSnapshot snapshot(frags.supersystem());
+    const auto cell = topology::make_unit_cell(lattice);
+    auto batch = cell ? CapBatch(snapshot, broken_bonds, *cell) :
+                        CapBatch(snapshot, broken_bonds);
+    batch.compute_ratios(CapRule::at_atom);
+    batch.place();
+    auto capped    = frags; // The only copy; caps are appended to it
+    auto cap_index = batch.add_caps(capped, cap);
 
     auto rv = results();
-    return my_pt::wrap_results(rv, frags);
+    return my_pt::wrap_results(rv, std::move(capped), std::move(cap_index));
 }
 } // namespace ghostfragment::capping
@@ -14,9 +14,12 @@
  * limitations under the License.
  */
 
-#include "../topology/covalent_radius.hpp"
+#include "cap_placement.hpp"
 #include "capping.hpp"
 #include <ghostfragment/property_types/fragmenting/capped_fragments.hpp>
+#include <optional>
+#include <tuple>
+#include <vector>
 
 using my_pt        = ghostfragment::pt::CappedFragments;
 using traits_t     = ghostfragment::pt::CappedFragmentsTraits;
@@ -39,6 +42,12 @@ added to the fragment such that the location along the original bond is the
 ratio
 of a normal A-H bond to a normal A-B bond.
 
+If lattice vectors are given, a broken bond may cross a face of the unit cell
+and the hydrogen atom is placed along the minimum image of the bond.
+
+The typical bond lengths are estimated from covalent radii, so the atomic
+connectivity input is not used.
+
 
 
 )""";
@@ -50,39 +59,32 @@ MODULE_CTOR(WeightedDistance) {
     add_input<nucleus_type>("capping nucleus")
       .set_description("nucleus to use as the cap")
       .set_default(nucleus_type{"H", 1ul, 1837.289, 0.0, 0.0, 0.0});
+    add_input<std::vector<double>>(topology::lattice_key)
+      .set_description(topology::lattice_desc)
+      .set_default(std::vector<double>{});
 }
 
 MODULE_RUN(WeightedDistance) {
-    using cap_type = typename result_type::cap_set_type::value_type;
-
-    auto&& [frags, broken_bonds] = my_pt::unwrap_inputs(inputs);
+    // The typical bond lengths come from the covalent radii, not the bonds in
+    // the system, so the connectivity is unused
+    const auto& ins          = my_pt::unwrap_inputs(inputs);
+    const auto& frags        = std::get<0>(ins);
+    const auto& broken_bonds = std::get<1>(ins);
     auto cap = inputs.at("capping nucleus").value<nucleus_type>();
-
-    const auto& mol = frags.supersystem();
-
-    for(const auto& bonds : broken_bonds) {
-        // Gets the both atoms from the bond
-        const auto& atom_i = mol[bonds.first];
-        const auto& atom_j = mol[bonds.second];
-
-        // Finds the bond lengths of i-H and i-j
-        auto i_j_bond = topology::covalent_radius(atom_i.Z()) +
-                        topology::covalent_radius(atom_j.Z());
-        auto i_h_bond = topology::covalent_radius(atom_i.Z()) +
-                        topology::covalent_radius(cap.Z());
-
-        auto ratio = i_h_bond / i_j_bond;
-
-        nucleus_type new_cap(cap);
-
-        for(auto i = 0; i < 3; i++) {
-            new_cap.coord(i) =
-              (atom_i.coord(i) + ratio * (atom_j.coord(i) - atom_i.coord(i)));
-        }
-        frags.add_cap(cap_type(bonds.first, bonds.second, new_cap));
-    }
+    const auto& lattice =
+      inputs.at(topology::lattice_key).value<std::vector<double>>();
+
+    // Scale each broken bond by the ratio of the typical bond lengths
+    const topology::NucleiSnapshot snapshot(frags.supersystem());
+    const auto cell = topology::make_unit_cell(lattice);
+    auto batch = cell ? CapBatch(snapshot, broken_bonds, *cell) :
+                        CapBatch(snapshot, broken_bonds);
+    batch.compute_ratios(CapRule::covalent_ratio, cap.Z());
+    batch.place();
+    auto capped    = frags; // The only copy; caps are appended to it
+    auto cap_index = batch.add_caps(capped, cap);
 
     auto rv = results();
-    return my_pt::wrap_results(rv, frags);
+    return my_pt::wrap_results(rv, std::move(capped), std::move(cap_index));
 }
 } // namespace ghostfragment::capping
@@ -41,7 +41,8 @@ inline void set_defaults(pluginplay::ModuleManager& mm) {
     mm.change_submod("Fragment Driver", "N-mer builder", "All nmers");
 
     mm.change_submod("Fragment Driver", "Intersection finder", "intersections");
-    mm.change_submod("Fragment Driver", "Find broken bonds", "Broken bonds");
+    mm.change_submod("Fragment Driver", "Find broken bonds",
+                     "Broken Bonds By Fragment");
     mm.change_submod("Fragment Driver", "Cap broken bonds",
                      "Weighted distance");
 
@@ -51,6 +52,14 @@ inline void set_defaults(pluginplay::ModuleManager& mm) {
     mm.change_submod("Fragment Based Method", "Subsystem former",
                      "FragmentedChemicalSystem Driver");
     mm.change_submod("Fragment Based Method", "Weighter", "GMBE Weights");
+    mm.change_submod("Fragment Based Method", "Weighted subsystem former",
+                     "GMBE Subsystems");
+    mm.change_submod("Fragment Based Method", "Atomic connectivity",
+                     "Covalent Radius");
+    mm.change_submod("Fragment Based Method", "Find broken bonds",
+                     "Broken Bonds By Fragment");
+    mm.change_submod("Fragment Based Method", "Cap broken bonds",
+                     "Weighted distance");
 }
 
 } // namespace ghostfragment::drivers
@@ -14,24 +14,196 @@
  * limitations under the License.
  */
 
+#include "../topology/spatial_order.hpp"
+#include "../topology/unit_cell.hpp"
+#include "../utilities/allocation_tracker.hpp"
+#include "../utilities/binomial.hpp"
+#include "../utilities/memory_footprint.hpp"
 #include "drivers.hpp"
 #include <ghostfragment/property_types/fragmenting/capped_fragments.hpp>
 #include <ghostfragment/property_types/fragmenting/fragmented_nuclei.hpp>
 #include <ghostfragment/property_types/fragmenting/intersections.hpp>
 #include <ghostfragment/property_types/fragmenting/nuclear_graph_to_fragments.hpp>
+#include <ghostfragment/property_types/fragmenting/nuclear_graph_to_nmers.hpp>
 #include <ghostfragment/property_types/topology/broken_bonds.hpp>
+#include <ghostfragment/property_types/topology/broken_bonds_by_fragment.hpp>
 #include <ghostfragment/property_types/topology/connectivity_table.hpp>
 #include <ghostfragment/property_types/topology/nuclear_graph.hpp>
+#include <algorithm>
+#include <combinations.hpp>
+#include <limits>
+#include <optional>
+#include <set>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+#include <vector>
 namespace ghostfragment::drivers {
 
 using conn_pt          = pt::ConnectivityTable;
-using broken_bonds_pt  = pt::BrokenBonds;
+using broken_bonds_pt  = pt::BrokenBondsByFragment;
 using cap_pt           = pt::CappedFragments;
 using frags_pt         = pt::FragmentedNuclei;
 using intersections_pt = pt::Intersections;
 using graph_pt         = pt::NuclearGraph;
 using graph2frags_pt   = pt::NuclearGraphToFragments;
-using n_type           = unsigned short;
+using nmers_pt         = pt::NuclearGraphToNMers;
+using n_type           = typename pt::NuclearGraphToNMersTraits::n_type;
+using bond_type        = typename pt::BrokenBondsTraits::bond_type;
+using system_type      = typename pt::FragmentedNucleiTraits::system_type;
+using frags_type       = typename pt::FragmentedNucleiTraits::result_type;
+using order_type       = std::vector<std::size_t>;
+using lattice_type     = std::vector<double>;
+
+namespace {
+
+// Assembles the memory report for a stage of the driver
+std::string memory_msg(const std::string& stage, std::size_t nbytes,
+                       const utilities::StageMemoryMonitor& monitor) {
+    using utilities::format_bytes;
+    auto msg = stage + " holds " + format_bytes(nbytes);
+    if(utilities::AllocationTracker::is_enabled())
+        msg += " (peak memory " + format_bytes(monitor.peak_bytes()) + ")";
+    return msg + ".";
+}
+
+/* Runs @p submod as a PT, like run_as. If @p lattice is not empty and the
+ * submodule takes the lattice vectors, they are set to @p lattice for this
+ * call. Otherwise the submodule's own lattice vectors (if any) are used.
+ */
+template<typename PT, typename... Args>
+auto run_with_lattice(pluginplay::SubmoduleRequest& submod,
+                      const lattice_type& lattice, Args&&... args) {
+    if(lattice.empty()) return submod.run_as<PT>(std::forward<Args>(args)...);
+
+    auto& mod = submod.value();
+    auto ins  = PT::wrap_inputs(mod.inputs(), std::forward<Args>(args)...);
+    if(ins.count(topology::lattice_key))
+        ins.at(topology::lattice_key).change(lattice);
+    auto rv = PT::unwrap_results(mod.run(std::move(ins)));
+    if constexpr(std::tuple_size_v<decltype(rv)> == 1)
+        return std::get<0>(std::move(rv));
+    else
+        return rv;
+}
+
+// Copy of @p sys whose i-th atom is atom order[i] of @p sys
+template<typename SystemType>
+system_type renumber_system(const SystemType& sys, const order_type& order) {
+    using molecule_type = typename system_type::molecule_t;
+    using atom_type     = typename molecule_type::atom_type;
+
+    const auto mol = sys.molecule();
+    molecule_type renumbered;
+    for(const auto i : order) {
+        const auto nucleus = mol[i].as_nucleus();
+        renumbered.push_back(atom_type(nucleus.name(), nucleus.Z(),
+                                       nucleus.mass(), nucleus.x(),
+                                       nucleus.y(), nucleus.z()));
+    }
+    renumbered.set_charge(mol.charge());
+    renumbered.set_multiplicity(mol.multiplicity());
+    return system_type(std::move(renumbered));
+}
+
+// Maps fragments of the renumbered system back onto the original one
+template<typename NucleiType>
+frags_type restore_order(const frags_type& frags, const order_type& order,
+                         NucleiType supersystem) {
+    using cap_type     = typename frags_type::cap_set_type::value_type;
+    using nucleus_type = typename NucleiType::value_type;
+
+    frags_type rv(std::move(supersystem));
+    std::vector<std::size_t> indices;
+    for(std::size_t i = 0; i < frags.size(); ++i) {
+        indices.clear();
+        for(const auto j : frags.nuclear_indices(i))
+            indices.push_back(order[j]);
+        std::sort(indices.begin(), indices.end());
+        rv.insert(indices.begin(), indices.end());
+    }
+
+    for(const auto& cap : frags.cap_set()) {
+        if(cap.size() != 1)
+            throw std::runtime_error(
+              "Only single-nucleus caps can be renumbered");
+        const auto nucleus = cap.at(0);
+        nucleus_type new_cap(nucleus.name(), nucleus.Z(), nucleus.mass(),
+                             nucleus.x(), nucleus.y(), nucleus.z());
+        rv.add_cap(cap_type(order[cap.get_anchor_index()],
+                            order[cap.get_replaced_index()], new_cap));
+    }
+    return rv;
+}
+
+/* If the monomers are disjoint and @p nmers are all of the unions of n of them,
+ * returns @p nmers followed by the unions of 1 to n - 1 monomers, i.e., what
+ * the intersection finder would return. Otherwise returns std::nullopt.
+ */
+std::optional<frags_type> mbe_subsystems(const frags_type& monomers,
+                                         const frags_type& nmers,
+                                         std::size_t n) {
+    constexpr auto npos  = std::numeric_limits<std::size_t>::max();
+    const auto nmonomers = monomers.size();
+
+    // The monomer each nucleus is in
+    std::vector<std::size_t> owner(monomers.supersystem().size(), npos);
+    std::vector<std::vector<std::size_t>> monomer_nuclei(nmonomers);
+    for(std::size_t i = 0; i < nmonomers; ++i) {
+        for(const auto j : monomers.nuclear_indices(i)) {
+            if(owner[j] != npos) return std::nullopt;
+            owner[j] = i;
+            monomer_nuclei[i].push_back(j);
+        }
+        if(monomer_nuclei[i].empty()) return std::nullopt;
+    }
+
+    // Distinct unions of n monomers, so they are all there iff C(N, n) of them
+    if(nmers.size() != utilities::binomial(nmonomers, n)) return std::nullopt;
+    std::set<std::vector<std::size_t>> seen;
+    std::vector<std::size_t> members;
+    for(std::size_t i = 0; i < nmers.size(); ++i) {
+        members.clear();
+        std::size_t nnuclei = 0;
+        for(const auto j : nmers.nuclear_indices(i)) {
+            if(owner[j] == npos) return std::nullopt;
+            members.push_back(owner[j]);
+            ++nnuclei;
+        }
+        std::sort(members.begin(), members.end());
+        members.erase(std::unique(members.begin(), members.end()),
+                      members.end());
+
+        std::size_t union_size = 0;
+        for(const auto m : members) union_size += monomer_nuclei[m].size();
+        if(members.size() != n || union_size != nnuclei) return std::nullopt;
+        if(!seen.insert(members).second) return std::nullopt;
+    }
+
+    // If there are only n monomers the one n-mer has no intersections,
+    // otherwise every union of fewer monomers is one. The std::set puts them
+    // in the same order as the intersection finder.
+    std::set<std::vector<std::size_t>> intersections;
+    std::vector<std::size_t> monomer_ids(nmonomers);
+    for(std::size_t i = 0; i < nmonomers; ++i) monomer_ids[i] = i;
+    for(std::size_t k = 1; k < n && nmonomers > n; ++k) {
+        for(auto&& kmer : iter::combinations(monomer_ids, k)) {
+            std::vector<std::size_t> nuclei;
+            for(const auto m : kmer)
+                nuclei.insert(nuclei.end(), monomer_nuclei[m].begin(),
+                              monomer_nuclei[m].end());
+            std::sort(nuclei.begin(), nuclei.end());
+            intersections.insert(std::move(nuclei));
+        }
+    }
+
+    frags_type rv(nmers);
+    for(const auto& nuclei : intersections)
+        rv.insert(nuclei.begin(), nuclei.end());
+    return rv;
+}
+
+} // namespace
 
 const auto mod_desc = R"(
 Fragment Driver
@@ -41,11 +213,43 @@ This module is responsible for going from a chemist::ChemicalSystem object to
 a chemist::FragmentedNuclei object. Generally speaking this occurs by:
 
 #. Determining the connectivity of the ChemicalSystem
+#. Forming the molecular graph
 #. Fragmenting the resulting molecular graph
 #. Find intersections for the fragments
 #. Determine if bonds were broken
 #. Cap the broken bonds
 
+The atomic connectivity is computed once, in the first step, and is then
+passed to every later step which needs it. The broken bonds are found per
+fragment (by default with the Broken Bonds By Fragment module, whose cost is
+linear in the sizes of the fragments and the valences of their atoms). The
+distinct broken bonds are then passed to the capping module, which adds one cap
+per bond.
+
+If "deferred capping" is true the last two steps are skipped and the fragments
+are returned without caps. This is meant for callers (e.g., the Fragment Based
+Method) which only cap the subsystems they actually evaluate.
+
+If "spatial renumbering" is true, the atoms are first reordered along a Hilbert
+curve through the system, so that atoms which are close in space get nearby
+indices. The steps above are then run on the renumbered system, which improves
+the memory locality of every step when the input order is poorly localized
+(e.g., for PDB files). The resulting fragments and caps are mapped back onto
+the original atom order before they are returned. The fragments are the same as
+without renumbering, but they may be listed in a different order.
+
+If "disjoint fast path" is true (the default), step 4 is skipped when the
+monomers from the "Fragment builder" are disjoint and the fragments are all of
+the unions of n of them (e.g., unscreened n-mers of a Cluster or HeavyAtom
+partition). The intersections are then exactly the unions of fewer monomers,
+so they are formed directly instead of searched for. The result is the same as
+the one from the "Intersection finder". In this case the GMBE weights of the
+subsystems are known in closed form as well, see the GMBE Weights module.
+
+For periodic systems set "lattice vectors" on this module only. Unless it is
+empty, it is passed to every submodule which has a "lattice vectors" input
+(the default "Atomic connectivity", "N-mer builder", and "Cap broken bonds"
+modules do), replacing whatever value the submodule itself holds.
 )";
 
 MODULE_CTOR(Fragment) {
@@ -54,7 +258,19 @@ MODULE_CTOR(Fragment) {
 
     // Inputs/modules controlling
     add_input<n_type>("n").set_default(n_type(1));
-    add_submodule<graph2frags_pt>("N-mer builder");
+    add_input<bool>("deferred capping")
+      .set_description("Skip finding broken bonds and capping")
+      .set_default(false);
+    add_input<bool>("spatial renumbering")
+      .set_description("Reorder atoms along a space-filling curve first")
+      .set_default(false);
+    add_input<bool>("disjoint fast path")
+      .set_description("Form intersections of disjoint monomers directly")
+      .set_default(true);
+    add_input<lattice_type>(topology::lattice_key)
+      .set_description(topology::lattice_desc)
+      .set_default(lattice_type{});
+    add_submodule<nmers_pt>("N-mer builder");
     add_submodule<graph2frags_pt>("Fragment builder");
 
     add_submodule<conn_pt>("Atomic connectivity");
@@ -65,59 +281,133 @@ MODULE_CTOR(Fragment) {
 }
 
 MODULE_RUN(Fragment) {
-    auto n = inputs.at("n").value<n_type>();
+    auto n        = inputs.at("n").value<n_type>();
+    auto deferred = inputs.at("deferred capping").value<bool>();
+    auto renumber = inputs.at("spatial renumbering").value<bool>();
+    auto disjoint = inputs.at("disjoint fast path").value<bool>();
+    auto lattice  = inputs.at(topology::lattice_key).value<lattice_type>();
 
-    pluginplay::Module frags_mod;
+    const auto& [sys] = frags_pt::unwrap_inputs(inputs);
+    auto& runtime     = get_runtime();
+    auto& logger      = runtime.logger();
 
-    if(n == 1) {
-        frags_mod = submods.at("Fragment builder").value();
-    } else {
-        frags_mod = submods.at("N-mer builder").value().unlocked_copy();
-        frags_mod.change_input("n", n);
+    // Step 0: Optionally renumber the atoms, mol is the system actually used
+    using system_view = std::decay_t<decltype(sys)>;
+    using nuclei_type = typename frags_type::supersystem_type;
+    order_type order;
+    std::optional<system_type> renumbered;
+    std::optional<nuclei_type> original_nuclei;
+    if(renumber) {
+        const auto sys_mol = sys.molecule();
+        original_nuclei.emplace(sys_mol.nuclei().as_nuclei());
+
+        order = topology::hilbert_order(topology::NucleiSnapshot(sys_mol));
+        renumbered.emplace(renumber_system(sys, order));
+        logger.debug("Renumbered the atoms along a Hilbert curve.");
     }
+    const system_view mol = renumbered ? system_view(*renumbered) : sys;
 
-    const auto& [mol] = frags_pt::unwrap_inputs(inputs);
-    auto& runtime     = get_runtime();
+    auto wrap_fragments = [&](const frags_type& frags) {
+        auto rv = results();
+        if(!renumber) return frags_pt::wrap_results(rv, frags);
+        auto restored = restore_order(frags, order, *original_nuclei);
+        return frags_pt::wrap_results(rv, std::move(restored));
+    };
 
+    using utilities::fragments_footprint;
+    using utilities::StageMemoryMonitor;
+
+    std::optional<StageMemoryMonitor> monitor;
+    monitor.emplace();
     auto& conn_mod           = submods.at("Atomic connectivity");
-    const auto& atomic_conns = conn_mod.run_as<conn_pt>(mol.molecule());
+    const auto& atomic_conns =
+      run_with_lattice<conn_pt>(conn_mod, lattice, mol.molecule());
+    const auto conns_bytes   = atomic_conns.nbonds() * sizeof(bond_type);
+    logger.debug(memory_msg("Connectivity", conns_bytes, *monitor));
 
     // Step 1: Form the molecular graph
+    monitor.emplace();
     auto& graph_mod    = submods.at("Molecular Graph");
-    const auto& graph  = graph_mod.run_as<graph_pt>(mol);
+    const auto& graph  = graph_mod.run_as<graph_pt>(mol, atomic_conns);
     const auto n_nodes = graph.nodes_size();
     const auto n_edges = graph.edges_size();
-    runtime.logger().debug("Created a graph with " + std::to_string(n_nodes) +
-                           " nodes and " + std::to_string(n_edges) + " edges.");
+    logger.debug("Created a graph with " + std::to_string(n_nodes) +
+                 " nodes and " + std::to_string(n_edges) + " edges.");
+    const auto graph_bytes = utilities::graph_footprint(graph);
+    logger.debug(memory_msg("NuclearGraph", graph_bytes, *monitor));
 
     // Step 2: Use the graph to make fragments
-    const auto& frags_no_ints = frags_mod.run_as<graph2frags_pt>(graph);
-    const auto n_frags        = frags_no_ints.size();
-    runtime.logger().debug("Created " + std::to_string(n_frags) +
-                           " fragments.");
+    monitor.emplace();
+    // N.b. n is an input of the N-mer builder's property type, so the same
+    //      (memoized) N-mer builder is used for every n
+    auto& frag_mod = submods.at("Fragment builder");
+    auto& nmer_mod = submods.at("N-mer builder");
+    const auto& frags_no_ints =
+      n == 1 ? frag_mod.run_as<graph2frags_pt>(graph) :
+               run_with_lattice<nmers_pt>(nmer_mod, lattice, graph, n);
+    const auto n_frags = frags_no_ints.size();
+    logger.debug("Created " + std::to_string(n_frags) + " fragments.");
+    const auto frags_bytes = fragments_footprint(frags_no_ints);
+    logger.debug(memory_msg("Fragments", frags_bytes, *monitor));
 
     // Step 3: Analyze the fragments for intersections
-    auto& intersect_mod = submods.at("Intersection finder");
-    const auto& frags   = intersect_mod.run_as<intersections_pt>(frags_no_ints);
-    const auto n_ints   = frags.size() - n_frags;
-    runtime.logger().debug("Added " + std::to_string(n_ints) +
-                           " intersections.");
+    monitor.emplace();
+    std::optional<frags_type> frags_with_ints;
+    if(disjoint) {
+        frags_with_ints =
+          n == 1 ? mbe_subsystems(frags_no_ints, frags_no_ints, n) :
+                   mbe_subsystems(frag_mod.run_as<graph2frags_pt>(graph),
+                                  frags_no_ints, n);
+        if(frags_with_ints)
+            logger.debug("Formed the intersections of disjoint monomers.");
+    }
+    if(!frags_with_ints) {
+        auto& intersect_mod = submods.at("Intersection finder");
+        frags_with_ints.emplace(
+          intersect_mod.run_as<intersections_pt>(frags_no_ints));
+    }
+    const auto& frags = *frags_with_ints;
+    const auto n_ints = frags.size() - n_frags;
+    logger.debug("Added " + std::to_string(n_ints) + " intersections.");
+    const auto ints_bytes = fragments_footprint(frags);
+    logger.debug(memory_msg("Intersections", ints_bytes, *monitor));
+
+    if(deferred) {
+        logger.debug("Capping is deferred.");
+        monitor.reset();
+        return wrap_fragments(frags);
+    }
 
     // Step 4: Did forming fragments (or intersections) break bonds?
+    monitor.emplace();
     auto& bonds_mod = submods.at("Find broken bonds");
-    const auto& broken_bonds =
+    const auto& by_frag =
       bonds_mod.run_as<broken_bonds_pt>(frags, atomic_conns);
-    runtime.logger().debug("Found " + std::to_string(broken_bonds.size()) +
-                           " broken bonds.");
+    if(by_frag.size() != frags.size())
+        throw std::runtime_error("Broken bonds were found for " +
+                                 std::to_string(by_frag.size()) +
+                                 " fragments, but there are " +
+                                 std::to_string(frags.size()));
+    const auto broken_bonds = by_frag.unique_bonds();
+    logger.debug("Found " + std::to_string(broken_bonds.size()) +
+                 " broken bonds (" + std::to_string(by_frag.nbonds()) +
+                 " counting repeats).");
+    const auto bonds_bytes = by_frag.nbonds() * sizeof(bond_type) +
+                             by_frag.offsets().size() * sizeof(std::size_t);
+    logger.debug(memory_msg("Broken bonds", bonds_bytes, *monitor));
 
     // Step 5: Fix those broken bonds!!!!
-    auto& cap_mod            = submods.at("Cap broken bonds");
-    const auto& capped_frags = cap_mod.run_as<cap_pt>(frags, broken_bonds);
-    const auto n_caps        = capped_frags.cap_set().size();
-    runtime.logger().debug("Added " + std::to_string(n_caps) + " caps.");
+    monitor.emplace();
+    auto& cap_mod = submods.at("Cap broken bonds");
+    const auto& [capped_frags, cap_index] = run_with_lattice<cap_pt>(
+      cap_mod, lattice, frags, broken_bonds, atomic_conns);
+    const auto n_caps = cap_index.size();
+    logger.debug("Added " + std::to_string(n_caps) + " caps.");
+    const auto caps_bytes = fragments_footprint(capped_frags);
+    logger.debug(memory_msg("Capped fragments", caps_bytes, *monitor));
+    monitor.reset();
 
-    auto rv = results();
-    return frags_pt::wrap_results(rv, capped_frags);
+    return wrap_fragments(capped_frags);
 }
 
 } // namespace ghostfragment::drivers
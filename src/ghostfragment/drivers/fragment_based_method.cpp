@@ -14,11 +14,18 @@
  * limitations under the License.
  */
 
+#include "../utilities/allocation_tracker.hpp"
+#include "../utilities/memory_footprint.hpp"
 #include "drivers.hpp"
+#include <ghostfragment/cap_index.hpp>
+#include <ghostfragment/property_types/fragmenting/capped_fragments.hpp>
 #include <ghostfragment/property_types/fragmenting/fragment_weights.hpp>
 #include <ghostfragment/property_types/fragmenting/fragmented_chemical_system.hpp>
+#include <ghostfragment/property_types/fragmenting/weighted_subsystems.hpp>
+#include <ghostfragment/property_types/topology/broken_bonds_by_fragment.hpp>
+#include <ghostfragment/property_types/topology/connectivity_table.hpp>
+#include <optional>
 #include <simde/energy/ao_energy.hpp>
-#include <zip.hpp>
 namespace ghostfragment::drivers {
 
 using my_pt                = simde::TotalEnergy;
@@ -26,18 +33,75 @@ using ao_energy_pt         = simde::AOEnergy;
 using fragmenting_pt       = pt::FragmentedChemicalSystem;
 using fragmenting_traits   = pt::FragmentedChemicalSystemTraits;
 using chemical_system_type = typename fragmenting_traits::system_type;
+using frag_sys_type        = typename fragmenting_traits::result_type;
+using frag_mol_type        = typename frag_sys_type::fragmented_molecule_type;
+using frag_nuclei_type     = typename frag_mol_type::fragmented_nuclei_type;
+using size_type            = typename frag_nuclei_type::size_type;
 using basis_set_pt         = simde::MolecularBasisSet;
 using weight_pt            = pt::FragmentWeights;
+using weighted_subsys_pt   = pt::WeightedSubsystems;
 using egy_type             = simde::type::tensor;
+using conn_pt              = pt::ConnectivityTable;
+using broken_bonds_pt      = pt::BrokenBondsByFragment;
+using cap_pt               = pt::CappedFragments;
+using molecule_type        = typename chemical_system_type::molecule_type;
 
 namespace {
 const auto mod_desc = R"(
 Fragment-Based Method Driver
 ----------------------------
 
+If "weighted subsystems" is true, the fragments of the "Subsystem former" are
+given to the "Weighted subsystem former" (by default the GMBE Subsystems
+module) instead of the "Weighter". Its subsystems, which only include those
+with nonzero weights, and its weights are then used in place of the
+"Subsystem former"'s subsystems and the "Weighter"'s weights. Adding
+intersections to the fragments does not change the GMBE subsystems or their
+weights, so the "Subsystem former" may, but need not, find the intersections.
+
+If "deferred capping" is true, the subsystems are expected to come from the
+"Subsystem former" without caps (e.g., the Fragment Driver with its "deferred
+capping" input set to true). After the weights are computed, only the
+subsystems with nonzero weights are capped and evaluated. The broken-bond and
+capping work for the discarded subsystems is thus skipped. The broken bonds are
+found per survivor (by default with the Broken Bonds By Fragment module) and
+the distinct ones are capped.
+
+Either way, each subsystem is assembled (its nuclei, then its caps) with a
+CapIndex, which finds the caps of a subsystem by looking only at the caps
+anchored on its atoms, rather than by filtering the caps of all subsystems.
+With deferred capping the index is the one returned by the capping module,
+otherwise it is built once from the subsystems. Every subsystem gets the charge
+and multiplicity of the input system.
 )";
+
+// The k-th subsystem of frags, followed by its caps in cap set order (i.e.,
+// the nuclei FragmentedMolecule gives), with the charge and multiplicity of mol
+template<typename MoleculeType>
+molecule_type capped_subsystem(const frag_nuclei_type& frags, size_type k,
+                               const CapIndex& cap_index,
+                               const MoleculeType& mol) {
+    using atom_type = typename molecule_type::atom_type;
+    molecule_type mol_k;
+    auto add_atom = [&](const auto& nucleus) {
+        mol_k.push_back(atom_type(nucleus.name(), nucleus.Z(), nucleus.mass(),
+                                  nucleus.x(), nucleus.y(), nucleus.z()));
+    };
+
+    const auto& supersystem = frags.supersystem();
+    const auto& cap_set     = frags.cap_set();
+    for(const auto j : frags.nuclear_indices(k))
+        add_atom(supersystem[j].as_nucleus());
+    for(const auto c : cap_index.caps(frags, k))
+        for(size_type n = 0; n < cap_set[c].size(); ++n)
+            add_atom(cap_set[c].at(n));
+    mol_k.set_charge(mol.charge());
+    mol_k.set_multiplicity(mol.multiplicity());
+    return mol_k;
 }
 
+} // namespace
+
 MODULE_CTOR(FragmentBasedMethod) {
     description(mod_desc);
 
@@ -46,6 +110,19 @@ MODULE_CTOR(FragmentBasedMethod) {
     add_submodule<fragmenting_pt>("Subsystem former");
     add_submodule<weight_pt>("Weighter");
     add_submodule<my_pt>("Energy method");
+
+    add_input<bool>("weighted subsystems")
+      .set_description("Get the subsystems and their weights from the "
+                       "Weighted subsystem former")
+      .set_default(false);
+    add_submodule<weighted_subsys_pt>("Weighted subsystem former");
+
+    add_input<bool>("deferred capping")
+      .set_description("Only cap subsystems with nonzero weights")
+      .set_default(false);
+    add_submodule<conn_pt>("Atomic connectivity");
+    add_submodule<broken_bonds_pt>("Find broken bonds");
+    add_submodule<cap_pt>("Cap broken bonds");
 }
 
 MODULE_RUN(FragmentBasedMethod) {
@@ -55,28 +132,58 @@ MODULE_RUN(FragmentBasedMethod) {
     const auto& [sys] = my_pt::unwrap_inputs(inputs);
 
     // Step 1: Form subsystems
-    auto& subsystem_mod    = submods.at("Subsystem former");
-    const auto& subsystems = subsystem_mod.run_as<fragmenting_pt>(sys);
+    auto& subsystem_mod = submods.at("Subsystem former");
+    const auto& formed  = subsystem_mod.run_as<fragmenting_pt>(sys);
+
+    // Step 2: Determine weights (and, optionally, prune the subsystems)
+    utilities::StageMemoryMonitor monitor;
+    std::optional<frag_sys_type> weighted_subsystems;
+    std::vector<double> weights;
+    if(inputs.at("weighted subsystems").value<bool>()) {
+        const auto& frags = formed.fragmented_molecule().fragmented_nuclei();
+        auto& ws_mod      = submods.at("Weighted subsystem former");
+        const auto& [subsystems_ws, weights_ws] =
+          ws_mod.run_as<weighted_subsys_pt>(frags);
+        if(subsystems_ws.size() != weights_ws.size())
+            throw std::runtime_error(
+              "Got " + std::to_string(weights_ws.size()) + " weights for " +
+              std::to_string(subsystems_ws.size()) + " subsystems");
+        const auto& mol = sys.molecule();
+        weighted_subsystems.emplace(
+          frag_mol_type(subsystems_ws, mol.charge(), mol.multiplicity()));
+        weights = weights_ws;
+    } else {
+        auto& weight_mod = submods.at("weighter");
+        weights          = weight_mod.run_as<weight_pt>(formed);
+    }
+    const auto& subsystems =
+      weighted_subsystems ? *weighted_subsystems : formed;
+    if(weights.size() != subsystems.size())
+        throw std::runtime_error("Got " + std::to_string(weights.size()) +
+                                 " weights for " +
+                                 std::to_string(subsystems.size()) +
+                                 " subsystems");
 
-    // Step 2: Determine weights
-    auto& weight_mod    = submods.at("weighter");
-    const auto& weights = weight_mod.run_as<weight_pt>(subsystems);
+    using utilities::format_bytes;
+    const auto weight_bytes = utilities::vector_footprint(weights);
+    auto weight_msg = "Weights hold " + format_bytes(weight_bytes);
+    if(utilities::AllocationTracker::is_enabled())
+        weight_msg += " (peak memory " +
+                      format_bytes(monitor.peak_bytes()) + ")";
+    logger.debug(weight_msg + ".");
 
     auto& energy_mod = submods.at("Energy method");
 
     egy_type energy(0.0);
 
-    auto n_subsystems              = subsystems.size();
-    decltype(n_subsystems) counter = 0;
-    auto msg = [](auto counter, auto n_subsystems, auto egy) {
+    auto n_subsystems = subsystems.size();
+    auto msg          = [](auto counter, auto n_subsystems, auto egy) {
         std::stringstream ss;
         ss << egy;
         return "Energy of subsystem " + std::to_string(counter) + " of " +
                std::to_string(n_subsystems) + " : " + ss.str();
     };
-    for(auto&& [c_i, sys_i] : iter::zip(weights, subsystems)) {
-        auto mol_i = sys_i.molecule().as_molecule();
-
+    auto evaluate = [&](size_type i, double c_i, const auto& mol_i) {
         // This is a hack until views work with values
         chemical_system_type sys_i_copy(mol_i);
 
@@ -84,9 +191,66 @@ MODULE_RUN(FragmentBasedMethod) {
         simde::type::tensor temp;
         temp("")   = e_i("") * c_i;
         energy("") = energy("") + temp("");
-        logger.debug("Weight of subsystem " + std::to_string(counter) + " is " +
+        logger.debug("Weight of subsystem " + std::to_string(i) + " is " +
                      std::to_string(c_i) + ".");
-        logger.info(msg(counter++, n_subsystems, e_i));
+        logger.info(msg(i, n_subsystems, e_i));
+    };
+
+    if(!inputs.at("deferred capping").value<bool>()) {
+        const auto& frags =
+          subsystems.fragmented_molecule().fragmented_nuclei();
+        const CapIndex cap_index(frags);
+        for(size_type i = 0; i < frags.size(); ++i)
+            evaluate(i, weights[i],
+                     capped_subsystem(frags, i, cap_index, sys.molecule()));
+
+        auto rv = results();
+        return my_pt::wrap_results(rv, energy);
+    }
+
+    // Step 3 (deferred capping): Cap the subsystems which survived weighting
+    const auto& uncapped = subsystems.fragmented_molecule().fragmented_nuclei();
+    if(!uncapped.cap_set().empty())
+        throw std::runtime_error("Deferred capping requires uncapped "
+                                 "subsystems. Was the Subsystem former told "
+                                 "to defer capping?");
+
+    frag_nuclei_type survivors(uncapped.supersystem());
+    std::vector<size_type> survivor_offsets;
+    for(size_type i = 0; i < uncapped.size(); ++i) {
+        if(weights[i] == 0.0) continue;
+        const auto indices = uncapped.nuclear_indices(i);
+        survivors.insert(indices.begin(), indices.end());
+        survivor_offsets.push_back(i);
+    }
+    logger.debug("Capping " + std::to_string(survivor_offsets.size()) +
+                 " of " + std::to_string(n_subsystems) + " subsystems.");
+
+    auto& conn_mod      = submods.at("Atomic connectivity");
+    const auto& conns   = conn_mod.run_as<conn_pt>(sys.molecule());
+    auto& bonds_mod     = submods.at("Find broken bonds");
+    const auto& by_frag = bonds_mod.run_as<broken_bonds_pt>(survivors, conns);
+    if(by_frag.size() != survivors.size())
+        throw std::runtime_error("Broken bonds were found for " +
+                                 std::to_string(by_frag.size()) +
+                                 " subsystems, but " +
+                                 std::to_string(survivors.size()) +
+                                 " survived weighting");
+    const auto bonds = by_frag.unique_bonds();
+    auto& cap_mod    = submods.at("Cap broken bonds");
+    const auto& [capped, cap_index] =
+      cap_mod.run_as<cap_pt>(survivors, bonds, conns);
+    if(cap_index.size() != capped.cap_set().size())
+        throw std::runtime_error("The cap index has " +
+                                 std::to_string(cap_index.size()) +
+                                 " caps, but there are " +
+                                 std::to_string(capped.cap_set().size()));
+
+    // Step 4 (deferred capping): Evaluate the survivors
+    for(size_type k = 0; k < survivor_offsets.size(); ++k) {
+        const auto i = survivor_offsets[k];
+        evaluate(i, weights[i],
+                 capped_subsystem(capped, k, cap_index, sys.molecule()));
     }
 
     auto rv = results();
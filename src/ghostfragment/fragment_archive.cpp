@@ -0,0 +1,539 @@
+/*
+ * Copyright 2024 GhostFragment
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "utilities/mapped_file.hpp"
+#include <algorithm>
+#include <array>
+#include <fstream>
+#include <ghostfragment/fragment_archive.hpp>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+
+namespace ghostfragment {
+
+using size_type    = FragmentArchive::size_type;
+using index_view   = FragmentArchive::const_index_view;
+using double_view  = FragmentArchive::const_double_view;
+using char_view    = FragmentArchive::const_array_view<char>;
+using nuclei_type  = FragmentArchive::nuclei_type;
+using nucleus_type = typename nuclei_type::value_type;
+using cap_type = typename FragmentArchive::fragmented_nuclei::cap_set_type::
+  value_type;
+
+namespace {
+
+using magic_type = std::array<char, 8>;
+
+constexpr magic_type magic{'G', 'F', 'A', 'R', 'C', 'H', 'V', '\0'};
+
+// Reads back as a different value if the byte order differs
+constexpr std::uint32_t byte_order_tag = 0x01020304;
+
+// Layout of the header at the start of every archive
+struct Header {
+    magic_type magic;
+    std::uint32_t version;
+    std::uint32_t byte_order;
+    size_type natoms;
+    size_type atom_name_bytes;
+    size_type nfrags;
+    size_type nmembers;
+    size_type ncaps;
+    size_type cap_name_bytes;
+    size_type nnodes;
+    size_type nnode_members;
+    size_type nedges;
+};
+
+// Rounds n up to a multiple of 8
+constexpr size_type pad8(size_type n) noexcept { return (n + 7) / 8 * 8; }
+
+// The nuclei (of the supersystem or the caps) as flat arrays
+struct NucleiTable {
+    std::vector<size_type> Z;
+    std::vector<double> mass;
+    std::vector<double> x;
+    std::vector<double> y;
+    std::vector<double> z;
+    std::vector<size_type> name_offsets{0};
+    std::string names;
+
+    template<typename NucleusType>
+    void push_back(const NucleusType& nucleus) {
+        Z.push_back(nucleus.Z());
+        mass.push_back(nucleus.mass());
+        x.push_back(nucleus.x());
+        y.push_back(nucleus.y());
+        z.push_back(nucleus.z());
+        names += nucleus.name();
+        name_offsets.push_back(names.size());
+    }
+};
+
+// Index sets stored in CSR layout
+struct IndexCSR {
+    std::vector<size_type> offsets{0};
+    std::vector<size_type> members;
+
+    template<typename IndexSetType>
+    void push_back(const IndexSetType& indices) {
+        for(const auto i : indices) members.push_back(i);
+        offsets.push_back(members.size());
+    }
+};
+
+// A name next to @p path which no other writer will pick
+FragmentArchive::path_type temporary_path(
+  const FragmentArchive::path_type& path) {
+    std::random_device rd;
+    auto tmp_path = path;
+    tmp_path += ".tmp" + std::to_string(rd()) + std::to_string(rd());
+    return tmp_path;
+}
+
+/* Writes arrays to a file, padding each to a multiple of 8 bytes. The arrays
+ * go to a temporary file which close() renames to the archive's path, so the
+ * archive is replaced in one step. Jobs which have the old archive mapped keep
+ * their (complete) copy, and a failed write leaves the old archive in place.
+ */
+class ArchiveWriter {
+public:
+    explicit ArchiveWriter(const FragmentArchive::path_type& path) :
+      m_path_(path),
+      m_tmp_path_(temporary_path(path)),
+      m_file_(m_tmp_path_, std::ios::binary | std::ios::trunc) {}
+
+    ArchiveWriter(const ArchiveWriter&)            = delete;
+    ArchiveWriter& operator=(const ArchiveWriter&) = delete;
+
+    // Removes the temporary file if close() did not rename it
+    ~ArchiveWriter() noexcept {
+        if(m_renamed_) return;
+        m_file_.close();
+        std::error_code error;
+        std::filesystem::remove(m_tmp_path_, error);
+    }
+
+    template<typename T>
+    void write(const T* data, size_type n) {
+        constexpr char zeros[8] = {};
+        const auto nbytes       = n * sizeof(T);
+        m_file_.write(reinterpret_cast<const char*>(data), nbytes);
+        m_file_.write(zeros, pad8(nbytes) - nbytes);
+    }
+
+    template<typename T>
+    void write(const std::vector<T>& values) {
+        write(values.data(), values.size());
+    }
+
+    void write(const NucleiTable& table) {
+        write(table.Z);
+        write(table.mass);
+        write(table.x);
+        write(table.y);
+        write(table.z);
+        write(table.name_offsets);
+        write(table.names.data(), table.names.size());
+    }
+
+    void write(const IndexCSR& csr) {
+        write(csr.offsets);
+        write(csr.members);
+    }
+
+    void close() {
+        m_file_.close();
+        if(!m_file_)
+            throw std::runtime_error("Could not write fragment archive " +
+                                     m_tmp_path_.string());
+
+        std::error_code error;
+        std::filesystem::rename(m_tmp_path_, m_path_, error);
+        if(error)
+            throw std::runtime_error("Could not write fragment archive " +
+                                     m_path_.string() + ": " +
+                                     error.message());
+        m_renamed_ = true;
+    }
+
+private:
+    FragmentArchive::path_type m_path_;
+    FragmentArchive::path_type m_tmp_path_;
+    std::ofstream m_file_;
+    bool m_renamed_ = false;
+};
+
+void write_archive(const FragmentArchive::path_type& path,
+                   const FragmentArchive::fragmented_nuclei& frags,
+                   const FragmentArchive::weight_container& weights,
+                   const NuclearGraph* graph) {
+    if(weights.size() != frags.size())
+        throw std::runtime_error("Have " + std::to_string(frags.size()) +
+                                 " fragments, but " +
+                                 std::to_string(weights.size()) + " weights");
+
+    NucleiTable atoms;
+    for(const auto& nucleus : frags.supersystem()) atoms.push_back(nucleus);
+
+    IndexCSR fragments;
+    for(std::size_t i = 0; i < frags.size(); ++i)
+        fragments.push_back(frags.nuclear_indices(i));
+
+    std::vector<size_type> anchors, replaced;
+    NucleiTable cap_nuclei;
+    for(const auto& cap : frags.cap_set()) {
+        if(cap.size() != 1)
+            throw std::runtime_error(
+              "Only single-nucleus caps can be archived");
+        anchors.push_back(cap.get_anchor_index());
+        replaced.push_back(cap.get_replaced_index());
+        cap_nuclei.push_back(cap.at(0));
+    }
+
+    IndexCSR nodes;
+    std::vector<size_type> edges;
+    if(graph != nullptr && graph->nodes_size() > 0) {
+        if(graph->nuclei() != frags.supersystem())
+            throw std::runtime_error("The graph and the fragments have "
+                                     "different supersystems");
+        for(std::size_t i = 0; i < graph->nodes_size(); ++i)
+            nodes.push_back(graph->node_indices(i));
+        for(const auto& edge : graph->edges().bonds()) {
+            edges.push_back(edge[0]);
+            edges.push_back(edge[1]);
+        }
+    }
+
+    Header header{magic,
+                  FragmentArchive::format_version,
+                  byte_order_tag,
+                  atoms.Z.size(),
+                  atoms.names.size(),
+                  frags.size(),
+                  fragments.members.size(),
+                  anchors.size(),
+                  cap_nuclei.names.size(),
+                  nodes.offsets.size() - 1,
+                  nodes.members.size(),
+                  edges.size() / 2};
+
+    ArchiveWriter w(path);
+    w.write(&header, 1);
+    w.write(atoms);
+    w.write(fragments);
+    w.write(anchors);
+    w.write(replaced);
+    w.write(cap_nuclei);
+    w.write(weights);
+    w.write(nodes);
+    w.write(edges);
+    w.close();
+}
+
+// Hands out consecutive, 8-byte aligned arrays of the mapped file
+class SectionReader {
+public:
+    SectionReader(const char* data, size_type nbytes) noexcept :
+      m_data_(data), m_nbytes_(nbytes) {}
+
+    template<typename T>
+    FragmentArchive::const_array_view<T> next(size_type n) {
+        if(n > (m_nbytes_ - m_offset_) / sizeof(T))
+            throw std::runtime_error("the file is truncated");
+        const auto* p = reinterpret_cast<const T*>(m_data_ + m_offset_);
+        m_offset_ += std::min(pad8(n * sizeof(T)), m_nbytes_ - m_offset_);
+        return {p, n};
+    }
+
+    bool done() const noexcept { return m_offset_ == m_nbytes_; }
+
+private:
+    const char* m_data_;
+    size_type m_nbytes_;
+    size_type m_offset_ = 0;
+};
+
+// Throws unless offsets is a valid CSR offset array for nmembers members
+void check_offsets(const index_view& offsets, size_type nmembers) {
+    if(offsets.empty() || offsets[0] != 0 ||
+       offsets[offsets.size() - 1] != nmembers)
+        throw std::runtime_error("CSR offsets do not span the members");
+    for(size_type i = 1; i < offsets.size(); ++i)
+        if(offsets[i] < offsets[i - 1])
+            throw std::runtime_error("CSR offsets are not sorted");
+}
+
+// Throws unless every index in indices is less than n
+void check_indices(const index_view& indices, size_type n) {
+    for(const auto i : indices)
+        if(i >= n)
+            throw std::runtime_error("index " + std::to_string(i) +
+                                     " is out of range");
+}
+
+} // namespace
+
+namespace detail_ {
+
+// The views of a NucleiTable in the mapped file
+struct NucleiSection {
+    index_view Z;
+    double_view mass;
+    double_view x;
+    double_view y;
+    double_view z;
+    index_view name_offsets;
+    char_view names;
+
+    void read(SectionReader& r, size_type n, size_type name_bytes) {
+        Z            = r.next<size_type>(n);
+        mass         = r.next<double>(n);
+        x            = r.next<double>(n);
+        y            = r.next<double>(n);
+        z            = r.next<double>(n);
+        name_offsets = r.next<size_type>(n + 1);
+        names        = r.next<char>(name_bytes);
+        check_offsets(name_offsets, name_bytes);
+    }
+
+    nucleus_type operator[](size_type i) const {
+        const auto begin = names.data() + name_offsets[i];
+        const auto end   = names.data() + name_offsets[i + 1];
+        return nucleus_type(std::string(begin, end), Z[i], mass[i], x[i], y[i],
+                            z[i]);
+    }
+};
+
+class FragmentArchivePIMPL {
+public:
+    explicit FragmentArchivePIMPL(const FragmentArchive::path_type& path) :
+      m_file(path) {
+        try {
+            read_sections();
+        } catch(const std::runtime_error& e) {
+            throw std::runtime_error(path.string() +
+                                     " is not a valid fragment archive: " +
+                                     e.what());
+        }
+    }
+
+    utilities::MappedFile m_file;
+    NucleiSection m_atoms;
+    index_view m_offsets;
+    index_view m_members;
+    index_view m_anchors;
+    index_view m_replaced;
+    NucleiSection m_caps;
+    double_view m_weights;
+    index_view m_node_offsets;
+    index_view m_node_members;
+    index_view m_edges;
+
+private:
+    void read_sections() {
+        SectionReader r(m_file.data(), m_file.size());
+        const auto& h = r.next<Header>(1)[0];
+        if(h.magic != magic) throw std::runtime_error("wrong magic number");
+        if(h.byte_order != byte_order_tag)
+            throw std::runtime_error("it was written with a different byte "
+                                     "order");
+        if(h.version != FragmentArchive::format_version)
+            throw std::runtime_error("it is version " +
+                                     std::to_string(h.version) +
+                                     ", but version " +
+                                     std::to_string(
+                                       FragmentArchive::format_version) +
+                                     " is required");
+
+        // Guards the "+ 1" and "2 *" below against overflow
+        if(std::max({h.natoms, h.nfrags, h.ncaps, h.nnodes, h.nedges}) >
+           m_file.size())
+            throw std::runtime_error("the file is truncated");
+
+        m_atoms.read(r, h.natoms, h.atom_name_bytes);
+        m_offsets  = r.next<size_type>(h.nfrags + 1);
+        m_members  = r.next<size_type>(h.nmembers);
+        m_anchors  = r.next<size_type>(h.ncaps);
+        m_replaced = r.next<size_type>(h.ncaps);
+        m_caps.read(r, h.ncaps, h.cap_name_bytes);
+        m_weights      = r.next<double>(h.nfrags);
+        m_node_offsets = r.next<size_type>(h.nnodes + 1);
+        m_node_members = r.next<size_type>(h.nnode_members);
+        m_edges        = r.next<size_type>(2 * h.nedges);
+        if(!r.done()) throw std::runtime_error("the file has trailing bytes");
+
+        check_offsets(m_offsets, h.nmembers);
+        check_indices(m_members, h.natoms);
+        check_indices(m_anchors, h.natoms);
+        check_indices(m_replaced, h.natoms);
+        check_offsets(m_node_offsets, h.nnode_members);
+        check_indices(m_node_members, h.natoms);
+        check_indices(m_edges, h.nnodes);
+    }
+};
+
+} // namespace detail_
+
+namespace {
+
+// Throws if supersystem is smaller than the archive's supersystem
+void assert_supersystem(const nuclei_type& supersystem, size_type natoms) {
+    if(supersystem.size() >= natoms) return;
+    throw std::runtime_error("The archive has " + std::to_string(natoms) +
+                             " nuclei, but the supersystem only has " +
+                             std::to_string(supersystem.size()));
+}
+
+} // namespace
+
+//------------------------------------------------------------------------------
+//                                  Writing
+//------------------------------------------------------------------------------
+
+void FragmentArchive::write(const path_type& path,
+                            const fragmented_nuclei& frags,
+                            const weight_container& weights) {
+    write_archive(path, frags, weights, nullptr);
+}
+
+void FragmentArchive::write(const path_type& path,
+                            const fragmented_nuclei& frags,
+                            const weight_container& weights,
+                            const NuclearGraph& graph) {
+    write_archive(path, frags, weights, &graph);
+}
+
+//------------------------------------------------------------------------------
+//                          CTors, Assignment, and DTors
+//------------------------------------------------------------------------------
+
+FragmentArchive::FragmentArchive(const path_type& path) :
+  m_pimpl_(std::make_unique<detail_::FragmentArchivePIMPL>(path)) {}
+
+FragmentArchive::FragmentArchive(FragmentArchive&& other) noexcept = default;
+
+FragmentArchive& FragmentArchive::operator=(FragmentArchive&& rhs) noexcept =
+  default;
+
+FragmentArchive::~FragmentArchive() noexcept = default;
+
+//------------------------------------------------------------------------------
+//                                 Accessors
+//------------------------------------------------------------------------------
+
+size_type FragmentArchive::natoms() const noexcept {
+    return m_pimpl_->m_atoms.Z.size();
+}
+
+index_view FragmentArchive::atomic_numbers() const noexcept {
+    return m_pimpl_->m_atoms.Z;
+}
+
+double_view FragmentArchive::x() const noexcept { return m_pimpl_->m_atoms.x; }
+
+double_view FragmentArchive::y() const noexcept { return m_pimpl_->m_atoms.y; }
+
+double_view FragmentArchive::z() const noexcept { return m_pimpl_->m_atoms.z; }
+
+size_type FragmentArchive::size() const noexcept {
+    return m_pimpl_->m_offsets.size() - 1;
+}
+
+index_view FragmentArchive::offsets() const noexcept {
+    return m_pimpl_->m_offsets;
+}
+
+index_view FragmentArchive::members() const noexcept {
+    return m_pimpl_->m_members;
+}
+
+index_view FragmentArchive::fragment(size_type i) const {
+    if(i >= size())
+        throw std::out_of_range("Fragment " + std::to_string(i) +
+                                " is not in the range [0, " +
+                                std::to_string(size()) + ")");
+    const auto& offsets = m_pimpl_->m_offsets;
+    return {members().data() + offsets[i], offsets[i + 1] - offsets[i]};
+}
+
+size_type FragmentArchive::ncaps() const noexcept {
+    return m_pimpl_->m_anchors.size();
+}
+
+double_view FragmentArchive::weights() const noexcept {
+    return m_pimpl_->m_weights;
+}
+
+size_type FragmentArchive::nodes_size() const noexcept {
+    return m_pimpl_->m_node_offsets.size() - 1;
+}
+
+index_view FragmentArchive::edges() const noexcept {
+    return m_pimpl_->m_edges;
+}
+
+//------------------------------------------------------------------------------
+//                                 Assembly
+//------------------------------------------------------------------------------
+
+nuclei_type FragmentArchive::nuclei() const {
+    nuclei_type rv;
+    for(size_type i = 0; i < natoms(); ++i) rv.push_back(m_pimpl_->m_atoms[i]);
+    return rv;
+}
+
+FragmentArchive::fragmented_nuclei FragmentArchive::fragments(
+  nuclei_type supersystem) const {
+    assert_supersystem(supersystem, natoms());
+    fragmented_nuclei rv(std::move(supersystem));
+    for(size_type i = 0; i < size(); ++i) {
+        const auto indices = fragment(i);
+        rv.insert(indices.begin(), indices.end());
+    }
+
+    const auto& pimpl = *m_pimpl_;
+    for(size_type i = 0; i < ncaps(); ++i)
+        rv.add_cap(
+          cap_type(pimpl.m_anchors[i], pimpl.m_replaced[i], pimpl.m_caps[i]));
+    return rv;
+}
+
+FragmentArchive::weight_container FragmentArchive::weight_list() const {
+    const auto w = weights();
+    return weight_container(w.begin(), w.end());
+}
+
+NuclearGraph FragmentArchive::graph(nuclei_type supersystem) const {
+    assert_supersystem(supersystem, natoms());
+    const auto& pimpl = *m_pimpl_;
+    fragmented_nuclei nodes(std::move(supersystem));
+    for(size_type i = 0; i < nodes_size(); ++i) {
+        const auto* begin = pimpl.m_node_members.data();
+        nodes.insert(begin + pimpl.m_node_offsets[i],
+                     begin + pimpl.m_node_offsets[i + 1]);
+    }
+
+    NuclearGraph::connectivity_type edges(nodes_size());
+    const auto& pairs = pimpl.m_edges;
+    for(size_type i = 0; i < pairs.size(); i += 2)
+        edges.add_bond(pairs[i], pairs[i + 1]);
+    return NuclearGraph(std::move(nodes), std::move(edges));
+}
+
+} // namespace ghostfragment
@@ -0,0 +1,59 @@
+/*
+ * Copyright 2024 GhostFragment
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <ghostfragment/fragment_broken_bonds.hpp>
+#include <stdexcept>
+#include <string>
+
+namespace ghostfragment {
+
+FragmentBrokenBonds::FragmentBrokenBonds(offset_list_type offsets,
+                                         bond_list_type bonds) :
+  m_offsets_(std::move(offsets)), m_bonds_(std::move(bonds)) {
+    if(m_offsets_.empty() || m_offsets_.front() != 0)
+        throw std::runtime_error("Offsets must start at 0");
+    for(size_type i = 1; i < m_offsets_.size(); ++i)
+        if(m_offsets_[i] < m_offsets_[i - 1])
+            throw std::runtime_error("Offsets must be non-decreasing");
+    if(m_offsets_.back() != m_bonds_.size())
+        throw std::runtime_error("Last offset must be the number of bonds");
+}
+
+typename FragmentBrokenBonds::const_bond_range FragmentBrokenBonds::bonds(
+  size_type i) const {
+    if(i >= size())
+        throw std::out_of_range("Fragment " + std::to_string(i) +
+                                " is not in the range [0, " +
+                                std::to_string(size()) + ")");
+    auto begin = m_bonds_.begin();
+    return const_bond_range(begin + m_offsets_[i], begin + m_offsets_[i + 1]);
+}
+
+typename FragmentBrokenBonds::bond_set_type FragmentBrokenBonds::unique_bonds()
+  const {
+    return bond_set_type(m_bonds_.begin(), m_bonds_.end());
+}
+
+void FragmentBrokenBonds::print(std::ostream& os) const {
+    for(size_type i = 0; i < size(); ++i) {
+        os << "Fragment " << i << ":";
+        for(const auto& [anchor, replaced] : bonds(i))
+            os << " (" << anchor << ", " << replaced << ")";
+        os << std::endl;
+    }
+}
+
+} // namespace ghostfragment
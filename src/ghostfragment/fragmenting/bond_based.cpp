@@ -14,6 +14,8 @@
  * limitations under the License.
  */
 
+#include "../utilities/index_set.hpp"
+#include "../utilities/parallel_for.hpp"
 #include "fragmenting.hpp"
 #include <ghostfragment/property_types/fragmenting/nuclear_graph_to_fragments.hpp>
 #include <simde/simde.hpp>
@@ -22,7 +24,7 @@ namespace ghostfragment::fragmenting {
 
 using my_pt       = pt::NuclearGraphToFragments;
 using result_type = pt::NuclearGraphToFragmentsTraits::fragment_type;
-using subset_type = typename result_type::nucleus_index_set;
+using subset_type = utilities::IndexSet;
 using input_type  = pt::NuclearGraphToFragmentsTraits::graph_type;
 using nuclei_type = typename input_type::nuclei_type;
 
@@ -31,12 +33,13 @@ using nuclei_type = typename input_type::nuclei_type;
 // node_stack to perform a depth-first search, where the elements of node_stack
 // are pairs containing the indices of nodes and their distance from the root
 // node. The function loops over the stack, adding the nodes with distance <=
-// nbonds to a set.
+// nbonds to a set. The edge list of the graph is passed in so that it is only
+// made once.
 
-subset_type frag_nodes(const NuclearGraph& graph, std::size_t root_node,
-                       std::size_t nbonds) {
-    const auto& bonds = graph.edge_list();
-    using size_type   = typename subset_type::value_type;
+subset_type frag_nodes(const NuclearGraph& graph,
+                       const NuclearGraph::edge_list_type& bonds,
+                       std::size_t root_node, std::size_t nbonds) {
+    using size_type = typename subset_type::value_type;
     std::unordered_map<size_type, size_type> distance;
     std::stack<std::pair<size_type, size_type>> node_stack;
 
@@ -77,37 +80,46 @@ subset_type frag_nodes(const NuclearGraph& graph, std::size_t root_node,
 
     // Convert nodes (which could consist of multiple nuclei) to their
     // constituent nuclei
-    std::set<size_type> buffer;
+    subset_type nuclei;
     for(const auto& entry : distance) {
-        std::size_t node = entry.first;
-        for(std::size_t j : graph.node_indices(node)) { buffer.insert(j); }
+        const auto node_nuclei = graph.node_indices(entry.first);
+        nuclei.insert(node_nuclei.begin(), node_nuclei.end());
     }
-    return subset_type(buffer.begin(), buffer.end());
+    return nuclei;
 }
 
-// This function takes a MolecularGraph and a parameter nbonds, and loops
-// over all nodes in MolecularGraph, calling frag_nodes for each. If the set
-// of indices is novel, then it is added to a vector of sets to be returned.
+// This function takes a MolecularGraph and a parameter nbonds, and calls
+// frag_nodes for each node in MolecularGraph. The calls are independent, so
+// they are split over nthreads threads. The fragments are then considered in
+// the order of their root nodes; if the set of indices is novel, then it is
+// added to a vector of sets to be returned.
 
 std::vector<subset_type> graph_to_frags(const NuclearGraph& graph,
-                                        std::size_t nbonds) {
+                                        std::size_t nbonds,
+                                        std::size_t nthreads) {
     using return_type = std::vector<subset_type>;
     using size_type   = typename subset_type::value_type;
+
+    const auto bonds  = graph.edge_list();
+    const auto nnodes = graph.nodes_size();
+    return_type candidates(nnodes);
+    utilities::parallel_for_chunks(
+      nnodes, nthreads, [&](std::size_t, std::size_t begin, std::size_t end) {
+          for(auto i = begin; i < end; ++i)
+              candidates[i] = frag_nodes(graph, bonds, i, nbonds);
+      });
+
     return_type indices; // vector of sets of indices denoting fragments
-    subset_type current_frag;
     size_type supersets = 0;
     size_type subsets   = 0;
 
-    for(size_type i = 0; i < graph.nodes_size(); ++i) {
-        auto current_frag = frag_nodes(graph, i, nbonds);
-        size_type j       = 0;
+    for(auto& current_frag : candidates) {
+        size_type j = 0;
         while(j < indices.size()) {
-            if(std::includes(indices[j].begin(), indices[j].end(),
-                             current_frag.begin(), current_frag.end())) {
+            if(utilities::includes(indices[j], current_frag)) {
                 supersets++;
             }
-            if(std::includes(current_frag.begin(), current_frag.end(),
-                             indices[j].begin(), indices[j].end())) {
+            if(utilities::includes(current_frag, indices[j])) {
                 indices.erase(indices.begin() + j);
                 j--;
                 subsets++;
@@ -116,9 +128,9 @@ std::vector<subset_type> graph_to_frags(const NuclearGraph& graph,
         }
 
         if(supersets == 0) {
-            indices.push_back(current_frag);
+            indices.push_back(std::move(current_frag));
         } else if(subsets > 0) {
-            indices.push_back(current_frag);
+            indices.push_back(std::move(current_frag));
         }
 
         supersets = 0;
@@ -137,6 +149,10 @@ object. The fragments are generated by looping over the nodes in
 MolecularGraph and assembling all nodes a distance of nbonds or less away
 from the node in question into a fragment. Each distinct fragment will be
 output exactly once (i.e. no repeats).
+
+The fragments of the nodes are found in parallel. Duplicates are then removed
+in the order of the nodes, so the result does not depend on the number of
+threads.
 )";
 
 MODULE_CTOR(BondBased) {
@@ -146,11 +162,16 @@ MODULE_CTOR(BondBased) {
     add_input<std::size_t>("nbonds")
       .set_description("bond width of fragment")
       .set_default(std::size_t(0));
+    add_input<std::size_t>("nthreads")
+      .set_description("Threads to use (0 for all hardware threads)")
+      .set_default(std::size_t{0});
 }
 
 MODULE_RUN(BondBased) {
     const auto& [graph] = my_pt::unwrap_inputs(inputs);
     const auto& nbonds  = inputs.at("nbonds").value<std::size_t>();
+    auto nthreads       = inputs.at("nthreads").value<std::size_t>();
+    if(nthreads == 0) nthreads = utilities::default_nthreads();
 
     if(graph.nodes_size() == 0) { // Handles trivial mol edge-case
         auto rv = results();
@@ -159,7 +180,7 @@ MODULE_RUN(BondBased) {
 
     result_type frags(graph.nuclei().as_nuclei()); // Will be the fragments
 
-    const auto indices = graph_to_frags(graph, nbonds);
+    const auto indices = graph_to_frags(graph, nbonds, nthreads);
 
     for(std::size_t i = 0; i < indices.size(); ++i) {
         frags.insert(indices[i].begin(), indices[i].end());
@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 
+#include "../utilities/index_set.hpp"
 #include "fragmenting.hpp"
 #include <ghostfragment/property_types/fragmenting/nuclear_graph_to_fragments.hpp>
 #include <simde/simde.hpp>
@@ -25,7 +26,7 @@ using traits_type = pt::NuclearGraphToFragmentsTraits;
 using graph_type  = typename traits_type::graph_type;
 using frags_type  = typename traits_type::fragment_type;
 using edge_list   = typename graph_type::edge_list_type;
-using index_type  = typename edge_list::size_type;
+using index_set   = utilities::IndexSet;
 
 namespace detail_ {
 
@@ -47,10 +48,10 @@ namespace detail_ {
  * missing bonds involving atoms found in the current loop. We thus keep looping
  * until the set of atoms that comes in is the same as the set of atoms we find.
  */
-auto assign_bonds(const edge_list& bonds, const std::set<index_type>& atoms) {
-    std::set<index_type> new_atoms(atoms);
+auto assign_bonds(const edge_list& bonds, const index_set& atoms) {
+    index_set new_atoms(atoms);
     for(const auto& [i, j] : bonds) {
-        if(new_atoms.count(i) || new_atoms.count(j)) {
+        if(new_atoms.contains(i) || new_atoms.contains(j)) {
             new_atoms.insert(i);
             new_atoms.insert(j);
         }
@@ -97,13 +98,13 @@ MODULE_RUN(Cluster) {
     const auto& bonds = graph.edge_list();
 
     using size_type = typename std::decay_t<decltype(bonds)>::size_type;
-    std::vector<std::set<size_type>> patom2frag;
+    std::vector<index_set> patom2frag;
 
     // We know we have at least one patom so seed patom 0 to fragment 0
     std::vector<bool> seen(npatoms, false); // Ensures all patoms get assigned
     for(size_type i = 0; i < npatoms; ++i) {
         if(seen[i]) continue;
-        std::set<size_type> seed{i};
+        index_set seed{i};
         patom2frag.push_back(detail_::assign_bonds(bonds, seed));
         for(auto x : patom2frag.back()) seen[x] = true;
     }
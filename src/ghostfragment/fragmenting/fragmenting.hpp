@@ -25,6 +25,7 @@ DECLARE_MODULE(NMers);
 DECLARE_MODULE(BondBased);
 DECLARE_MODULE(IntersectionsByRecursion);
 DECLARE_MODULE(GMBEWeights);
+DECLARE_MODULE(GMBESubsystems);
 
 inline void load_modules(pluginplay::ModuleManager& mm) {
     mm.add_module<Cluster>("Cluster Partition");
@@ -33,10 +34,10 @@ inline void load_modules(pluginplay::ModuleManager& mm) {
     mm.add_module<BondBased>("Bond-Based Fragmenter");
     mm.add_module<IntersectionsByRecursion>("Intersections");
     mm.add_module<GMBEWeights>("GMBE Weights");
+    mm.add_module<GMBESubsystems>("GMBE Subsystems");
 }
 
 inline void set_defaults(pluginplay::ModuleManager& mm) {
-    mm.change_submod("Heavy Atom Partition", "Connectivity", "Covalent Radius");
     mm.change_submod("All nmers", "Monomer maker", "Bond-Based Fragmenter");
 }
 
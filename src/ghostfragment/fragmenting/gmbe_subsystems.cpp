@@ -0,0 +1,221 @@
+/*
+ * Copyright 2024 GhostFragment
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../utilities/index_set.hpp"
+#include "../utilities/overlap_components.hpp"
+#include "../utilities/parallel_for.hpp"
+#include "fragmenting.hpp"
+#include "gmbe_weights.hpp"
+#include <algorithm>
+#include <ghostfragment/property_types/fragmenting/weighted_subsystems.hpp>
+#include <set>
+#include <vector>
+
+namespace ghostfragment::fragmenting {
+
+using my_pt            = pt::WeightedSubsystems;
+using traits_type      = pt::WeightedSubsystemsTraits;
+using fragments_type   = typename traits_type::fragments_type;
+using weight_container = typename traits_type::weight_container;
+using size_type        = typename fragments_type::size_type;
+using index_set        = utilities::IndexSet;
+using index_set_set    = std::set<index_set>;
+
+namespace {
+
+const auto mod_desc = R"(
+GMBE Subsystems
+---------------
+
+Given the fragments, this module determines the subsystems of the generalized
+many-body expansion (GMBE) and their weights. By the inclusion-exclusion
+principle, the property of the union of the fragments is
+
+.. math::
+
+   E = \sum_{S}(-1)^{|S|+1}E\left(\bigcap_{F\in S}F\right),
+
+where the sum runs over the non-empty sets :math:`S` of fragments. Combining
+the terms with the same intersection, each subsystem :math:`X` (a fragment or a
+non-empty intersection of fragments) gets the net coefficient
+:math:`c_X = 1-\sum_{Y\supset X}c_Y`, where the sum is over the subsystems
+which are proper supersets of :math:`X`. These are the weights of the GMBE
+Weights module.
+
+Many of the coefficients cancel to zero, e.g., those of fragments which are
+contained in other fragments. This module only returns the subsystems with
+nonzero weights, so the energy evaluations never see the other subsystems.
+Except for the dropped subsystems, the result is the same as running the
+Intersections module followed by the GMBE Weights module, with the subsystems
+in the same order: the fragments, followed by the intersections. Repeated and
+empty fragments are ignored. The caps of the fragments are copied to the
+result, so each capped subsystem gets the caps anchored on its nuclei.
+
+The algorithm is:
+
+#. Set aside the fragments which are contained in other fragments. If
+   :math:`A\subset B`, adding :math:`B` to or removing it from a set :math:`S`
+   which contains :math:`A` does not change the intersection, but flips the
+   sign of the term. These terms thus cancel in pairs, so intersections which
+   can only be formed with :math:`A` have zero weights and are never formed.
+#. Intersect the subsystems found last (initially the remaining fragments)
+   with every remaining fragment of their overlap component, i.e., of the
+   group of fragments connected to them through shared nuclei. Repeat with the
+   new intersections until none are found.
+#. Compute the weights as the GMBE Weights module does (without its closed
+   form for n-body expansions).
+#. Keep the subsystems with nonzero weights.
+
+Only the first step prunes the intersection lattice. Whether any other weight
+is zero is only known once the weights of all of its supersets are, so every
+intersection of the remaining fragments is formed, and held at the same time,
+as the Intersections module would. The savings are in what is returned: the
+subsystems with zero weights are never passed on or evaluated.
+
+The second and third steps are split over threads. Each weight is still
+accumulated by one thread in the same order, so the results do not depend on
+the number of threads.
+)";
+
+} // namespace
+
+MODULE_CTOR(GMBESubsystems) {
+    description(mod_desc);
+    satisfies_property_type<my_pt>();
+    add_input<std::size_t>("nthreads")
+      .set_description("Threads to use (0 for all hardware threads)")
+      .set_default(std::size_t{0});
+}
+
+MODULE_RUN(GMBESubsystems) {
+    auto& logger        = get_runtime().logger();
+    const auto& [frags] = my_pt::unwrap_inputs(inputs);
+    auto nthreads       = inputs.at("nthreads").value<std::size_t>();
+    if(nthreads == 0) nthreads = utilities::default_nthreads();
+
+    // Step 0: The distinct fragments
+    std::vector<index_set> subsystems;
+    index_set_set frag_set;
+    for(size_type i = 0; i < frags.size(); ++i) {
+        const auto indices = frags.nuclear_indices(i);
+        index_set frag(indices.begin(), indices.end());
+        if(frag.empty() || !frag_set.insert(frag).second) continue;
+        subsystems.push_back(std::move(frag));
+    }
+    const auto nfrags = subsystems.size();
+
+    // Step 1: Set aside the fragments contained in other fragments. A
+    // container has every nucleus of the fragment, so only the fragments
+    // with its least shared nucleus are checked.
+    const auto nnuclei = frags.supersystem().size();
+    std::vector<bool> is_contained(nfrags, false);
+    {
+        std::vector<std::vector<size_type>> owners(nnuclei);
+        for(size_type f = 0; f < nfrags; ++f)
+            for(const auto j : subsystems[f]) owners[j].push_back(f);
+
+        auto by_owners = [&](size_type j, size_type k) {
+            return owners[j].size() < owners[k].size();
+        };
+        for(size_type f = 0; f < nfrags; ++f) {
+            const auto& x = subsystems[f];
+            const auto j  = *std::min_element(x.begin(), x.end(), by_owners);
+            for(const auto g : owners[j]) {
+                const auto& y = subsystems[g];
+                if(y.size() > x.size() && utilities::includes(y, x)) {
+                    is_contained[f] = true;
+                    break;
+                }
+            }
+        }
+    }
+
+    // Step 2: Intersect the newest subsystems with the remaining fragments.
+    // The sets are only read while the threads run.
+    index_set_set intersections;
+    auto is_known = [&](const index_set& x) {
+        return frag_set.count(x) || intersections.count(x);
+    };
+
+    // A subsystem only intersects the fragments of its overlap component. The
+    // contained fragments do not change the components.
+    auto components = utilities::overlap_components(subsystems, nnuclei);
+    std::vector<size_type> component_of(nnuclei);
+    for(size_type c = 0; c < components.size(); ++c) {
+        auto& component = components[c];
+        for(const auto f : component)
+            for(const auto j : subsystems[f]) component_of[j] = c;
+        auto contained = [&](size_type f) { return is_contained[f]; };
+        component.erase(
+          std::remove_if(component.begin(), component.end(), contained),
+          component.end());
+    }
+
+    std::vector<index_set> newest;
+    for(size_type f = 0; f < nfrags; ++f)
+        if(!is_contained[f]) newest.push_back(subsystems[f]);
+    logger.debug("Intersecting " + std::to_string(newest.size()) + " of " +
+                 std::to_string(nfrags) + " fragments.");
+
+    std::vector<index_set_set> found(nthreads);
+    while(!newest.empty()) {
+        auto intersect = [&](std::size_t chunk, std::size_t begin,
+                             std::size_t end) {
+            for(auto k = begin; k < end; ++k) {
+                const auto& x = newest[k];
+                for(const auto f : components[component_of[x[0]]]) {
+                    auto intersection =
+                      utilities::set_intersection(x, subsystems[f]);
+                    if(intersection.empty() || is_known(intersection))
+                        continue;
+                    found[chunk].insert(std::move(intersection));
+                }
+            }
+        };
+        utilities::parallel_for_chunks(newest.size(), nthreads, intersect);
+
+        index_set_set new_ints;
+        for(auto& found_i : found) new_ints.merge(found_i);
+        newest.assign(new_ints.begin(), new_ints.end());
+        intersections.merge(new_ints);
+    }
+    while(!intersections.empty()) {
+        auto node = intersections.extract(intersections.begin());
+        subsystems.push_back(std::move(node.value()));
+    }
+    const auto nsubsystems = subsystems.size();
+
+    // Step 3: The weights
+    const auto weights = gmbe_weights(subsystems, nnuclei, nthreads);
+
+    // Step 4: Keep the subsystems which contribute, and the caps
+    fragments_type nonzero(frags.supersystem());
+    weight_container nonzero_weights;
+    for(size_type i = 0; i < nsubsystems; ++i) {
+        if(weights[i] == 0.0) continue;
+        nonzero.insert(subsystems[i].begin(), subsystems[i].end());
+        nonzero_weights.push_back(weights[i]);
+    }
+    for(const auto& cap : frags.cap_set()) nonzero.add_cap(cap);
+    logger.debug("Kept " + std::to_string(nonzero.size()) + " of " +
+                 std::to_string(nsubsystems) + " subsystems.");
+
+    auto rv = results();
+    return my_pt::wrap_results(rv, std::move(nonzero),
+                               std::move(nonzero_weights));
+}
+
+} // namespace ghostfragment::fragmenting
@@ -14,8 +14,20 @@
  * limitations under the License.
  */
 
+#include "../utilities/binomial.hpp"
+#include "../utilities/index_set.hpp"
+#include "../utilities/overlap_components.hpp"
+#include "../utilities/parallel_for.hpp"
 #include "fragmenting.hpp"
+#include "gmbe_weights.hpp"
 #include <algorithm>
+#include <limits>
+#include <map>
+#include <numeric>
+#include <optional>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
 #include <ghostfragment/property_types/fragmenting/fragment_weights.hpp>
 
 namespace ghostfragment::fragmenting {
@@ -31,9 +43,8 @@ using fragmented_nuclei_type =
 using nucleus_index_set = typename fragmented_nuclei_type::nucleus_index_set;
 using index_type        = typename nucleus_index_set::value_type;
 using size_type         = typename fragmented_nuclei_type::size_type;
-using index_set         = std::set<index_type>;
-using index_set_to_frag = std::map<index_set, size_type>;
-using length_to_map     = std::map<size_type, index_set_to_frag>;
+using index_set         = utilities::IndexSet;
+using length_to_offsets = std::map<size_type, std::vector<size_type>>;
 
 namespace {
 
@@ -73,61 +84,226 @@ subsystem(s), so on and so forth. More formally:
 
 #. Set :math:`n` to :math:`n-1`. If :math:`n` is 0 terminate, otherwise return
    to step 4.
+
+A subsystem can only be a subset of subsystems it shares nuclei with. The
+subsystems are therefore first split into overlap components, i.e., groups of
+subsystems connected through shared nuclei, and the algorithm is run for each
+component on its own. For large systems this turns one problem into many small
+ones. The components are split over threads. Within a component, the weights of
+the subsystems of length :math:`n` only depend on the weights of longer
+subsystems, so step 5 is done for all subsystems of length :math:`n` at once,
+split over the component's threads. Each weight is still accumulated by one
+thread in the same order, so the weights are bit-for-bit the same for any
+number of threads.
+
+If "closed form" is true (the default) the module first checks whether the
+subsystems are exactly the :math:`k`-mers, :math:`1\le k\le n`, of :math:`N`
+disjoint monomers, i.e., the subsystems of a traditional :math:`n`-body
+expansion. Two nuclei belong to the same monomer if they are members of the
+same subsystems, so this check needs no subset tests. If the check passes, the
+weight of each :math:`k`-mer is
+:math:`c_k=(-1)^{n-k}\binom{N-k-1}{n-k}` and the algorithm above is skipped.
+The weights are the same as those of the algorithm above.
 )";
 
-template<typename SetType>
-bool is_subset(const SetType& superset, const SetType& subset) {
-    return std::includes(superset.begin(), superset.end(), subset.begin(),
-                         subset.end());
+/* Returns the weights in closed form if the subsystems in @p frags are all
+ * unions of 1 to n of N disjoint monomers, and std::nullopt otherwise.
+ */
+std::optional<weight_container> closed_form_weights(
+  const fragmented_nuclei_type& frags) {
+    const auto nfrags = frags.size();
+    if(nfrags == 0) return std::nullopt;
+
+    // The subsystems each nucleus is in (in increasing order)
+    std::vector<index_set> owners(frags.supersystem().size());
+    for(size_type i = 0; i < nfrags; ++i)
+        for(const auto j : frags.nuclear_indices(i)) owners[j].insert(i);
+
+    // Nuclei in the same subsystems are in the same monomer
+    std::unordered_map<index_set, size_type> monomer_ids;
+    std::vector<size_type> monomer(owners.size());
+    for(size_type j = 0; j < owners.size(); ++j) {
+        if(owners[j].empty()) continue;
+        const auto id    = monomer_ids.size();
+        const auto entry = monomer_ids.emplace(std::move(owners[j]), id);
+        monomer[j]       = entry.first->second;
+    }
+    const auto nmonomers = monomer_ids.size();
+
+    // Which monomers make up each subsystem, each set must appear once
+    std::unordered_set<index_set> seen;
+    std::vector<size_type> nbody(nfrags);
+    index_set members;
+    for(size_type i = 0; i < nfrags; ++i) {
+        members.clear();
+        for(const auto j : frags.nuclear_indices(i)) members.insert(monomer[j]);
+        if(members.empty() || !seen.insert(members).second)
+            return std::nullopt;
+        nbody[i] = members.size();
+    }
+
+    // Distinct subsystems, so there are C(N, k) k-mers iff all are present
+    const auto n = *std::max_element(nbody.begin(), nbody.end());
+    std::vector<size_type> nkmers(n + 1, 0);
+    for(const auto k : nbody) ++nkmers[k];
+    for(size_type k = 1; k <= n; ++k)
+        if(nkmers[k] != utilities::binomial(nmonomers, k)) return std::nullopt;
+
+    constexpr auto max = std::numeric_limits<std::size_t>::max();
+    weight_container weights(nfrags, 1.0);
+    for(size_type i = 0; i < nfrags; ++i) {
+        const auto k = nbody[i];
+        if(k == n) continue;
+        const auto c = utilities::binomial(nmonomers - k - 1, n - k);
+        if(c == max) return std::nullopt;
+        weights[i] = (n - k) % 2 ? -double(c) : double(c);
+    }
+    return weights;
+}
+
+/* The GMBE weights of the subsystems of one component, see mod_desc.
+ * @p sorted_frags holds the offsets in @p subsystems of the component's
+ * subsystems, by length.
+ */
+void component_weights(const std::vector<index_set>& subsystems,
+                       const length_to_offsets& sorted_frags,
+                       weight_container& weights, std::size_t nthreads) {
+    // N.B. use of rbegin/rend to start with largest fragment. The threads
+    // only read the (already complete) levels of longer subsystems.
+    std::vector<const std::vector<size_type>*> levels;
+    for(auto itr = sorted_frags.rbegin(); itr != sorted_frags.rend(); ++itr)
+        levels.push_back(&itr->second);
+
+    for(std::size_t subset_level = 0; subset_level < levels.size();
+        ++subset_level) {
+        const auto& level = *levels[subset_level];
+
+        auto level_weights = [&](std::size_t, std::size_t begin,
+                                 std::size_t end) {
+            for(auto k = begin; k < end; ++k) {
+                const auto i       = level[k];
+                const auto& subset = subsystems[i];
+                // Final weight is equal to 1 minus the weight of each
+                // parent's weight
+                auto weight = 1.0;
+
+                // N.b. starting at the end again
+                for(std::size_t parent_level = 0; parent_level < subset_level;
+                    ++parent_level) {
+                    for(const auto j : *levels[parent_level]) {
+                        if(utilities::includes(subsystems[j], subset))
+                            weight -= weights[j];
+                    }
+                }
+                weights[i] = weight;
+            }
+        };
+        utilities::parallel_for_chunks(level.size(), nthreads, level_weights);
+    }
+}
+
+/* Sorts the offsets in @p level by their subsystems. Of repeated subsystems
+ * only the last offset is kept, so the other copies get weights of zero.
+ */
+void sort_and_drop_repeats(const std::vector<index_set>& subsystems,
+                           std::vector<size_type>& level) {
+    auto by_subsystem = [&](size_type i, size_type j) {
+        return subsystems[i] < subsystems[j];
+    };
+    std::stable_sort(level.begin(), level.end(), by_subsystem);
+
+    std::vector<size_type> kept;
+    for(std::size_t k = 0; k < level.size(); ++k) {
+        const auto is_last = k + 1 == level.size() ||
+                             subsystems[level[k]] != subsystems[level[k + 1]];
+        if(is_last) kept.push_back(level[k]);
+    }
+    level = std::move(kept);
 }
 
 } // namespace
 
+std::vector<double> gmbe_weights(const std::vector<index_set>& subsystems,
+                                 std::size_t nnuclei, std::size_t nthreads) {
+    // Subsystems in different overlap components are never subsets of one
+    // another, but an empty subsystem is a subset of every subsystem
+    const auto nsubsystems = subsystems.size();
+    const bool has_empty =
+      std::any_of(subsystems.begin(), subsystems.end(),
+                  [](const index_set& x) { return x.empty(); });
+
+    std::vector<std::vector<std::size_t>> components;
+    if(has_empty) {
+        components.emplace_back(nsubsystems);
+        std::iota(components[0].begin(), components[0].end(), std::size_t{0});
+    } else {
+        components = utilities::overlap_components(subsystems, nnuclei);
+    }
+
+    // The work of a component grows (at least) quadratically with its size.
+    // Components sharing a chunk are solved one after the other, with the
+    // chunk's share of the threads.
+    std::vector<double> work;
+    for(const auto& component : components)
+        work.push_back(double(component.size()) * double(component.size()));
+    const auto bounds  = utilities::weighted_chunk_bounds(work, nthreads);
+    const auto nchunks = bounds.size() - 1;
+    const auto chunk_nthreads = std::max<std::size_t>(1, nthreads / nchunks);
+
+    weight_container weights(nsubsystems, 0.0);
+    auto solve = [&](std::size_t chunk, std::size_t, std::size_t) {
+        for(auto c = bounds[chunk]; c < bounds[chunk + 1]; ++c) {
+            length_to_offsets sorted_frags;
+            for(const auto i : components[c])
+                sorted_frags[subsystems[i].size()].push_back(i);
+            for(auto& entry : sorted_frags)
+                sort_and_drop_repeats(subsystems, entry.second);
+            component_weights(subsystems, sorted_frags, weights,
+                              chunk_nthreads);
+        }
+    };
+    utilities::parallel_for_chunks(nchunks, nchunks, solve);
+    return weights;
+}
+
 MODULE_CTOR(GMBEWeights) {
     description(mod_desc);
     satisfies_property_type<my_pt>();
+    add_input<std::size_t>("nthreads")
+      .set_description("Threads to use (0 for all hardware threads)")
+      .set_default(std::size_t{0});
+    add_input<bool>("closed form")
+      .set_description("Use closed-form weights for n-body expansions")
+      .set_default(true);
 }
 
 MODULE_RUN(GMBEWeights) {
     const auto& [fragmented_sys]    = my_pt::unwrap_inputs(inputs);
     const auto& fragmented_molecule = fragmented_sys.fragmented_molecule();
     const auto& fragmented_nuclei   = fragmented_molecule.fragmented_nuclei();
+    auto nthreads = inputs.at("nthreads").value<std::size_t>();
+    if(nthreads == 0) nthreads = utilities::default_nthreads();
 
-    length_to_map sorted_frags;
-    std::set<size_type> nnuclei;
-    for(size_type frag_i = 0; frag_i < fragmented_nuclei.size(); ++frag_i) {
-        auto buffer = fragmented_nuclei.nuclear_indices(frag_i);
-        index_set indices(buffer.begin(), buffer.end());
-        sorted_frags[buffer.size()][indices] = frag_i;
-        nnuclei.insert(buffer.size());
+    if(inputs.at("closed form").value<bool>()) {
+        auto mbe_weights = closed_form_weights(fragmented_nuclei);
+        if(mbe_weights) {
+            auto rv = results();
+            return my_pt::wrap_results(rv, std::move(*mbe_weights));
+        }
     }
 
-    weight_container weights(fragmented_nuclei.size(), 0.0);
-
-    // N.B. use of rbegin/rend to start with largest fragment
-    auto subset_size = nnuclei.rbegin();
-    auto smallest    = nnuclei.rend();
-
-    while(subset_size != smallest) {
-        for(const auto& [subset, i] : sorted_frags[*subset_size]) {
-            // Final weight is equal to 1 minus the weight of each parent's
-            // weight
-            weights[i] = 1.0;
-
-            // N.b. starting at the end again
-            auto parent_size = nnuclei.rbegin();
-            while(parent_size != subset_size) {
-                for(const auto& [superset, j] : sorted_frags[*parent_size]) {
-                    if(is_subset(superset, subset)) weights[i] -= weights[j];
-                }
-                ++parent_size;
-            }
-        }
-        ++subset_size;
+    const auto nsubsystems = fragmented_nuclei.size();
+    std::vector<index_set> subsystems;
+    for(size_type frag_i = 0; frag_i < nsubsystems; ++frag_i) {
+        auto buffer = fragmented_nuclei.nuclear_indices(frag_i);
+        subsystems.emplace_back(buffer.begin(), buffer.end());
     }
 
+    const auto nnuclei = fragmented_nuclei.supersystem().size();
+    auto weights       = gmbe_weights(subsystems, nnuclei, nthreads);
+
     auto rv = results();
-    return my_pt::wrap_results(rv, weights);
+    return my_pt::wrap_results(rv, std::move(weights));
 }
 
 } // namespace ghostfragment::fragmenting
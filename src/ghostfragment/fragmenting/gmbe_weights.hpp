@@ -0,0 +1,47 @@
+/*
+ * Copyright 2024 GhostFragment
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include "../utilities/index_set.hpp"
+#include <cstddef>
+#include <vector>
+
+namespace ghostfragment::fragmenting {
+
+/** @brief Computes the GMBE weights of a set of subsystems.
+ *
+ *  This is the algorithm of the GMBE Weights module without the closed-form
+ *  shortcut. The weight of each subsystem is 1 minus the sum of the weights of
+ *  its proper supersets. The weights are computed from the largest subsystems
+ *  down, separately for each overlap component of the subsystems. The results
+ *  do not depend on @p nthreads.
+ *
+ *  @param[in] subsystems The distinct subsystems, as the offsets of their
+ *                        nuclei.
+ *  @param[in] nnuclei The number of nuclei in the supersystem. Each offset in
+ *                     @p subsystems must be less than this.
+ *  @param[in] nthreads The number of threads to use.
+ *
+ *  @return The weights, the i-th of which is the weight of subsystems[i].
+ *
+ *  @throw std::bad_alloc if allocating the work space fails. Strong throw
+ *                        guarantee.
+ */
+std::vector<double> gmbe_weights(
+  const std::vector<utilities::IndexSet>& subsystems, std::size_t nnuclei,
+  std::size_t nthreads);
+
+} // namespace ghostfragment::fragmenting
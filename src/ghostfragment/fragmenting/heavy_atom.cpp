@@ -17,14 +17,12 @@
 #include "fragmenting.hpp"
 
 #include <chemist/fragmenting/fragmented_nuclei.hpp>
-#include <ghostfragment/property_types/fragmenting/fragmented_nuclei.hpp>
-#include <ghostfragment/property_types/topology/connectivity_table.hpp>
+#include <ghostfragment/property_types/fragmenting/fragmented_nuclei_from_connectivity.hpp>
 #include <iostream>
 
 namespace ghostfragment::fragmenting {
 
-using frags_pt = pt::FragmentedNuclei;
-using conn_pt  = pt::ConnectivityTable;
+using frags_pt = pt::FragmentedNucleiFromConnectivity;
 
 const auto mod_desc = R"(
 Fragmentation by Heavy Atom
@@ -41,6 +39,9 @@ While theoretically usable as a fragmentation method proper, this module is
 largely envisioned as being used as a pseudoatom submodule, or as the first step
 in a more involved pseudoatom submodule.
 
+Which hydrogens are bonded to which heavy atoms is determined from the atomic
+connectivity, which is an input to this module.
+
 This module will raise an error if there is a hydrogen atom bonded to more than
 one other atom.
 )";
@@ -49,8 +50,6 @@ MODULE_CTOR(HeavyAtom) {
     description(mod_desc);
 
     satisfies_property_type<frags_pt>();
-
-    add_submodule<conn_pt>("Connectivity");
 }
 
 MODULE_RUN(HeavyAtom) {
@@ -58,11 +57,8 @@ MODULE_RUN(HeavyAtom) {
     using size_type         = typename fragmented_nuclei::size_type;
     auto& logger            = get_runtime().logger();
 
-    const auto& [system] = frags_pt::unwrap_inputs(inputs);
-    const auto& mol      = system.molecule();
-
-    auto& con_mod     = submods.at("Connectivity");
-    const auto& conns = con_mod.run_as<conn_pt>(mol);
+    const auto& [system, conns] = frags_pt::unwrap_inputs(inputs);
+    const auto& mol             = system.molecule();
     logger.debug("Found " + std::to_string(conns.nbonds()) + " bonds.");
 
     fragmented_nuclei frags(mol.nuclei().as_nuclei());
@@ -13,8 +13,14 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include "../utilities/index_set.hpp"
+#include "../utilities/overlap_components.hpp"
+#include "../utilities/parallel_for.hpp"
 #include "fragmenting.hpp"
+#include <algorithm>
 #include <ghostfragment/property_types/fragmenting/intersections.hpp>
+#include <unordered_set>
+#include <utility>
 
 namespace ghostfragment::fragmenting {
 
@@ -24,28 +30,29 @@ using fragments_type    = typename traits_type::input_type;
 using result_type       = typename traits_type::result_type;
 using nuclear_index_set = typename fragments_type::nucleus_index_set;
 using size_type         = typename nuclear_index_set::size_type;
-using index_set         = std::set<size_type>;
-using intersection_set  = std::set<index_set>;
+using index_set         = utilities::IndexSet;
+using intersection_set  = std::unordered_set<index_set>;
 using frag_set          = std::vector<index_set>;
+using component_type    = std::vector<std::size_t>;
 
 namespace {
+// Only the fragments in @p component, from @p starting_frag on, are considered
 void compute_intersection(const index_set& curr_frag, std::size_t starting_frag,
+                          const component_type& component,
                           const frag_set& frag_indices,
                           intersection_set& ints_so_far) {
-    while(starting_frag < frag_indices.size()) {
-        index_set intersection;
-        const index_set& next_frag = frag_indices[starting_frag];
-        auto itr = std::inserter(intersection, intersection.begin());
-        std::set_intersection(curr_frag.begin(), curr_frag.end(),
-                              next_frag.begin(), next_frag.end(), itr);
+    while(starting_frag < component.size()) {
+        const index_set& next_frag = frag_indices[component[starting_frag]];
+        auto intersection = set_intersection(curr_frag, next_frag);
         ++starting_frag;
         // If it's empty and/or we've seen it befor just move on
-        if(intersection.empty() || ints_so_far.count(intersection)) continue;
+        if(intersection.empty()) continue;
 
         // Add the intersection
-        ints_so_far.insert(intersection);
+        const auto [itr, added] = ints_so_far.insert(std::move(intersection));
+        if(!added) continue;
 
-        compute_intersection(intersection, starting_frag, frag_indices,
+        compute_intersection(*itr, starting_frag, component, frag_indices,
                              ints_so_far);
     }
 }
@@ -55,6 +62,17 @@ Intersections by Recursion
 --------------------------
 
 This module finds the intersections of a set of fragments via recursion.
+
+The fragments are first split into overlap components, i.e., groups of
+fragments which are connected through shared nuclei. Fragments in different
+components have no intersections, so the recursion started from a fragment only
+considers the fragments of its component. For large systems this turns one
+problem into many small ones.
+
+The recursions started from different fragments, of the same or of different
+components, are split over threads. Each thread collects the intersections it
+finds in its own set and the sets are merged afterwards, so the intersections
+do not depend on the number of threads.
 )";
 } // namespace
 
@@ -62,11 +80,16 @@ MODULE_CTOR(IntersectionsByRecursion) {
     description(mod_desc);
 
     satisfies_property_type<property_type>();
+    add_input<std::size_t>("nthreads")
+      .set_description("Threads to use (0 for all hardware threads)")
+      .set_default(std::size_t{0});
 }
 
 MODULE_RUN(IntersectionsByRecursion) {
     auto& logger = get_runtime().logger();
-    auto [frags] = property_type::unwrap_inputs(inputs);
+    const auto& [frags] = property_type::unwrap_inputs(inputs);
+    auto nthreads       = inputs.at("nthreads").value<std::size_t>();
+    if(nthreads == 0) nthreads = utilities::default_nthreads();
 
     // It's much easier to work with nuclear indices
     std::vector<index_set> frag_indices;
@@ -80,23 +103,58 @@ MODULE_RUN(IntersectionsByRecursion) {
         frag_indices.emplace_back(frag_i.begin(), frag_i.end());
     }
 
-    std::set<index_set> intersections;
-
-    for(decltype(frags.size()) begin = 0; begin < frags.size(); ++begin) {
-        const index_set& frag = frag_indices[begin];
-        compute_intersection(frag, begin + 1, frag_indices, intersections);
+    // Fragments in different components never intersect, so each recursion
+    // only needs the fragments of its own component
+    const auto components = utilities::overlap_components(
+      frag_indices, frags.supersystem().size());
+
+    // The k-th fragment of a component is intersected with the fragments of
+    // the component after it, so balance the work, not the fragments
+    std::vector<std::pair<const component_type*, std::size_t>> starts;
+    std::vector<double> work;
+    for(const auto& component : components) {
+        for(std::size_t k = 0; k < component.size(); ++k) {
+            starts.emplace_back(&component, k);
+            work.push_back(double(component.size() - 1 - k));
+        }
+    }
+    const auto bounds  = utilities::weighted_chunk_bounds(work, nthreads);
+    const auto nchunks = bounds.size() - 1;
+    std::vector<intersection_set> found(nchunks);
+
+    auto recurse = [&](std::size_t chunk, std::size_t, std::size_t) {
+        for(auto s = bounds[chunk]; s < bounds[chunk + 1]; ++s) {
+            const auto& [component, k] = starts[s];
+            const index_set& frag      = frag_indices[(*component)[k]];
+            compute_intersection(frag, k + 1, *component, frag_indices,
+                                 found[chunk]);
+        }
+    };
+    utilities::parallel_for_chunks(nchunks, nchunks, recurse);
+
+    // A chunk may find intersections another one also found. Sorting gives
+    // an order which does not depend on the number of threads.
+    std::vector<index_set> intersections;
+    for(auto& found_i : found) {
+        for(auto itr = found_i.begin(); itr != found_i.end();)
+            intersections.push_back(std::move(found_i.extract(itr++).value()));
     }
+    std::sort(intersections.begin(), intersections.end());
+    intersections.erase(std::unique(intersections.begin(), intersections.end()),
+                        intersections.end());
 
+    // The only copy of the fragments; the intersections are appended to it
+    result_type frags_with_ints(frags);
     for(const auto& intersection_i : intersections) {
         std::string int_str;
         for(auto x : intersection_i) int_str += std::to_string(x) + ",";
         int_str.pop_back();
         logger.debug("Found intersection: " + int_str);
-        frags.insert(intersection_i.begin(), intersection_i.end());
+        frags_with_ints.insert(intersection_i.begin(), intersection_i.end());
     }
 
     auto rv = results();
-    return property_type::wrap_results(rv, frags);
+    return property_type::wrap_results(rv, std::move(frags_with_ints));
 }
 
 } // namespace ghostfragment::fragmenting
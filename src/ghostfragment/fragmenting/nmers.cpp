@@ -14,19 +14,180 @@
  * limitations under the License.
  */
 
+#include "../topology/cell_list.hpp"
+#include "../topology/unit_cell.hpp"
+#include "../utilities/binomial.hpp"
+#include "../utilities/index_set.hpp"
+#include "../utilities/parallel_for.hpp"
 #include "fragmenting.hpp"
 #include <combinations.hpp>
-#include <enumerate.hpp>
-#include <ghostfragment/property_types/fragmenting/nuclear_graph_to_fragments.hpp>
+#include <ghostfragment/property_types/fragmenting/nuclear_graph_to_nmers.hpp>
+#include <limits>
 #include <numeric>
 namespace ghostfragment::fragmenting {
 
 using my_pt              = ghostfragment::pt::NuclearGraphToFragments;
+using nmers_pt           = ghostfragment::pt::NuclearGraphToNMers;
 using traits_type        = ghostfragment::pt::NuclearGraphToFragmentsTraits;
 using nmers_type         = typename traits_type::fragment_type;
-using nucleus_index_list = typename nmers_type::nucleus_index_set;
-using index_type         = typename nucleus_index_list::value_type;
-using n_type             = unsigned short;
+using n_type             = pt::NuclearGraphToNMersTraits::n_type;
+using size_type          = std::size_t;
+using adjacency_type     = std::vector<std::vector<size_type>>;
+
+namespace {
+
+/* Monomers i and j are adjacent if any nucleus of i is within @p cutoff of
+ * any nucleus of j (or if they share a nucleus). The close pairs of nuclei
+ * come from a cell list, so the cost is linear in the number of nuclei.
+ */
+template<typename FragsType>
+adjacency_type monomer_adjacency(const FragsType& frags, double cutoff,
+                                 const std::vector<double>& lattice) {
+    const topology::NucleiSnapshot snapshot(frags.supersystem());
+    const auto natoms = snapshot.size();
+    const auto nfrags = frags.size();
+
+    // CSR map from each nucleus to the monomers containing it
+    std::vector<size_type> offsets(natoms + 1, 0);
+    for(size_type f = 0; f < nfrags; ++f)
+        for(auto i : frags.nuclear_indices(f)) ++offsets[i + 1];
+    for(size_type i = 0; i < natoms; ++i) offsets[i + 1] += offsets[i];
+    std::vector<size_type> owners(offsets.back());
+    auto next = offsets;
+    for(size_type f = 0; f < nfrags; ++f)
+        for(auto i : frags.nuclear_indices(f)) owners[next[i]++] = f;
+
+    adjacency_type adj(nfrags);
+    auto connect = [&](size_type i, size_type j) {
+        for(auto a = offsets[i]; a < offsets[i + 1]; ++a)
+            for(auto b = offsets[j]; b < offsets[j + 1]; ++b) {
+                if(owners[a] == owners[b]) continue;
+                adj[owners[a]].push_back(owners[b]);
+                adj[owners[b]].push_back(owners[a]);
+            }
+    };
+    for(size_type i = 0; i < natoms; ++i) connect(i, i);
+
+    auto pair_fxn = [&](size_type i, size_type j, double) { connect(i, j); };
+    if(lattice.empty()) {
+        topology::CellList(snapshot, cutoff).for_each_pair(pair_fxn);
+    } else {
+        const topology::UnitCell cell(lattice);
+        topology::CellList(snapshot, cutoff, cell).for_each_pair(pair_fxn);
+    }
+
+    for(auto& neighbors : adj) {
+        std::sort(neighbors.begin(), neighbors.end());
+        auto last = std::unique(neighbors.begin(), neighbors.end());
+        neighbors.erase(last, neighbors.end());
+    }
+    return adj;
+}
+
+/// Does every monomer have nuclei and no nucleus belong to two monomers?
+template<typename FragsType>
+bool are_disjoint(const FragsType& frags) {
+    std::vector<bool> used(frags.supersystem().size(), false);
+    for(size_type f = 0; f < frags.size(); ++f) {
+        auto indices = frags.nuclear_indices(f);
+        if(indices.begin() == indices.end()) return false;
+        for(auto i : indices) {
+            if(used[i]) return false;
+            used[i] = true;
+        }
+    }
+    return true;
+}
+
+/* Enumerates each connected set of exactly n monomers once, using the ESU
+ * algorithm of Wernicke (IEEE/ACM TCBB 3, 347 (2006)). A set is grown from its
+ * smallest monomer, v, and only by monomers which are larger than v and which
+ * are not adjacent to any monomer already in the set (other than the one
+ * being added). The cost is proportional to the number of sets found. Sets
+ * grown from different monomers are independent, so the monomers may be split
+ * over several instances of this class (one per thread).
+ */
+class ConnectedSets {
+public:
+    ConnectedSets(const adjacency_type& adj, size_type n) :
+      m_adj_(adj), m_n_(n), m_covered_(adj.size(), 0) {}
+
+    /// Calls @p fxn for each set whose smallest monomer is in [begin, end)
+    template<typename FxnType>
+    void for_each(size_type begin, size_type end, FxnType&& fxn) {
+        for(size_type v = begin; v < end; ++v) {
+            std::vector<size_type> extension;
+            for(auto u : m_adj_[v])
+                if(u > v) extension.push_back(u);
+            push_(v);
+            extend_(v, std::move(extension), fxn);
+            pop_();
+        }
+    }
+
+private:
+    template<typename FxnType>
+    void extend_(size_type v, std::vector<size_type> extension,
+                 FxnType& fxn) {
+        if(m_set_.size() == m_n_) {
+            fxn(m_set_);
+            return;
+        }
+        while(!extension.empty()) {
+            const auto w = extension.back();
+            extension.pop_back();
+
+            auto new_extension = extension;
+            for(auto u : m_adj_[w])
+                if(u > v && !m_covered_[u]) new_extension.push_back(u);
+
+            push_(w);
+            extend_(v, std::move(new_extension), fxn);
+            pop_();
+        }
+    }
+
+    // Tracks how many members of the set each monomer is in or next to
+    void push_(size_type w) {
+        m_set_.push_back(w);
+        ++m_covered_[w];
+        for(auto u : m_adj_[w]) ++m_covered_[u];
+    }
+
+    void pop_() {
+        const auto w = m_set_.back();
+        m_set_.pop_back();
+        --m_covered_[w];
+        for(auto u : m_adj_[w]) --m_covered_[u];
+    }
+
+    const adjacency_type& m_adj_;
+    size_type m_n_;
+    std::vector<size_type> m_covered_;
+    std::vector<size_type> m_set_;
+};
+
+/// Connected components of the monomer graph with fewer than n monomers
+std::vector<std::vector<size_type>> small_components(
+  const adjacency_type& adj, size_type n) {
+    std::vector<std::vector<size_type>> rv;
+    std::vector<bool> seen(adj.size(), false);
+    for(size_type v = 0; v < adj.size(); ++v) {
+        if(seen[v]) continue;
+        std::vector<size_type> component{v};
+        seen[v] = true;
+        for(size_type i = 0; i < component.size(); ++i)
+            for(auto u : adj[component[i]])
+                if(!seen[u]) {
+                    seen[u] = true;
+                    component.push_back(u);
+                }
+        if(component.size() < n) rv.push_back(std::move(component));
+    }
+    return rv;
+}
+
+} // namespace
 
 const auto mod_desc = R"(
 .. |n| replace:: :math:`n`
@@ -39,15 +200,59 @@ input fragments. This module works with both disjoint and intersecting
 fragments. For intersecting fragments, this module will ensure that the
 resulting set of |n|-mers are such that no |n|-mer is a subset of another
 |n|-mer (notably this also guarantees their uniqueness).
+
+When run as a NuclearGraphToNMers module |n| is taken from the property type's
+inputs. This is the preferred way of using this module since it lets the same
+(memoized) instance serve every |n|. When run as a NuclearGraphToFragments
+module |n| is taken from the "n" input.
+
+Distance Screening
+------------------
+
+If a distance threshold is provided, two fragments are considered close if any
+nucleus of one is within the threshold of any nucleus of the other. Only unions
+of fragments which are connected through close fragments are then formed, i.e.,
+the |n|-mers are the connected sets of |n| fragments plus any group of fewer
+than |n| close fragments which is far from all other fragments. Close pairs of
+nuclei are found with a cell list and the connected sets are enumerated
+directly, so the cost is proportional to the number of |n|-mers rather than to
+the number of |n|-way combinations.
+
+If lattice vectors are also provided, the input is taken to be one unit cell of
+a periodic system and distances are minimum-image distances. The threshold must
+then be at most half of the narrowest width of the cell.
+
+Threading
+---------
+
+Forming the unions and removing those which are subsets of other unions is
+split over threads. Each thread collects its unions in its own list, and the
+lists are merged, sorted and deduplicated afterwards, so the |n|-mers do not
+depend on the number of threads.
+)";
+
+const auto threshold_desc = R"(
+Fragments further apart than this distance (in Bohr) are never in the same
+n-mer. The default performs no screening.
 )";
 
 MODULE_CTOR(NMers) {
     description(mod_desc);
     satisfies_property_type<my_pt>();
+    satisfies_property_type<nmers_pt>();
 
     add_input<n_type>("n")
       .set_description("The maximum n-mer size")
       .set_default(n_type(1));
+    add_input<double>("distance threshold")
+      .set_description(threshold_desc)
+      .set_default(std::numeric_limits<double>::max());
+    add_input<std::vector<double>>(topology::lattice_key)
+      .set_description(topology::lattice_desc)
+      .set_default(std::vector<double>{});
+    add_input<std::size_t>("nthreads")
+      .set_description("Threads to use (0 for all hardware threads)")
+      .set_default(std::size_t{0});
     add_submodule<my_pt>("Monomer maker");
 }
 
@@ -56,6 +261,12 @@ MODULE_RUN(NMers) {
 
     const auto& [graph] = my_pt::unwrap_inputs(inputs);
     auto n              = inputs.at("n").value<n_type>();
+    auto threshold      = inputs.at("distance threshold").value<double>();
+    auto lattice =
+      inputs.at(topology::lattice_key).value<std::vector<double>>();
+    const bool screen = threshold < std::numeric_limits<double>::max();
+    auto nthreads     = inputs.at("nthreads").value<std::size_t>();
+    if(nthreads == 0) nthreads = utilities::default_nthreads();
 
     auto nmer_str = std::to_string(n) + "-mers";
     logger.debug("Will be making " + nmer_str + ".");
@@ -73,50 +284,135 @@ MODULE_RUN(NMers) {
     // Initialize nmer container and container of fragment indices
     nmers_type nmers(frags.supersystem().as_nuclei());
 
-    std::vector<decltype(n_frags)> frag_indices(n_frags);
-    std::iota(frag_indices.begin(), frag_indices.end(), 0);
-
-    // Use a set of sets to avoid copies
-    using index_set_type     = std::set<index_type>;
-    using index_set_set_type = std::set<index_set_type>;
+    // The unions are collected in a list, which is sorted and deduplicated
+    // once they have all been found
+    using index_set_type      = utilities::IndexSet;
+    using index_set_list_type = std::vector<index_set_type>;
 
-    index_set_set_type nmer_indices;
+    index_set_list_type nmer_indices;
 
-    // Make the mmers
-    for(auto&& mmer : iter::combinations(frag_indices, n)) {
+    auto mmer_nuclei = [&](auto&& mmer) {
         index_set_type nuclear_indices;
         for(auto&& frag_index : mmer) {
             auto buffer = frags.nuclear_indices(frag_index);
             nuclear_indices.insert(buffer.begin(), buffer.end());
         }
-        nmer_indices.insert(nuclear_indices);
+        return nuclear_indices;
+    };
+
+    // Each chunk collects its unions in its own list, merged in chunk order
+    std::vector<index_set_list_type> found;
+    auto merge_found = [&]() {
+        for(auto& found_i : found)
+            for(auto& nmer : found_i) nmer_indices.push_back(std::move(nmer));
+    };
+
+    if(screen) {
+        const auto adj = monomer_adjacency(frags, threshold, lattice);
+        found.resize(std::max<std::size_t>(1, std::min(nthreads, n_frags)));
+        utilities::parallel_for_chunks(
+          n_frags, found.size(),
+          [&](std::size_t chunk, std::size_t begin, std::size_t end) {
+              auto& found_i = found[chunk];
+              ConnectedSets(adj, n).for_each(begin, end, [&](auto&& mmer) {
+                  found_i.push_back(mmer_nuclei(mmer));
+              });
+          });
+        merge_found();
+        for(const auto& component : small_components(adj, n))
+            nmer_indices.push_back(mmer_nuclei(component));
+    } else if(n < 2) {
+        std::vector<decltype(n_frags)> frag_indices(n_frags);
+        std::iota(frag_indices.begin(), frag_indices.end(), 0);
+
+        // Make the mmers
+        for(auto&& mmer : iter::combinations(frag_indices, n))
+            nmer_indices.push_back(mmer_nuclei(mmer));
+    } else {
+        // The combinations are split by their first (i.e., smallest)
+        // fragment; there are C(n_frags - 1 - i, n - 1) starting with i
+        std::vector<double> work(n_frags);
+        for(size_type i = 0; i < n_frags; ++i)
+            work[i] = double(utilities::binomial(n_frags - 1 - i, n - 1));
+        const auto bounds = utilities::weighted_chunk_bounds(work, nthreads);
+        found.resize(bounds.size() - 1);
+
+        utilities::parallel_for_chunks(
+          found.size(), found.size(),
+          [&](std::size_t chunk, std::size_t, std::size_t) {
+              auto& found_i = found[chunk];
+              std::vector<size_type> mmer(n);
+              for(auto i = bounds[chunk]; i < bounds[chunk + 1]; ++i) {
+                  std::vector<size_type> rest(n_frags - 1 - i);
+                  std::iota(rest.begin(), rest.end(), i + 1);
+
+                  // Make the mmers starting with i
+                  mmer[0] = i;
+                  for(auto&& tail : iter::combinations(rest, n - 1)) {
+                      std::copy(tail.begin(), tail.end(), mmer.begin() + 1);
+                      found_i.push_back(mmer_nuclei(mmer));
+                  }
+              }
+          });
+        merge_found();
+    }
+
+    // Same order as a std::set of the unions
+    std::sort(nmer_indices.begin(), nmer_indices.end());
+    nmer_indices.erase(std::unique(nmer_indices.begin(), nmer_indices.end()),
+                       nmer_indices.end());
+    if(screen)
+        logger.debug("Screening kept " + std::to_string(nmer_indices.size()) +
+                     " " + nmer_str + ".");
+
+    // For disjoint fragments no screened n-mer is a subset of another one:
+    // different sets of fragments cover different nuclei and the small
+    // components are not contained in any connected set. Skipping the
+    // quadratic check below keeps the cost linear in the number of n-mers.
+    if(screen && are_disjoint(frags)) {
+        for(const auto& nmer : nmer_indices)
+            nmers.insert(nmer.begin(), nmer.end());
+        logger.debug("Made " + std::to_string(nmers.size()) + " " + nmer_str +
+                     ".");
+        auto rv = results();
+        return my_pt::wrap_results(rv, nmers);
     }
 
     // This block ensures we only add non subsets
+    const auto n_candidates = nmer_indices.size();
+
+    // Element i is only written by the chunk containing i (hence char, not
+    // bool, which would pack several elements into one byte)
+    std::vector<char> i_is_good(n_candidates, true);
 
-    // This is used to avoid comparing against sets we know are subsets already
-    std::vector<bool> i_is_good(nmer_indices.size(), true);
-
-    for(const auto&& [i, nmer_i] : iter::enumerate(nmer_indices)) {
-        // N.b. "x is not a subset of y" does NOT mean that
-        // "y is not a subset of x", i.e., this loop must always consider the
-        // full range.
-        for(const auto&& [j, nmer_j] : iter::enumerate(nmer_indices)) {
-            // Every set is a subset of itself, so skip i == j, also skip j if
-            // we already know it's a subset of something else (i.e., if i was
-            // going to be a subset of j, and j is a subset of say x, then i
-            // is also going to be a subset of x)
-            if(i == j || !i_is_good[j]) continue;
-
-            // Checks if nmer_i is a subset of nmer_j
-            if(std::includes(nmer_j.begin(), nmer_j.end(), nmer_i.begin(),
-                             nmer_i.end())) {
-                i_is_good[i] = false;
-                break; // Early out b/c it's a subset
+    auto find_good = [&](std::size_t, std::size_t begin, std::size_t end) {
+        for(auto i = begin; i < end; ++i) {
+            const auto& nmer_i = nmer_indices[i];
+            // N.b. "x is not a subset of y" does NOT mean that
+            // "y is not a subset of x", i.e., this loop must always consider
+            // the full range.
+            for(std::size_t j = 0; j < n_candidates; ++j) {
+                // Every set is a subset of itself, so skip i == j, also skip
+                // j if this chunk already knows it's a subset of something
+                // else (i.e., if i was going to be a subset of j, and j is a
+                // subset of say x, then i is also going to be a subset of x)
+                const bool known_subset = begin <= j && j < i && !i_is_good[j];
+                if(i == j || known_subset) continue;
+
+                // Checks if nmer_i is a subset of nmer_j
+                const auto& nmer_j = nmer_indices[j];
+                if(utilities::includes(nmer_j, nmer_i)) {
+                    i_is_good[i] = false;
+                    break; // Early out b/c it's a subset
+                }
             }
         }
-        if(i_is_good[i]) nmers.insert(nmer_i.begin(), nmer_i.end());
-    }
+    };
+    utilities::parallel_for_chunks(n_candidates, nthreads, find_good);
+
+    for(std::size_t i = 0; i < n_candidates; ++i)
+        if(i_is_good[i])
+            nmers.insert(nmer_indices[i].begin(), nmer_indices[i].end());
     logger.debug("Made " + std::to_string(nmers.size()) + " " + nmer_str + ".");
     auto rv = results();
     return my_pt::wrap_results(rv, nmers);
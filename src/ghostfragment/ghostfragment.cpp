@@ -14,9 +14,12 @@
  * limitations under the License.
  */
 
+#include "archive/archive.hpp"
+#include "caching/caching.hpp"
 #include "capping/capping.hpp"
 #include "drivers/drivers.hpp"
 #include "fragmenting/fragmenting.hpp"
+#include "io/io.hpp"
 #include "screening/screening.hpp"
 #include "topology/topology.hpp"
 #include <ghostfragment/load_modules.hpp>
@@ -28,12 +31,17 @@ void load_modules(pluginplay::ModuleManager& mm) {
     topology::load_modules(mm);
     drivers::load_modules(mm);
     fragmenting::load_modules(mm);
+    caching::load_modules(mm);
+    archive::load_modules(mm);
+    io::load_modules(mm);
     // screening::load_modules(mm);
 
     capping::set_defaults(mm);
     topology::set_defaults(mm);
     drivers::set_defaults(mm);
     fragmenting::set_defaults(mm);
+    caching::set_defaults(mm);
+    archive::set_defaults(mm);
     // screening::set_defaults(mm);
 }
 
@@ -0,0 +1,107 @@
+/*
+ * Copyright 2024 GhostFragment
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include <array>
+#include <cctype>
+#include <cstddef>
+#include <string_view>
+
+namespace ghostfragment::io {
+
+/// The number of elements known to element_symbol, atomic_number, etc.
+inline constexpr std::size_t n_elements = 118;
+
+/// Converts masses from daltons to atomic units (electron masses)
+inline constexpr double dalton_to_au = 1822.888486209;
+
+/// Converts lengths from angstroms to atomic units (bohr)
+inline constexpr double angstrom_to_bohr = 1.8897261246257702;
+
+/** @brief Returns the symbol of the specified element.
+ *
+ *  @param[in] z The atomic number of the element. @p z is 1-based and must be
+ *               in the range [1, n_elements].
+ *
+ *  @return The symbol, e.g., "He" for @p z = 2.
+ */
+inline std::string_view element_symbol(std::size_t z) {
+    static constexpr std::array<std::string_view, n_elements> symbols{
+      "H",  "He", "Li", "Be", "B",  "C",  "N",  "O",  "F",  "Ne", "Na", "Mg",
+      "Al", "Si", "P",  "S",  "Cl", "Ar", "K",  "Ca", "Sc", "Ti", "V",  "Cr",
+      "Mn", "Fe", "Co", "Ni", "Cu", "Zn", "Ga", "Ge", "As", "Se", "Br", "Kr",
+      "Rb", "Sr", "Y",  "Zr", "Nb", "Mo", "Tc", "Ru", "Rh", "Pd", "Ag", "Cd",
+      "In", "Sn", "Sb", "Te", "I",  "Xe", "Cs", "Ba", "La", "Ce", "Pr", "Nd",
+      "Pm", "Sm", "Eu", "Gd", "Tb", "Dy", "Ho", "Er", "Tm", "Yb", "Lu", "Hf",
+      "Ta", "W",  "Re", "Os", "Ir", "Pt", "Au", "Hg", "Tl", "Pb", "Bi", "Po",
+      "At", "Rn", "Fr", "Ra", "Ac", "Th", "Pa", "U",  "Np", "Pu", "Am", "Cm",
+      "Bk", "Cf", "Es", "Fm", "Md", "No", "Lr", "Rf", "Db", "Sg", "Bh", "Hs",
+      "Mt", "Ds", "Rg", "Cn", "Nh", "Fl", "Mc", "Lv", "Ts", "Og"};
+    return symbols[z - 1];
+}
+
+/** @brief Returns the atomic number of the element with symbol @p symbol.
+ *
+ *  The comparison ignores case, so "CL", "cl", and "Cl" are all chlorine.
+ *
+ *  @return The atomic number, or 0 if @p symbol is not an element symbol.
+ */
+inline std::size_t atomic_number(std::string_view symbol) noexcept {
+    auto lower = [](char c) {
+        return std::tolower(static_cast<unsigned char>(c));
+    };
+    for(std::size_t z = 1; z <= n_elements; ++z) {
+        const auto symbol_z = element_symbol(z);
+        if(symbol_z.size() != symbol.size()) continue;
+        bool same = true;
+        for(std::size_t i = 0; same && i < symbol.size(); ++i)
+            same = lower(symbol[i]) == lower(symbol_z[i]);
+        if(same) return z;
+    }
+    return 0;
+}
+
+/** @brief Returns the mass (in atomic units) of the specified element.
+ *
+ *  The masses are the IUPAC standard atomic weights (conventional values for
+ *  elements with an interval). For elements without a standard atomic weight
+ *  the mass number of the longest-lived isotope is used.
+ *
+ *  @param[in] z The atomic number of the element, in the range
+ *               [1, n_elements].
+ */
+inline double atomic_mass(std::size_t z) {
+    /// Standard atomic weights in daltons
+    static constexpr std::array<double, n_elements> masses{
+      1.008, 4.002602, 6.94, 9.0121831, 10.81, 12.011, 14.007, 15.999,
+      18.998403163, 20.1797, 22.98976928, 24.305, 26.9815385, 28.085,
+      30.973761998, 32.06, 35.45, 39.948, 39.0983, 40.078, 44.955908, 47.867,
+      50.9415, 51.9961, 54.938044, 55.845, 58.933194, 58.6934, 63.546, 65.38,
+      69.723, 72.630, 74.921595, 78.971, 79.904, 83.798, 85.4678, 87.62,
+      88.90584, 91.224, 92.90637, 95.95, 98.0, 101.07, 102.90550, 106.42,
+      107.8682, 112.414, 114.818, 118.710, 121.760, 127.60, 126.90447, 131.293,
+      132.90545196, 137.327, 138.90547, 140.116, 140.90766, 144.242, 145.0,
+      150.36, 151.964, 157.25, 158.92535, 162.500, 164.93033, 167.259,
+      168.93422, 173.045, 174.9668, 178.49, 180.94788, 183.84, 186.207, 190.23,
+      192.217, 195.084, 196.966569, 200.592, 204.38, 207.2, 208.98040, 209.0,
+      210.0, 222.0, 223.0, 226.0, 227.0, 232.0377, 231.03588, 238.02891, 237.0,
+      244.0, 243.0, 247.0, 247.0, 251.0, 252.0, 257.0, 258.0, 259.0, 266.0,
+      267.0, 268.0, 269.0, 270.0, 269.0, 278.0, 281.0, 282.0, 285.0, 286.0,
+      289.0, 290.0, 293.0, 294.0, 294.0};
+    return masses[z - 1] * dalton_to_au;
+}
+
+} // namespace ghostfragment::io
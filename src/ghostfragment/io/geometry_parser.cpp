@@ -0,0 +1,216 @@
+/*
+ * Copyright 2024 GhostFragment
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../utilities/parallel_for.hpp"
+#include "elements.hpp"
+#include "geometry_parser.hpp"
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <exception>
+#include <stdexcept>
+#include <string>
+
+namespace ghostfragment::io {
+namespace {
+
+// Returns the line starting at pos (without its "\n" or "\r\n") and moves pos
+// to the start of the next line
+std::string_view next_line(std::string_view text, std::size_t& pos) {
+    const auto begin = pos;
+    auto end         = text.find('\n', begin);
+    if(end == std::string_view::npos) end = text.size();
+    pos       = std::min(end + 1, text.size());
+    auto line = text.substr(begin, end - begin);
+    if(!line.empty() && line.back() == '\r') line.remove_suffix(1);
+    return line;
+}
+
+bool is_space(char c) { return std::isspace(static_cast<unsigned char>(c)); }
+
+// Removes leading and trailing whitespace
+std::string_view trim(std::string_view s) {
+    while(!s.empty() && is_space(s.front())) s.remove_prefix(1);
+    while(!s.empty() && is_space(s.back())) s.remove_suffix(1);
+    return s;
+}
+
+// Returns the next whitespace-delimited token of line, starting at pos
+std::string_view next_token(std::string_view line, std::size_t& pos) {
+    while(pos < line.size() && is_space(line[pos])) ++pos;
+    const auto begin = pos;
+    while(pos < line.size() && !is_space(line[pos])) ++pos;
+    return line.substr(begin, pos - begin);
+}
+
+// Parses all of s (ignoring surrounding whitespace) as a T
+template<typename T>
+bool parse_number(std::string_view s, T& value) {
+    s = trim(s);
+    if(!s.empty() && s.front() == '+') s.remove_prefix(1);
+    const auto end = s.data() + s.size();
+    auto [ptr, ec] = std::from_chars(s.data(), end, value);
+    return ec == std::errc() && ptr == end && !s.empty();
+}
+
+[[noreturn]] void bad_line(std::string_view what, std::string_view line) {
+    throw std::runtime_error(std::string(what) + ": '" + std::string(line) +
+                             "'");
+}
+
+// Returns the atomic number of an element given by symbol or atomic number
+std::size_t parse_element(std::string_view element, std::string_view line) {
+    std::size_t Z = 0;
+    if(!parse_number(element, Z)) Z = atomic_number(element);
+    if(Z == 0 || Z > n_elements) bad_line("Unknown element", line);
+    return Z;
+}
+
+// Splits text into nchunks pieces which start at the beginning of lines
+std::vector<std::size_t> line_aligned_chunks(std::string_view text,
+                                             std::size_t nchunks) {
+    std::vector<std::size_t> bounds{0};
+    for(std::size_t i = 1; i < nchunks; ++i) {
+        auto pos = std::max(bounds.back(), i * text.size() / nchunks);
+        if(pos > 0 && pos < text.size() && text[pos - 1] != '\n') {
+            pos = text.find('\n', pos);
+            pos = pos == std::string_view::npos ? text.size() : pos + 1;
+        }
+        bounds.push_back(pos);
+    }
+    bounds.push_back(text.size());
+    return bounds;
+}
+
+// Parses an atom line of an XYZ file
+void parse_xyz_line(std::string_view line, ParsedGeometry& geom) {
+    std::size_t pos = 0;
+    const auto Z    = parse_element(next_token(line, pos), line);
+    double r[3];
+    for(auto& q : r)
+        if(!parse_number(next_token(line, pos), q))
+            bad_line("Could not parse XYZ coordinates", line);
+    geom.push_back(Z, r[0] * angstrom_to_bohr, r[1] * angstrom_to_bohr,
+                   r[2] * angstrom_to_bohr);
+}
+
+// Columns 13-14 of an atom name hold the element, right justified
+std::string_view element_from_atom_name(std::string_view line) {
+    const auto name = line.substr(12, 2);
+    auto is_alpha   = [](char c) {
+        return std::isalpha(static_cast<unsigned char>(c));
+    };
+    if(!is_alpha(name[0])) return trim(name.substr(1));
+    if(!is_alpha(name[1])) return name.substr(0, 1);
+    return name;
+}
+
+// Parses an ATOM or HETATM record of a PDB file
+void parse_pdb_line(std::string_view line, ParsedGeometry& geom) {
+    if(line.size() < 54) bad_line("PDB atom record is too short", line);
+
+    std::string_view element;
+    if(line.size() >= 78) element = trim(line.substr(76, 2));
+    if(element.empty()) element = element_from_atom_name(line);
+    const auto Z = parse_element(element, line);
+
+    double r[3];
+    for(std::size_t q = 0; q < 3; ++q)
+        if(!parse_number(line.substr(30 + 8 * q, 8), r[q]))
+            bad_line("Could not parse PDB coordinates", line);
+    geom.push_back(Z, r[0] * angstrom_to_bohr, r[1] * angstrom_to_bohr,
+                   r[2] * angstrom_to_bohr);
+}
+
+// The record name of a PDB line (columns 1-6, trimmed)
+std::string_view record_name(std::string_view line) {
+    return trim(line.substr(0, 6));
+}
+
+} // namespace
+
+ParsedGeometry parse_xyz(std::string_view text, std::size_t nthreads) {
+    std::size_t pos   = 0;
+    const auto header = next_line(text, pos);
+    std::size_t natoms;
+    if(!parse_number(header, natoms))
+        bad_line("The first line of an XYZ file must be the number of atoms",
+                 header);
+    next_line(text, pos); // Comment line
+
+    // Find the end of the first frame. This is a sequential, but cheap, scan
+    const auto body_begin = pos;
+    for(std::size_t i = 0; i < natoms; ++i) {
+        if(pos == text.size())
+            throw std::runtime_error("XYZ file has " + std::to_string(i) +
+                                     " atoms, but its header says " +
+                                     std::to_string(natoms));
+        next_line(text, pos);
+    }
+    const auto body = text.substr(body_begin, pos - body_begin);
+
+    const auto bounds  = line_aligned_chunks(body, nthreads);
+    const auto nchunks = bounds.size() - 1;
+    std::vector<ParsedGeometry> chunks(nchunks);
+    utilities::parallel_for_chunks(
+      nchunks, nchunks, [&](std::size_t k, std::size_t, std::size_t) {
+          const auto chunk = body.substr(bounds[k], bounds[k + 1] - bounds[k]);
+          std::size_t chunk_pos = 0;
+          while(chunk_pos < chunk.size())
+              parse_xyz_line(next_line(chunk, chunk_pos), chunks[k]);
+      });
+
+    ParsedGeometry rv;
+    for(const auto& chunk : chunks) rv.append(chunk);
+    return rv;
+}
+
+ParsedGeometry parse_pdb(std::string_view text, std::size_t nthreads) {
+    const auto bounds  = line_aligned_chunks(text, nthreads);
+    const auto nchunks = bounds.size() - 1;
+    std::vector<ParsedGeometry> chunks(nchunks);
+    std::vector<char> ended(nchunks, false);
+
+    // Errors are deferred; they only matter if they precede the first END
+    std::vector<std::exception_ptr> errors(nchunks);
+    utilities::parallel_for_chunks(
+      nchunks, nchunks, [&](std::size_t k, std::size_t, std::size_t) {
+          const auto chunk = text.substr(bounds[k], bounds[k + 1] - bounds[k]);
+          std::size_t pos  = 0;
+          try {
+              while(pos < chunk.size()) {
+                  const auto line   = next_line(chunk, pos);
+                  const auto record = record_name(line);
+                  if(record == "ATOM" || record == "HETATM")
+                      parse_pdb_line(line, chunks[k]);
+                  else if(record == "END" || record == "ENDMDL") {
+                      ended[k] = true;
+                      break;
+                  }
+              }
+          } catch(...) { errors[k] = std::current_exception(); }
+      });
+
+    ParsedGeometry rv;
+    for(std::size_t k = 0; k < nchunks; ++k) {
+        if(errors[k]) std::rethrow_exception(errors[k]);
+        rv.append(chunks[k]);
+        if(ended[k]) break;
+    }
+    return rv;
+}
+
+} // namespace ghostfragment::io
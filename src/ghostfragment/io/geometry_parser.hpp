@@ -0,0 +1,98 @@
+/*
+ * Copyright 2024 GhostFragment
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include <cstddef>
+#include <string_view>
+#include <vector>
+
+namespace ghostfragment::io {
+
+/// Nuclei read from a geometry file, stored as flat arrays
+struct ParsedGeometry {
+    /// Atomic number of each nucleus
+    std::vector<std::size_t> Z;
+
+    /// Coordinates (in bohr) of each nucleus
+    ///@{
+    std::vector<double> x;
+    std::vector<double> y;
+    std::vector<double> z;
+    ///@}
+
+    /// The number of nuclei
+    std::size_t size() const noexcept { return Z.size(); }
+
+    /// Adds a nucleus with atomic number @p Zi at (@p xi, @p yi, @p zi)
+    void push_back(std::size_t Zi, double xi, double yi, double zi) {
+        Z.push_back(Zi);
+        x.push_back(xi);
+        y.push_back(yi);
+        z.push_back(zi);
+    }
+
+    /// Adds the nuclei in @p other after the nuclei in *this
+    void append(const ParsedGeometry& other) {
+        Z.insert(Z.end(), other.Z.begin(), other.Z.end());
+        x.insert(x.end(), other.x.begin(), other.x.end());
+        y.insert(y.end(), other.y.begin(), other.y.end());
+        z.insert(z.end(), other.z.begin(), other.z.end());
+    }
+};
+
+/** @brief Parses the first frame of an XYZ file.
+ *
+ *  The first line is the number of atoms, the second line is a comment, and
+ *  each of the following lines is an element (symbol or atomic number) and
+ *  the x, y, and z coordinates in angstroms. Anything after the z coordinate
+ *  is ignored, as are lines after the first frame.
+ *
+ *  After the lines of the first frame are found, they are split into
+ *  @p nthreads chunks which are parsed concurrently. The result does not
+ *  depend on @p nthreads.
+ *
+ *  @param[in] text The contents of the file.
+ *  @param[in] nthreads How many threads to parse with.
+ *
+ *  @return The nuclei, in the order they appear in the file, with
+ *          coordinates converted to bohr.
+ *
+ *  @throw std::runtime_error if the file is not a valid XYZ file.
+ */
+ParsedGeometry parse_xyz(std::string_view text, std::size_t nthreads);
+
+/** @brief Parses the ATOM and HETATM records of the first model of a PDB
+ *         file.
+ *
+ *  Coordinates are read from columns 31-54 and the element from columns
+ *  77-78. If the element columns are blank, the element is taken from the
+ *  atom name (columns 13-14, right justified, as in the PDB format). Records
+ *  after the first END or ENDMDL record are ignored.
+ *
+ *  The file is split into @p nthreads chunks (at line boundaries) which are
+ *  parsed concurrently. The result does not depend on @p nthreads.
+ *
+ *  @param[in] text The contents of the file.
+ *  @param[in] nthreads How many threads to parse with.
+ *
+ *  @return The nuclei, in the order they appear in the file, with
+ *          coordinates converted to bohr.
+ *
+ *  @throw std::runtime_error if an ATOM or HETATM record can not be parsed.
+ */
+ParsedGeometry parse_pdb(std::string_view text, std::size_t nthreads);
+
+} // namespace ghostfragment::io
@@ -0,0 +1,111 @@
+/*
+ * Copyright 2024 GhostFragment
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../utilities/mapped_file.hpp"
+#include "../utilities/parallel_for.hpp"
+#include "elements.hpp"
+#include "geometry_parser.hpp"
+#include "io.hpp"
+#include <cctype>
+#include <filesystem>
+#include <ghostfragment/property_types/io/chemical_system_from_file.hpp>
+
+namespace ghostfragment::io {
+
+using my_pt         = pt::ChemicalSystemFromFile;
+using result_type   = typename pt::ChemicalSystemFromFileTraits::result_type;
+using molecule_type = chemist::Molecule;
+using atom_type     = typename molecule_type::atom_type;
+
+namespace {
+const auto mod_desc = R"(
+Geometry Reader
+---------------
+
+Creates a ChemicalSystem from an XYZ or PDB file. The file is memory mapped
+and split into chunks (at line boundaries) which are parsed concurrently, so
+that reading very large systems is limited by I/O rather than by parsing.
+
+Coordinates in the file are taken to be in angstroms and are converted to bohr.
+Masses are the standard atomic weights (in atomic units). For PDB files only
+the ATOM and HETATM records of the first model are read; for XYZ files only
+the first frame is read.
+
+The format is given by the "format" input; "auto" picks it from the file
+extension (".xyz" or ".pdb", ignoring case).
+)";
+
+// Resolves the "format" input for the file at path
+std::string file_format(std::string format, const std::string& path) {
+    if(format == "auto") {
+        format = std::filesystem::path(path).extension().string();
+        if(!format.empty()) format.erase(0, 1); // Drop the "."
+    }
+    for(auto& c : format) c = std::tolower(static_cast<unsigned char>(c));
+    if(format == "xyz" || format == "pdb") return format;
+    throw std::runtime_error("Can not determine the format of " + path +
+                             ". Set the \"format\" input to xyz or pdb.");
+}
+
+} // namespace
+
+MODULE_CTOR(GeometryReader) {
+    description(mod_desc);
+    satisfies_property_type<my_pt>();
+
+    add_input<std::string>("format")
+      .set_description("File format: xyz, pdb, or auto")
+      .set_default(std::string("auto"));
+    add_input<std::size_t>("nthreads")
+      .set_description("Threads to parse with (0 for all hardware threads)")
+      .set_default(std::size_t(0));
+    add_input<int>("charge")
+      .set_description("Total charge of the system")
+      .set_default(0);
+    add_input<std::size_t>("multiplicity")
+      .set_description("Spin multiplicity of the system")
+      .set_default(std::size_t(1));
+}
+
+MODULE_RUN(GeometryReader) {
+    auto& logger       = get_runtime().logger();
+    const auto& [path] = my_pt::unwrap_inputs(inputs);
+    const auto format =
+      file_format(inputs.at("format").value<std::string>(), path);
+    auto nthreads = inputs.at("nthreads").value<std::size_t>();
+    if(nthreads == 0) nthreads = utilities::default_nthreads();
+
+    const utilities::MappedFile file(path);
+    const auto geom = format == "xyz" ? parse_xyz(file.view(), nthreads) :
+                                        parse_pdb(file.view(), nthreads);
+    logger.debug("Read " + std::to_string(geom.size()) + " atoms from " +
+                 path + ".");
+
+    molecule_type mol;
+    for(std::size_t i = 0; i < geom.size(); ++i) {
+        const auto Z = geom.Z[i];
+        mol.push_back(atom_type(std::string(element_symbol(Z)), Z,
+                                atomic_mass(Z), geom.x[i], geom.y[i],
+                                geom.z[i]));
+    }
+    mol.set_charge(inputs.at("charge").value<int>());
+    mol.set_multiplicity(inputs.at("multiplicity").value<std::size_t>());
+
+    auto rv = results();
+    return my_pt::wrap_results(rv, result_type(std::move(mol)));
+}
+
+} // namespace ghostfragment::io
@@ -43,7 +43,8 @@ namespace {
 
 template<typename... Args>
 auto make_pimpl(Args&&... args) {
-    return std::make_unique<NuclearGraphPIMPL>(std::forward<Args>(args)...);
+    return std::make_shared<const NuclearGraphPIMPL>(
+      std::forward<Args>(args)...);
 }
 
 } // namespace
@@ -59,13 +60,13 @@ NuclearGraph::NuclearGraph() noexcept = default;
 NuclearGraph::NuclearGraph(fragmented_nuclei nodes, connectivity_type edges) :
   m_pimpl_(detail_::make_pimpl(std::move(nodes), std::move(edges))) {}
 
-NuclearGraph::NuclearGraph(const NuclearGraph& other) :
-  m_pimpl_(other.m_pimpl_ ? detail_::make_pimpl(*other.m_pimpl_) : nullptr) {}
+NuclearGraph::NuclearGraph(const NuclearGraph& other) noexcept :
+  m_pimpl_(other.m_pimpl_) {}
 
 NuclearGraph::NuclearGraph(NuclearGraph&& other) noexcept = default;
 
-NuclearGraph& NuclearGraph::operator=(const NuclearGraph& rhs) {
-    if(this != &rhs) NuclearGraph(rhs).swap(*this);
+NuclearGraph& NuclearGraph::operator=(const NuclearGraph& rhs) noexcept {
+    m_pimpl_ = rhs.m_pimpl_;
     return *this;
 }
 
@@ -126,6 +127,7 @@ void NuclearGraph::swap(NuclearGraph& other) noexcept {
 }
 
 bool NuclearGraph::operator==(const NuclearGraph& rhs) const noexcept {
+    if(m_pimpl_ == rhs.m_pimpl_) return true; // Same (or no) state
     if(m_pimpl_ && rhs.m_pimpl_)
         return *m_pimpl_ == *rhs.m_pimpl_;
     else if(!m_pimpl_ && !rhs.m_pimpl_)
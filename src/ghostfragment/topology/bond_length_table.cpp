@@ -0,0 +1,109 @@
+/*
+ * Copyright 2024 GhostFragment
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "bond_length_table.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+
+namespace ghostfragment::topology {
+
+BondLengthTable::BondLengthTable(const NucleiSnapshot& snapshot,
+                                 const connectivity_type& conns) {
+    tabulate_(snapshot, conns, nullptr);
+}
+
+BondLengthTable::BondLengthTable(const NucleiSnapshot& snapshot,
+                                 const connectivity_type& conns,
+                                 const UnitCell& cell) {
+    tabulate_(snapshot, conns, &cell);
+}
+
+void BondLengthTable::tabulate_(const NucleiSnapshot& snapshot,
+                                const connectivity_type& conns,
+                                const UnitCell* cell) {
+    const auto& Z = snapshot.Z();
+    auto length   = [&](size_type i, size_type j) {
+        if(cell == nullptr) return snapshot.distance(i, j);
+        auto dx = snapshot.x()[j] - snapshot.x()[i];
+        auto dy = snapshot.y()[j] - snapshot.y()[i];
+        auto dz = snapshot.z()[j] - snapshot.z()[i];
+        cell->minimum_image(dx, dy, dz);
+        return std::sqrt(dx * dx + dy * dy + dz * dz);
+    };
+
+    // Elements without a covalent radius have no typical bond length
+    for(const auto z : Z)
+        if(z < 1 || z > max_covalent_radius_z)
+            throw std::runtime_error("No covalent radius for atomic number " +
+                                     std::to_string(z));
+
+    // Assign each element present a kind, in order of first appearance
+    const auto max_z = Z.empty() ? 0 : *std::max_element(Z.begin(), Z.end());
+    std::vector<size_type> z2kind(max_z + 1, no_kind_);
+    size_type nkinds = 0;
+    for(const auto z : Z)
+        if(z2kind[z] == no_kind_) z2kind[z] = nkinds++;
+
+    std::vector<distance_type> sums(nkinds * nkinds, 0.0);
+    std::vector<size_type> counts(nkinds * nkinds, 0);
+
+    // Each bond contributes to both the i-j and the j-i entries
+    for(const auto& [i, j] : conns.bonds()) {
+        const auto rij = length(i, j);
+        const auto ki  = z2kind[Z[i]];
+        const auto kj  = z2kind[Z[j]];
+        sums[ki * nkinds + kj] += rij;
+        counts[ki * nkinds + kj] += 1;
+        if(ki == kj) continue;
+        sums[kj * nkinds + ki] += rij;
+        counts[kj * nkinds + ki] += 1;
+    }
+
+    m_z2kind_.swap(z2kind);
+    m_nkinds_ = nkinds;
+    m_sums_.swap(sums);
+    m_counts_.swap(counts);
+}
+
+BondLengthTable::size_type BondLengthTable::count(
+  atomic_number_type zi, atomic_number_type zj) const noexcept {
+    const auto ki = kind_(zi);
+    const auto kj = kind_(zj);
+    if(ki == no_kind_ || kj == no_kind_) return 0;
+    return m_counts_[ki * m_nkinds_ + kj];
+}
+
+BondLengthTable::distance_type BondLengthTable::average(
+  atomic_number_type zi, atomic_number_type zj) const noexcept {
+    const auto n = count(zi, zj);
+    if(n == 0) return radius_(zi) + radius_(zj);
+    return m_sums_[kind_(zi) * m_nkinds_ + kind_(zj)] / n;
+}
+
+BondLengthTable::distance_type BondLengthTable::radius_(
+  atomic_number_type z) noexcept {
+    if(z < 1 || z > max_covalent_radius_z) return 0.0;
+    return covalent_radius(z);
+}
+
+BondLengthTable::size_type BondLengthTable::kind_(
+  atomic_number_type z) const noexcept {
+    return z < m_z2kind_.size() ? m_z2kind_[z] : no_kind_;
+}
+
+} // namespace ghostfragment::topology
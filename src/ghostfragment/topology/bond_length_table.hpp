@@ -0,0 +1,133 @@
+/*
+ * Copyright 2024 GhostFragment
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include "nuclei_snapshot.hpp"
+#include "unit_cell.hpp"
+#include <chemist/topology/connectivity_table.hpp>
+#include <limits>
+#include <vector>
+
+namespace ghostfragment::topology {
+
+/** @brief Average bond length for each pair of elements in a system.
+ *
+ *  Capping methods such as DCLC place a cap at the average length of the
+ *  bonds, in the supersystem, between the anchor's element and the cap's
+ *  element. This class tabulates those averages for every pair of elements in
+ *  a single pass over the bonds of the system, so that each cap is then an
+ *  O(1) lookup.
+ */
+class BondLengthTable {
+public:
+    /// Type used for offsets and counting
+    using size_type = NucleiSnapshot::size_type;
+
+    /// Type of an atomic number
+    using atomic_number_type = NucleiSnapshot::atomic_number_type;
+
+    /// Type of a bond length
+    using distance_type = NucleiSnapshot::coord_type;
+
+    /// Type of the connectivity the table is built from
+    using connectivity_type = chemist::topology::ConnectivityTable;
+
+    /** @brief Tabulates the average bond lengths of a system.
+     *
+     *  @param[in] snapshot The geometry of the system.
+     *  @param[in] conns The bonds in the system. Offsets in @p conns are
+     *                   offsets into @p snapshot.
+     *
+     *  @throw std::runtime_error if @p snapshot contains an element without a
+     *                            covalent radius, *i.e.*, one whose atomic
+     *                            number is 0 or greater than
+     *                            max_covalent_radius_z. Strong throw
+     *                            guarantee.
+     *  @throw std::bad_alloc if allocating the table fails. Strong throw
+     *                        guarantee.
+     */
+    BondLengthTable(const NucleiSnapshot& snapshot,
+                    const connectivity_type& conns);
+
+    /** @brief Tabulates the average bond lengths of a periodic system.
+     *
+     *  Bond lengths are minimum-image distances, so bonds which cross a face
+     *  of @p cell count with their actual lengths.
+     *
+     *  @param[in] snapshot The nuclei in the unit cell.
+     *  @param[in] conns The bonds in the system, including those to periodic
+     *                   images. Offsets in @p conns are offsets into
+     *                   @p snapshot.
+     *  @param[in] cell The unit cell.
+     *
+     *  @throw std::runtime_error if @p snapshot contains an element without a
+     *                            covalent radius. Strong throw guarantee.
+     *  @throw std::bad_alloc if allocating the table fails. Strong throw
+     *                        guarantee.
+     */
+    BondLengthTable(const NucleiSnapshot& snapshot,
+                    const connectivity_type& conns, const UnitCell& cell);
+
+    /// The number of bonds between elements @p zi and @p zj
+    size_type count(atomic_number_type zi,
+                    atomic_number_type zj) const noexcept;
+
+    /** @brief The average length of the bonds between two elements.
+     *
+     *  If the system contains no bonds between @p zi and @p zj the typical
+     *  length, *i.e.*, the sum of the covalent radii, is returned instead.
+     *  Elements without a covalent radius (atomic number 0 or greater than
+     *  max_covalent_radius_z) can not be in the system, and contribute 0 to
+     *  the typical length.
+     *
+     *  @param[in] zi The atomic number of the first element.
+     *  @param[in] zj The atomic number of the second element.
+     *
+     *  @return The average (or typical) bond length in Bohr.
+     *
+     *  @throw None No throw guarantee.
+     */
+    distance_type average(atomic_number_type zi,
+                          atomic_number_type zj) const noexcept;
+
+private:
+    /// Value used to mark elements which are not in the system
+    static constexpr auto no_kind_ = std::numeric_limits<size_type>::max();
+
+    /// Fills in the table, using minimum-image distances if @p cell is set
+    void tabulate_(const NucleiSnapshot& snapshot,
+                   const connectivity_type& conns, const UnitCell* cell);
+
+    /// Covalent radius of @p z, or 0 if @p z has no tabulated radius
+    static distance_type radius_(atomic_number_type z) noexcept;
+
+    /// Offset of element @p z in the table, or no_kind_
+    size_type kind_(atomic_number_type z) const noexcept;
+
+    /// Maps atomic numbers to offsets in the table
+    std::vector<size_type> m_z2kind_;
+
+    /// The number of distinct elements in the system
+    size_type m_nkinds_ = 0;
+
+    /// Sum of the bond lengths for each pair of kinds
+    std::vector<distance_type> m_sums_;
+
+    /// Number of bonds for each pair of kinds
+    std::vector<size_type> m_counts_;
+};
+
+} // namespace ghostfragment::topology
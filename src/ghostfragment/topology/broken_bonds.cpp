@@ -14,11 +14,14 @@
  * limitations under the License.
  */
 
+#include "../utilities/parallel_for.hpp"
 #include "topology.hpp"
 #include <ghostfragment/property_types/topology/broken_bonds.hpp>
 #include <ghostfragment/property_types/topology/connectivity_table.hpp>
 #include <ghostfragment/property_types/topology/nuclear_graph.hpp>
+#include <algorithm>
 #include <simde/simde.hpp>
+#include <vector>
 
 namespace ghostfragment::topology {
 
@@ -32,11 +35,20 @@ Broken Bonds from Fragmented Nuclei
 This module takes as input a set of disjoint fragments and the connectivity of
 the supersystem. Using the connectivity of the supersystem it then determines
 the bonds that were broken in forming the fragments.
+
+The fragments are split over threads. Each thread records the broken bonds of
+its fragments in its own buffer, and the buffers are merged into the result
+afterwards, so the result does not depend on the number of threads.
 )";
 
+const auto nthreads_desc = "Threads to use (0 for all hardware threads)";
+
 MODULE_CTOR(BrokenBonds) {
     description(module_desc);
     satisfies_property_type<my_pt>();
+    add_input<std::size_t>("nthreads")
+      .set_description(nthreads_desc)
+      .set_default(std::size_t{0});
 }
 
 MODULE_RUN(BrokenBonds) {
@@ -52,60 +64,51 @@ MODULE_RUN(BrokenBonds) {
     logger.debug("Input: " + std::to_string(n_frags) + " fragments and " +
                  std::to_string(n_bonds) + " bonds.");
 
-    result_type bonds;
+    auto nthreads = inputs.at("nthreads").value<std::size_t>();
+    if(nthreads == 0) nthreads = utilities::default_nthreads();
 
-    // Looks at each fragment
-    for(std::size_t i = 0; i < frags.size(); i++) {
-        // The set of bonds for a specific fragment
-        const auto nukes = frags.nuclear_indices(i);
-
-        // Looks at each nucleus index within the fragment
-        for(const auto atom_i : nukes) {
-            // Checks to see if the index appears within any of the edges in the
-            // molecule graph
-            for(const auto existing_bonds : atom_conns.bonds()) {
-                // If the index is in the first, that means its pair is bigger
-                if(atom_i == existing_bonds[0]) {
-                    auto in_current_frag = false;
-
-                    // Checks to see if the pair is already in the fragment
-                    for(const auto atom_j : nukes) {
-                        if(atom_j == existing_bonds[1]) {
-                            in_current_frag = true;
-                            break;
-                        }
-                    }
-
-                    // If the pair is not already in the fragment,
-                    // then it is a broken bond and must be added to the set
-                    if(!in_current_frag) {
-                        bond_type broken(atom_i, existing_bonds[1]);
-                        bonds.insert(broken);
-                    }
-                }
+    const auto all_bonds = atom_conns.bonds();
+    const auto nchunks = std::max<std::size_t>(1, std::min(nthreads, n_frags));
+    std::vector<std::vector<bond_type>> buffers(nchunks);
 
-                // If the index is in the second, that means its pair is smaller
-                if(atom_i == existing_bonds[1]) {
-                    auto in_current_frag = false;
-
-                    // Checks to see if the pair is already in the fragment
-                    for(const auto atom_j : nukes) {
-                        if(atom_j == existing_bonds[0]) {
-                            in_current_frag = true;
-                            break;
-                        }
-                    }
-
-                    // If the pair is not already in the fragment,
-                    // then it is a broken bond and must be added to the set
-                    if(!in_current_frag) {
-                        bond_type broken(atom_i, existing_bonds[0]);
-                        bonds.insert(broken);
-                    }
+    // Looks at each fragment
+    auto find_broken = [&](std::size_t chunk, std::size_t begin,
+                           std::size_t end) {
+        auto& buffer = buffers[chunk];
+        for(std::size_t i = begin; i < end; i++) {
+            // The set of bonds for a specific fragment
+            const auto nukes = frags.nuclear_indices(i);
+
+            // Looks at each nucleus index within the fragment
+            for(const auto atom_i : nukes) {
+                // Checks to see if the index appears within any of the edges
+                // in the molecule graph
+                for(const auto& existing_bond : all_bonds) {
+                    // If the index is in the first, its pair is bigger. If it
+                    // is in the second, its pair is smaller.
+                    std::size_t atom_j;
+                    if(atom_i == existing_bond[0])
+                        atom_j = existing_bond[1];
+                    else if(atom_i == existing_bond[1])
+                        atom_j = existing_bond[0];
+                    else
+                        continue;
+
+                    // If the pair is not already in the fragment, then it is
+                    // a broken bond and must be added to the set
+                    const auto in_current_frag =
+                      std::find(nukes.begin(), nukes.end(), atom_j) !=
+                      nukes.end();
+                    if(!in_current_frag) buffer.emplace_back(atom_i, atom_j);
                 }
             }
         }
-    }
+    };
+    utilities::parallel_for_chunks(n_frags, nchunks, find_broken);
+
+    result_type bonds;
+    for(const auto& buffer : buffers)
+        bonds.insert(buffer.begin(), buffer.end());
 
     // Returning the results
     auto rv = results();
@@ -0,0 +1,107 @@
+/*
+ * Copyright 2024 GhostFragment
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "topology.hpp"
+#include <algorithm>
+#include <ghostfragment/property_types/topology/broken_bonds_by_fragment.hpp>
+
+namespace ghostfragment::topology {
+
+using my_pt       = pt::BrokenBondsByFragment;
+using traits_type = pt::BrokenBondsByFragmentTraits;
+
+const auto by_frag_desc = R"(
+Broken Bonds By Fragment
+------------------------
+
+This module takes as input a set of fragments and the connectivity of the
+supersystem. For each fragment it determines the bonds that were broken in
+forming that fragment, i.e., the bonds between an atom in the fragment (the
+anchor) and an atom not in the fragment (the replaced atom).
+
+The bonds are returned grouped by fragment in a compressed sparse row layout.
+The algorithm is O(number of atoms + number of bonds) for building the atomic
+adjacency list plus O(sum of the fragment sizes and their atoms' valences) for
+the fragments.
+)";
+
+MODULE_CTOR(BrokenBondsByFragment) {
+    description(by_frag_desc);
+    satisfies_property_type<my_pt>();
+}
+
+MODULE_RUN(BrokenBondsByFragment) {
+    using result_type      = traits_type::result_type;
+    using size_type        = typename result_type::size_type;
+    using offset_list_type = typename result_type::offset_list_type;
+    using bond_list_type   = typename result_type::bond_list_type;
+
+    const auto& [frags, atom_conns] = my_pt::unwrap_inputs(inputs);
+
+    const auto n_frags = frags.size();
+    const auto n_atoms = atom_conns.natoms();
+
+    // Step 1. Atomic adjacency list in CSR form (neighbors sorted ascending)
+    const auto bonds = atom_conns.bonds();
+    offset_list_type adj_offsets(n_atoms + 1, 0);
+    for(const auto& bond : bonds) {
+        ++adj_offsets[bond[0] + 1];
+        ++adj_offsets[bond[1] + 1];
+    }
+    for(size_type i = 0; i < n_atoms; ++i) adj_offsets[i + 1] += adj_offsets[i];
+
+    std::vector<size_type> neighbors(adj_offsets.back());
+    offset_list_type fill(adj_offsets.begin(), adj_offsets.end() - 1);
+    for(const auto& bond : bonds) {
+        neighbors[fill[bond[0]]++] = bond[1];
+        neighbors[fill[bond[1]]++] = bond[0];
+    }
+    for(size_type i = 0; i < n_atoms; ++i)
+        std::sort(neighbors.begin() + adj_offsets[i],
+                  neighbors.begin() + adj_offsets[i + 1]);
+
+    // Step 2. Per-fragment broken bonds. stamp[j] == i + 1 iff atom j is in
+    //         fragment i, so the mask never needs to be cleared.
+    std::vector<size_type> stamp(n_atoms, 0);
+    offset_list_type offsets(1, 0);
+    offsets.reserve(n_frags + 1);
+    bond_list_type broken;
+
+    for(size_type i = 0; i < n_frags; ++i) {
+        const auto nukes = frags.nuclear_indices(i);
+        for(const auto atom_j : nukes) stamp[atom_j] = i + 1;
+
+        const auto frag_begin = broken.size();
+        for(const auto anchor : nukes) {
+            const auto adj_begin = adj_offsets[anchor];
+            const auto adj_end   = adj_offsets[anchor + 1];
+            for(auto k = adj_begin; k < adj_end; ++k) {
+                const auto replaced = neighbors[k];
+                if(stamp[replaced] != i + 1)
+                    broken.emplace_back(anchor, replaced);
+            }
+        }
+        std::sort(broken.begin() + frag_begin, broken.end());
+        offsets.push_back(broken.size());
+    }
+
+    result_type by_frag(std::move(offsets), std::move(broken));
+
+    auto rv = results();
+    return my_pt::wrap_results(rv, std::move(by_frag));
+}
+
+} // namespace ghostfragment::topology
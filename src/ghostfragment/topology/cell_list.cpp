@@ -0,0 +1,153 @@
+/*
+ * Copyright 2024 GhostFragment
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "cell_list.hpp"
+#include <cmath>
+#include <stdexcept>
+#include <string>
+
+namespace ghostfragment::topology {
+namespace {
+
+using size_type  = CellList::size_type;
+using coord_type = CellList::coord_type;
+
+/// Caps the grid so that sparse systems do not allocate mostly empty cells
+size_type max_cells_per_direction(size_type natoms) {
+    const auto n = std::cbrt(8.0 * static_cast<double>(natoms));
+    return std::max<size_type>(1, static_cast<size_type>(n));
+}
+
+/// The number of cells of width at least @p cutoff which fit in @p width
+size_type ncells_along(coord_type width, coord_type cutoff, size_type max_n) {
+    const auto n = std::floor(width / cutoff);
+    if(!(n >= 1.0)) return 1;
+    return std::min(max_n, static_cast<size_type>(std::min(n, 1.0E9)));
+}
+
+/// The bin, in [0, n), containing @p s, where [0, 1) is split into n bins
+size_type bin_of(coord_type s, size_type n) {
+    const auto b = static_cast<size_type>(std::max(0.0, s * n));
+    return std::min(b, n - 1);
+}
+
+void check_cutoff(coord_type cutoff) {
+    if(!(cutoff > 0.0))
+        throw std::runtime_error("The cell list cutoff must be positive");
+}
+
+} // namespace
+
+CellList::CellList(const NucleiSnapshot& snapshot, coord_type cutoff) :
+  m_snapshot_(&snapshot), m_cutoff2_(cutoff * cutoff) {
+    check_cutoff(cutoff);
+    const auto natoms = snapshot.size();
+    const auto max_n  = max_cells_per_direction(natoms);
+
+    std::array<coord_type, 3> lo{0.0, 0.0, 0.0};
+    std::array<coord_type, 3> extent{0.0, 0.0, 0.0};
+    for(size_type q = 0; q < 3; ++q) {
+        if(natoms > 0) {
+            const auto& r = q == 0 ? snapshot.x() :
+                                     (q == 1 ? snapshot.y() : snapshot.z());
+            const auto [min, max] = std::minmax_element(r.begin(), r.end());
+            lo[q]                 = *min;
+            extent[q]             = *max - *min;
+        }
+        m_shape_[q] = ncells_along(extent[q], cutoff, max_n);
+    }
+
+    std::vector<size_type> cell_of(natoms);
+    for(size_type i = 0; i < natoms; ++i) {
+        size_type b[3];
+        for(size_type q = 0; q < 3; ++q) {
+            const auto s = extent[q] > 0.0 ?
+                             (snapshot.coord(i, q) - lo[q]) / extent[q] :
+                             0.0;
+            b[q]         = bin_of(s, m_shape_[q]);
+        }
+        cell_of[i] = offset_(b[0], b[1], b[2]);
+    }
+    bin_(cell_of);
+}
+
+CellList::CellList(const NucleiSnapshot& snapshot, coord_type cutoff,
+                   const UnitCell& cell) :
+  m_snapshot_(&snapshot), m_cutoff2_(cutoff * cutoff), m_cell_(cell) {
+    check_cutoff(cutoff);
+    if(2.0 * cutoff > cell.min_width())
+        throw std::runtime_error(
+          "The cutoff (" + std::to_string(cutoff) +
+          " a.u.) exceeds half the narrowest width of the unit cell (" +
+          std::to_string(cell.min_width()) + " a.u.), use a supercell");
+
+    const auto natoms = snapshot.size();
+    const auto max_n  = max_cells_per_direction(natoms);
+    for(size_type q = 0; q < 3; ++q)
+        m_shape_[q] = ncells_along(cell.width(q), cutoff, max_n);
+
+    std::vector<size_type> cell_of(natoms);
+    for(size_type i = 0; i < natoms; ++i) {
+        auto s = cell.to_fractional(snapshot.x()[i], snapshot.y()[i],
+                                    snapshot.z()[i]);
+        size_type b[3];
+        for(size_type q = 0; q < 3; ++q)
+            b[q] = bin_of(s[q] - std::floor(s[q]), m_shape_[q]);
+        cell_of[i] = offset_(b[0], b[1], b[2]);
+    }
+    bin_(cell_of);
+}
+
+void CellList::bin_(const std::vector<size_type>& cell_of) {
+    const auto n = m_shape_[0] * m_shape_[1] * m_shape_[2];
+
+    // Counting sort keeps the nuclei in each cell in increasing order
+    m_offsets_.assign(n + 1, 0);
+    for(const auto c : cell_of) ++m_offsets_[c + 1];
+    for(size_type c = 0; c < n; ++c) m_offsets_[c + 1] += m_offsets_[c];
+
+    m_nuclei_.resize(cell_of.size());
+    auto next = m_offsets_;
+    for(size_type i = 0; i < cell_of.size(); ++i)
+        m_nuclei_[next[cell_of[i]]++] = i;
+}
+
+void CellList::neighbors_(size_type i, size_type j, size_type k,
+                          std::vector<size_type>& cells) const {
+    const bool periodic = is_periodic();
+    const size_type center[3] = {i, j, k};
+
+    // Adjacent positions along each direction; with fewer than three cells
+    // along a periodic direction the wrapped positions repeat and are skipped
+    size_type pos[3][3];
+    size_type npos[3];
+    for(size_type q = 0; q < 3; ++q) {
+        const auto n = m_shape_[q];
+        const auto c = center[q];
+        npos[q]      = 0;
+        if(c > 0 || (periodic && n > 1)) pos[q][npos[q]++] = (c + n - 1) % n;
+        pos[q][npos[q]++] = c;
+        if(c + 1 < n || (periodic && n > 2)) pos[q][npos[q]++] = (c + 1) % n;
+        if(npos[q] == 3 && pos[q][0] == pos[q][2]) --npos[q];
+    }
+
+    for(size_type a = 0; a < npos[0]; ++a)
+        for(size_type b = 0; b < npos[1]; ++b)
+            for(size_type c = 0; c < npos[2]; ++c)
+                cells.push_back(offset_(pos[0][a], pos[1][b], pos[2][c]));
+}
+
+} // namespace ghostfragment::topology
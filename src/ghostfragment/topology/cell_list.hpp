@@ -0,0 +1,205 @@
+/*
+ * Copyright 2024 GhostFragment
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include "nuclei_snapshot.hpp"
+#include "unit_cell.hpp"
+#include <algorithm>
+#include <array>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace ghostfragment::topology {
+
+/** @brief Bins nuclei into cells so that close pairs can be found in O(N).
+ *
+ *  Finding every pair of nuclei within a cutoff by comparing all pairs scales
+ *  quadratically. CellList instead divides space into a grid of cells which
+ *  are at least as wide as the cutoff. Every pair within the cutoff is then in
+ *  the same or in adjacent cells, so only those cells need to be searched.
+ *
+ *  For isolated systems the grid spans the bounding box of the nuclei. For
+ *  periodic systems the grid spans the unit cell, cells on one face are
+ *  adjacent to the cells on the opposite face, and distances are minimum-image
+ *  distances. The cutoff may then be at most half the narrowest width of the
+ *  unit cell, so that each pair is within the cutoff for at most one image.
+ *
+ *  The cell list refers to the snapshot it was built from, which must outlive
+ *  it.
+ */
+class CellList {
+public:
+    /// Type used for indexing and offsets
+    using size_type = NucleiSnapshot::size_type;
+
+    /// Type of a coordinate or distance
+    using coord_type = NucleiSnapshot::coord_type;
+
+    /// Type of the number of cells along each direction
+    using shape_type = std::array<size_type, 3>;
+
+    /** @brief Bins the nuclei of an isolated system.
+     *
+     *  @param[in] snapshot The nuclei to bin.
+     *  @param[in] cutoff The largest distance pairs will be searched for.
+     *
+     *  @throw std::runtime_error if @p cutoff is not positive. Strong throw
+     *                            guarantee.
+     *  @throw std::bad_alloc if allocating the cells fails. Strong throw
+     *                        guarantee.
+     */
+    CellList(const NucleiSnapshot& snapshot, coord_type cutoff);
+
+    /** @brief Bins the nuclei of a periodic system.
+     *
+     *  @param[in] snapshot The nuclei in the unit cell. Nuclei outside of the
+     *                      cell are binned with their image inside of it.
+     *  @param[in] cutoff The largest distance pairs will be searched for.
+     *  @param[in] cell The unit cell.
+     *
+     *  @throw std::runtime_error if @p cutoff is not positive or if it exceeds
+     *                            half the narrowest width of @p cell. Strong
+     *                            throw guarantee.
+     *  @throw std::bad_alloc if allocating the cells fails. Strong throw
+     *                        guarantee.
+     */
+    CellList(const NucleiSnapshot& snapshot, coord_type cutoff,
+             const UnitCell& cell);
+
+    /// The number of cells along each direction
+    const shape_type& shape() const noexcept { return m_shape_; }
+
+    /// The total number of cells
+    size_type ncells() const noexcept { return m_offsets_.size() - 1; }
+
+    /// Is the grid periodic?
+    bool is_periodic() const noexcept { return m_cell_.has_value(); }
+
+    /** @brief Calls @p fxn for each pair of nuclei within the cutoff.
+     *
+     *  @tparam FxnType The type of a callable with the signature
+     *                  `void(size_type i, size_type j, coord_type r2)`.
+     *
+     *  @param[in] fxn Called once for each pair, with @p i < @p j and @p r2
+     *                 the (minimum-image, if periodic) squared distance
+     *                 between nuclei @p i and @p j. The order of the calls is
+     *                 deterministic, but unspecified.
+     *
+     *  If @p fxn throws, the exception is passed on to the caller and no more
+     *  pairs are visited. The calls made before it are not undone, so the
+     *  throw guarantee is the basic one at best.
+     *
+     *  @throw std::bad_alloc if allocating the list of neighboring cells
+     *                        fails. Strong throw guarantee.
+     */
+    template<typename FxnType>
+    void for_each_pair(FxnType&& fxn) const {
+        for_each_pair(0, ncells(), std::forward<FxnType>(fxn));
+    }
+
+    /** @brief Calls @p fxn for the pairs found from a range of cells.
+     *
+     *  Each pair is found from exactly one cell, so splitting [0, ncells())
+     *  into ranges and calling this function for each range (e.g., from
+     *  different threads) visits every pair exactly once. Visiting the ranges
+     *  in order gives the same calls, in the same order, as for_each_pair.
+     *
+     *  @tparam FxnType The type of the callback, see for_each_pair.
+     *
+     *  @param[in] begin The first cell to search from.
+     *  @param[in] end Just past the last cell to search from.
+     *  @param[in] fxn The callback, see for_each_pair. Exceptions from it
+     *                 are passed on just as for for_each_pair.
+     *
+     *  @throw std::bad_alloc if allocating the list of neighboring cells
+     *                        fails. Strong throw guarantee.
+     */
+    template<typename FxnType>
+    void for_each_pair(size_type begin, size_type end, FxnType&& fxn) const;
+
+private:
+    /// Sorts the nuclei into cells given the cell of each nucleus
+    void bin_(const std::vector<size_type>& cell_of);
+
+    /// Offset of the cell at grid position (@p i, @p j, @p k)
+    size_type offset_(size_type i, size_type j, size_type k) const noexcept {
+        return (i * m_shape_[1] + j) * m_shape_[2] + k;
+    }
+
+    /// Appends to @p cells the (unique) cells adjacent to cell (i, j, k)
+    void neighbors_(size_type i, size_type j, size_type k,
+                    std::vector<size_type>& cells) const;
+
+    /// The nuclei which were binned
+    const NucleiSnapshot* m_snapshot_;
+
+    /// The squared cutoff
+    coord_type m_cutoff2_;
+
+    /// The unit cell, if the system is periodic
+    std::optional<UnitCell> m_cell_;
+
+    /// Number of cells along each direction
+    shape_type m_shape_;
+
+    /// Nuclei in cell c are m_nuclei_[m_offsets_[c]] to m_offsets_[c + 1]
+    std::vector<size_type> m_offsets_;
+
+    /// The nuclei, sorted by cell
+    std::vector<size_type> m_nuclei_;
+};
+
+// -----------------------------------------------------------------------------
+// -- Inline implementations
+// -----------------------------------------------------------------------------
+
+template<typename FxnType>
+void CellList::for_each_pair(size_type begin, size_type end,
+                             FxnType&& fxn) const {
+    const auto& x = m_snapshot_->x();
+    const auto& y = m_snapshot_->y();
+    const auto& z = m_snapshot_->z();
+
+    std::vector<size_type> cells;
+    for(auto c = begin; c < end; ++c) {
+        if(m_offsets_[c] == m_offsets_[c + 1]) continue;
+        const auto ck = c % m_shape_[2];
+        const auto cj = (c / m_shape_[2]) % m_shape_[1];
+        const auto ci = c / (m_shape_[2] * m_shape_[1]);
+        cells.clear();
+        neighbors_(ci, cj, ck, cells);
+
+        for(auto a = m_offsets_[c]; a < m_offsets_[c + 1]; ++a) {
+            const auto i = m_nuclei_[a];
+            for(const auto d : cells) {
+                for(auto b = m_offsets_[d]; b < m_offsets_[d + 1]; ++b) {
+                    // Each pair is visited from both of its cells
+                    const auto j = m_nuclei_[b];
+                    if(j <= i) continue;
+                    auto dx = x[j] - x[i];
+                    auto dy = y[j] - y[i];
+                    auto dz = z[j] - z[i];
+                    if(m_cell_) m_cell_->minimum_image(dx, dy, dz);
+                    const auto r2 = dx * dx + dy * dy + dz * dz;
+                    if(r2 <= m_cutoff2_) fxn(i, j, r2);
+                }
+            }
+        }
+    }
+}
+
+} // namespace ghostfragment::topology
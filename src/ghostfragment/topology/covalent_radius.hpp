@@ -19,16 +19,22 @@
 
 namespace ghostfragment::topology {
 
+/// The largest atomic number covalent_radius has a radius for
+inline constexpr std::size_t max_covalent_radius_z = 96;
+
 /** @brief  Returns the covalent radius (in Bohr) of the specified element.
  *
  *  @param[in] z The atomic number of the element. @p z is 1-based, *i.e.*,
  *               @p z = 1 is hydrogen, @p z = 2 is helium, etc.
  *
  *  @return The requested covalent radius.
+ *
+ *  @warning @p z must be in the range [1, max_covalent_radius_z]. Other values
+ *           are undefined behavior.
  */
 inline double covalent_radius(std::size_t z) {
     /// Data is generated with Mathematica 10.0 (only available up to Z=96)
-    std::array<double, 96> cov_radii{
+    std::array<double, max_covalent_radius_z> cov_radii{
       0.585815, 0.529123, 2.418849, 1.814137, 1.606267, 1.436192, 1.341706,
       1.247219, 1.077144, 1.096041, 3.136945, 2.664514, 2.286569, 2.097596,
       2.022007, 1.984212, 1.927521, 2.003110, 3.836144, 3.325918, 3.212534,
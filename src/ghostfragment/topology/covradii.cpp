@@ -14,10 +14,16 @@
  * limitations under the License.
  */
 
-#include "covalent_radius.hpp"
+#include "../utilities/parallel_for.hpp"
+#include "cell_list.hpp"
+#include "distance_kernels.hpp"
 #include "topology.hpp"
+#include "unit_cell.hpp"
 #include <ghostfragment/property_types/topology/connectivity_table.hpp>
+#include <algorithm>
 #include <simde/simde.hpp>
+#include <utility>
+#include <vector>
 
 namespace ghostfragment::topology {
 
@@ -41,6 +47,25 @@ where :math:`r_{ij}` can be no more than :math:`1+\tau` times larger than
 :math:`\sigma_{i} + \sigma_{j}` for :math:`i` and :math:`j` to be bonded. For
 example, for :math:`tau=1` :math:`r_{ij}` is allowed to be two times larger
 than the distance predicted by the covalent radii.
+
+Periodic Systems
+^^^^^^^^^^^^^^^^
+
+If lattice vectors are provided, the input molecule is taken to be the contents
+of one unit cell and :math:`r_{ij}` is the minimum-image distance, i.e., the
+distance from nucleus :math:`i` to the closest periodic image of nucleus
+:math:`j`. Nuclei near opposite faces of the cell can thus be bonded. Pairs are
+found with a cell list, so the cost is linear in the number of nuclei in the
+cell. The longest possible bond must be shorter than half of the narrowest
+width of the cell; use a supercell if it is not.
+
+Threading
+^^^^^^^^^
+
+The search for bonded pairs is split over threads. Each thread records the
+bonds it finds in its own buffer and the buffers are added to the connectivity
+table in a fixed order, so the result does not depend on the number of
+threads.
 )";
 
 const auto tau_desc = R"(
@@ -48,44 +73,91 @@ How much larger the actual distance can be compared to the predicted distance
 (as a ratio).
 )";
 
+const auto nthreads_desc = "Threads to use (0 for all hardware threads)";
+
 MODULE_CTOR(CovRadii) {
     description(mod_desc);
     satisfies_property_type<my_pt>();
     add_input<double>("tau").set_description(tau_desc).set_default(0.10);
+    add_input<std::vector<double>>(lattice_key)
+      .set_description(lattice_desc)
+      .set_default(std::vector<double>{});
+    add_input<std::size_t>("nthreads")
+      .set_description(nthreads_desc)
+      .set_default(std::size_t{0});
 }
 
 MODULE_RUN(CovRadii) {
-    auto& logger          = get_runtime().logger();
-    const auto& [mol]     = my_pt::unwrap_inputs(inputs);
-    const auto tau        = inputs.at("tau").value<double>();
-    const auto tau_plus_1 = tau + 1.0;
-    const auto natoms     = mol.size();
-
+    auto& logger       = get_runtime().logger();
+    const auto& [mol]  = my_pt::unwrap_inputs(inputs);
+    const auto tau     = inputs.at("tau").value<double>();
+    const auto lattice = inputs.at(lattice_key).value<std::vector<double>>();
+    auto nthreads      = inputs.at("nthreads").value<std::size_t>();
+    if(nthreads == 0) nthreads = utilities::default_nthreads();
+
+    const NucleiSnapshot snapshot(mol);
+    const SquaredThresholdTable thresholds(snapshot, tau);
+    const auto natoms = snapshot.size();
     traits_type::result_type ct(natoms);
 
-    using size_type = typename std::decay_t<decltype(mol)>::size_type;
-    for(size_type i = 0; i < natoms; ++i) {
-        const auto atom_i  = mol[i];
-        const auto sigma_i = covalent_radius(atom_i.Z());
-        logger.trace("Atom " + std::to_string(i) + " has covalent radius " +
-                     std::to_string(sigma_i) + " (a.u.).");
-
-        for(size_type j = i + 1; j < natoms; ++j) {
-            const auto atom_j  = mol[j].as_nucleus();
-            const auto sigma_j = covalent_radius(atom_j.Z());
-            logger.trace("Atom " + std::to_string(j) + " has covalent radius " +
-                         std::to_string(sigma_j) + " (a.u.).");
-
-            const auto rij      = (atom_i.as_nucleus() - atom_j).magnitude();
-            const auto max_bond = tau_plus_1 * (sigma_i + sigma_j);
-
-            logger.trace(std::to_string(i) + "-" + std::to_string(j) +
-                         " distance is: " + std::to_string(rij));
-
-            if(rij <= max_bond) ct.add_bond(i, j);
+    using size_type   = NucleiSnapshot::size_type;
+    using bond_buffer = std::vector<std::pair<size_type, size_type>>;
+    std::vector<bond_buffer> buffers;
+
+    if(!lattice.empty()) {
+        const UnitCell cell(lattice);
+        logger.debug("Using minimum-image distances.");
+
+        // The longest bond possible in this system
+        const auto& radii = snapshot.radius();
+        const auto max_radius =
+          natoms ? *std::max_element(radii.begin(), radii.end()) : 0.0;
+        const auto cutoff = (1.0 + tau) * 2.0 * max_radius;
+        if(cutoff > 0.0) {
+            const CellList cells(snapshot, cutoff, cell);
+            const auto nchunks = std::min(nthreads, cells.ncells());
+            buffers.resize(nchunks);
+            utilities::parallel_for_chunks(
+              cells.ncells(), nchunks,
+              [&](std::size_t chunk, std::size_t begin, std::size_t end) {
+                  auto& buffer = buffers[chunk];
+                  cells.for_each_pair(
+                    begin, end, [&](size_type i, size_type j, double r2) {
+                        if(r2 <= thresholds(i, j)) buffer.emplace_back(i, j);
+                    });
+              });
+            for(const auto& buffer : buffers)
+                for(const auto& [i, j] : buffer) ct.add_bond(i, j);
         }
+        auto rv = results();
+        return my_pt::wrap_results(rv, ct);
     }
 
+    const auto kernel = best_distance_kernel();
+    logger.debug("Using the " + to_string(kernel) + " distance kernel.");
+
+    for(size_type i = 0; i < natoms; ++i)
+        logger.trace("Atom " + std::to_string(i) + " has covalent radius " +
+                     std::to_string(snapshot.radius()[i]) + " (a.u.).");
+
+    // Row i checks natoms - 1 - i pairs, so balance the work, not the rows
+    const auto bounds  = utilities::triangular_chunk_bounds(natoms, nthreads);
+    const auto nchunks = bounds.size() - 1;
+    buffers.resize(nchunks);
+    utilities::parallel_for_chunks(
+      nchunks, nchunks, [&](std::size_t chunk, std::size_t, std::size_t) {
+          auto& buffer = buffers[chunk];
+          std::vector<size_type> partners;
+          for(auto i = bounds[chunk]; i < bounds[chunk + 1]; ++i) {
+              partners.clear();
+              append_bonded_partners(snapshot, thresholds, i, i + 1, natoms,
+                                     partners, kernel);
+              for(const auto j : partners) buffer.emplace_back(i, j);
+          }
+      });
+    for(const auto& buffer : buffers)
+        for(const auto& [i, j] : buffer) ct.add_bond(i, j);
+
     auto rv = results();
     return my_pt::wrap_results(rv, ct);
 }
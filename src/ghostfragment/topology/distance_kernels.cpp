@@ -0,0 +1,245 @@
+/*
+ * Copyright 2024 GhostFragment
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "distance_kernels.hpp"
+#include <map>
+
+// The kernels must not fuse multiplies and adds into FMAs, see below. The
+// build also passes -ffp-contract=off for this file; the pragmas keep that
+// true when the file is compiled some other way.
+#if defined(__clang__)
+#pragma clang fp contract(off)
+#elif defined(__GNUC__)
+#pragma GCC optimize("fp-contract=off")
+#endif
+
+#if(defined(__x86_64__) || defined(__i386__)) && \
+  (defined(__GNUC__) || defined(__clang__))
+#define GHOSTFRAGMENT_X86_KERNELS
+#include <immintrin.h>
+#endif
+
+namespace ghostfragment::topology {
+namespace {
+
+using size_type  = NucleiSnapshot::size_type;
+using kind_type  = SquaredThresholdTable::kind_type;
+using index_list = std::vector<size_type>;
+
+/* N.B. All kernels evaluate the squared distance as
+ *
+ *     (dx * dx + dy * dy) + dz * dz
+ *
+ * with separate, correctly rounded multiplies and adds so that they agree
+ * bit-for-bit. A compiler which contracts a multiply and an add into an FMA
+ * rounds once instead of twice and the kernels no longer agree, which is why
+ * contraction is disabled for this file. Vector kernels finish the range with
+ * the scalar kernel.
+ */
+
+void bonded_scalar(const double* x, const double* y, const double* z,
+                   const kind_type* kinds, const double* row, double xi,
+                   double yi, double zi, size_type begin, size_type end,
+                   index_list& partners) {
+    for(size_type j = begin; j < end; ++j) {
+        const double dx = x[j] - xi;
+        const double dy = y[j] - yi;
+        const double dz = z[j] - zi;
+        const double r2 = dx * dx + dy * dy + dz * dz;
+        if(r2 <= row[kinds[j]]) partners.push_back(j);
+    }
+}
+
+#ifdef GHOSTFRAGMENT_X86_KERNELS
+
+__attribute__((target("avx2"))) void bonded_avx2(
+  const double* x, const double* y, const double* z, const kind_type* kinds,
+  const double* row, double xi, double yi, double zi, size_type begin,
+  size_type end, index_list& partners) {
+    const __m256d vxi = _mm256_set1_pd(xi);
+    const __m256d vyi = _mm256_set1_pd(yi);
+    const __m256d vzi       = _mm256_set1_pd(zi);
+    const __m256d all_lanes = _mm256_castsi256_pd(_mm256_set1_epi64x(-1));
+
+    size_type j = begin;
+    for(; j + 4 <= end; j += 4) {
+        const __m256d dx = _mm256_sub_pd(_mm256_loadu_pd(x + j), vxi);
+        const __m256d dy = _mm256_sub_pd(_mm256_loadu_pd(y + j), vyi);
+        const __m256d dz = _mm256_sub_pd(_mm256_loadu_pd(z + j), vzi);
+        const __m256d r2 = _mm256_add_pd(
+          _mm256_add_pd(_mm256_mul_pd(dx, dx), _mm256_mul_pd(dy, dy)),
+          _mm256_mul_pd(dz, dz));
+
+        const auto* pidx  = reinterpret_cast<const __m128i*>(kinds + j);
+        const __m128i idx = _mm_loadu_si128(pidx);
+        // Masked gather, with every lane enabled, so that no lane is left
+        // uninitialized
+        const __m256d thr = _mm256_mask_i32gather_pd(
+          _mm256_setzero_pd(), row, idx, all_lanes, 8);
+
+        auto mask = _mm256_movemask_pd(_mm256_cmp_pd(r2, thr, _CMP_LE_OQ));
+        while(mask) {
+            partners.push_back(j + __builtin_ctz(mask));
+            mask &= mask - 1;
+        }
+    }
+    bonded_scalar(x, y, z, kinds, row, xi, yi, zi, j, end, partners);
+}
+
+__attribute__((target("avx512f"))) void bonded_avx512(
+  const double* x, const double* y, const double* z, const kind_type* kinds,
+  const double* row, double xi, double yi, double zi, size_type begin,
+  size_type end, index_list& partners) {
+    const __m512d vxi = _mm512_set1_pd(xi);
+    const __m512d vyi = _mm512_set1_pd(yi);
+    const __m512d vzi = _mm512_set1_pd(zi);
+
+    size_type j = begin;
+    for(; j + 8 <= end; j += 8) {
+        const __m512d dx = _mm512_sub_pd(_mm512_loadu_pd(x + j), vxi);
+        const __m512d dy = _mm512_sub_pd(_mm512_loadu_pd(y + j), vyi);
+        const __m512d dz = _mm512_sub_pd(_mm512_loadu_pd(z + j), vzi);
+        const __m512d r2 = _mm512_add_pd(
+          _mm512_add_pd(_mm512_mul_pd(dx, dx), _mm512_mul_pd(dy, dy)),
+          _mm512_mul_pd(dz, dz));
+
+        const auto* pidx  = reinterpret_cast<const __m256i*>(kinds + j);
+        const __m256i idx = _mm256_loadu_si256(pidx);
+        const __m512d thr =
+          _mm512_mask_i32gather_pd(_mm512_setzero_pd(), 0xFF, idx, row, 8);
+
+        unsigned mask = _mm512_cmp_pd_mask(r2, thr, _CMP_LE_OQ);
+        while(mask) {
+            partners.push_back(j + __builtin_ctz(mask));
+            mask &= mask - 1;
+        }
+    }
+    bonded_scalar(x, y, z, kinds, row, xi, yi, zi, j, end, partners);
+}
+
+#endif
+
+DistanceKernel detect_best_kernel() noexcept {
+#ifdef GHOSTFRAGMENT_X86_KERNELS
+    __builtin_cpu_init();
+    if(__builtin_cpu_supports("avx512f")) return DistanceKernel::avx512;
+    if(__builtin_cpu_supports("avx2")) return DistanceKernel::avx2;
+#endif
+    return DistanceKernel::scalar;
+}
+
+} // namespace
+
+bool distance_kernel_supported(DistanceKernel kernel) noexcept {
+    switch(kernel) {
+        case DistanceKernel::scalar: return true;
+        case DistanceKernel::avx2:
+            return best_distance_kernel() != DistanceKernel::scalar;
+        case DistanceKernel::avx512:
+            return best_distance_kernel() == DistanceKernel::avx512;
+    }
+    return false;
+}
+
+DistanceKernel best_distance_kernel() noexcept {
+    static const DistanceKernel best = detect_best_kernel();
+    return best;
+}
+
+std::string to_string(DistanceKernel kernel) {
+    switch(kernel) {
+        case DistanceKernel::scalar: return "scalar";
+        case DistanceKernel::avx2: return "AVX2";
+        case DistanceKernel::avx512: return "AVX-512";
+    }
+    return "unknown";
+}
+
+// -----------------------------------------------------------------------------
+// -- SquaredThresholdTable
+// -----------------------------------------------------------------------------
+
+SquaredThresholdTable::SquaredThresholdTable(const NucleiSnapshot& snapshot,
+                                             double tau) {
+    const auto& Z      = snapshot.Z();
+    const auto& radius = snapshot.radius();
+
+    // Assign kinds in order of increasing atomic number
+    std::map<NucleiSnapshot::atomic_number_type, kind_type> z2kind;
+    for(const auto z : Z) z2kind.emplace(z, 0);
+
+    std::vector<double> kind_radius(z2kind.size(), 0.0);
+    kind_type counter = 0;
+    for(auto& [z, kind] : z2kind) kind = counter++;
+
+    kind_array kinds(Z.size());
+    for(size_type i = 0; i < Z.size(); ++i) {
+        kinds[i]              = z2kind[Z[i]];
+        kind_radius[kinds[i]] = radius[i];
+    }
+
+    const auto nkinds     = z2kind.size();
+    const auto tau_plus_1 = tau + 1.0;
+    std::vector<double> table(nkinds * nkinds);
+    for(size_type k = 0; k < nkinds; ++k) {
+        for(size_type l = 0; l < nkinds; ++l) {
+            const auto sigma_kl   = kind_radius[k] + kind_radius[l];
+            const auto max_bond   = tau_plus_1 * sigma_kl;
+            table[k * nkinds + l] = max_bond * max_bond;
+        }
+    }
+
+    m_nkinds_ = nkinds;
+    m_kinds_.swap(kinds);
+    m_table_.swap(table);
+}
+
+// -----------------------------------------------------------------------------
+// -- Kernels
+// -----------------------------------------------------------------------------
+
+void append_bonded_partners(const NucleiSnapshot& snapshot,
+                            const SquaredThresholdTable& thresholds,
+                            size_type i, size_type begin, size_type end,
+                            index_list& partners, DistanceKernel kernel) {
+    const auto* x     = snapshot.x().data();
+    const auto* y     = snapshot.y().data();
+    const auto* z     = snapshot.z().data();
+    const auto* kinds = thresholds.kinds().data();
+    const auto* row   = thresholds.row(i);
+    const auto xi     = x[i];
+    const auto yi     = y[i];
+    const auto zi     = z[i];
+
+    if(!distance_kernel_supported(kernel)) kernel = best_distance_kernel();
+    switch(kernel) {
+#ifdef GHOSTFRAGMENT_X86_KERNELS
+        case DistanceKernel::avx512:
+            bonded_avx512(x, y, z, kinds, row, xi, yi, zi, begin, end,
+                          partners);
+            return;
+        case DistanceKernel::avx2:
+            bonded_avx2(x, y, z, kinds, row, xi, yi, zi, begin, end,
+                        partners);
+            return;
+#endif
+        default:
+            bonded_scalar(x, y, z, kinds, row, xi, yi, zi, begin, end,
+                          partners);
+    }
+}
+
+} // namespace ghostfragment::topology
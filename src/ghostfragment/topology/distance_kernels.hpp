@@ -0,0 +1,124 @@
+/*
+ * Copyright 2024 GhostFragment
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include "nuclei_snapshot.hpp"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ghostfragment::topology {
+
+/// The implementations available for the pairwise distance kernels
+enum class DistanceKernel { scalar, avx2, avx512 };
+
+/// Can @p kernel be run on the current CPU?
+bool distance_kernel_supported(DistanceKernel kernel) noexcept;
+
+/// The fastest kernel the current CPU supports (detected once, at runtime)
+DistanceKernel best_distance_kernel() noexcept;
+
+/// Name of @p kernel, suitable for logging
+std::string to_string(DistanceKernel kernel);
+
+/** @brief Squared bonding thresholds for every pair of elements in a system.
+ *
+ *  Two nuclei, with covalent radii @f$\sigma_i@f$ and @f$\sigma_j@f$, are
+ *  considered bonded if they are no further apart than
+ *  @f$(1+\tau)(\sigma_i + \sigma_j)@f$. Comparing squared distances against
+ *  the square of this threshold avoids a square root per pair. Since the
+ *  threshold only depends on the elements of the two nuclei, this class maps
+ *  the distinct elements of the system to dense "kinds" and tabulates the
+ *  squared threshold for each pair of kinds.
+ */
+class SquaredThresholdTable {
+public:
+    /// Type used for offsets
+    using size_type = NucleiSnapshot::size_type;
+
+    /// Type of the per-nucleus kind (32-bit so it can be used for gathers)
+    using kind_type = std::int32_t;
+
+    /// Type of the per-nucleus kind array
+    using kind_array = std::vector<kind_type>;
+
+    /** @brief Tabulates the thresholds for the elements in @p snapshot.
+     *
+     *  @param[in] snapshot The nuclei the table is for.
+     *  @param[in] tau How much longer (as a ratio) a bond can be than the sum
+     *                 of the covalent radii.
+     *
+     *  @throw std::bad_alloc if allocating the table fails. Strong throw
+     *                        guarantee.
+     */
+    SquaredThresholdTable(const NucleiSnapshot& snapshot, double tau);
+
+    /// The number of distinct elements
+    size_type nkinds() const noexcept { return m_nkinds_; }
+
+    /// The kind of each nucleus in the snapshot the table was made for
+    const kind_array& kinds() const noexcept { return m_kinds_; }
+
+    /// Squared thresholds between the kind of nucleus @p i and each kind
+    const double* row(size_type i) const noexcept {
+        return m_table_.data() + m_kinds_[i] * m_nkinds_;
+    }
+
+    /// Squared threshold for nuclei @p i and @p j
+    double operator()(size_type i, size_type j) const noexcept {
+        return row(i)[m_kinds_[j]];
+    }
+
+private:
+    /// The number of distinct elements
+    size_type m_nkinds_ = 0;
+
+    /// Kind of each nucleus
+    kind_array m_kinds_;
+
+    /// nkinds by nkinds table of squared thresholds
+    std::vector<double> m_table_;
+};
+
+/** @brief Finds the nuclei in a range which are bonded to nucleus @p i.
+ *
+ *  For each @f$j@f$ in [@p begin, @p end), @f$j@f$ is appended to @p partners
+ *  if the squared distance between nuclei @f$i@f$ and @f$j@f$ is less than or
+ *  equal to the squared threshold for the pair. Indices are appended in
+ *  increasing order. All kernels give identical results, which relies on
+ *  the kernels being compiled without FMA contraction. If @p kernel is not
+ *  supported by the CPU the fastest supported kernel is used instead.
+ *
+ *  @param[in] snapshot The geometry of the system.
+ *  @param[in] thresholds The squared thresholds for @p snapshot.
+ *  @param[in] i The nucleus whose partners are wanted.
+ *  @param[in] begin The first nucleus to consider.
+ *  @param[in] end Just past the last nucleus to consider.
+ *  @param[in,out] partners Where the bonded nuclei are appended.
+ *  @param[in] kernel The implementation to use. Defaults to the fastest one
+ *                    the CPU supports.
+ *
+ *  @throw std::bad_alloc if growing @p partners fails. Basic throw guarantee.
+ */
+void append_bonded_partners(const NucleiSnapshot& snapshot,
+                            const SquaredThresholdTable& thresholds,
+                            NucleiSnapshot::size_type i,
+                            NucleiSnapshot::size_type begin,
+                            NucleiSnapshot::size_type end,
+                            std::vector<NucleiSnapshot::size_type>& partners,
+                            DistanceKernel kernel = best_distance_kernel());
+
+} // namespace ghostfragment::topology
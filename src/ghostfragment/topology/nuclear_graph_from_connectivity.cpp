@@ -14,33 +14,49 @@
  * limitations under the License.
  */
 
+#include "../utilities/parallel_for.hpp"
 #include "topology.hpp"
-#include <ghostfragment/property_types/fragmenting/fragmented_nuclei.hpp>
-#include <ghostfragment/property_types/topology/connectivity_table.hpp>
+#include <ghostfragment/property_types/fragmenting/fragmented_nuclei_from_connectivity.hpp>
 #include <ghostfragment/property_types/topology/nuclear_graph.hpp>
+#include <utility>
+#include <vector>
 
 namespace ghostfragment::topology {
 
-using my_pt   = ghostfragment::pt::NuclearGraph;
-using pa_pt   = ghostfragment::pt::FragmentedNuclei;
-using conn_pt = ghostfragment::pt::ConnectivityTable;
+using my_pt = ghostfragment::pt::NuclearGraph;
+using pa_pt = ghostfragment::pt::FragmentedNucleiFromConnectivity;
 
 const auto module_desc = R"(
 Nuclear Graph From Atomic Connectivity
 --------------------------------------
 
-This module takes as input a ChemicalSystem, breaks it into a set of disjoint
-fragments (how this is done is controlled by the "Nodes" submodule). Then uses
-the connectivity of the ChemicalSystem's Molecule to determine the edges of the
-graph.
+This module takes as input a ChemicalSystem and the connectivity of its
+Molecule, breaks the ChemicalSystem into a set of disjoint fragments (how this
+is done is controlled by the "Nodes" submodule). Then uses the connectivity to
+determine the edges of the graph. The connectivity is passed along to the
+"Nodes" submodule so that it never needs to be recomputed.
+
+Since the edges only depend on the connectivity, periodic systems need no
+special treatment: if the connectivity was computed with minimum-image
+distances (e.g., by providing lattice vectors to the covalent radius module)
+nodes bonded through the boundary of the unit cell are connected.
+
+The search for edges is split over threads (the "Nodes" submodule is still
+run by the calling thread). Each thread records the edges it finds in its own
+buffer and the buffers are added to the graph in a fixed order, so the graph
+does not depend on the number of threads.
 )";
 
+const auto nthreads_desc = "Threads to use (0 for all hardware threads)";
+
 MODULE_CTOR(NuclearGraphFromConnectivity) {
     description(module_desc);
     satisfies_property_type<my_pt>();
+    add_input<std::size_t>("nthreads")
+      .set_description(nthreads_desc)
+      .set_default(std::size_t{0});
 
     add_submodule<pa_pt>("Nodes");
-    add_submodule<conn_pt>("Connectivity");
 }
 
 MODULE_RUN(NuclearGraphFromConnectivity) {
@@ -48,46 +64,60 @@ MODULE_RUN(NuclearGraphFromConnectivity) {
     using result_type = traits_type::result_type;
     auto& logger      = get_runtime().logger();
 
-    const auto& [chem_sys] = my_pt::unwrap_inputs(inputs);
+    const auto& [chem_sys, atom_conns] = my_pt::unwrap_inputs(inputs);
 
     auto& pseudo_atom_mod = submods.at("Nodes");
-    const auto& frags     = pseudo_atom_mod.run_as<pa_pt>(chem_sys);
+    const auto& frags     = pseudo_atom_mod.run_as<pa_pt>(chem_sys, atom_conns);
     const auto n_atoms    = chem_sys.molecule().size();
     const auto n_pas      = frags.size();
     logger.debug("The " + std::to_string(n_atoms) +
                  " atoms of the system were converted into " +
                  std::to_string(n_pas) + " pseudoatoms.");
 
-    auto& conn_mod         = submods.at("Connectivity");
-    const auto& atom_conns = conn_mod.run_as<conn_pt>(chem_sys.molecule());
-    const auto n_bonds     = atom_conns.nbonds();
+    const auto n_bonds = atom_conns.nbonds();
     logger.debug("System has " + std::to_string(n_bonds) + " bonds.");
 
     const auto nnodes = frags.size();
     std::decay_t<decltype(atom_conns)> edges(nnodes);
 
-    for(std::size_t i = 0; i < nnodes; ++i) {
-        const auto node_i = frags.nuclear_indices(i);
-
-        // Get a set of all atoms bonded to node_i
-        decltype(atom_conns.bonded_atoms(i)) node_i_conns;
-        for(const auto atom_i : node_i) {
-            const auto conns = atom_conns.bonded_atoms(atom_i);
-            node_i_conns.insert(conns.begin(), conns.end());
-        }
+    auto nthreads = inputs.at("nthreads").value<std::size_t>();
+    if(nthreads == 0) nthreads = utilities::default_nthreads();
+
+    // Node i is compared to nnodes - 1 - i nodes, so balance the comparisons
+    using edge_buffer  = std::vector<std::pair<std::size_t, std::size_t>>;
+    const auto bounds  = utilities::triangular_chunk_bounds(nnodes, nthreads);
+    const auto nchunks = bounds.size() - 1;
+    std::vector<edge_buffer> buffers(nchunks);
+
+    auto find_edges = [&](std::size_t chunk, std::size_t, std::size_t) {
+        auto& buffer = buffers[chunk];
+        for(auto i = bounds[chunk]; i < bounds[chunk + 1]; ++i) {
+            const auto node_i = frags.nuclear_indices(i);
+
+            // Get a set of all atoms bonded to node_i
+            decltype(atom_conns.bonded_atoms(i)) node_i_conns;
+            for(const auto atom_i : node_i) {
+                const auto conns = atom_conns.bonded_atoms(atom_i);
+                node_i_conns.insert(conns.begin(), conns.end());
+            }
 
-        // Loop over other nodes
-        for(std::size_t j = i + 1; j < nnodes; ++j) {
-            const auto node_j = frags.nuclear_indices(j);
-            // If an atom in node_j is bonded to node_i, then there's an edge
-            for(const auto atom_j : node_j) {
-                if(node_i_conns.count(atom_j)) {
-                    edges.add_bond(i, j);
-                    break;
+            // Loop over other nodes
+            for(std::size_t j = i + 1; j < nnodes; ++j) {
+                const auto node_j = frags.nuclear_indices(j);
+                // If an atom in node_j is bonded to node_i, there's an edge
+                for(const auto atom_j : node_j) {
+                    if(node_i_conns.count(atom_j)) {
+                        buffer.emplace_back(i, j);
+                        break;
+                    }
                 }
             }
         }
-    }
+    };
+    utilities::parallel_for_chunks(nchunks, nchunks, find_edges);
+
+    for(const auto& buffer : buffers)
+        for(const auto& [i, j] : buffer) edges.add_bond(i, j);
 
     result_type graph(frags, std::move(edges));
     auto rv = results();
@@ -0,0 +1,167 @@
+/*
+ * Copyright 2024 GhostFragment
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include "covalent_radius.hpp"
+#include <cmath>
+#include <vector>
+
+namespace ghostfragment::topology {
+
+/** @brief Structure-of-arrays copy of the geometry of a set of nuclei.
+ *
+ *  Geometric modules (connectivity, capping, etc.) repeatedly need the
+ *  coordinates, atomic numbers, and covalent radii of the nuclei in the
+ *  supersystem. Going through chemist's views for each pair of nuclei
+ *  materializes a full Nucleus (name included) every time. NucleiSnapshot
+ *  copies the needed data into contiguous arrays once, so that inner loops only
+ *  touch plain numbers.
+ *
+ *  The snapshot is just a copy, it does NOT track changes to the nuclei it was
+ *  created from.
+ */
+class NucleiSnapshot {
+public:
+    /// Type used for indexing and offsets
+    using size_type = std::size_t;
+
+    /// Type used to store the atomic numbers
+    using atomic_number_type = std::size_t;
+
+    /// Type of a coordinate or distance
+    using coord_type = double;
+
+    /// Type of the arrays holding per-nucleus floating-point quantities
+    using coord_array = std::vector<coord_type>;
+
+    /// Type of the array holding the atomic numbers
+    using atomic_number_array = std::vector<atomic_number_type>;
+
+    /// Creates a snapshot with no nuclei
+    NucleiSnapshot() = default;
+
+    /** @brief Copies the geometry out of @p nuclei.
+     *
+     *  @tparam NucleiType An indexable container (e.g., Nuclei, Molecule, or
+     *                     views of them) whose elements define `Z()` and
+     *                     `as_nucleus()`.
+     *
+     *  @param[in] nuclei The nuclei to take the snapshot of.
+     *
+     *  @throw std::bad_alloc if allocating the arrays fails. Strong throw
+     *                        guarantee.
+     */
+    template<typename NucleiType>
+    explicit NucleiSnapshot(const NucleiType& nuclei);
+
+    /// The number of nuclei in the snapshot
+    size_type size() const noexcept { return m_Z_.size(); }
+
+    /// Is the snapshot empty?
+    bool empty() const noexcept { return m_Z_.empty(); }
+
+    /// Contiguous x coordinates of the nuclei
+    const coord_array& x() const noexcept { return m_x_; }
+
+    /// Contiguous y coordinates of the nuclei
+    const coord_array& y() const noexcept { return m_y_; }
+
+    /// Contiguous z coordinates of the nuclei
+    const coord_array& z() const noexcept { return m_z_; }
+
+    /// Contiguous atomic numbers of the nuclei
+    const atomic_number_array& Z() const noexcept { return m_Z_; }
+
+    /** @brief Contiguous covalent radii (in Bohr) of the nuclei.
+     *
+     *  Elements for which there is no tabulated radius (the dummy element,
+     *  Z = 0, and Z > 96) are assigned a radius of 0.
+     */
+    const coord_array& radius() const noexcept { return m_radius_; }
+
+    /** @brief The @p q-th Cartesian coordinate of the @p i-th nucleus.
+     *
+     *  @param[in] i The offset of the nucleus. Must be in [0, size()).
+     *  @param[in] q Which coordinate (0 for x, 1 for y, 2 for z).
+     *
+     *  @throw None No throw guarantee.
+     */
+    coord_type coord(size_type i, size_type q) const noexcept {
+        return q == 0 ? m_x_[i] : (q == 1 ? m_y_[i] : m_z_[i]);
+    }
+
+    /// Squared distance between nuclei @p i and @p j
+    coord_type distance_squared(size_type i, size_type j) const noexcept {
+        const auto dx = m_x_[j] - m_x_[i];
+        const auto dy = m_y_[j] - m_y_[i];
+        const auto dz = m_z_[j] - m_z_[i];
+        return dx * dx + dy * dy + dz * dz;
+    }
+
+    /// Distance between nuclei @p i and @p j
+    coord_type distance(size_type i, size_type j) const noexcept {
+        return std::sqrt(distance_squared(i, j));
+    }
+
+    /// Are the two snapshots of the same geometry?
+    bool operator==(const NucleiSnapshot& rhs) const noexcept {
+        return m_Z_ == rhs.m_Z_ && m_x_ == rhs.m_x_ && m_y_ == rhs.m_y_ &&
+               m_z_ == rhs.m_z_;
+    }
+
+    /// Are the two snapshots of different geometries?
+    bool operator!=(const NucleiSnapshot& rhs) const noexcept {
+        return !(*this == rhs);
+    }
+
+private:
+    /// The x, y, and z coordinates
+    coord_array m_x_;
+    coord_array m_y_;
+    coord_array m_z_;
+
+    /// The covalent radii
+    coord_array m_radius_;
+
+    /// The atomic numbers
+    atomic_number_array m_Z_;
+};
+
+// -----------------------------------------------------------------------------
+// -- Inline implementations
+// -----------------------------------------------------------------------------
+
+template<typename NucleiType>
+NucleiSnapshot::NucleiSnapshot(const NucleiType& nuclei) {
+    const auto n = nuclei.size();
+    m_x_.reserve(n);
+    m_y_.reserve(n);
+    m_z_.reserve(n);
+    m_radius_.reserve(n);
+    m_Z_.reserve(n);
+    for(size_type i = 0; i < n; ++i) {
+        const auto nucleus_i       = nuclei[i].as_nucleus();
+        const atomic_number_type Z = nucleus_i.Z();
+        m_x_.push_back(nucleus_i.coord(0));
+        m_y_.push_back(nucleus_i.coord(1));
+        m_z_.push_back(nucleus_i.coord(2));
+        const bool has_radius = Z >= 1 && Z <= max_covalent_radius_z;
+        m_radius_.push_back(has_radius ? covalent_radius(Z) : 0.0);
+        m_Z_.push_back(Z);
+    }
+}
+
+} // namespace ghostfragment::topology
@@ -0,0 +1,95 @@
+/*
+ * Copyright 2024 GhostFragment
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "spatial_order.hpp"
+#include <algorithm>
+#include <array>
+#include <numeric>
+
+namespace ghostfragment::topology {
+
+hilbert_key_type hilbert_key(std::uint32_t x, std::uint32_t y, std::uint32_t z,
+                             unsigned bits) noexcept {
+    std::uint32_t X[3] = {x, y, z};
+    const std::uint32_t m = std::uint32_t(1) << (bits - 1);
+
+    // Inverse undo excess work
+    for(auto q = m; q > 1; q >>= 1) {
+        const auto p = q - 1;
+        for(int i = 0; i < 3; ++i) {
+            if(X[i] & q) {
+                X[0] ^= p;
+            } else {
+                const auto t = (X[0] ^ X[i]) & p;
+                X[0] ^= t;
+                X[i] ^= t;
+            }
+        }
+    }
+
+    // Gray encode
+    X[1] ^= X[0];
+    X[2] ^= X[1];
+    std::uint32_t t = 0;
+    for(auto q = m; q > 1; q >>= 1)
+        if(X[2] & q) t ^= q - 1;
+    for(auto& Xi : X) Xi ^= t;
+
+    // The key interleaves the bits of the transposed coordinates
+    hilbert_key_type key = 0;
+    for(int b = int(bits) - 1; b >= 0; --b)
+        for(int i = 0; i < 3; ++i) key = (key << 1) | ((X[i] >> b) & 1u);
+    return key;
+}
+
+std::vector<NucleiSnapshot::size_type> hilbert_order(
+  const NucleiSnapshot& snapshot) {
+    using size_type = NucleiSnapshot::size_type;
+    const auto n    = snapshot.size();
+
+    std::vector<size_type> order(n);
+    std::iota(order.begin(), order.end(), 0);
+    if(n < 2) return order;
+
+    // One scale for all directions, so the grid cells are cubes
+    std::array<double, 3> lo;
+    double extent = 0.0;
+    for(size_type q = 0; q < 3; ++q) {
+        const auto& r = q == 0 ? snapshot.x() :
+                                 (q == 1 ? snapshot.y() : snapshot.z());
+        const auto [min, max] = std::minmax_element(r.begin(), r.end());
+        lo[q]                 = *min;
+        extent                = std::max(extent, *max - *min);
+    }
+    const double max_index = double((1u << max_hilbert_bits) - 1);
+    const double scale     = extent > 0.0 ? max_index / extent : 0.0;
+
+    std::vector<hilbert_key_type> keys(n);
+    for(size_type i = 0; i < n; ++i) {
+        std::uint32_t g[3];
+        for(size_type q = 0; q < 3; ++q) {
+            const auto s = (snapshot.coord(i, q) - lo[q]) * scale;
+            g[q] = std::uint32_t(std::min(max_index, std::max(0.0, s)));
+        }
+        keys[i] = hilbert_key(g[0], g[1], g[2]);
+    }
+
+    auto by_key = [&](size_type i, size_type j) { return keys[i] < keys[j]; };
+    std::stable_sort(order.begin(), order.end(), by_key);
+    return order;
+}
+
+} // namespace ghostfragment::topology
@@ -0,0 +1,72 @@
+/*
+ * Copyright 2024 GhostFragment
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include "nuclei_snapshot.hpp"
+#include <cstdint>
+#include <vector>
+
+namespace ghostfragment::topology {
+
+/// Type of a position along the Hilbert curve
+using hilbert_key_type = std::uint64_t;
+
+/// The largest number of bits per coordinate hilbert_key supports
+constexpr unsigned max_hilbert_bits = 21;
+
+/** @brief The position of a grid point along a 3D Hilbert curve.
+ *
+ *  The Hilbert curve visits every point of a @f$2^b\times2^b\times2^b@f$ grid
+ *  such that consecutive points are always adjacent. Sorting objects by the
+ *  key of the grid point they fall in therefore keeps objects which are close
+ *  in space close in the sorted order. The key is computed with Skilling's
+ *  algorithm (AIP Conf. Proc. 707, 381 (2004)).
+ *
+ *  @param[in] x The x index of the grid point. Must be less than 2^@p bits.
+ *  @param[in] y The y index of the grid point. Must be less than 2^@p bits.
+ *  @param[in] z The z index of the grid point. Must be less than 2^@p bits.
+ *  @param[in] bits The number of bits per index. Must be in
+ *                  [1, max_hilbert_bits].
+ *
+ *  @return The position of (@p x, @p y, @p z) along the curve, in
+ *          [0, 2^(3 * @p bits)).
+ *
+ *  @throw None No throw guarantee.
+ */
+hilbert_key_type hilbert_key(std::uint32_t x, std::uint32_t y, std::uint32_t z,
+                             unsigned bits = max_hilbert_bits) noexcept;
+
+/** @brief Orders nuclei along a Hilbert curve through their bounding box.
+ *
+ *  Index-based structures (connectivity, graph nodes, fragments) inherit the
+ *  order of the nuclei, so an order in which nearby nuclei have nearby indices
+ *  improves the locality of every loop over them. This function maps the
+ *  bounding box of @p snapshot onto the finest supported Hilbert grid and
+ *  sorts the nuclei by the key of the grid point they fall in. Nuclei sharing
+ *  a grid point keep their original relative order.
+ *
+ *  @param[in] snapshot The nuclei to order.
+ *
+ *  @return The permutation, i.e., the i-th element is the (original) index of
+ *          the nucleus which should be i-th.
+ *
+ *  @throw std::bad_alloc if allocating the permutation fails. Strong throw
+ *                        guarantee.
+ */
+std::vector<NucleiSnapshot::size_type> hilbert_order(
+  const NucleiSnapshot& snapshot);
+
+} // namespace ghostfragment::topology
@@ -15,22 +15,52 @@
  */
 
 #pragma once
+#include <memory>
 #include <simde/simde.hpp>
 namespace ghostfragment::topology {
 
 DECLARE_MODULE(CovRadii);
 DECLARE_MODULE(NuclearGraphFromConnectivity);
 DECLARE_MODULE(BrokenBonds);
+DECLARE_MODULE(BrokenBondsByFragment);
+
+/** @brief Assigns bonds with a Verlet neighbor list kept between calls.
+ *
+ *  The other modules are stateless and declared with DECLARE_MODULE. This one
+ *  reuses the neighbor list of the previous call, so it is declared by hand to
+ *  give each instance a member owning its list. The list is created with the
+ *  instance and destroyed with it.
+ */
+class VerletConnectivity : public pluginplay::ModuleBase {
+public:
+    VerletConnectivity();
+    ~VerletConnectivity() noexcept;
+
+private:
+    /// Holds the neighbor list and the inputs it was made with
+    struct ListState;
+
+    pluginplay::type::result_map run_(
+      pluginplay::type::input_map inputs,
+      pluginplay::type::submodule_map submods) const override;
+
+    /// The state of this instance (run_ is const, the state is not)
+    std::unique_ptr<ListState> m_state_;
+};
 
 inline void load_modules(pluginplay::ModuleManager& mm) {
     mm.add_module<CovRadii>("Covalent Radius");
     mm.add_module<NuclearGraphFromConnectivity>("Nuclear Graph");
     mm.add_module<BrokenBonds>("Broken Bonds");
+    mm.add_module<BrokenBondsByFragment>("Broken Bonds By Fragment");
+    mm.add_module<VerletConnectivity>("Verlet Connectivity");
 }
 
 inline void set_defaults(pluginplay::ModuleManager& mm) {
     mm.change_submod("Nuclear Graph", "Nodes", "Heavy Atom Partition");
-    mm.change_submod("Nuclear Graph", "Connectivity", "Covalent Radius");
+
+    // The bond changes depend on the previous call
+    mm.at("Verlet Connectivity").turn_off_memoization();
 }
 
 } // namespace ghostfragment::topology
@@ -0,0 +1,121 @@
+/*
+ * Copyright 2024 GhostFragment
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "unit_cell.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+
+namespace ghostfragment::topology {
+namespace {
+
+using vector_type = UnitCell::vector_type;
+
+vector_type cross(const vector_type& u, const vector_type& v) noexcept {
+    return {u[1] * v[2] - u[2] * v[1], u[2] * v[0] - u[0] * v[2],
+            u[0] * v[1] - u[1] * v[0]};
+}
+
+double dot(const vector_type& u, const vector_type& v) noexcept {
+    return u[0] * v[0] + u[1] * v[1] + u[2] * v[2];
+}
+
+double norm(const vector_type& u) noexcept { return std::sqrt(dot(u, u)); }
+
+} // namespace
+
+UnitCell::UnitCell(const std::vector<coord_type>& lattice) {
+    if(lattice.size() != 9)
+        throw std::runtime_error("Lattice vectors must have 9 components, "
+                                 "not " +
+                                 std::to_string(lattice.size()));
+    std::copy(lattice.begin(), lattice.end(), m_lattice_.begin());
+
+    const auto a = lattice_vector(0);
+    const auto b = lattice_vector(1);
+    const auto c = lattice_vector(2);
+
+    // Rows of the inverse are the reciprocal vectors (without the 2 pi)
+    const auto bxc = cross(b, c);
+    const auto cxa = cross(c, a);
+    const auto axb = cross(a, b);
+    const auto det = dot(a, bxc);
+
+    // Relative test so the check does not depend on the size of the cell
+    const auto scale = norm(a) * norm(b) * norm(c);
+    if(!(std::fabs(det) > 1.0E-10 * scale))
+        throw std::runtime_error("Lattice vectors must be linearly "
+                                 "independent");
+
+    const vector_type* rows[3] = {&bxc, &cxa, &axb};
+    for(size_type q = 0; q < 3; ++q)
+        for(size_type r = 0; r < 3; ++r)
+            m_inverse_[3 * q + r] = (*rows[q])[r] / det;
+
+    m_volume_ = std::fabs(det);
+    for(size_type q = 0; q < 3; ++q) m_widths_[q] = m_volume_ / norm(*rows[q]);
+
+    m_orthorhombic_ = a[1] == 0.0 && a[2] == 0.0 && b[0] == 0.0 &&
+                      b[2] == 0.0 && c[0] == 0.0 && c[1] == 0.0;
+}
+
+UnitCell::coord_type UnitCell::min_width() const noexcept {
+    return *std::min_element(m_widths_.begin(), m_widths_.end());
+}
+
+UnitCell::vector_type UnitCell::to_fractional(coord_type x, coord_type y,
+                                              coord_type z) const noexcept {
+    const auto& m = m_inverse_;
+    return {m[0] * x + m[1] * y + m[2] * z, m[3] * x + m[4] * y + m[5] * z,
+            m[6] * x + m[7] * y + m[8] * z};
+}
+
+void UnitCell::minimum_image(coord_type& dx, coord_type& dy,
+                             coord_type& dz) const noexcept {
+    auto s = to_fractional(dx, dy, dz);
+    for(auto& si : s) si -= std::round(si);
+
+    const auto& l = m_lattice_;
+    dx = s[0] * l[0] + s[1] * l[3] + s[2] * l[6];
+    dy = s[0] * l[1] + s[1] * l[4] + s[2] * l[7];
+    dz = s[0] * l[2] + s[1] * l[5] + s[2] * l[8];
+    if(m_orthorhombic_) return;
+
+    // Rounding in fractional coordinates need not give the shortest vector
+    // for skewed cells, so also try the neighboring images
+    auto best_x = dx, best_y = dy, best_z = dz;
+    auto best   = dx * dx + dy * dy + dz * dz;
+    for(int i = -1; i <= 1; ++i)
+        for(int j = -1; j <= 1; ++j)
+            for(int k = -1; k <= 1; ++k) {
+                const auto x  = dx + i * l[0] + j * l[3] + k * l[6];
+                const auto y  = dy + i * l[1] + j * l[4] + k * l[7];
+                const auto z  = dz + i * l[2] + j * l[5] + k * l[8];
+                const auto r2 = x * x + y * y + z * z;
+                if(r2 < best) {
+                    best   = r2;
+                    best_x = x;
+                    best_y = y;
+                    best_z = z;
+                }
+            }
+    dx = best_x;
+    dy = best_y;
+    dz = best_z;
+}
+
+} // namespace ghostfragment::topology
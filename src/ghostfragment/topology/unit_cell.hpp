@@ -0,0 +1,166 @@
+/*
+ * Copyright 2024 GhostFragment
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include <array>
+#include <cstddef>
+#include <optional>
+#include <vector>
+
+namespace ghostfragment::topology {
+
+/** @brief The lattice of a periodic system.
+ *
+ *  A periodic system is described by the nuclei in one unit cell and the three
+ *  lattice vectors, @f$\mathbf{a}@f$, @f$\mathbf{b}@f$, and @f$\mathbf{c}@f$,
+ *  which translate the cell onto its images. This class stores the lattice
+ *  along with its inverse so that displacements can be reduced to their
+ *  minimum image, i.e., to the shortest displacement between one nucleus and
+ *  any periodic image of another.
+ *
+ *  Lattice vectors are given in Bohr, flattened as
+ *  @f$(a_x, a_y, a_z, b_x, b_y, b_z, c_x, c_y, c_z)@f$.
+ */
+class UnitCell {
+public:
+    /// Type used for indexing
+    using size_type = std::size_t;
+
+    /// Type of a coordinate or distance
+    using coord_type = double;
+
+    /// Type of a Cartesian or fractional vector
+    using vector_type = std::array<coord_type, 3>;
+
+    /// Type of the (flattened) lattice
+    using lattice_type = std::array<coord_type, 9>;
+
+    /** @brief Creates a unit cell from its lattice vectors.
+     *
+     *  @param[in] lattice The nine components of the lattice vectors, in Bohr,
+     *                     ordered as described in the class documentation.
+     *
+     *  @throw std::runtime_error if @p lattice does not have nine components
+     *                            or if the lattice vectors are linearly
+     *                            dependent. Strong throw guarantee.
+     */
+    explicit UnitCell(const std::vector<coord_type>& lattice);
+
+    /// The flattened lattice vectors
+    const lattice_type& lattice() const noexcept { return m_lattice_; }
+
+    /// The @p q-th lattice vector (0 for a, 1 for b, 2 for c)
+    vector_type lattice_vector(size_type q) const noexcept {
+        return {m_lattice_[3 * q], m_lattice_[3 * q + 1],
+                m_lattice_[3 * q + 2]};
+    }
+
+    /// The volume of the cell
+    coord_type volume() const noexcept { return m_volume_; }
+
+    /** @brief The width of the cell perpendicular to a pair of faces.
+     *
+     *  The width along @p q is the distance between the two faces of the cell
+     *  which are spanned by the other two lattice vectors. A sphere of radius
+     *  @f$r@f$ centered anywhere in the cell only touches its nearest image
+     *  along @p q if @f$2r@f$ exceeds this width.
+     *
+     *  @param[in] q Which lattice vector (0 for a, 1 for b, 2 for c).
+     *
+     *  @throw None No throw guarantee.
+     */
+    coord_type width(size_type q) const noexcept { return m_widths_[q]; }
+
+    /// The smallest of the three widths
+    coord_type min_width() const noexcept;
+
+    /// Are the lattice vectors aligned with the Cartesian axes?
+    bool is_orthorhombic() const noexcept { return m_orthorhombic_; }
+
+    /// Fractional coordinates of the Cartesian point (@p x, @p y, @p z)
+    vector_type to_fractional(coord_type x, coord_type y,
+                              coord_type z) const noexcept;
+
+    /** @brief Reduces a displacement to its minimum image.
+     *
+     *  Adds to (@p dx, @p dy, @p dz) the lattice translation which makes it as
+     *  short as possible. The result is exact for orthorhombic cells. For
+     *  other cells the images around the nearest one (in fractional
+     *  coordinates) are searched too, which is exact for all but pathologically
+     *  skewed cells.
+     *
+     *  @param[in,out] dx The x component of the displacement.
+     *  @param[in,out] dy The y component of the displacement.
+     *  @param[in,out] dz The z component of the displacement.
+     *
+     *  @throw None No throw guarantee.
+     */
+    void minimum_image(coord_type& dx, coord_type& dy,
+                       coord_type& dz) const noexcept;
+
+    /// Are the two cells spanned by the same lattice vectors?
+    bool operator==(const UnitCell& rhs) const noexcept {
+        return m_lattice_ == rhs.m_lattice_;
+    }
+
+    /// Are the two cells spanned by different lattice vectors?
+    bool operator!=(const UnitCell& rhs) const noexcept {
+        return !(*this == rhs);
+    }
+
+private:
+    /// The lattice vectors, one per row
+    lattice_type m_lattice_;
+
+    /// Row-major inverse of the matrix whose columns are the lattice vectors
+    lattice_type m_inverse_;
+
+    /// Perpendicular widths along a, b, and c
+    vector_type m_widths_;
+
+    /// The volume of the cell
+    coord_type m_volume_;
+
+    /// Are the lattice vectors aligned with the Cartesian axes?
+    bool m_orthorhombic_;
+};
+
+/// Key of the input through which modules take the lattice vectors
+inline constexpr auto lattice_key = "lattice vectors";
+
+/// Description of the lattice vectors input, the same for every module
+inline constexpr auto lattice_desc = R"(
+The lattice vectors (in Bohr) of the unit cell, flattened as
+(a_x, a_y, a_z, b_x, b_y, b_z, c_x, c_y, c_z). Empty for isolated systems.
+)";
+
+/** @brief The unit cell spanned by @p lattice, if the system is periodic.
+ *
+ *  @param[in] lattice The lattice vectors, as given to the lattice vectors
+ *                     input. Empty for isolated systems.
+ *
+ *  @return An empty optional if @p lattice is empty and the cell otherwise.
+ *
+ *  @throw std::runtime_error if @p lattice is not empty and is not a valid
+ *                            lattice. Strong throw guarantee.
+ */
+inline std::optional<UnitCell> make_unit_cell(
+  const std::vector<double>& lattice) {
+    if(lattice.empty()) return std::nullopt;
+    return UnitCell(lattice);
+}
+
+} // namespace ghostfragment::topology
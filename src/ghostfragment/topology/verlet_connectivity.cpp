@@ -0,0 +1,129 @@
+/*
+ * Copyright 2024 GhostFragment
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "topology.hpp"
+#include "unit_cell.hpp"
+#include "verlet_neighbor_list.hpp"
+#include <ghostfragment/property_types/topology/bond_changes.hpp>
+#include <ghostfragment/property_types/topology/connectivity_table.hpp>
+#include <memory>
+#include <mutex>
+
+namespace ghostfragment::topology {
+
+using my_pt       = pt::ConnectivityTable;
+using changes_pt  = pt::BondChanges;
+using traits_type = pt::BondChangesTraits;
+
+namespace {
+
+const auto mod_desc = R"(
+Connectivity Table via a Verlet Neighbor List
+---------------------------------------------
+
+Meant for trajectories, e.g., reactive molecular dynamics, where the bonding
+pattern can change from frame to frame. Bonds are assigned with the same
+criterion as the covalent radius module, but the module keeps a Verlet neighbor
+list between calls: the list holds every pair of nuclei within the longest
+possible bond plus a "skin" distance. Each frame only the pairs in the list are
+checked, and the list is only rebuilt (with a cell list) once some nucleus has
+moved more than half of the skin since the last build. The first frame, and any
+frame with different elements than the previous one, always triggers a
+rebuild.
+
+When run as a BondChanges module, the bonds which formed or broke since the
+previous call are also returned. Since these depend on the previous call the
+module should not be memoized, which is why memoization is turned off for it by
+default.
+
+The neighbor list belongs to the module's implementation and is freed with it.
+Copies of the module (e.g., made with ModuleManager::copy_module) share one
+implementation and thus one list, so calls on different copies count as
+consecutive frames of one trajectory; load the module again (add_module) for an
+independent trajectory.
+)";
+
+const auto tau_desc = R"(
+How much larger the actual distance can be compared to the predicted distance
+(as a ratio).
+)";
+
+const auto skin_desc = R"(
+Extra distance (in Bohr), beyond the longest possible bond, of the pairs kept in
+the neighbor list. Larger skins mean fewer rebuilds but more pairs per frame.
+)";
+
+} // namespace
+
+struct VerletConnectivity::ListState {
+    std::mutex mutex;
+    std::unique_ptr<VerletNeighborList> list;
+    std::vector<double> lattice;
+};
+
+MODULE_CTOR(VerletConnectivity) {
+    description(mod_desc);
+    satisfies_property_type<my_pt>();
+    satisfies_property_type<changes_pt>();
+
+    add_input<double>("tau").set_description(tau_desc).set_default(0.10);
+    add_input<double>("skin").set_description(skin_desc).set_default(1.0);
+    add_input<std::vector<double>>(lattice_key)
+      .set_description(lattice_desc)
+      .set_default(std::vector<double>{});
+
+    m_state_ = std::make_unique<ListState>();
+}
+
+VerletConnectivity::~VerletConnectivity() noexcept = default;
+
+MODULE_RUN(VerletConnectivity) {
+    auto& logger       = get_runtime().logger();
+    const auto& [mol]  = my_pt::unwrap_inputs(inputs);
+    const auto tau     = inputs.at("tau").value<double>();
+    const auto skin    = inputs.at("skin").value<double>();
+    const auto lattice = inputs.at(lattice_key).value<std::vector<double>>();
+
+    auto& state = *m_state_;
+    std::lock_guard<std::mutex> lock(state.mutex);
+
+    // Changing the criterion invalidates the list (and the previous bonds)
+    auto& list = state.list;
+    if(!list || list->tau() != tau || list->skin() != skin ||
+       state.lattice != lattice) {
+        using list_type = VerletNeighborList;
+        list            = std::make_unique<list_type>(tau, skin, lattice);
+        state.lattice   = lattice;
+    }
+
+    const auto changes = list->update(NucleiSnapshot(mol));
+    logger.debug(std::string(changes.rebuilt ? "Rebuilt" : "Reused") +
+                 " the neighbor list (" + std::to_string(list->npairs()) +
+                 " pairs). " + std::to_string(changes.formed.size()) +
+                 " bonds formed and " + std::to_string(changes.broken.size()) +
+                 " broke.");
+
+    traits_type::bond_set_type formed(changes.formed.begin(),
+                                      changes.formed.end());
+    traits_type::bond_set_type broken(changes.broken.begin(),
+                                      changes.broken.end());
+
+    auto rv = results();
+    return changes_pt::wrap_results(rv, list->connectivity(), std::move(formed),
+                                    std::move(broken));
+}
+
+} // namespace ghostfragment::topology
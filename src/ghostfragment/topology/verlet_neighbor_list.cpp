@@ -0,0 +1,123 @@
+/*
+ * Copyright 2024 GhostFragment
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "cell_list.hpp"
+#include "distance_kernels.hpp"
+#include "verlet_neighbor_list.hpp"
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+
+namespace ghostfragment::topology {
+
+VerletNeighborList::VerletNeighborList(coord_type tau, coord_type skin,
+                                       const std::vector<coord_type>& lattice) :
+  m_tau_(tau), m_skin_(skin) {
+    if(!(skin >= 0.0))
+        throw std::runtime_error("The skin distance can not be negative");
+    if(!lattice.empty()) m_cell_.emplace(lattice);
+}
+
+VerletNeighborList::BondChanges VerletNeighborList::update(
+  const NucleiSnapshot& snapshot) {
+    BondChanges changes;
+    if(needs_rebuild_(snapshot)) {
+        // A different system shares no bonds with the previous one
+        if(m_reference_.Z() != snapshot.Z()) m_bonds_.clear();
+        rebuild_(snapshot);
+        changes.rebuilt = true;
+    }
+
+    // Pairs are sorted, so the new bonds are too
+    bond_list bonds;
+    for(size_type p = 0; p < m_pairs_.size(); ++p) {
+        const auto& [i, j] = m_pairs_[p];
+        if(distance_squared_(snapshot, i, j) <= m_thresholds_[p])
+            bonds.push_back(m_pairs_[p]);
+    }
+
+    std::set_difference(bonds.begin(), bonds.end(), m_bonds_.begin(),
+                        m_bonds_.end(), std::back_inserter(changes.formed));
+    std::set_difference(m_bonds_.begin(), m_bonds_.end(), bonds.begin(),
+                        bonds.end(), std::back_inserter(changes.broken));
+    m_bonds_ = std::move(bonds);
+    return changes;
+}
+
+VerletNeighborList::connectivity_type VerletNeighborList::connectivity()
+  const {
+    connectivity_type rv(m_reference_.size());
+    for(const auto& [i, j] : m_bonds_) rv.add_bond(i, j);
+    return rv;
+}
+
+bool VerletNeighborList::needs_rebuild_(
+  const NucleiSnapshot& snapshot) const noexcept {
+    if(m_nbuilds_ == 0 || snapshot.Z() != m_reference_.Z()) return true;
+
+    // Two nuclei which each moved at most skin / 2 got at most skin closer
+    const auto max_move2 = 0.25 * m_skin_ * m_skin_;
+    for(size_type i = 0; i < snapshot.size(); ++i) {
+        auto dx = snapshot.x()[i] - m_reference_.x()[i];
+        auto dy = snapshot.y()[i] - m_reference_.y()[i];
+        auto dz = snapshot.z()[i] - m_reference_.z()[i];
+        // Nuclei wrapped back into the cell have not really moved
+        if(m_cell_) m_cell_->minimum_image(dx, dy, dz);
+        if(dx * dx + dy * dy + dz * dz > max_move2) return true;
+    }
+    return false;
+}
+
+void VerletNeighborList::rebuild_(const NucleiSnapshot& snapshot) {
+    const SquaredThresholdTable thresholds(snapshot, m_tau_);
+    const auto& radii = snapshot.radius();
+    const auto max_radius =
+      radii.empty() ? 0.0 : *std::max_element(radii.begin(), radii.end());
+    const auto cutoff = (1.0 + m_tau_) * 2.0 * max_radius + m_skin_;
+
+    bond_list pairs;
+    std::vector<coord_type> pair_thresholds;
+    if(cutoff > 0.0) {
+        auto pair_fxn = [&](size_type i, size_type j, coord_type) {
+            pairs.emplace_back(i, j);
+        };
+        if(m_cell_)
+            CellList(snapshot, cutoff, *m_cell_).for_each_pair(pair_fxn);
+        else
+            CellList(snapshot, cutoff).for_each_pair(pair_fxn);
+        std::sort(pairs.begin(), pairs.end());
+
+        pair_thresholds.reserve(pairs.size());
+        for(const auto& [i, j] : pairs)
+            pair_thresholds.push_back(thresholds(i, j));
+    }
+
+    m_pairs_      = std::move(pairs);
+    m_thresholds_ = std::move(pair_thresholds);
+    m_reference_  = snapshot;
+    ++m_nbuilds_;
+}
+
+VerletNeighborList::coord_type VerletNeighborList::distance_squared_(
+  const NucleiSnapshot& snapshot, size_type i, size_type j) const noexcept {
+    auto dx = snapshot.x()[j] - snapshot.x()[i];
+    auto dy = snapshot.y()[j] - snapshot.y()[i];
+    auto dz = snapshot.z()[j] - snapshot.z()[i];
+    if(m_cell_) m_cell_->minimum_image(dx, dy, dz);
+    return dx * dx + dy * dy + dz * dz;
+}
+
+} // namespace ghostfragment::topology
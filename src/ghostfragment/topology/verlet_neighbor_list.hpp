@@ -0,0 +1,163 @@
+/*
+ * Copyright 2024 GhostFragment
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include "nuclei_snapshot.hpp"
+#include "unit_cell.hpp"
+#include <chemist/topology/connectivity_table.hpp>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace ghostfragment::topology {
+
+/** @brief Incrementally updated connectivity for a trajectory.
+ *
+ *  Recomputing the connectivity of every frame of a trajectory from scratch
+ *  searches all pairs of nuclei each time, even though the nuclei barely move
+ *  between frames. A Verlet neighbor list instead records, when it is built,
+ *  every pair of nuclei which is within the longest possible bond plus a
+ *  "skin" distance. As long as no nucleus has moved more than half of the
+ *  skin since then, no pair outside of the list can have come within bonding
+ *  distance, so each frame only needs to recheck the pairs in the list. The
+ *  list is rebuilt (with a cell list) once some nucleus moves further.
+ *
+ *  Bonds are determined exactly as by the covalent radius module, i.e., nuclei
+ *  @f$i@f$ and @f$j@f$ are bonded if
+ *  @f$r_{ij} \le (1 + \tau)(\sigma_i + \sigma_j)@f$. For periodic systems
+ *  @f$r_{ij}@f$ is the minimum-image distance.
+ */
+class VerletNeighborList {
+public:
+    /// Type used for indexing and offsets
+    using size_type = NucleiSnapshot::size_type;
+
+    /// Type of a coordinate or distance
+    using coord_type = NucleiSnapshot::coord_type;
+
+    /// Type of a bond (or pair), always stored with first < second
+    using bond_type = std::pair<size_type, size_type>;
+
+    /// Type of a sorted list of bonds
+    using bond_list = std::vector<bond_type>;
+
+    /// Type of the connectivity table the bonds can be converted to
+    using connectivity_type = chemist::topology::ConnectivityTable;
+
+    /// How the bonds changed from one frame to the next
+    struct BondChanges {
+        /// Bonds present now, but not in the previous frame (sorted)
+        bond_list formed;
+
+        /// Bonds present in the previous frame, but not now (sorted)
+        bond_list broken;
+
+        /// Was the neighbor list rebuilt for this frame?
+        bool rebuilt = false;
+    };
+
+    /** @brief Creates a neighbor list which has not seen any frames.
+     *
+     *  @param[in] tau How much longer (as a ratio) a bond can be than the sum
+     *                 of the covalent radii.
+     *  @param[in] skin How much further apart (in Bohr) than the longest
+     *                  possible bond two nuclei may be and still be in the
+     *                  list. Larger skins mean fewer rebuilds, but more pairs
+     *                  to check per frame.
+     *  @param[in] lattice The lattice vectors of the unit cell (see UnitCell),
+     *                     or empty for isolated systems.
+     *
+     *  @throw std::runtime_error if @p skin is negative or if @p lattice is
+     *                            not a valid set of lattice vectors. Strong
+     *                            throw guarantee.
+     */
+    VerletNeighborList(coord_type tau, coord_type skin,
+                       const std::vector<coord_type>& lattice = {});
+
+    /** @brief Computes the bonds for a new frame.
+     *
+     *  The first frame, and any frame whose elements differ from those of the
+     *  previous frame, always causes a rebuild. For such frames every bond is
+     *  reported as formed (and every bond of the previous frame as broken).
+     *
+     *  @param[in] snapshot The geometry of the new frame.
+     *
+     *  @return The bonds which formed and broke since the previous frame.
+     *
+     *  @throw std::runtime_error if the system is periodic and the longest
+     *                            possible bond plus the skin exceeds half the
+     *                            narrowest width of the cell. Basic throw
+     *                            guarantee.
+     *  @throw std::bad_alloc if allocating the list fails. Basic throw
+     *                        guarantee.
+     */
+    BondChanges update(const NucleiSnapshot& snapshot);
+
+    /// The bonds of the most recent frame (sorted)
+    const bond_list& bonds() const noexcept { return m_bonds_; }
+
+    /// The bonds of the most recent frame as a connectivity table
+    connectivity_type connectivity() const;
+
+    /// The number of pairs which are rechecked every frame
+    size_type npairs() const noexcept { return m_pairs_.size(); }
+
+    /// How many times the list has been built
+    size_type nbuilds() const noexcept { return m_nbuilds_; }
+
+    /// The ratio by which bonds may exceed the sum of the covalent radii
+    coord_type tau() const noexcept { return m_tau_; }
+
+    /// The skin distance, in Bohr
+    coord_type skin() const noexcept { return m_skin_; }
+
+private:
+    /// Does @p snapshot require the list to be rebuilt?
+    bool needs_rebuild_(const NucleiSnapshot& snapshot) const noexcept;
+
+    /// Builds the list of pairs from @p snapshot
+    void rebuild_(const NucleiSnapshot& snapshot);
+
+    /// Squared (minimum-image, if periodic) distance between i and j
+    coord_type distance_squared_(const NucleiSnapshot& snapshot, size_type i,
+                                 size_type j) const noexcept;
+
+    /// Bond thresholds are (1 + tau) times the sum of the covalent radii
+    coord_type m_tau_;
+
+    /// Extra distance included in the list
+    coord_type m_skin_;
+
+    /// The unit cell, if the system is periodic
+    std::optional<UnitCell> m_cell_;
+
+    /// The geometry the list was last built for
+    NucleiSnapshot m_reference_;
+
+    /// The pairs within the longest bond plus the skin (sorted)
+    bond_list m_pairs_;
+
+    /// The squared bonding threshold of each pair in m_pairs_
+    std::vector<coord_type> m_thresholds_;
+
+    /// The bonds of the most recent frame
+    bond_list m_bonds_;
+
+    /// The number of times the list was built
+    size_type m_nbuilds_ = 0;
+};
+
+} // namespace ghostfragment::topology
@@ -0,0 +1,112 @@
+/*
+ * Copyright 2024 GhostFragment
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "allocation_tracker.hpp"
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace ghostfragment::utilities {
+namespace {
+
+/* The high-water mark of the monitors which reset the kernel's one. The
+ * kernel only knows the peak since the last reset, so StageMemoryMonitor puts
+ * the enclosing peak here when it is done.
+ */
+std::atomic<std::size_t> g_carried_peak{0};
+
+void update_peak(std::size_t value) noexcept {
+    auto peak = g_carried_peak.load(std::memory_order_relaxed);
+    while(value > peak &&
+          !g_carried_peak.compare_exchange_weak(peak, value,
+                                                std::memory_order_relaxed)) {}
+}
+
+// The "<key>: <value> kB" entry of /proc/self/status, in bytes (0 if missing)
+std::size_t status_bytes(const char* key) noexcept {
+    std::FILE* status = std::fopen("/proc/self/status", "r");
+    if(!status) return 0;
+
+    const auto key_size = std::strlen(key);
+    std::size_t rv      = 0;
+    char line[256];
+    while(std::fgets(line, sizeof(line), status)) {
+        if(std::strncmp(line, key, key_size) || line[key_size] != ':')
+            continue;
+        rv = std::strtoull(line + key_size + 1, nullptr, 10) * 1024;
+        break;
+    }
+    std::fclose(status);
+    return rv;
+}
+
+// Sets the kernel's high-water mark of the RSS to the current RSS
+bool reset_kernel_peak() noexcept {
+    std::FILE* clear_refs = std::fopen("/proc/self/clear_refs", "w");
+    if(!clear_refs) return false;
+    const bool written = std::fputs("5", clear_refs) >= 0;
+    return std::fclose(clear_refs) == 0 && written;
+}
+
+bool can_measure() noexcept {
+#ifdef GHOSTFRAGMENT_TRACK_ALLOCATIONS
+    return status_bytes("VmHWM") > 0 && reset_kernel_peak();
+#else
+    return false;
+#endif
+}
+
+} // namespace
+
+bool AllocationTracker::is_enabled() noexcept {
+    static const bool enabled = can_measure();
+    return enabled;
+}
+
+AllocationTracker::size_type AllocationTracker::current_bytes() noexcept {
+    return is_enabled() ? status_bytes("VmRSS") : 0;
+}
+
+AllocationTracker::size_type AllocationTracker::peak_bytes() noexcept {
+    if(!is_enabled()) return 0;
+    const auto carried = g_carried_peak.load(std::memory_order_relaxed);
+    const auto kernel  = status_bytes("VmHWM");
+    return kernel > carried ? kernel : carried;
+}
+
+AllocationTracker::size_type AllocationTracker::reset_peak() noexcept {
+    if(!is_enabled()) return 0;
+    const auto old = peak_bytes();
+    reset_kernel_peak();
+    g_carried_peak.store(0, std::memory_order_relaxed);
+    return old;
+}
+
+StageMemoryMonitor::StageMemoryMonitor() noexcept :
+  m_baseline_(AllocationTracker::current_bytes()),
+  m_enclosing_peak_(AllocationTracker::reset_peak()) {}
+
+StageMemoryMonitor::~StageMemoryMonitor() noexcept {
+    update_peak(m_enclosing_peak_);
+}
+
+StageMemoryMonitor::size_type StageMemoryMonitor::peak_bytes() const noexcept {
+    const auto peak = AllocationTracker::peak_bytes();
+    return peak > m_baseline_ ? peak - m_baseline_ : 0;
+}
+
+} // namespace ghostfragment::utilities
@@ -0,0 +1,87 @@
+/*
+ * Copyright 2024 GhostFragment
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include <cstddef>
+
+namespace ghostfragment::utilities {
+
+/** @brief Reports how much memory the process uses, as seen by the kernel.
+ *
+ *  The counters are the resident set size (RSS) of the process and its
+ *  high-water mark, which Linux reports in /proc/self/status. Nothing is
+ *  intercepted, so every allocation (including those made by other libraries
+ *  or by malloc directly) counts, at page granularity. The high-water mark is
+ *  reset by writing to /proc/self/clear_refs, which affects the whole process.
+ *  Measuring is thus opt-in: when GhostFragment is not configured with
+ *  GHOSTFRAGMENT_TRACK_ALLOCATIONS, or the files are not available, all of the
+ *  counters remain zero. is_enabled() can be used to tell the two situations
+ *  apart.
+ *
+ *  All members are thread-safe.
+ */
+class AllocationTracker {
+public:
+    /// Type used for counting bytes
+    using size_type = std::size_t;
+
+    /// Is memory use being measured?
+    static bool is_enabled() noexcept;
+
+    /// The number of bytes currently resident
+    static size_type current_bytes() noexcept;
+
+    /// The high-water mark of current_bytes() since the last reset_peak()
+    static size_type peak_bytes() noexcept;
+
+    /// Sets the high-water mark to current_bytes(), returns the old value
+    static size_type reset_peak() noexcept;
+};
+
+/** @brief Measures the peak memory use of a stage of a calculation.
+ *
+ *  Creating a StageMemoryMonitor resets the high-water mark of the
+ *  AllocationTracker. While the monitor is alive, peak_bytes() returns the
+ *  maximum number of bytes in use on top of what was already in use when the
+ *  monitor was created. When the monitor is destroyed the tracker's
+ *  high-water mark is restored so that monitors may be nested.
+ */
+class StageMemoryMonitor {
+public:
+    /// Type used for counting bytes
+    using size_type = AllocationTracker::size_type;
+
+    /// Starts monitoring
+    StageMemoryMonitor() noexcept;
+
+    /// Stops monitoring and restores the enclosing high-water mark
+    ~StageMemoryMonitor() noexcept;
+
+    StageMemoryMonitor(const StageMemoryMonitor&)            = delete;
+    StageMemoryMonitor& operator=(const StageMemoryMonitor&) = delete;
+
+    /// Peak number of bytes used since this monitor was created
+    size_type peak_bytes() const noexcept;
+
+private:
+    /// Bytes in use when the monitor was created
+    size_type m_baseline_;
+
+    /// High-water mark before the monitor was created
+    size_type m_enclosing_peak_;
+};
+
+} // namespace ghostfragment::utilities
@@ -0,0 +1,55 @@
+/*
+ * Copyright 2024 GhostFragment
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include <cstddef>
+#include <limits>
+#include <numeric>
+
+namespace ghostfragment::utilities {
+
+/** @brief The number of ways to choose @p k of @p n items.
+ *
+ *  The binomial coefficient is computed exactly with integer arithmetic. If
+ *  it does not fit in a std::size_t, std::numeric_limits<std::size_t>::max()
+ *  is returned instead.
+ *
+ *  @param[in] n The number of items.
+ *  @param[in] k The number of items to choose.
+ *
+ *  @return The binomial coefficient, or 0 if @p k > @p n.
+ *
+ *  @throw None No throw guarantee.
+ */
+inline std::size_t binomial(std::size_t n, std::size_t k) noexcept {
+    constexpr auto max = std::numeric_limits<std::size_t>::max();
+    if(k > n) return 0;
+    if(k > n - k) k = n - k;
+
+    // After step i, rv is C(n - k + i, i). Dividing by the gcd first keeps
+    // every intermediate value exact and no larger than the result.
+    std::size_t rv = 1;
+    for(std::size_t i = 1; i <= k; ++i) {
+        const auto gcd    = std::gcd(rv, i);
+        const auto factor = (n - k + i) / (i / gcd);
+        rv /= gcd;
+        if(rv > max / factor) return max;
+        rv *= factor;
+    }
+    return rv;
+}
+
+} // namespace ghostfragment::utilities
@@ -0,0 +1,110 @@
+/*
+ * Copyright 2024 GhostFragment
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "index_set.hpp"
+#include <memory>
+
+namespace ghostfragment::utilities {
+
+IndexSet::IndexSet(const IndexSet& other) : IndexSet() {
+    reserve_(other.m_size_);
+    std::copy(other.begin(), other.end(), m_data_);
+    m_size_ = other.m_size_;
+}
+
+IndexSet::IndexSet(IndexSet&& other) noexcept : IndexSet() {
+    *this = std::move(other);
+}
+
+IndexSet& IndexSet::operator=(const IndexSet& rhs) {
+    if(this == &rhs) return *this;
+    reserve_(rhs.m_size_);
+    std::copy(rhs.begin(), rhs.end(), m_data_);
+    m_size_ = rhs.m_size_;
+    return *this;
+}
+
+IndexSet& IndexSet::operator=(IndexSet&& rhs) noexcept {
+    if(this == &rhs) return *this;
+    if(rhs.m_data_ == rhs.m_buffer_) {
+        // Small sets have to be copied, but fit in any storage
+        std::copy(rhs.begin(), rhs.end(), m_data_);
+    } else {
+        if(m_data_ != m_buffer_) delete[] m_data_;
+        m_data_         = rhs.m_data_;
+        m_capacity_     = rhs.m_capacity_;
+        rhs.m_data_     = rhs.m_buffer_;
+        rhs.m_capacity_ = inline_capacity;
+    }
+    m_size_     = rhs.m_size_;
+    rhs.m_size_ = 0;
+    return *this;
+}
+
+IndexSet::~IndexSet() noexcept {
+    if(m_data_ != m_buffer_) delete[] m_data_;
+}
+
+bool IndexSet::insert(value_type value) {
+    auto itr = std::lower_bound(begin(), end(), value);
+    if(itr != end() && *itr == value) return false;
+    const auto offset = static_cast<size_type>(itr - begin());
+    if(m_size_ == m_capacity_) reserve_(2 * m_capacity_);
+    std::copy_backward(m_data_ + offset, m_data_ + m_size_,
+                       m_data_ + m_size_ + 1);
+    m_data_[offset] = value;
+    ++m_size_;
+    return true;
+}
+
+std::size_t IndexSet::hash() const noexcept {
+    // The combination step of boost::hash_combine
+    std::size_t seed = m_size_;
+    for(const auto value : *this)
+        seed ^= std::hash<value_type>{}(value) + 0x9e3779b9 + (seed << 6) +
+                (seed >> 2);
+    return seed;
+}
+
+IndexSet set_intersection(const IndexSet& lhs, const IndexSet& rhs) {
+    IndexSet rv;
+    rv.reserve_(std::min(lhs.size(), rhs.size()));
+    auto last = std::set_intersection(lhs.begin(), lhs.end(), rhs.begin(),
+                                      rhs.end(), rv.m_data_);
+    rv.m_size_ = static_cast<IndexSet::size_type>(last - rv.m_data_);
+    return rv;
+}
+
+void IndexSet::reserve_(size_type capacity) {
+    if(capacity <= m_capacity_) return;
+    std::unique_ptr<value_type[]> new_data(new value_type[capacity]);
+    std::copy(begin(), end(), new_data.get());
+    if(m_data_ != m_buffer_) delete[] m_data_;
+    m_data_     = new_data.release();
+    m_capacity_ = capacity;
+}
+
+void IndexSet::normalize_(size_type nsorted) {
+    auto first  = m_data_;
+    auto middle = m_data_ + nsorted;
+    auto last   = m_data_ + m_size_;
+    if(!std::is_sorted(middle, last)) std::sort(middle, last);
+    if(nsorted > 0 && middle != last && *middle < *(middle - 1))
+        std::inplace_merge(first, middle, last);
+    m_size_ = static_cast<size_type>(std::unique(first, last) - first);
+}
+
+} // namespace ghostfragment::utilities
@@ -0,0 +1,204 @@
+/*
+ * Copyright 2024 GhostFragment
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+
+namespace ghostfragment::utilities {
+
+/** @brief A set of indices (e.g., of nuclei) stored as a sorted array.
+ *
+ *  std::set allocates a node per element and every lookup or comparison
+ *  chases pointers through those nodes. IndexSet instead keeps its elements
+ *  sorted and unique in one contiguous array. Sets with at most
+ *  inline_capacity elements live in a buffer inside the object and need no
+ *  allocation at all. Iteration, comparison, hashing, subset tests and
+ *  intersections are then simple linear passes over arrays.
+ *
+ *  Comparisons are lexicographic, so sorting IndexSets gives the same order
+ *  as sorting the corresponding std::sets.
+ */
+class IndexSet {
+public:
+    /// Type of the elements
+    using value_type = std::size_t;
+
+    /// Type used for sizes and offsets
+    using size_type = std::size_t;
+
+    /// Type of an iterator over the (sorted) elements
+    using const_iterator = const value_type*;
+
+    /// The number of elements which can be stored without allocating
+    static constexpr size_type inline_capacity = 8;
+
+    /// Creates an empty set
+    IndexSet() noexcept : m_data_(m_buffer_) {}
+
+    /// Creates a set with the elements of @p il (in any order)
+    IndexSet(std::initializer_list<value_type> il) :
+      IndexSet(il.begin(), il.end()) {}
+
+    /** @brief Creates a set with the elements in [@p begin, @p end).
+     *
+     *  The elements may be in any order and may repeat. Already sorted input
+     *  is detected and is not sorted again.
+     *
+     *  @throw std::bad_alloc if allocating the elements fails.
+     */
+    template<typename IteratorType>
+    IndexSet(IteratorType begin, IteratorType end) : IndexSet() {
+        insert(begin, end);
+    }
+
+    /// Deep copies @p other
+    IndexSet(const IndexSet& other);
+
+    /// Takes the elements of @p other, leaving it empty
+    IndexSet(IndexSet&& other) noexcept;
+
+    /// Deep copies @p rhs into this set
+    IndexSet& operator=(const IndexSet& rhs);
+
+    /// Takes the elements of @p rhs, leaving it empty
+    IndexSet& operator=(IndexSet&& rhs) noexcept;
+
+    /// Releases the elements
+    ~IndexSet() noexcept;
+
+    /// The smallest element
+    const_iterator begin() const noexcept { return m_data_; }
+
+    /// Just past the largest element
+    const_iterator end() const noexcept { return m_data_ + m_size_; }
+
+    /// The @p i-th smallest element, @p i must be less than size()
+    value_type operator[](size_type i) const noexcept { return m_data_[i]; }
+
+    /// The number of elements
+    size_type size() const noexcept { return m_size_; }
+
+    /// Is the set empty?
+    bool empty() const noexcept { return m_size_ == 0; }
+
+    /// Is @p value in the set? Binary search.
+    bool contains(value_type value) const noexcept {
+        return std::binary_search(begin(), end(), value);
+    }
+
+    /** @brief Adds @p value to the set.
+     *
+     *  @return True if @p value was added and false if it already was in the
+     *          set.
+     *
+     *  @throw std::bad_alloc if allocating the elements fails. Strong throw
+     *                        guarantee.
+     */
+    bool insert(value_type value);
+
+    /** @brief Adds the elements in [@p begin, @p end) to the set.
+     *
+     *  @throw std::bad_alloc if allocating the elements fails.
+     */
+    template<typename IteratorType>
+    void insert(IteratorType begin, IteratorType end) {
+        const auto old_size = m_size_;
+        for(; begin != end; ++begin) push_back_(*begin);
+        normalize_(old_size);
+    }
+
+    /// Removes all elements, keeping the storage
+    void clear() noexcept { m_size_ = 0; }
+
+    /// A hash of the elements, equal sets have equal hashes
+    std::size_t hash() const noexcept;
+
+    /// Do the sets have the same elements?
+    bool operator==(const IndexSet& rhs) const noexcept {
+        return std::equal(begin(), end(), rhs.begin(), rhs.end());
+    }
+
+    /// Do the sets have different elements?
+    bool operator!=(const IndexSet& rhs) const noexcept {
+        return !(*this == rhs);
+    }
+
+    /// Lexicographic comparison, as for std::set
+    bool operator<(const IndexSet& rhs) const noexcept {
+        return std::lexicographical_compare(begin(), end(), rhs.begin(),
+                                            rhs.end());
+    }
+
+    /** @brief The elements in both @p lhs and @p rhs.
+     *
+     *  @throw std::bad_alloc if allocating the elements fails.
+     */
+    friend IndexSet set_intersection(const IndexSet& lhs, const IndexSet& rhs);
+
+private:
+    /// Makes room for at least @p capacity elements
+    void reserve_(size_type capacity);
+
+    /// Appends @p value, without restoring the order
+    void push_back_(value_type value) {
+        if(m_size_ == m_capacity_) reserve_(2 * m_capacity_);
+        m_data_[m_size_++] = value;
+    }
+
+    /// Sorts and deduplicates after elements were appended to the first
+    /// @p nsorted (sorted) ones
+    void normalize_(size_type nsorted);
+
+    /// The elements, either m_buffer_ or an allocation
+    value_type* m_data_;
+
+    /// The number of elements
+    size_type m_size_ = 0;
+
+    /// The number of elements m_data_ can hold
+    size_type m_capacity_ = inline_capacity;
+
+    /// The storage of small sets
+    value_type m_buffer_[inline_capacity];
+};
+
+/// Is every element of @p subset also in @p superset?
+inline bool includes(const IndexSet& superset,
+                     const IndexSet& subset) noexcept {
+    return subset.size() <= superset.size() &&
+           std::includes(superset.begin(), superset.end(), subset.begin(),
+                         subset.end());
+}
+
+IndexSet set_intersection(const IndexSet& lhs, const IndexSet& rhs);
+
+} // namespace ghostfragment::utilities
+
+namespace std {
+
+/// Allows IndexSets to be used in unordered containers
+template<>
+struct hash<ghostfragment::utilities::IndexSet> {
+    std::size_t operator()(
+      const ghostfragment::utilities::IndexSet& set) const noexcept {
+        return set.hash();
+    }
+};
+
+} // namespace std
@@ -0,0 +1,68 @@
+/*
+ * Copyright 2024 GhostFragment
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "mapped_file.hpp"
+#include <fcntl.h>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utility>
+
+namespace ghostfragment::utilities {
+
+MappedFile::MappedFile(const path_type& path) {
+    const auto fd = ::open(path.c_str(), O_RDONLY);
+    if(fd < 0) throw std::runtime_error("Could not open " + path.string());
+
+    struct stat info;
+    if(::fstat(fd, &info) != 0) {
+        ::close(fd);
+        throw std::runtime_error("Could not open " + path.string());
+    }
+
+    if(info.st_size > 0) {
+        auto* p = ::mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if(p == MAP_FAILED) {
+            ::close(fd);
+            throw std::runtime_error("Could not map " + path.string());
+        }
+        m_data_ = static_cast<const char*>(p);
+        m_size_ = info.st_size;
+    }
+    ::close(fd);
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept :
+  m_data_(std::exchange(other.m_data_, nullptr)),
+  m_size_(std::exchange(other.m_size_, 0)) {}
+
+MappedFile& MappedFile::operator=(MappedFile&& rhs) noexcept {
+    if(this != &rhs) {
+        unmap_();
+        m_data_ = std::exchange(rhs.m_data_, nullptr);
+        m_size_ = std::exchange(rhs.m_size_, 0);
+    }
+    return *this;
+}
+
+MappedFile::~MappedFile() noexcept { unmap_(); }
+
+void MappedFile::unmap_() noexcept {
+    if(m_data_ != nullptr) ::munmap(const_cast<char*>(m_data_), m_size_);
+}
+
+} // namespace ghostfragment::utilities
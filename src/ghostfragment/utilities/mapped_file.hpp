@@ -0,0 +1,79 @@
+/*
+ * Copyright 2024 GhostFragment
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include <cstddef>
+#include <filesystem>
+#include <string_view>
+
+namespace ghostfragment::utilities {
+
+/** @brief A read-only memory mapping of an entire file.
+ *
+ *  Reading a large file through a stream copies every byte into a buffer
+ *  before it is parsed. Mapping the file instead lets the parser work on the
+ *  page cache directly, and lets several threads work on different parts of
+ *  the file at once. The mapping is released when the instance is destroyed.
+ *
+ *  Empty files are supported; data() is then a null pointer.
+ */
+class MappedFile {
+public:
+    /// Type used for paths
+    using path_type = std::filesystem::path;
+
+    /// Type used for sizes
+    using size_type = std::size_t;
+
+    /** @brief Maps the file at @p path.
+     *
+     *  @throw std::runtime_error if the file can not be opened or mapped.
+     */
+    explicit MappedFile(const path_type& path);
+
+    /// Mappings can be moved, but not copied
+    MappedFile(MappedFile&& other) noexcept;
+
+    /// Releases the mapping of this instance and takes that of @p rhs
+    MappedFile& operator=(MappedFile&& rhs) noexcept;
+
+    MappedFile(const MappedFile&)            = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /// Releases the mapping
+    ~MappedFile() noexcept;
+
+    /// The first byte of the file
+    const char* data() const noexcept { return m_data_; }
+
+    /// The number of bytes in the file
+    size_type size() const noexcept { return m_size_; }
+
+    /// The contents of the file
+    std::string_view view() const noexcept { return {m_data_, m_size_}; }
+
+private:
+    /// Releases the mapping (if there is one)
+    void unmap_() noexcept;
+
+    /// The mapped bytes
+    const char* m_data_ = nullptr;
+
+    /// The number of mapped bytes
+    size_type m_size_ = 0;
+};
+
+} // namespace ghostfragment::utilities
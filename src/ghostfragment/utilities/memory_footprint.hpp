@@ -0,0 +1,133 @@
+/*
+ * Copyright 2024 GhostFragment
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include <chemist/fragmenting/fragmented_nuclei.hpp>
+#include <cstdio>
+#include <ghostfragment/nuclear_graph.hpp>
+#include <string>
+#include <vector>
+
+namespace ghostfragment::utilities {
+
+/** @brief Estimates the number of bytes used to store a set of nuclei.
+ *
+ *  The estimate counts each nucleus as a full chemist::Nucleus object plus any
+ *  heap storage needed for its name (names short enough to fit in the small
+ *  string buffer are free).
+ *
+ *  @param[in] nuclei The nuclei whose footprint is wanted.
+ *
+ *  @return The estimated number of bytes held by @p nuclei.
+ *
+ *  @throw None No throw guarantee.
+ */
+template<typename NucleiType>
+std::size_t nuclei_footprint(const NucleiType& nuclei) noexcept {
+    using nucleus_type = typename chemist::Nuclei::value_type;
+    const std::size_t sso_size = std::string{}.capacity();
+
+    std::size_t nbytes = nuclei.size() * sizeof(nucleus_type);
+    for(std::size_t i = 0; i < nuclei.size(); ++i) {
+        const auto name_size = nuclei[i].name().size();
+        if(name_size > sso_size) nbytes += name_size + 1;
+    }
+    return nbytes;
+}
+
+/** @brief Estimates the number of bytes held by a FragmentedNuclei object.
+ *
+ *  The estimate is broken into the supersystem, the index sets for the
+ *  fragments (which includes any intersections stored in the object), and the
+ *  caps.
+ *
+ *  @param[in] frags The object whose footprint is wanted.
+ *
+ *  @return The estimated number of bytes held by @p frags.
+ *
+ *  @throw None No throw guarantee.
+ */
+template<typename SupersystemType>
+std::size_t fragments_footprint(
+  const chemist::fragmenting::FragmentedNuclei<SupersystemType>&
+    frags) noexcept {
+    using frags_type = chemist::fragmenting::FragmentedNuclei<SupersystemType>;
+    using index_type   = typename frags_type::size_type;
+    using index_set    = std::vector<index_type>;
+    using cap_type     = typename frags_type::cap_set_type::value_type;
+    using nucleus_type = typename SupersystemType::value_type;
+
+    std::size_t nbytes = nuclei_footprint(frags.supersystem());
+
+    for(std::size_t i = 0; i < frags.size(); ++i) {
+        const auto n_members = frags.nuclear_indices(i).size();
+        nbytes += sizeof(index_set) + n_members * sizeof(index_type);
+    }
+
+    const auto n_caps = frags.cap_set().size();
+    nbytes += n_caps * (sizeof(cap_type) + sizeof(nucleus_type));
+    return nbytes;
+}
+
+/** @brief Estimates the number of bytes held by a NuclearGraph.
+ *
+ *  @param[in] graph The graph whose footprint is wanted.
+ *
+ *  @return The estimated number of bytes held by the nodes and edges of
+ *          @p graph. Default constructed graphs hold zero bytes.
+ *
+ *  @throw None No throw guarantee.
+ */
+inline std::size_t graph_footprint(const NuclearGraph& graph) noexcept {
+    using edge_type = NuclearGraph::edge_type;
+    if(graph.nodes_size() == 0 && graph.edges_size() == 0) return 0;
+
+    std::size_t nbytes = nuclei_footprint(graph.nuclei());
+    for(std::size_t i = 0; i < graph.nodes_size(); ++i) {
+        const auto n_members = graph.node_indices(i).size();
+        nbytes += n_members * sizeof(std::size_t);
+    }
+    return nbytes + graph.edges_size() * sizeof(edge_type);
+}
+
+/// Number of bytes held by a container of weights (or any other vector)
+template<typename T>
+std::size_t vector_footprint(const std::vector<T>& v) noexcept {
+    return v.capacity() * sizeof(T);
+}
+
+/** @brief Converts a number of bytes into a human-readable string.
+ *
+ *  @param[in] nbytes The number of bytes.
+ *
+ *  @return @p nbytes expressed in the largest binary unit (B, KiB, MiB, GiB,
+ *          or TiB) for which the value is at least one.
+ */
+inline std::string format_bytes(std::size_t nbytes) {
+    const char* units[] = {"B", "KiB", "MiB", "GiB", "TiB"};
+    double value        = static_cast<double>(nbytes);
+    std::size_t unit    = 0;
+    while(value >= 1024.0 && unit < 4) {
+        value /= 1024.0;
+        ++unit;
+    }
+    if(unit == 0) return std::to_string(nbytes) + " B";
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%.2f %s", value, units[unit]);
+    return std::string(buffer);
+}
+
+} // namespace ghostfragment::utilities
@@ -0,0 +1,96 @@
+/*
+ * Copyright 2024 GhostFragment
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include <cstddef>
+#include <iterator>
+#include <limits>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+namespace ghostfragment::utilities {
+
+/** @brief Groups sets which overlap, directly or through other sets.
+ *
+ *  Two sets are in the same component if they share an element, or if they
+ *  are connected through a chain of sets, each sharing an element with the
+ *  next one. Sets in different components thus never share elements, nor do
+ *  any intersections formed from them. The components are found with a
+ *  union-find over the elements, so this is linear (up to the inverse
+ *  Ackermann function) in the total size of the sets.
+ *
+ *  @tparam SetsType A range of ranges of the elements' offsets.
+ *
+ *  @param[in] sets The sets. Every element must be less than @p nelements.
+ *  @param[in] nelements The number of possible elements.
+ *
+ *  @return The offsets of the sets in each component. The offsets in each
+ *          component are in increasing order and the components are ordered
+ *          by their first offsets. Each empty set is a component of its own.
+ *
+ *  @throw std::bad_alloc if allocating the components fails. Strong throw
+ *                        guarantee.
+ */
+template<typename SetsType>
+std::vector<std::vector<std::size_t>> overlap_components(
+  const SetsType& sets, std::size_t nelements) {
+    constexpr auto npos = std::numeric_limits<std::size_t>::max();
+
+    // Union-find with union by size and path halving
+    std::vector<std::size_t> parent(nelements);
+    std::vector<std::size_t> size(nelements, 1);
+    std::iota(parent.begin(), parent.end(), std::size_t{0});
+    auto find = [&](std::size_t x) {
+        while(parent[x] != x) {
+            parent[x] = parent[parent[x]];
+            x         = parent[x];
+        }
+        return x;
+    };
+
+    for(const auto& set : sets) {
+        auto itr = std::begin(set);
+        if(itr == std::end(set)) continue;
+        auto root = find(*itr);
+        for(++itr; itr != std::end(set); ++itr) {
+            auto other = find(*itr);
+            if(other == root) continue;
+            if(size[other] > size[root]) std::swap(root, other);
+            parent[other] = root;
+            size[root] += size[other];
+        }
+    }
+
+    std::vector<std::vector<std::size_t>> rv;
+    std::vector<std::size_t> component(nelements, npos);
+    std::size_t i = 0;
+    for(const auto& set : sets) {
+        if(std::begin(set) == std::end(set)) {
+            rv.emplace_back(1, i++);
+            continue;
+        }
+        const auto root = find(*std::begin(set));
+        if(component[root] == npos) {
+            component[root] = rv.size();
+            rv.emplace_back();
+        }
+        rv[component[root]].push_back(i++);
+    }
+    return rv;
+}
+
+} // namespace ghostfragment::utilities
@@ -0,0 +1,140 @@
+/*
+ * Copyright 2024 GhostFragment
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <thread>
+#include <vector>
+
+namespace ghostfragment::utilities {
+
+/// The number of threads to use when the user did not ask for a number
+inline std::size_t default_nthreads() noexcept {
+    const auto n = std::thread::hardware_concurrency();
+    return n == 0 ? 1 : n;
+}
+
+/** @brief Splits [0, @p n) into contiguous chunks and processes them
+ *         concurrently.
+ *
+ *  The range is split into min(@p nchunks, @p n) chunks (at least one) whose
+ *  sizes differ by at most one. @p fxn is called as `fxn(chunk, begin, end)`
+ *  for each chunk; chunk 0 runs on the calling thread and every other chunk
+ *  on its own std::thread. The chunks are always the same for the same
+ *  @p n and @p nchunks, so callers which store per-chunk results and merge
+ *  them in chunk order get results that do not depend on thread scheduling.
+ *
+ *  @param[in] n The number of items.
+ *  @param[in] nchunks The requested number of chunks (i.e., threads).
+ *  @param[in] fxn The callback. Must be safe to call concurrently for
+ *                 different chunks.
+ *
+ *  If @p fxn throws, the exception from the lowest numbered chunk which threw
+ *  is rethrown after all threads have finished.
+ *
+ *  @throw std::system_error if a thread can not be started.
+ */
+template<typename FxnType>
+void parallel_for_chunks(std::size_t n, std::size_t nchunks, FxnType&& fxn) {
+    nchunks = std::max<std::size_t>(1, std::min(nchunks, n));
+    const auto chunk_size = n / nchunks;
+    const auto remainder  = n % nchunks;
+    auto chunk_begin      = [=](std::size_t chunk) {
+        return chunk * chunk_size + std::min(chunk, remainder);
+    };
+
+    std::vector<std::exception_ptr> errors(nchunks);
+    auto run = [&](std::size_t chunk) {
+        try {
+            fxn(chunk, chunk_begin(chunk), chunk_begin(chunk + 1));
+        } catch(...) { errors[chunk] = std::current_exception(); }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(nchunks - 1);
+    try {
+        for(std::size_t chunk = 1; chunk < nchunks; ++chunk)
+            threads.emplace_back(run, chunk);
+    } catch(...) {
+        for(auto& thread : threads) thread.join();
+        throw;
+    }
+    run(0);
+    for(auto& thread : threads) thread.join();
+
+    for(const auto& error : errors)
+        if(error) std::rethrow_exception(error);
+}
+
+/** @brief Splits items of uneven cost into chunks of (about) equal work.
+ *
+ *  Item i is assumed to cost @p work[i]. Chunk c consists of the items
+ *  [bounds[c], bounds[c + 1]), which are then typically processed by calling
+ *  parallel_for_chunks(nchunks, nchunks, ...) and looping over the items of
+ *  the chunk. The boundaries only depend on @p work and @p nchunks.
+ *
+ *  @param[in] work The cost of each item.
+ *  @param[in] nchunks The requested number of chunks.
+ *
+ *  @return The boundaries of the chunks, i.e., at most min(@p nchunks,
+ *          work.size()) + 1 (but at least 2) non-decreasing offsets, starting
+ *          with 0 and ending with work.size().
+ *
+ *  @throw std::bad_alloc if allocating the boundaries fails. Strong throw
+ *                        guarantee.
+ */
+inline std::vector<std::size_t> weighted_chunk_bounds(
+  const std::vector<double>& work, std::size_t nchunks) {
+    const auto n = work.size();
+    nchunks      = std::max<std::size_t>(1, std::min(nchunks, n));
+    double total = 0.0;
+    for(const auto w : work) total += w;
+
+    std::vector<std::size_t> bounds{0};
+    double sum = 0.0;
+    for(std::size_t i = 0; i + 1 < n && bounds.size() < nchunks; ++i) {
+        sum += work[i];
+        if(sum >= total * double(bounds.size()) / double(nchunks))
+            bounds.push_back(i + 1);
+    }
+    bounds.push_back(n);
+    return bounds;
+}
+
+/** @brief Splits the rows of a triangular loop into chunks of equal work.
+ *
+ *  In loops of the form `for(i = 0; i < n; ++i) for(j = i + 1; j < n; ++j)`
+ *  row i does n - 1 - i units of work, so chunks with the same number of rows
+ *  are badly imbalanced. This is weighted_chunk_bounds for those costs.
+ *
+ *  @param[in] n The number of rows.
+ *  @param[in] nchunks The requested number of chunks.
+ *
+ *  @return The boundaries of the chunks, see weighted_chunk_bounds.
+ *
+ *  @throw std::bad_alloc if allocating the boundaries fails. Strong throw
+ *                        guarantee.
+ */
+inline std::vector<std::size_t> triangular_chunk_bounds(std::size_t n,
+                                                        std::size_t nchunks) {
+    std::vector<double> work(n);
+    for(std::size_t i = 0; i < n; ++i) work[i] = double(n - 1 - i);
+    return weighted_chunk_bounds(work, nchunks);
+}
+
+} // namespace ghostfragment::utilities
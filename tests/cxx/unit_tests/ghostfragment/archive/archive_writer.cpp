@@ -0,0 +1,54 @@
+/*
+ * Copyright 2024 GhostFragment
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../test_ghostfragment.hpp"
+#include <ghostfragment/fragment_archive.hpp>
+#include <ghostfragment/property_types/fragmenting/weighted_subsystems.hpp>
+
+using namespace ghostfragment;
+
+using property_type = pt::WeightedSubsystems;
+
+/* Testing strategy:
+ *
+ * The writer returns what its submodule (by default GMBE Subsystems) returns,
+ * so we compare to running that module directly. The archive must then hold
+ * the same subsystems and weights.
+ */
+
+TEST_CASE("Archive Writer") {
+    auto mm   = testing::initialize();
+    auto& mod = mm.at("Archive Writer");
+
+    const auto path = std::filesystem::temp_directory_path() /
+                      "ghostfragment_test_archive_writer.bin";
+    mod.change_input("archive path", path.string());
+
+    const auto frags = testing::hydrocarbon_fragmented_nuclei(3, 2);
+    auto& gmbe_mod   = mm.at("GMBE Subsystems");
+
+    const auto& [corr, corr_weights] = gmbe_mod.run_as<property_type>(frags);
+
+    const auto& [subsystems, weights] = mod.run_as<property_type>(frags);
+    REQUIRE(subsystems == corr);
+    REQUIRE(weights == corr_weights);
+
+    FragmentArchive archive(path);
+    REQUIRE(archive.fragments() == corr);
+    REQUIRE(archive.weight_list() == corr_weights);
+
+    std::filesystem::remove(path);
+}
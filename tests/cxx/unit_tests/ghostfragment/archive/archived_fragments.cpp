@@ -0,0 +1,56 @@
+/*
+ * Copyright 2024 GhostFragment
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../test_ghostfragment.hpp"
+#include <ghostfragment/fragment_archive.hpp>
+#include <ghostfragment/property_types/fragmenting/fragmented_nuclei.hpp>
+
+using namespace ghostfragment;
+
+using property_type = pt::FragmentedNuclei;
+using traits_type   = pt::FragmentedNucleiTraits;
+using system_type   = typename traits_type::system_type;
+using frags_type    = typename traits_type::result_type;
+using cap_type      = typename frags_type::cap_set_type::value_type;
+
+TEST_CASE("Archived Fragments") {
+    auto mm   = testing::initialize();
+    auto& mod = mm.at("Archived Fragments");
+
+    const auto path = std::filesystem::temp_directory_path() /
+                      "ghostfragment_test_archived_fragments.bin";
+    mod.change_input("archive path", path.string());
+
+    auto corr          = testing::hydrocarbon_fragmented_nuclei(3, 2);
+    const auto& nuclei = corr.supersystem();
+    corr.add_cap(cap_type(1, 2, nuclei[2].as_nucleus()));
+    FragmentArchive::write(path, corr, {1.0, 1.0});
+
+    SECTION("Same system") {
+        system_type propane(testing::hydrocarbon(3));
+        const auto& frags = mod.run_as<property_type>(propane);
+        REQUIRE(frags == corr);
+        REQUIRE(are_caps_equal(frags.cap_set(), corr.cap_set()));
+    }
+
+    SECTION("Different system") {
+        system_type butane(testing::hydrocarbon(4));
+        REQUIRE_THROWS_AS(mod.run_as<property_type>(butane),
+                          std::runtime_error);
+    }
+
+    std::filesystem::remove(path);
+}
@@ -0,0 +1,66 @@
+/*
+ * Copyright 2024 GhostFragment
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../test_ghostfragment.hpp"
+#include <ghostfragment/fragment_archive.hpp>
+#include <ghostfragment/property_types/fragmenting/fragment_weights.hpp>
+
+using namespace ghostfragment;
+
+using property_type       = pt::FragmentWeights;
+using traits_type         = pt::FragmentWeightsTraits;
+using fragmented_sys_type = typename traits_type::fragments_type;
+using fragmented_mol_type =
+  typename fragmented_sys_type::fragmented_molecule_type;
+using fragmented_nuclei_type =
+  typename fragmented_mol_type::fragmented_nuclei_type;
+using weight_container = typename traits_type::weight_container;
+
+namespace {
+
+// Wraps going from fragmented nuclei to fragmented system
+auto as_system(fragmented_nuclei_type frags) {
+    fragmented_mol_type fragmented_mol(std::move(frags), 0, 1);
+    return fragmented_sys_type(std::move(fragmented_mol));
+}
+
+} // namespace
+
+TEST_CASE("Archived Weights") {
+    auto mm   = testing::initialize();
+    auto& mod = mm.at("Archived Weights");
+
+    const auto path = std::filesystem::temp_directory_path() /
+                      "ghostfragment_test_archived_weights.bin";
+    mod.change_input("archive path", path.string());
+
+    auto dimers = testing::hydrocarbon_fragmented_nuclei(3, 2);
+    const weight_container corr{1.0, -0.5};
+    FragmentArchive::write(path, dimers, corr);
+
+    SECTION("Same fragments") {
+        const auto& weights = mod.run_as<property_type>(as_system(dimers));
+        REQUIRE(weights == corr);
+    }
+
+    SECTION("Different fragments") {
+        auto monomers = as_system(testing::hydrocarbon_fragmented_nuclei(3, 1));
+        REQUIRE_THROWS_AS(mod.run_as<property_type>(monomers),
+                          std::runtime_error);
+    }
+
+    std::filesystem::remove(path);
+}
@@ -0,0 +1,91 @@
+/*
+ * Copyright 2024 GhostFragment
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../test_ghostfragment.hpp"
+#include <ghostfragment/property_types/topology/connectivity_table.hpp>
+
+using pt          = ghostfragment::pt::ConnectivityTable;
+using traits_type = ghostfragment::pt::ConnectivityTableTraits;
+using result_type = typename traits_type::result_type;
+
+/* Testing Strategy:
+ *
+ * Each call to `run` uses a new ModuleManager, so that the in-memory
+ * memoization of pluginplay can not hide whether or not the on-disk cache was
+ * hit. The wrapped submodule counts how many times it is called.
+ */
+
+TEST_CASE("Cached Connectivity") {
+    const auto root = std::filesystem::temp_directory_path() /
+                      "ghostfragment_test_cached_connectivity";
+    std::filesystem::remove_all(root);
+
+    std::size_t ncalls = 0;
+
+    auto run = [&](const chemist::Molecule& mol) {
+        auto mm   = testing::initialize();
+        auto& mod = mm.at("Cached Connectivity");
+        mod.change_input("cache directory", root.string());
+        mod.change_submod("Connectivity",
+                          pluginplay::make_lambda<pt>([&](auto&& mol_in) {
+                              ++ncalls;
+                              return testing::water_connectivity(
+                                mol_in.size() / 3);
+                          }));
+        return result_type(mod.run_as<pt>(mol));
+    };
+
+    const auto corr = testing::water_connectivity(2);
+
+    SECTION("Computes and then loads") {
+        REQUIRE(run(testing::water(2)) == corr);
+        REQUIRE(ncalls == 1);
+        REQUIRE(run(testing::water(2)) == corr);
+        REQUIRE(ncalls == 1);
+    }
+
+    SECTION("Different system is a miss") {
+        run(testing::water(2));
+        REQUIRE(run(testing::water(3)) == testing::water_connectivity(3));
+        REQUIRE(ncalls == 2);
+    }
+
+    SECTION("Changing an input of the wrapped module is a miss") {
+        // Uses the real wrapped module, so ncalls can't be used
+        auto run_tau = [&](double tau) {
+            auto mm = testing::initialize();
+            mm.change_input("Cached Connectivity", "cache directory",
+                            root.string());
+            mm.change_input("Covalent Radius", "tau", tau);
+            return result_type(
+              mm.at("Cached Connectivity").run_as<pt>(testing::water(2)));
+        };
+        auto uncached = [](double tau) {
+            auto mm = testing::initialize();
+            mm.change_input("Covalent Radius", "tau", tau);
+            return result_type(
+              mm.at("Covalent Radius").run_as<pt>(testing::water(2)));
+        };
+
+        // tau = 10 also bonds the hydrogens of a water molecule
+        REQUIRE(uncached(0.1) != uncached(10.0));
+        REQUIRE(run_tau(0.1) == uncached(0.1));
+        REQUIRE(run_tau(10.0) == uncached(10.0));
+        REQUIRE(run_tau(0.1) == uncached(0.1));
+    }
+
+    std::filesystem::remove_all(root);
+}
@@ -0,0 +1,103 @@
+/*
+ * Copyright 2024 GhostFragment
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../test_ghostfragment.hpp"
+#include <fstream>
+#include <ghostfragment/property_types/fragmenting/fragmented_nuclei.hpp>
+
+using pt          = ghostfragment::pt::FragmentedNuclei;
+using traits_type = ghostfragment::pt::FragmentedNucleiTraits;
+using system_type = typename traits_type::system_type;
+using frags_type  = typename traits_type::result_type;
+using cap_type    = typename frags_type::cap_set_type::value_type;
+
+/* Testing Strategy:
+ *
+ * Each call to `run` uses a new ModuleManager, so that the in-memory
+ * memoization of pluginplay can not hide whether or not the on-disk cache was
+ * hit. The wrapped submodule counts how many times it is called and returns
+ * capped dimers of a hydrocarbon, so that the caps are round-tripped too.
+ */
+
+TEST_CASE("Cached Fragments") {
+    const auto root = std::filesystem::temp_directory_path() /
+                      "ghostfragment_test_cached_fragments";
+    std::filesystem::remove_all(root);
+
+    auto corr          = testing::hydrocarbon_fragmented_nuclei(3, 2);
+    const auto& nuclei = corr.supersystem();
+    corr.add_cap(cap_type(1, 2, nuclei[2].as_nucleus()));
+    corr.add_cap(cap_type(1, 0, nuclei[0].as_nucleus()));
+
+    std::size_t ncalls = 0;
+    auto directory     = root;
+
+    auto run = [&](const system_type& sys) {
+        auto mm   = testing::initialize();
+        auto& mod = mm.at("Cached Fragments");
+        mod.change_input("cache directory", directory.string());
+        mod.change_submod("Fragmenter",
+                          pluginplay::make_lambda<pt>([&](auto&& sys_in) {
+                              ++ncalls;
+                              return corr;
+                          }));
+        return frags_type(mod.run_as<pt>(sys));
+    };
+
+    system_type propane(testing::hydrocarbon(3));
+
+    SECTION("Computes and then loads") {
+        REQUIRE(run(propane) == corr);
+        REQUIRE(ncalls == 1);
+        auto loaded = run(propane);
+        REQUIRE(ncalls == 1);
+        REQUIRE(loaded == corr);
+        REQUIRE(are_caps_equal(loaded.cap_set(), corr.cap_set()));
+    }
+
+    SECTION("Different charge is a miss") {
+        run(propane);
+        auto cation = testing::hydrocarbon(3);
+        cation.set_charge(1);
+        cation.set_multiplicity(2);
+        run(system_type(cation));
+        REQUIRE(ncalls == 2);
+    }
+
+    SECTION("Failing to store is not an error") {
+        // The cache directory can not be created inside a regular file
+        std::filesystem::create_directories(root);
+        std::ofstream(root / "file") << "not a directory";
+        directory = root / "file" / "cache";
+        REQUIRE(run(propane) == corr);
+        REQUIRE(run(propane) == corr);
+        REQUIRE(ncalls == 2);
+    }
+
+    SECTION("Results which can't be serialized are still returned") {
+        // Only single-nucleus caps can be serialized
+        const auto h0 = nuclei[0].as_nucleus();
+        const auto h2 = nuclei[2].as_nucleus();
+        corr.add_cap(cap_type(1, 2, h2, h0));
+        auto rv = run(propane);
+        REQUIRE(rv == corr);
+        REQUIRE(are_caps_equal(rv.cap_set(), corr.cap_set()));
+        run(propane);
+        REQUIRE(ncalls == 2);
+    }
+
+    std::filesystem::remove_all(root);
+}
@@ -0,0 +1,82 @@
+/*
+ * Copyright 2024 GhostFragment
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../test_ghostfragment.hpp"
+#include <ghostfragment/property_types/topology/nuclear_graph.hpp>
+
+using pt          = ghostfragment::pt::NuclearGraph;
+using traits_type = ghostfragment::pt::NuclearGraphTraits;
+using system_type = typename traits_type::input_type;
+using conns_type  = typename traits_type::connectivity_type;
+using graph_type  = typename traits_type::result_type;
+
+/* Testing Strategy:
+ *
+ * Each call to `run` uses a new ModuleManager, so that the in-memory
+ * memoization of pluginplay can not hide whether or not the on-disk cache was
+ * hit. The wrapped submodule counts how many times it is called and returns
+ * a graph whose nodes are the waters.
+ */
+
+TEST_CASE("Cached Nuclear Graph") {
+    const auto root = std::filesystem::temp_directory_path() /
+                      "ghostfragment_test_cached_nuclear_graph";
+    std::filesystem::remove_all(root);
+
+    std::size_t ncalls = 0;
+
+    auto run = [&](std::size_t n_waters, const conns_type& conns) {
+        auto mm   = testing::initialize();
+        auto& mod = mm.at("Cached Nuclear Graph");
+        mod.change_input("cache directory", root.string());
+        mod.change_submod(
+          "Graph maker",
+          pluginplay::make_lambda<pt>([&](auto&& sys_in, auto&& conns_in) {
+              ++ncalls;
+              const auto n = sys_in.molecule().size() / 3;
+              return graph_type(testing::water_fragmented_nuclei(n),
+                                conns_type(n));
+          }));
+        system_type sys(testing::water(n_waters));
+        return graph_type(mod.run_as<pt>(sys, conns));
+    };
+
+    const auto conns = testing::water_connectivity(2);
+    const graph_type corr(testing::water_fragmented_nuclei(2), conns_type(2));
+
+    SECTION("Computes and then loads") {
+        REQUIRE(run(2, conns) == corr);
+        REQUIRE(ncalls == 1);
+        REQUIRE(run(2, conns) == corr);
+        REQUIRE(ncalls == 1);
+    }
+
+    SECTION("Different connectivity is a miss") {
+        run(2, conns);
+        auto bonded = conns;
+        bonded.add_bond(1, 3);
+        REQUIRE(run(2, bonded) == corr);
+        REQUIRE(ncalls == 2);
+    }
+
+    SECTION("Different system is a miss") {
+        run(2, conns);
+        run(3, testing::water_connectivity(3));
+        REQUIRE(ncalls == 2);
+    }
+
+    std::filesystem::remove_all(root);
+}
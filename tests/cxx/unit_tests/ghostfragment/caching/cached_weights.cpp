@@ -0,0 +1,85 @@
+/*
+ * Copyright 2024 GhostFragment
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../test_ghostfragment.hpp"
+#include <ghostfragment/property_types/fragmenting/fragment_weights.hpp>
+
+using pt                  = ghostfragment::pt::FragmentWeights;
+using traits_type         = ghostfragment::pt::FragmentWeightsTraits;
+using fragmented_sys_type = typename traits_type::fragments_type;
+using fragmented_mol_type =
+  typename fragmented_sys_type::fragmented_molecule_type;
+using fragmented_nuclei_type =
+  typename fragmented_mol_type::fragmented_nuclei_type;
+using weight_container = typename traits_type::weight_container;
+
+namespace {
+
+// Wraps going from fragmented nuclei to fragmented system
+auto as_system(fragmented_nuclei_type frags) {
+    fragmented_mol_type fragmented_mol(std::move(frags), 0, 1);
+    return fragmented_sys_type(std::move(fragmented_mol));
+}
+
+} // namespace
+
+/* Testing Strategy:
+ *
+ * Each call to `run` uses a new ModuleManager, so that the in-memory
+ * memoization of pluginplay can not hide whether or not the on-disk cache was
+ * hit. The wrapped submodule counts how many times it is called.
+ */
+
+TEST_CASE("Cached Weights") {
+    const auto root = std::filesystem::temp_directory_path() /
+                      "ghostfragment_test_cached_weights";
+    std::filesystem::remove_all(root);
+
+    std::size_t ncalls = 0;
+
+    auto run = [&](const fragmented_sys_type& frags) {
+        auto mm   = testing::initialize();
+        auto& mod = mm.at("Cached Weights");
+        mod.change_input("cache directory", root.string());
+        mod.change_submod("Weighter",
+                          pluginplay::make_lambda<pt>([&](auto&& frags_in) {
+                              ++ncalls;
+                              const auto& nuclei_frags =
+                                frags_in.fragmented_molecule()
+                                  .fragmented_nuclei();
+                              return weight_container(nuclei_frags.size(), 1.0);
+                          }));
+        return weight_container(mod.run_as<pt>(frags));
+    };
+
+    auto monomers = as_system(testing::hydrocarbon_fragmented_nuclei(3, 1));
+    auto dimers   = as_system(testing::hydrocarbon_fragmented_nuclei(3, 2));
+
+    SECTION("Computes and then loads") {
+        REQUIRE(run(monomers) == weight_container(3, 1.0));
+        REQUIRE(ncalls == 1);
+        REQUIRE(run(monomers) == weight_container(3, 1.0));
+        REQUIRE(ncalls == 1);
+    }
+
+    SECTION("Different fragments are a miss") {
+        run(monomers);
+        REQUIRE(run(dimers) == weight_container(2, 1.0));
+        REQUIRE(ncalls == 2);
+    }
+
+    std::filesystem::remove_all(root);
+}
@@ -0,0 +1,85 @@
+/*
+ * Copyright 2024 GhostFragment
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../test_ghostfragment.hpp"
+#include <fstream>
+#include <ghostfragment/caching/disk_cache.hpp>
+
+using namespace ghostfragment::caching;
+
+TEST_CASE("DiskCache") {
+    const auto root = std::filesystem::temp_directory_path() /
+                      "ghostfragment_test_disk_cache";
+    std::filesystem::remove_all(root);
+
+    DiskCache cache(root);
+    DiskCache::buffer_type payload{'a', 'b', 'c'};
+
+    SECTION("root") { REQUIRE(cache.root() == root); }
+
+    SECTION("path") {
+        REQUIRE(cache.path("weights", 0x1f) ==
+                root / "weights-000000000000001f.bin");
+    }
+
+    SECTION("Miss") {
+        REQUIRE_FALSE(cache.load("weights", 1).has_value());
+    }
+
+    SECTION("Store then load") {
+        cache.store("weights", 1, payload);
+        REQUIRE(cache.load("weights", 1) == payload);
+
+        // Different tag or key are different entries
+        REQUIRE_FALSE(cache.load("fragments", 1).has_value());
+        REQUIRE_FALSE(cache.load("weights", 2).has_value());
+
+        // Overwrites
+        DiskCache::buffer_type payload2{'d'};
+        cache.store("weights", 1, payload2);
+        REQUIRE(cache.load("weights", 1) == payload2);
+
+        // Is persistent
+        REQUIRE(DiskCache(root).load("weights", 1) == payload2);
+    }
+
+    SECTION("Corrupted entries are misses") {
+        cache.store("weights", 1, payload);
+        const auto path = cache.path("weights", 1);
+        const auto size = std::filesystem::file_size(path);
+
+        SECTION("Truncated") {
+            std::filesystem::resize_file(path, size - 1);
+            REQUIRE_FALSE(cache.load("weights", 1).has_value());
+        }
+
+        SECTION("Payload changed") {
+            std::fstream f(path, std::ios::in | std::ios::out |
+                                   std::ios::binary);
+            f.seekp(size - 1);
+            f.put('z');
+            f.close();
+            REQUIRE_FALSE(cache.load("weights", 1).has_value());
+        }
+
+        SECTION("Not a cache entry") {
+            std::ofstream(path, std::ios::binary) << "not a cache entry";
+            REQUIRE_FALSE(cache.load("weights", 1).has_value());
+        }
+    }
+
+    std::filesystem::remove_all(root);
+}
@@ -0,0 +1,113 @@
+/*
+ * Copyright 2024 GhostFragment
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../test_ghostfragment.hpp"
+#include <ghostfragment/caching/hasher.hpp>
+
+using namespace ghostfragment::caching;
+using ghostfragment::topology::NucleiSnapshot;
+
+TEST_CASE("Hasher") {
+    SECTION("FNV-1a reference values") {
+        Hasher empty;
+        REQUIRE(empty.value() == 14695981039346656037ull);
+
+        Hasher a;
+        a.update("a", 1);
+        REQUIRE(a.value() == 0xaf63dc4c8601ec8cull);
+    }
+
+    SECTION("Strings include their length") {
+        Hasher ab_c, a_bc;
+        ab_c.update(std::string("ab"));
+        ab_c.update(std::string("c"));
+        a_bc.update(std::string("a"));
+        a_bc.update(std::string("bc"));
+        REQUIRE(ab_c.value() != a_bc.value());
+    }
+
+    SECTION("Key material") {
+        Hasher h;
+        h.update(std::string("ab"));
+        h.update(std::uint8_t(7));
+        REQUIRE(h.material().size() == sizeof(std::uint64_t) + 3);
+        REQUIRE(h.material().substr(sizeof(std::uint64_t)) == "ab\x07");
+
+        Hasher unrecorded(false);
+        unrecorded.update(std::string("ab"));
+        unrecorded.update(std::uint8_t(7));
+        REQUIRE(unrecorded.material().empty());
+        REQUIRE(unrecorded.value() == h.value());
+    }
+
+    SECTION("hash_snapshot") {
+        auto hash = [](const chemist::Molecule& mol) {
+            Hasher h;
+            hash_snapshot(h, NucleiSnapshot(mol));
+            return h.value();
+        };
+        REQUIRE(hash(testing::water(1)) == hash(testing::water(1)));
+        REQUIRE(hash(testing::water(1)) != hash(testing::water(2)));
+
+        using atom_type = typename chemist::Molecule::atom_type;
+        chemist::Molecule h, moved_h, he;
+        h.push_back(atom_type("H", 1ul, 1.0, 0.0, 0.0, 0.0));
+        moved_h.push_back(atom_type("H", 1ul, 1.0, 0.0, 0.0, 1.0E-8));
+        he.push_back(atom_type("He", 2ul, 4.0, 0.0, 0.0, 0.0));
+        REQUIRE(hash(h) != hash(moved_h));
+        REQUIRE(hash(h) != hash(he));
+    }
+
+    SECTION("hash_connectivity") {
+        auto hash = [](const auto& conns) {
+            Hasher h;
+            hash_connectivity(h, conns);
+            return h.value();
+        };
+        auto conns = testing::water_connectivity(2);
+        REQUIRE(hash(conns) == hash(testing::water_connectivity(2)));
+        REQUIRE(hash(conns) != hash(testing::water_connectivity(1)));
+    }
+
+    SECTION("hash_fragments") {
+        auto hash = [](const auto& frags) {
+            Hasher h;
+            hash_fragments(h, frags);
+            return h.value();
+        };
+        auto frags  = testing::hydrocarbon_fragmented_nuclei(3, 1);
+        auto frags2 = testing::hydrocarbon_fragmented_nuclei(3, 1);
+        auto dimers = testing::hydrocarbon_fragmented_nuclei(3, 2);
+        REQUIRE(hash(frags) == hash(frags2));
+        REQUIRE(hash(frags) != hash(dimers));
+
+        using cap_type = typename decltype(frags)::cap_set_type::value_type;
+        auto capped    = frags;
+        capped.add_cap(cap_type(0, 1, frags.supersystem()[1].as_nucleus()));
+        REQUIRE(hash(frags) != hash(capped));
+
+        // Every nucleus of a cap is hashed
+        const auto h0 = frags.supersystem()[0].as_nucleus();
+        const auto h1 = frags.supersystem()[1].as_nucleus();
+        const auto h2 = frags.supersystem()[2].as_nucleus();
+        auto capped2  = frags;
+        auto capped3  = frags;
+        capped2.add_cap(cap_type(0, 1, h1, h2));
+        capped3.add_cap(cap_type(0, 1, h1, h0));
+        REQUIRE(hash(capped2) != hash(capped));
+        REQUIRE(hash(capped2) != hash(capped3));
+    }
+}
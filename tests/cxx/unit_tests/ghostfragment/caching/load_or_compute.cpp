@@ -0,0 +1,81 @@
+/*
+ * Copyright 2024 GhostFragment
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../test_ghostfragment.hpp"
+#include <ghostfragment/caching/load_or_compute.hpp>
+
+using namespace ghostfragment::caching;
+
+namespace {
+
+// Stands in for the pluginplay logger
+struct Logger {
+    void debug(const std::string&) {}
+    void warn(const std::string& msg) { warnings.push_back(msg); }
+    std::vector<std::string> warnings;
+};
+
+} // namespace
+
+TEST_CASE("load_or_compute") {
+    const auto root = std::filesystem::temp_directory_path() /
+                      "ghostfragment_test_load_or_compute";
+    std::filesystem::remove_all(root);
+
+    DiskCache cache(root);
+    Logger logger;
+    std::size_t ncalls = 0;
+
+    auto run = [&](const Hasher& key, std::vector<double> value) {
+        return load_or_compute(
+          cache, "weights", key,
+          [](BinaryReader& r) { return deserialize_weights(r); },
+          [&]() {
+              ++ncalls;
+              return value;
+          },
+          logger);
+    };
+
+    Hasher key;
+    key.update(std::string("key"));
+    const std::vector<double> corr{1.0, -1.0};
+
+    SECTION("Computes and then loads") {
+        REQUIRE(run(key, corr) == corr);
+        REQUIRE(run(key, {}) == corr);
+        REQUIRE(ncalls == 1);
+        REQUIRE(logger.warnings.empty());
+    }
+
+    SECTION("Entry with different key material is a miss") {
+        // Simulates a collision: an entry with the same hash, but written
+        // for different key material
+        BinaryWriter w;
+        w.write(std::string("other key"));
+        serialize(w, std::vector<double>{2.0});
+        cache.store("weights", key.value(), w.buffer());
+
+        REQUIRE(run(key, corr) == corr);
+        REQUIRE(ncalls == 1);
+
+        // and was overwritten
+        REQUIRE(run(key, {}) == corr);
+        REQUIRE(ncalls == 1);
+    }
+
+    std::filesystem::remove_all(root);
+}
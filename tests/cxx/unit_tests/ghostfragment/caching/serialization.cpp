@@ -0,0 +1,113 @@
+/*
+ * Copyright 2024 GhostFragment
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../test_ghostfragment.hpp"
+#include <ghostfragment/caching/serialization.hpp>
+
+using namespace ghostfragment;
+using namespace ghostfragment::caching;
+
+/* Testing Strategy:
+ *
+ * Everything is written with a BinaryWriter and read back with a BinaryReader
+ * over the same buffer. The round trip should reproduce the original object
+ * and consume the entire buffer.
+ */
+
+TEST_CASE("BinaryWriter/BinaryReader") {
+    BinaryWriter w;
+    w.write(std::uint64_t(42));
+    w.write(3.14);
+    w.write(std::string("hello"));
+
+    BinaryReader r(w.buffer());
+    REQUIRE(r.read<std::uint64_t>() == 42);
+    REQUIRE_FALSE(r.done());
+    REQUIRE(r.read<double>() == 3.14);
+    REQUIRE(r.read_string() == "hello");
+    REQUIRE(r.done());
+    REQUIRE_THROWS_AS(r.read<char>(), std::runtime_error);
+
+    auto truncated = w.buffer();
+    truncated.pop_back();
+    BinaryReader r2(truncated);
+    r2.read<std::uint64_t>();
+    r2.read<double>();
+    REQUIRE_THROWS_AS(r2.read_string(), std::runtime_error);
+}
+
+TEST_CASE("serialization") {
+    using cap_type = typename fragments_type::cap_set_type::value_type;
+    BinaryWriter w;
+
+    SECTION("Connectivity") {
+        auto conns = testing::water_connectivity(3);
+        serialize(w, conns);
+        BinaryReader r(w.buffer());
+        REQUIRE(deserialize_connectivity(r) == conns);
+        REQUIRE(r.done());
+    }
+
+    SECTION("Fragments") {
+        auto frags = testing::hydrocarbon_fragmented_nuclei(3, 2);
+
+        SECTION("No caps") {
+            serialize(w, frags);
+            BinaryReader r(w.buffer());
+            REQUIRE(deserialize_fragments(r, frags.supersystem()) == frags);
+            REQUIRE(r.done());
+        }
+
+        SECTION("With caps") {
+            const auto& nuclei = frags.supersystem();
+            frags.add_cap(cap_type(0, 1, nuclei[1].as_nucleus()));
+            frags.add_cap(cap_type(2, 1, nuclei[1].as_nucleus()));
+            serialize(w, frags);
+            BinaryReader r(w.buffer());
+            auto corr = deserialize_fragments(r, frags.supersystem());
+            REQUIRE(corr == frags);
+            REQUIRE(are_caps_equal(corr.cap_set(), frags.cap_set()));
+            REQUIRE(r.done());
+        }
+
+        SECTION("Entry refers to nuclei which do not exist") {
+            serialize(w, frags);
+            BinaryReader r(w.buffer());
+            auto small = testing::hydrocarbon(1).nuclei().as_nuclei();
+            REQUIRE_THROWS_AS(deserialize_fragments(r, small),
+                              std::runtime_error);
+        }
+    }
+
+    SECTION("NuclearGraph") {
+        NuclearGraph::connectivity_type edges(3);
+        edges.add_bond(0, 1);
+        NuclearGraph graph(testing::water_fragmented_nuclei(3), edges);
+        serialize(w, graph);
+        BinaryReader r(w.buffer());
+        auto nuclei = testing::water(3).nuclei().as_nuclei();
+        REQUIRE(deserialize_graph(r, nuclei) == graph);
+        REQUIRE(r.done());
+    }
+
+    SECTION("Weights") {
+        weights_type weights{1.0, -1.0, 0.5};
+        serialize(w, weights);
+        BinaryReader r(w.buffer());
+        REQUIRE(deserialize_weights(r) == weights);
+        REQUIRE(r.done());
+    }
+}
@@ -0,0 +1,75 @@
+/*
+ * Copyright 2024 GhostFragment
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "test_ghostfragment.hpp"
+#include <ghostfragment/cap_index.hpp>
+namespace ghostfragment {
+
+TEST_CASE("CapIndex") {
+    using frags_type   = CapIndex::fragmented_nuclei;
+    using cap_set_type = CapIndex::cap_set_type;
+    using cap_type     = typename cap_set_type::value_type;
+    using nucleus_type = typename frags_type::supersystem_type::value_type;
+    using list_type    = CapIndex::index_list_type;
+    using set_type     = CapIndex::nucleus_index_set;
+
+    // Propane fragmented into {C0, C1} and {C1, C2} (plus hydrogens)
+    auto frags = testing::hydrocarbon_fragmented_nuclei(3, 2);
+    nucleus_type h("H", 1ul, 1837.289, 0.0, 0.0, 0.0);
+    frags.add_cap(cap_type(1, 2, h));
+    frags.add_cap(cap_type(1, 0, h));
+
+    CapIndex defaulted;
+    CapIndex index(frags);
+
+    SECTION("CTors") {
+        REQUIRE(defaulted.size() == 0);
+        REQUIRE(index.size() == 2);
+        REQUIRE(index == CapIndex(frags.cap_set()));
+        REQUIRE(CapIndex(cap_set_type{}) == defaulted);
+    }
+
+    SECTION("anchored_on") {
+        REQUIRE(index.anchored_on(0) == list_type{});
+        REQUIRE(index.anchored_on(1) == list_type{0, 1});
+        REQUIRE(index.anchored_on(2) == list_type{});
+        REQUIRE(index.anchored_on(100) == list_type{});
+        REQUIRE(defaulted.anchored_on(0) == list_type{});
+    }
+
+    SECTION("caps") {
+        REQUIRE(index.caps(frags, 0) == list_type{0});
+        REQUIRE(index.caps(frags, 1) == list_type{1});
+        REQUIRE(defaulted.caps(frags, 0) == list_type{});
+
+        // Fragments with both (or neither) of the replaced atoms need no caps
+        REQUIRE(index.caps(set_type{0, 1, 2}) == list_type{});
+        REQUIRE(index.caps(set_type{2}) == list_type{});
+
+        // Unsorted fragments work too
+        REQUIRE(index.caps(set_type{1, 0}) == list_type{0});
+        REQUIRE(index.caps(set_type{2, 1}) == list_type{1});
+        REQUIRE(index.caps(set_type{1}) == list_type{0, 1});
+    }
+
+    SECTION("Comparisons") {
+        REQUIRE(index != defaulted);
+        frags.add_cap(cap_type(2, 1, h));
+        REQUIRE(index != CapIndex(frags));
+    }
+}
+
+} // namespace ghostfragment
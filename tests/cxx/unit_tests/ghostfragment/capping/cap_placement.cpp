@@ -0,0 +1,191 @@
+/*
+ * Copyright 2024 GhostFragment
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../test_ghostfragment.hpp"
+#include "../testing/are_caps_equal.hpp"
+#include <ghostfragment/capping/cap_placement.hpp>
+#include <ghostfragment/property_types/fragmenting/capped_fragments.hpp>
+#include <ghostfragment/topology/covalent_radius.hpp>
+#include <array>
+
+using namespace ghostfragment::capping;
+using ghostfragment::topology::BondLengthTable;
+using ghostfragment::topology::covalent_radius;
+using ghostfragment::topology::NucleiSnapshot;
+using ghostfragment::topology::UnitCell;
+
+using traits_t     = ghostfragment::pt::CappedFragmentsTraits;
+using frags_t      = typename traits_t::frags_type;
+using bonds_t      = typename traits_t::broken_bonds_type;
+using cap_set_type = typename frags_t::cap_set_type;
+using nucleus_type = typename frags_t::supersystem_type::value_type;
+
+TEST_CASE("CapBatch") {
+    auto propane = testing::hydrocarbon(3);
+    NucleiSnapshot snapshot(propane.nuclei());
+    bonds_t broken_bonds{{0, 1}, {1, 0}, {1, 2}};
+
+    // Returns the cap position for broken bond a-b and ratio t
+    auto corr = [&](std::size_t a, std::size_t b, double t) {
+        std::array<double, 3> r;
+        for(std::size_t q = 0; q < 3; ++q)
+            r[q] = (1.0 - t) * snapshot.coord(a, q) + t * snapshot.coord(b, q);
+        return r;
+    };
+
+    auto check_coords = [&](const CapBatch& batch) {
+        for(std::size_t i = 0; i < batch.size(); ++i) {
+            const auto a = batch.anchors()[i];
+            const auto b = batch.replaced()[i];
+            const auto r = corr(a, b, batch.ratios()[i]);
+            REQUIRE(batch.x()[i] == Approx(r[0]));
+            REQUIRE(batch.y()[i] == Approx(r[1]));
+            REQUIRE(batch.z()[i] == Approx(r[2]));
+        }
+    };
+
+    SECTION("CTor") {
+        CapBatch batch(snapshot, broken_bonds);
+        REQUIRE(batch.size() == 3);
+        REQUIRE(batch.anchors() == CapBatch::index_array{0, 1, 1});
+        REQUIRE(batch.replaced() == CapBatch::index_array{1, 0, 2});
+        REQUIRE(batch.ratios() == CapBatch::coord_array{1.0, 1.0, 1.0});
+    }
+
+    SECTION("No broken bonds") {
+        CapBatch batch(snapshot, bonds_t{});
+        batch.compute_ratios(CapRule::covalent_ratio);
+        batch.place();
+        REQUIRE(batch.size() == 0);
+        REQUIRE(batch.x().empty());
+    }
+
+    SECTION("at_atom") {
+        CapBatch batch(snapshot, broken_bonds);
+        batch.compute_ratios(CapRule::at_atom);
+        batch.place();
+        for(std::size_t i = 0; i < batch.size(); ++i) {
+            const auto b = batch.replaced()[i];
+            REQUIRE(batch.x()[i] == snapshot.coord(b, 0));
+            REQUIRE(batch.y()[i] == snapshot.coord(b, 1));
+            REQUIRE(batch.z()[i] == snapshot.coord(b, 2));
+        }
+    }
+
+    SECTION("covalent_ratio") {
+        CapBatch batch(snapshot, broken_bonds);
+        batch.compute_ratios(CapRule::covalent_ratio, 1);
+        batch.place();
+        const auto sigma_c = covalent_radius(6);
+        const auto sigma_h = covalent_radius(1);
+        const auto t       = (sigma_c + sigma_h) / (2.0 * sigma_c);
+        for(const auto& ti : batch.ratios()) REQUIRE(ti == Approx(t));
+        check_coords(batch);
+    }
+
+    SECTION("average_length") {
+        BondLengthTable table(snapshot, testing::hydrocarbon_connectivity(3));
+        CapBatch batch(snapshot, broken_bonds);
+        batch.compute_ratios(CapRule::average_length, 1, &table);
+        batch.place();
+        const auto r0 = table.average(6, 1);
+        for(std::size_t i = 0; i < batch.size(); ++i) {
+            const auto a = batch.anchors()[i];
+            const auto b = batch.replaced()[i];
+            const auto t = r0 / snapshot.distance(a, b);
+            REQUIRE(batch.ratios()[i] == Approx(t));
+        }
+        check_coords(batch);
+    }
+
+    SECTION("average_length throws without a table") {
+        CapBatch batch(snapshot, broken_bonds);
+        REQUIRE_THROWS_AS(batch.compute_ratios(CapRule::average_length),
+                          std::runtime_error);
+    }
+
+    SECTION("add_caps") {
+        auto frags = testing::hydrocarbon_fragmented_nuclei(3, 1);
+        nucleus_type h("H", 1ul, 1837.289, 0.0, 0.0, 0.0);
+
+        CapBatch batch(snapshot, broken_bonds);
+        batch.place();
+        const auto index = batch.add_caps(frags, h);
+
+        cap_set_type corr_caps;
+        for(std::size_t i = 0; i < batch.size(); ++i) {
+            const auto b = batch.replaced()[i];
+            nucleus_type ci("H", 1ul, 1837.289, snapshot.coord(b, 0),
+                            snapshot.coord(b, 1), snapshot.coord(b, 2));
+            corr_caps.emplace_back(batch.anchors()[i], b, ci);
+        }
+        are_caps_equal(frags.cap_set(), corr_caps);
+        REQUIRE(index == ghostfragment::CapIndex(frags));
+    }
+}
+
+TEST_CASE("CapBatch (periodic)") {
+    // Two carbons 2.5 Bohr apart through the x faces of a 10 Bohr cube
+    using molecule_type = chemist::Molecule;
+    using atom_type     = typename molecule_type::atom_type;
+    molecule_type mol;
+    mol.push_back(atom_type("C", 6ul, 21874.662, 1.0, 0.0, 0.0));
+    mol.push_back(atom_type("C", 6ul, 21874.662, 8.5, 0.0, 0.0));
+    NucleiSnapshot snapshot(mol);
+    UnitCell cell({10.0, 0.0, 0.0, 0.0, 10.0, 0.0, 0.0, 0.0, 10.0});
+    bonds_t broken_bonds{{0, 1}, {1, 0}};
+
+    // A->B is -2.5 Bohr along x for bond 0-1 and +2.5 Bohr for bond 1-0
+    auto check_coords = [&](const CapBatch& batch) {
+        const std::array<double, 2> dx{-2.5, 2.5};
+        for(std::size_t i = 0; i < batch.size(); ++i) {
+            const auto a = batch.anchors()[i];
+            const auto t = batch.ratios()[i];
+            REQUIRE(batch.x()[i] == Approx(snapshot.coord(a, 0) + t * dx[i]));
+            REQUIRE(batch.y()[i] == Approx(0.0).margin(1e-12));
+            REQUIRE(batch.z()[i] == Approx(0.0).margin(1e-12));
+        }
+    };
+
+    SECTION("at_atom uses the nearest image of the replaced atom") {
+        CapBatch batch(snapshot, broken_bonds, cell);
+        batch.compute_ratios(CapRule::at_atom);
+        batch.place();
+        REQUIRE(batch.x()[0] == Approx(-1.5));
+        REQUIRE(batch.x()[1] == Approx(11.0));
+        check_coords(batch);
+    }
+
+    SECTION("covalent_ratio") {
+        CapBatch batch(snapshot, broken_bonds, cell);
+        batch.compute_ratios(CapRule::covalent_ratio, 1);
+        batch.place();
+        check_coords(batch);
+    }
+
+    SECTION("average_length uses the minimum-image bond length") {
+        BondLengthTable::connectivity_type conns(2);
+        conns.add_bond(0, 1);
+        BondLengthTable table(snapshot, conns, cell);
+        REQUIRE(table.average(6, 6) == Approx(2.5));
+
+        CapBatch batch(snapshot, broken_bonds, cell);
+        batch.compute_ratios(CapRule::average_length, 6, &table);
+        batch.place();
+        for(const auto& ti : batch.ratios()) REQUIRE(ti == Approx(1.0));
+        check_coords(batch);
+    }
+}
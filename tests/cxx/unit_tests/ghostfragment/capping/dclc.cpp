@@ -17,10 +17,8 @@
 #include "../test_ghostfragment.hpp"
 #include "../testing/are_caps_equal.hpp"
 #include <ghostfragment/property_types/fragmenting/capped_fragments.hpp>
-#include <ghostfragment/property_types/topology/connectivity_table.hpp>
 
 using the_pt         = ghostfragment::pt::CappedFragments;
-using connect_pt     = ghostfragment::pt::ConnectivityTable;
 using traits_t       = ghostfragment::pt::CappedFragmentsTraits;
 using broken_bonds_t = typename traits_t::broken_bonds_type;
 using frags_t        = typename traits_t::result_type;
@@ -84,13 +82,6 @@ auto propane_dclc_3_caps() {
     return caps;
 }
 
-auto make_submod(std::size_t n) {
-    return pluginplay::make_lambda<connect_pt>([=](auto&& mol_in) {
-        REQUIRE(testing::hydrocarbon(n) == mol_in);
-        return testing::hydrocarbon_connectivity(n);
-    });
-}
-
 } // namespace
 
 TEST_CASE("DCLC Capping") {
@@ -101,9 +92,11 @@ TEST_CASE("DCLC Capping") {
         auto corr = methane_dclc_caps();
         auto hc   = testing::hydrocarbon_fragmented_nuclei(1, 1);
         broken_bonds_t bonds;
-        mod.change_submod("Connectivity", make_submod(1));
-        auto caps = mod.run_as<the_pt>(hc, bonds);
+        auto conns = testing::hydrocarbon_connectivity(1);
+
+        const auto& [caps, index] = mod.run_as<the_pt>(hc, bonds, conns);
         REQUIRE(are_caps_equal(corr, caps.cap_set()));
+        REQUIRE(index == ghostfragment::CapIndex(caps));
     }
 
     SECTION("Ethane (2 carbon 2 frags)") {
@@ -112,8 +105,8 @@ TEST_CASE("DCLC Capping") {
         broken_bonds_t bonds;
         bonds.insert({0, 1});
         bonds.insert({1, 0});
-        mod.change_submod("Connectivity", make_submod(2));
-        auto caps = mod.run_as<the_pt>(hc, bonds);
+        auto conns = testing::hydrocarbon_connectivity(2);
+        auto caps  = std::get<0>(mod.run_as<the_pt>(hc, bonds, conns));
         REQUIRE(are_caps_equal(corr, caps.cap_set()));
     }
 
@@ -123,7 +116,8 @@ TEST_CASE("DCLC Capping") {
         broken_bonds_t bonds;
         bonds.insert({1, 0});
         bonds.insert({1, 2});
-        auto caps = mod.run_as<the_pt>(hc, bonds);
+        auto conns = testing::hydrocarbon_connectivity(3);
+        auto caps  = std::get<0>(mod.run_as<the_pt>(hc, bonds, conns));
         REQUIRE(are_caps_equal(corr, caps.cap_set()));
     }
 
@@ -135,7 +129,8 @@ TEST_CASE("DCLC Capping") {
         bonds.insert({1, 0});
         bonds.insert({1, 2});
         bonds.insert({2, 1});
-        auto caps = mod.run_as<the_pt>(hc, bonds);
+        auto conns = testing::hydrocarbon_connectivity(3);
+        auto caps  = std::get<0>(mod.run_as<the_pt>(hc, bonds, conns));
         REQUIRE(are_caps_equal(corr, caps.cap_set()));
     }
 }
@@ -73,8 +73,11 @@ TEST_CASE("SingleAtom") {
                 auto water_n = water_fragmented_nuclei(n_waters);
                 broken_bonds_type bonds;
 
-                const auto& rv = mod.run_as<the_pt>(water_n, bonds);
+                auto conns = water_connectivity(n_waters);
+                const auto& [rv, index] =
+                  mod.run_as<the_pt>(water_n, bonds, conns);
                 REQUIRE(rv == water_n);
+                REQUIRE(index == CapIndex{});
             }
         }
     }
@@ -84,7 +87,8 @@ TEST_CASE("SingleAtom") {
             auto corr = caps_methane_one();
             auto hc   = hydrocarbon_fragmented_nuclei(1, 1);
             broken_bonds_type bonds;
-            auto test = mod.run_as<the_pt>(hc, bonds);
+            auto conns = hydrocarbon_connectivity(1);
+            auto test  = std::get<0>(mod.run_as<the_pt>(hc, bonds, conns));
             REQUIRE(are_caps_equal(corr.cap_set(), test.cap_set()));
         }
 
@@ -94,7 +98,8 @@ TEST_CASE("SingleAtom") {
             broken_bonds_type bonds;
             bonds.insert({0, 1});
             bonds.insert({1, 0});
-            auto test = mod.run_as<the_pt>(hc, bonds);
+            auto conns = hydrocarbon_connectivity(2);
+            auto test  = std::get<0>(mod.run_as<the_pt>(hc, bonds, conns));
             REQUIRE(are_caps_equal(corr.cap_set(), test.cap_set()));
         }
 
@@ -106,7 +111,8 @@ TEST_CASE("SingleAtom") {
             bonds.insert({1, 0});
             bonds.insert({1, 2});
             bonds.insert({2, 1});
-            auto test = mod.run_as<the_pt>(hc, bonds);
+            auto conns = hydrocarbon_connectivity(3);
+            auto test  = std::get<0>(mod.run_as<the_pt>(hc, bonds, conns));
             REQUIRE(are_caps_equal(corr.cap_set(), test.cap_set()));
         }
 
@@ -116,8 +122,30 @@ TEST_CASE("SingleAtom") {
             broken_bonds_type bonds;
             bonds.insert({1, 2});
             bonds.insert({1, 0});
-            auto test = mod.run_as<the_pt>(hc, bonds);
+            auto conns = hydrocarbon_connectivity(3);
+            auto test  = std::get<0>(mod.run_as<the_pt>(hc, bonds, conns));
             REQUIRE(are_caps_equal(corr.cap_set(), test.cap_set()));
         }
     }
+
+    SECTION("Periodic") {
+        // The carbons are 2.36 Bohr apart along x, so in a cell 4 Bohr wide
+        // along x each is nearer to an image of the other through an x face
+        auto corr = hydrocarbon_fragmented_nuclei(2, 1);
+        nucleus_type c0("H", 1ul, 1837.289, -1.639905906, 1.667949599, 0.0);
+        nucleus_type c1("H", 1ul, 1837.289, 4.0, 0.0, 0.0);
+        corr.add_cap(cap_type(0, 1, c0));
+        corr.add_cap(cap_type(1, 0, c1));
+
+        auto hc = hydrocarbon_fragmented_nuclei(2, 1);
+        broken_bonds_type bonds;
+        bonds.insert({0, 1});
+        bonds.insert({1, 0});
+        auto conns = hydrocarbon_connectivity(2);
+        std::vector<double> lattice{4.0, 0.0, 0.0,  0.0, 20.0,
+                                    0.0, 0.0, 0.0, 20.0};
+        mod.change_input("lattice vectors", lattice);
+        auto test = std::get<0>(mod.run_as<the_pt>(hc, bonds, conns));
+        REQUIRE(are_caps_equal(corr.cap_set(), test.cap_set()));
+    }
 }
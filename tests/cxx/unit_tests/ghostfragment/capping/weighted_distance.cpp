@@ -82,15 +82,19 @@ TEST_CASE("Weighted Distance Capping") {
         auto hc   = hydrocarbon_fragmented_nuclei(1, 1);
         bonds_t bonds;
 
-        auto test = mod.run_as<my_pt>(hc, bonds);
+        auto conns = hydrocarbon_connectivity(1);
+
+        const auto& [test, index] = mod.run_as<my_pt>(hc, bonds, conns);
         REQUIRE(are_caps_equal(corr, test.cap_set()));
+        REQUIRE(index == ghostfragment::CapIndex(test));
     }
 
     SECTION("Ethane fragment (size 1)") {
         auto corr = caps_ethane_one();
         auto hc   = hydrocarbon_fragmented_nuclei(2, 1);
         bonds_t bonds{{0, 1}, {1, 0}};
-        auto test = mod.run_as<my_pt>(hc, bonds);
+        auto conns = hydrocarbon_connectivity(2);
+        auto test  = std::get<0>(mod.run_as<my_pt>(hc, bonds, conns));
         REQUIRE(are_caps_equal(corr, test.cap_set()));
     }
 
@@ -99,7 +103,8 @@ TEST_CASE("Weighted Distance Capping") {
         auto hc   = hydrocarbon_fragmented_nuclei(3, 1);
         bonds_t bonds{{0, 1}, {1, 0}, {1, 2}, {2, 1}};
 
-        auto test = mod.run_as<my_pt>(hc, bonds);
+        auto conns = hydrocarbon_connectivity(3);
+        auto test  = std::get<0>(mod.run_as<my_pt>(hc, bonds, conns));
         REQUIRE(are_caps_equal(corr, test.cap_set()));
     }
 
@@ -107,7 +112,8 @@ TEST_CASE("Weighted Distance Capping") {
         auto corr = caps_propane_two();
         auto hc   = hydrocarbon_fragmented_nuclei(3, 2);
         bonds_t bonds{{1, 0}, {1, 2}};
-        auto test = mod.run_as<my_pt>(hc, bonds);
+        auto conns = hydrocarbon_connectivity(3);
+        auto test  = std::get<0>(mod.run_as<my_pt>(hc, bonds, conns));
         REQUIRE(are_caps_equal(corr, test.cap_set()));
     }
 }
@@ -15,11 +15,15 @@
  */
 
 #include "../test_ghostfragment.hpp"
+#include <ghostfragment/property_types/fragmenting/capped_fragments.hpp>
 #include <ghostfragment/property_types/fragmenting/fragmented_nuclei.hpp>
 #include <ghostfragment/property_types/fragmenting/intersections.hpp>
 #include <ghostfragment/property_types/fragmenting/nuclear_graph_to_fragments.hpp>
+#include <ghostfragment/property_types/fragmenting/nuclear_graph_to_nmers.hpp>
+#include <ghostfragment/property_types/topology/broken_bonds_by_fragment.hpp>
 #include <ghostfragment/property_types/topology/connectivity_table.hpp>
 #include <ghostfragment/property_types/topology/nuclear_graph.hpp>
+#include <set>
 using namespace ghostfragment;
 using namespace testing;
 
@@ -28,7 +32,8 @@ using frags_pt        = pt::FragmentedNuclei;
 using graph_pt        = pt::NuclearGraph;
 using intersection_pt = pt::Intersections;
 using graph2frags_pt  = pt::NuclearGraphToFragments;
-using broken_bonds_pt = pt::BrokenBonds;
+using nmers_pt        = pt::NuclearGraphToNMers;
+using broken_bonds_pt = pt::BrokenBondsByFragment;
 using cap_pt          = pt::CappedFragments;
 
 using system_type       = typename pt::FragmentedNucleiTraits::system_type;
@@ -36,7 +41,8 @@ using molecule_type     = typename system_type::molecule_t;
 using frags_type        = typename pt::FragmentedNucleiTraits::result_type;
 using graph_type        = typename pt::NuclearGraphTraits::result_type;
 using conns_type        = typename graph_type::connectivity_type;
-using broken_bonds_type = typename pt::BrokenBondsTraits::result_type;
+using broken_bonds_type = FragmentBrokenBonds;
+using bonds_type        = typename pt::CappedFragmentsTraits::broken_bonds_type;
 using n_type            = unsigned short;
 
 namespace {
@@ -44,24 +50,71 @@ namespace {
 DECLARE_MODULE(NMerStub);
 
 MODULE_CTOR(NMerStub) {
-    satisfies_property_type<graph2frags_pt>();
+    satisfies_property_type<nmers_pt>();
 
-    add_input<n_type>("n").set_default(n_type(1));
     add_input<n_type>("corr n");
     add_input<graph_type>("corr input");
     add_input<frags_type>("corr result");
 }
 
 MODULE_RUN(NMerStub) {
-    const auto& [graph_in] = graph2frags_pt::unwrap_inputs(inputs);
+    const auto& [graph_in, n] = nmers_pt::unwrap_inputs(inputs);
     REQUIRE(graph_in == inputs.at("corr input").value<graph_type>());
-
-    auto n = inputs.at("n").value<n_type>();
     REQUIRE(n == inputs.at("corr n").value<n_type>());
 
     auto rv                = results();
     const auto& corr_frags = inputs.at("corr result").value<frags_type>();
-    return graph2frags_pt::wrap_results(rv, corr_frags);
+    return nmers_pt::wrap_results(rv, corr_frags);
+}
+
+// Checks it is given the expected inputs, returns the fragments without caps
+DECLARE_MODULE(CapStub);
+
+MODULE_CTOR(CapStub) {
+    satisfies_property_type<cap_pt>();
+
+    add_input<frags_type>("corr fragments");
+    add_input<bonds_type>("corr bonds");
+    add_input<conns_type>("corr connectivity");
+}
+
+MODULE_RUN(CapStub) {
+    const auto& [frags_in, bonds_in, conns_in] = cap_pt::unwrap_inputs(inputs);
+    REQUIRE(frags_in == inputs.at("corr fragments").value<frags_type>());
+    REQUIRE(bonds_in == inputs.at("corr bonds").value<bonds_type>());
+    REQUIRE(conns_in == inputs.at("corr connectivity").value<conns_type>());
+
+    auto rv = results();
+    return cap_pt::wrap_results(rv, frags_in, CapIndex(frags_in));
+}
+
+// Calling it makes the test fail
+DECLARE_MODULE(NoCapStub);
+
+MODULE_CTOR(NoCapStub) { satisfies_property_type<cap_pt>(); }
+
+MODULE_RUN(NoCapStub) { throw std::runtime_error("Should not cap"); }
+
+// Takes the lattice vectors, checks they are the expected ones
+DECLARE_MODULE(PeriodicConnStub);
+
+MODULE_CTOR(PeriodicConnStub) {
+    satisfies_property_type<conn_pt>();
+
+    add_input<std::vector<double>>("lattice vectors")
+      .set_default(std::vector<double>{});
+    add_input<std::vector<double>>("corr lattice");
+    add_input<graph_type>("corr result");
+}
+
+MODULE_RUN(PeriodicConnStub) {
+    const auto& lattice =
+      inputs.at("lattice vectors").value<std::vector<double>>();
+    REQUIRE(lattice == inputs.at("corr lattice").value<std::vector<double>>());
+
+    auto rv            = results();
+    const auto& result = inputs.at("corr result").value<graph_type>();
+    return conn_pt::wrap_results(rv, result.edges());
 }
 
 auto make_conn_module(const molecule_type& sys, const graph_type& conns) {
@@ -72,10 +125,12 @@ auto make_conn_module(const molecule_type& sys, const graph_type& conns) {
 }
 
 auto make_graph_module(const system_type& sys, const graph_type& g) {
-    return pluginplay::make_lambda<graph_pt>([=](auto&& sys_in) {
-        REQUIRE(sys_in == sys);
-        return g;
-    });
+    return pluginplay::make_lambda<graph_pt>(
+      [=](auto&& sys_in, auto&& conns_in) {
+          REQUIRE(sys_in == sys);
+          REQUIRE(conns_in == g.edges());
+          return g;
+      });
 }
 
 auto make_frag_module(const graph_type& g, const frags_type& rv) {
@@ -102,14 +157,22 @@ auto make_bond_module(const frags_type& frags, const graph_type& conns,
       });
 }
 
-auto make_cap_module(const frags_type& frags,
-                     const broken_bonds_type& broken_bonds) {
-    return pluginplay::make_lambda<cap_pt>(
-      [=](auto&& frags_in, auto&& bonds_in) {
-          REQUIRE(frags_in == frags);
-          REQUIRE(bonds_in == broken_bonds);
-          return frags_in;
-      });
+// The fragments as a set of index sets, i.e., ignoring their order
+auto as_sets(const frags_type& frags) {
+    std::set<std::set<std::size_t>> rv;
+    for(std::size_t i = 0; i < frags.size(); ++i) {
+        const auto indices = frags.nuclear_indices(i);
+        rv.emplace(indices.begin(), indices.end());
+    }
+    return rv;
+}
+
+// The (anchor, replaced) pairs of the caps
+auto cap_bonds(const frags_type& frags) {
+    std::set<std::pair<std::size_t, std::size_t>> rv;
+    for(const auto& cap : frags.cap_set())
+        rv.emplace(cap.get_anchor_index(), cap.get_replaced_index());
+    return rv;
 }
 
 } // namespace
@@ -118,6 +181,8 @@ auto make_cap_module(const frags_type& frags,
  *
  * The FragmentDriver module is purely a driver. If we assume the modules it
  * calls work correctly, the only thing we need to test is that the data flows.
+ * In particular, the atomic connectivity must be computed once and then passed
+ * to the graph, broken bond, and capping submodules.
  */
 
 TEST_CASE("Fragment Driver") {
@@ -137,13 +202,23 @@ TEST_CASE("Fragment Driver") {
         mm.add_module<NMerStub>(nmer_key);
         mm.change_submod("Fragment Driver", "N-mer builder", nmer_key);
 
-        // When eventually called we will pass n == 2, if called before we're
-        // ready we'll gen an error because n defaults to 1.
+        // When eventually called the driver will pass n == 2
         mm.change_input(nmer_key, "corr n", n_type(2));
         mm.change_input(nmer_key, "corr input", graph);
         mm.change_input(nmer_key, "corr result", frags);
     };
 
+    const auto cap_stub_key = "Cap stub";
+
+    auto make_cap_module = [&](const frags_type& frags, const graph_type& graph,
+                               const broken_bonds_type& bonds) {
+        mm.add_module<CapStub>(cap_stub_key);
+        mm.change_submod("Fragment Driver", cap_key, cap_stub_key);
+        mm.change_input(cap_stub_key, "corr fragments", frags);
+        mm.change_input(cap_stub_key, "corr bonds", bonds.unique_bonds());
+        mm.change_input(cap_stub_key, "corr connectivity", graph.edges());
+    };
+
     SECTION("Empty Molecule") {
         molecule_type mol;
         system_type system(mol);
@@ -156,7 +231,7 @@ TEST_CASE("Fragment Driver") {
         mod.change_submod(frag_key, make_frag_module(graph, corr));
         mod.change_submod(int_key, make_intersection_module(corr));
         mod.change_submod(bond_key, make_bond_module(corr, graph, bonds));
-        mod.change_submod(cap_key, make_cap_module(corr, bonds));
+        make_cap_module(corr, graph, bonds);
         make_nmer_module(graph, corr);
         const auto& rv = mod.run_as<frags_pt>(system);
         REQUIRE(corr == rv);
@@ -169,14 +244,14 @@ TEST_CASE("Fragment Driver") {
         frags_type corr(mol.nuclei());
         corr.insert({0});
         graph_type graph(corr, {});
-        broken_bonds_type bonds;
+        broken_bonds_type bonds({0, 0}, {});
 
         mod.change_submod(conn_key, make_conn_module(mol, graph));
         mod.change_submod("Molecular graph", make_graph_module(system, graph));
         mod.change_submod(frag_key, make_frag_module(graph, corr));
         mod.change_submod(int_key, make_intersection_module(corr));
         mod.change_submod(bond_key, make_bond_module(corr, graph, bonds));
-        mod.change_submod(cap_key, make_cap_module(corr, bonds));
+        make_cap_module(corr, graph, bonds);
         make_nmer_module(graph, corr);
         const auto& rv = mod.run_as<frags_pt>(system);
         REQUIRE(corr == rv);
@@ -188,14 +263,14 @@ TEST_CASE("Fragment Driver") {
         frags_type corr(methane.nuclei());
         corr.insert({0, 1, 2, 3, 4});
         graph_type graph(corr, {});
-        broken_bonds_type bonds;
+        broken_bonds_type bonds({0, 0}, {});
 
         mod.change_submod(conn_key, make_conn_module(methane, graph));
         mod.change_submod("Molecular graph", make_graph_module(system, graph));
         mod.change_submod(frag_key, make_frag_module(graph, corr));
         mod.change_submod(int_key, make_intersection_module(corr));
         mod.change_submod(bond_key, make_bond_module(corr, graph, bonds));
-        mod.change_submod(cap_key, make_cap_module(corr, bonds));
+        make_cap_module(corr, graph, bonds);
         make_nmer_module(graph, corr);
         const auto& rv = mod.run_as<frags_pt>(system);
         REQUIRE(corr == rv);
@@ -210,19 +285,110 @@ TEST_CASE("Fragment Driver") {
         conns_type c(2);
         c.add_bond(0, 1);
         graph_type graph(corr, c);
-        broken_bonds_type bonds{{0, 1}};
+        broken_bonds_type bonds({0, 1, 2}, {{0, 1}, {1, 0}});
+
+        mod.change_submod(conn_key, make_conn_module(ethane, graph));
+        mod.change_submod("Molecular graph", make_graph_module(system, graph));
+        mod.change_submod(frag_key, make_frag_module(graph, corr));
+        mod.change_submod(int_key, make_intersection_module(corr));
+        mod.change_submod(bond_key, make_bond_module(corr, graph, bonds));
+        make_cap_module(corr, graph, bonds);
+        make_nmer_module(graph, corr);
+        const auto& rv = mod.run_as<frags_pt>(system);
+        REQUIRE(corr == rv);
+    }
+
+    SECTION("Throws if the broken bonds aren't per fragment") {
+        auto ethane = hydrocarbon(2);
+        system_type system(ethane);
+        frags_type corr(ethane.nuclei());
+        corr.insert({0, 2, 3, 4});
+        corr.insert({1, 5, 6, 7});
+        conns_type c(2);
+        c.add_bond(0, 1);
+        graph_type graph(corr, c);
+        broken_bonds_type bonds({0, 1}, {{0, 1}});
 
         mod.change_submod(conn_key, make_conn_module(ethane, graph));
         mod.change_submod("Molecular graph", make_graph_module(system, graph));
         mod.change_submod(frag_key, make_frag_module(graph, corr));
         mod.change_submod(int_key, make_intersection_module(corr));
         mod.change_submod(bond_key, make_bond_module(corr, graph, bonds));
-        mod.change_submod(cap_key, make_cap_module(corr, bonds));
+        make_cap_module(corr, graph, bonds);
+        make_nmer_module(graph, corr);
+        REQUIRE_THROWS_AS(mod.run_as<frags_pt>(system), std::runtime_error);
+    }
+
+    SECTION("Deferred capping skips broken bonds and capping") {
+        auto ethane = hydrocarbon(2);
+        system_type system(ethane);
+        frags_type corr(ethane.nuclei());
+        corr.insert({0, 2, 3, 4});
+        corr.insert({1, 5, 6, 7});
+        conns_type c(2);
+        c.add_bond(0, 1);
+        graph_type graph(corr, c);
+
+        // Calling this or the cap module makes the test fail
+        auto bond_mod = pluginplay::make_lambda<broken_bonds_pt>(
+          [](auto&&, auto&&) {
+              throw std::runtime_error("Should not find broken bonds");
+              return broken_bonds_type{};
+          });
+
+        mod.change_submod(conn_key, make_conn_module(ethane, graph));
+        mod.change_submod("Molecular graph", make_graph_module(system, graph));
+        mod.change_submod(frag_key, make_frag_module(graph, corr));
+        mod.change_submod(int_key, make_intersection_module(corr));
+        mod.change_submod(bond_key, bond_mod);
+        mm.add_module<NoCapStub>(cap_stub_key);
+        mm.change_submod("Fragment Driver", cap_key, cap_stub_key);
         make_nmer_module(graph, corr);
+        mod.change_input("deferred capping", true);
         const auto& rv = mod.run_as<frags_pt>(system);
         REQUIRE(corr == rv);
     }
 
+    SECTION("Forwards the lattice vectors") {
+        auto ethane = hydrocarbon(2);
+        system_type system(ethane);
+        frags_type corr(ethane.nuclei());
+        corr.insert({0, 2, 3, 4});
+        corr.insert({1, 5, 6, 7});
+        conns_type c(2);
+        c.add_bond(0, 1);
+        graph_type graph(corr, c);
+        broken_bonds_type bonds({0, 1, 2}, {{0, 1}, {1, 0}});
+
+        const auto conn_stub_key = "Periodic connectivity stub";
+        mm.add_module<PeriodicConnStub>(conn_stub_key);
+        mm.change_submod("Fragment Driver", conn_key, conn_stub_key);
+        mm.change_input(conn_stub_key, "corr result", graph);
+        mod.change_submod("Molecular graph", make_graph_module(system, graph));
+        mod.change_submod(frag_key, make_frag_module(graph, corr));
+        mod.change_submod(int_key, make_intersection_module(corr));
+        mod.change_submod(bond_key, make_bond_module(corr, graph, bonds));
+        make_cap_module(corr, graph, bonds);
+        make_nmer_module(graph, corr);
+
+        const std::vector<double> cubic{20.0, 0.0, 0.0, 0.0, 20.0,
+                                        0.0,  0.0, 0.0, 20.0};
+
+        SECTION("Set on the driver") {
+            mod.change_input("lattice vectors", cubic);
+            mm.change_input(conn_stub_key, "corr lattice", cubic);
+            const auto& rv = mod.run_as<frags_pt>(system);
+            REQUIRE(corr == rv);
+        }
+
+        SECTION("Unset on the driver keeps the submodule's value") {
+            mm.change_input(conn_stub_key, "lattice vectors", cubic);
+            mm.change_input(conn_stub_key, "corr lattice", cubic);
+            const auto& rv = mod.run_as<frags_pt>(system);
+            REQUIRE(corr == rv);
+        }
+    }
+
     SECTION("Dispatches to N-mer builder when n > 1") {
         auto ethane = hydrocarbon(2);
         system_type system(ethane);
@@ -232,17 +398,107 @@ TEST_CASE("Fragment Driver") {
         conns_type c(2);
         c.add_bond(0, 1);
         graph_type graph(corr, c);
-        broken_bonds_type bonds{{0, 1}};
+        broken_bonds_type bonds({0, 1, 2}, {{0, 1}, {1, 0}});
 
         mod.change_submod(conn_key, make_conn_module(ethane, graph));
         mod.change_submod("Molecular graph", make_graph_module(system, graph));
         mod.change_submod(frag_key, make_frag_module(graph, corr));
         mod.change_submod(int_key, make_intersection_module(corr));
         mod.change_submod(bond_key, make_bond_module(corr, graph, bonds));
-        mod.change_submod(cap_key, make_cap_module(corr, bonds));
+        make_cap_module(corr, graph, bonds);
         make_nmer_module(graph, corr);
         mod.change_input("n", n_type(2));
         const auto& rv = mod.run_as<frags_pt>(system);
         REQUIRE(corr == rv);
     }
+
+    SECTION("Disjoint monomers skip the intersection finder") {
+        auto propane = hydrocarbon(3);
+        system_type system(propane);
+        frags_type monomers(propane.nuclei());
+        monomers.insert({0, 3, 4, 5});
+        monomers.insert({1, 6, 7});
+        monomers.insert({2, 8, 9, 10});
+        conns_type c(3);
+        c.add_bond(0, 1);
+        c.add_bond(1, 2);
+        graph_type graph(monomers, c);
+
+        frags_type dimers(propane.nuclei());
+        dimers.insert({0, 1, 3, 4, 5, 6, 7});
+        dimers.insert({0, 2, 3, 4, 5, 8, 9, 10});
+        dimers.insert({1, 2, 6, 7, 8, 9, 10});
+
+        // The intersections are the monomers
+        frags_type corr(dimers);
+        corr.insert({0, 3, 4, 5});
+        corr.insert({1, 6, 7});
+        corr.insert({2, 8, 9, 10});
+
+        auto int_mod = pluginplay::make_lambda<intersection_pt>([](auto&&) {
+            throw std::runtime_error("Should not find intersections");
+            return frags_type{};
+        });
+
+        mod.change_submod(conn_key, make_conn_module(propane, graph));
+        mod.change_submod("Molecular graph", make_graph_module(system, graph));
+        mod.change_submod(frag_key, make_frag_module(graph, monomers));
+        mod.change_submod(int_key, int_mod);
+        make_nmer_module(graph, dimers);
+        mod.change_input("n", n_type(2));
+        mod.change_input("deferred capping", true);
+        const auto& rv = mod.run_as<frags_pt>(system);
+        REQUIRE(corr == rv);
+    }
+
+    SECTION("Disjoint fast path matches the intersection finder") {
+        system_type system(water(4));
+
+        // Uses the default submodules, the reference has no fast path
+        auto ref_mm   = testing::initialize();
+        auto& ref_mod = ref_mm.at("Fragment Driver");
+        ref_mod.change_input("disjoint fast path", false);
+        ref_mod.change_input("n", n_type(3));
+        ref_mod.change_input("deferred capping", true);
+        mod.change_input("n", n_type(3));
+        mod.change_input("deferred capping", true);
+
+        const auto corr = ref_mod.run_as<frags_pt>(system);
+        const auto rv   = mod.run_as<frags_pt>(system);
+        REQUIRE(rv == corr);
+    }
+
+    SECTION("Spatial renumbering") {
+        // Reversing pentane's atoms gives a poorly localized order
+        using atom_type = typename molecule_type::atom_type;
+        auto pentane    = hydrocarbon(5);
+        molecule_type reversed;
+        for(std::size_t i = pentane.size(); i-- > 0;) {
+            const auto atom = pentane[i].as_nucleus();
+            reversed.push_back(atom_type(atom.name(), atom.Z(), atom.mass(),
+                                         atom.x(), atom.y(), atom.z()));
+        }
+        system_type system(reversed);
+
+        // Uses the default submodules, the reference does not renumber
+        auto ref_mm   = testing::initialize();
+        auto& ref_mod = ref_mm.at("Fragment Driver");
+        mod.change_input("spatial renumbering", true);
+
+        SECTION("Deferred capping") {
+            ref_mod.change_input("deferred capping", true);
+            mod.change_input("deferred capping", true);
+            const auto corr = ref_mod.run_as<frags_pt>(system);
+            const auto rv   = mod.run_as<frags_pt>(system);
+            REQUIRE(rv.supersystem() == corr.supersystem());
+            REQUIRE(as_sets(rv) == as_sets(corr));
+        }
+
+        SECTION("Caps") {
+            const auto corr = ref_mod.run_as<frags_pt>(system);
+            const auto rv   = mod.run_as<frags_pt>(system);
+            REQUIRE(as_sets(rv) == as_sets(corr));
+            REQUIRE(cap_bonds(rv) == cap_bonds(corr));
+        }
+    }
 }
@@ -15,8 +15,13 @@
  */
 
 #include "../test_ghostfragment.hpp"
+#include <ghostfragment/property_types/fragmenting/capped_fragments.hpp>
 #include <ghostfragment/property_types/fragmenting/fragment_weights.hpp>
 #include <ghostfragment/property_types/fragmenting/fragmented_chemical_system.hpp>
+#include <ghostfragment/property_types/fragmenting/weighted_subsystems.hpp>
+#include <ghostfragment/property_types/topology/broken_bonds_by_fragment.hpp>
+#include <ghostfragment/property_types/topology/connectivity_table.hpp>
+#include <memory>
 #include <simde/simde.hpp>
 
 /* Testing Strategy:
@@ -54,6 +59,14 @@ using frag_sys_type        = typename frag_sys_traits::result_type;
 using frag_mol_type        = typename frag_sys_type::fragmented_molecule_type;
 using weights_pt           = pt::FragmentWeights;
 using egy_type             = simde::type::tensor;
+using conn_pt              = pt::ConnectivityTable;
+using broken_bonds_pt      = pt::BrokenBondsByFragment;
+using cap_pt               = pt::CappedFragments;
+using ws_pt                = pt::WeightedSubsystems;
+using ws_traits            = pt::WeightedSubsystemsTraits;
+using ws_frags_type        = typename ws_traits::fragments_type;
+using weight_container     = typename ws_traits::weight_container;
+using cap_frags_type       = typename pt::CappedFragmentsTraits::frags_type;
 
 // Checks that we pass in the correct system, returns a set of fragments
 auto frag_mod(const chemical_system_type& sys, const frag_sys_type& frags) {
@@ -78,11 +91,64 @@ auto energy_mod(const chemical_system_type& sys) {
     });
 }
 
+namespace {
+
+// Checks it is given the expected fragments, returns the given subsystems
+DECLARE_MODULE(WeightedSubsystemsStub);
+
+MODULE_CTOR(WeightedSubsystemsStub) {
+    satisfies_property_type<ws_pt>();
+
+    add_input<ws_frags_type>("corr input");
+    add_input<ws_frags_type>("corr subsystems");
+    add_input<weight_container>("corr weights");
+}
+
+MODULE_RUN(WeightedSubsystemsStub) {
+    const auto& [frags_in] = ws_pt::unwrap_inputs(inputs);
+    REQUIRE(frags_in == inputs.at("corr input").value<ws_frags_type>());
+
+    auto rv          = results();
+    const auto& subs = inputs.at("corr subsystems").value<ws_frags_type>();
+    const auto& ws   = inputs.at("corr weights").value<weight_container>();
+    return ws_pt::wrap_results(rv, subs, ws);
+}
+
+// Caps the fragments with the (anchor, replaced) pairs in "caps". Each cap is
+// a copy of the nucleus it replaces.
+DECLARE_MODULE(CapStub);
+
+MODULE_CTOR(CapStub) {
+    satisfies_property_type<cap_pt>();
+
+    add_input<std::vector<std::size_t>>("caps").set_default(
+      std::vector<std::size_t>{});
+}
+
+MODULE_RUN(CapStub) {
+    using cap_type = typename cap_frags_type::cap_set_type::value_type;
+
+    const auto& [frags_in, bonds_in, conns_in] = cap_pt::unwrap_inputs(inputs);
+    const auto& caps = inputs.at("caps").value<std::vector<std::size_t>>();
+
+    cap_frags_type capped(frags_in);
+    const auto& nuclei = capped.supersystem();
+    for(std::size_t i = 0; i + 1 < caps.size(); i += 2)
+        capped.add_cap(
+          cap_type(caps[i], caps[i + 1], nuclei[caps[i + 1]].as_nucleus()));
+
+    auto rv = results();
+    return cap_pt::wrap_results(rv, capped, CapIndex(capped));
+}
+
+} // namespace
+
 using tensorwrapper::operations::approximately_equal;
 
 TEST_CASE("FragmentBasedMethod") {
     auto mm   = initialize();
     auto& mod = mm.at("Fragment Based Method");
+    const auto cap_key = "Cap stub";
 
     chemical_system_type water(testing::water(1));
     frag_mol_type frag_mol(testing::water_fragmented_nuclei(1), 0, 1);
@@ -92,10 +158,211 @@ TEST_CASE("FragmentBasedMethod") {
     mod.change_submod("Weighter", weight_mod(frags));
     mod.change_submod("Energy method", energy_mod(water));
 
-    auto energy = mod.run_as<my_pt>(water);
-    // simde::type::tensor corr(2.0 * -75.123456);
+    SECTION("Caps every subsystem up front") {
+        auto energy = mod.run_as<my_pt>(water);
+        // simde::type::tensor corr(2.0 * -75.123456);
+
+        // std::cout << energy << " " << corr << std::endl;
+
+        // REQUIRE(approximately_equal(energy, corr, 0.000001));
+    }
+
+    SECTION("Weighted subsystems") {
+        // Water dimer where the stub only returns the first monomer
+        chemical_system_type dimer(testing::water(2));
+        frag_mol_type dimer_mol(testing::water_fragmented_nuclei(2), 0, 1);
+        frag_sys_type dimer_frags(std::move(dimer_mol));
+
+        ws_frags_type monomers(testing::water_fragmented_nuclei(2));
+        auto monomer0 = monomers.nuclear_indices(0);
+        ws_frags_type survivors(monomers.supersystem());
+        survivors.insert(monomer0.begin(), monomer0.end());
+        const auto corr = frag_mol_type(survivors, 0, 1)[0].as_molecule();
+
+        const auto ws_key = "Weighted subsystems stub";
+        mm.add_module<WeightedSubsystemsStub>(ws_key);
+        mm.change_input(ws_key, "corr input", monomers);
+        mm.change_input(ws_key, "corr subsystems", survivors);
+        mm.change_input(ws_key, "corr weights", weight_container{2.0});
+
+        // Calling the Weighter makes the test fail
+        auto weights = pluginplay::make_lambda<weights_pt>([](auto&&) {
+            throw std::runtime_error("Should not call the Weighter");
+            return std::vector<double>{};
+        });
+
+        auto n_calls = std::make_shared<std::size_t>(0);
+        auto egy_mod = pluginplay::make_lambda<my_pt>([=](auto&& sys_in) {
+            REQUIRE(sys_in.molecule() == corr);
+            ++(*n_calls);
+            return egy_type(-75.123456);
+        });
+
+        mod.change_input("weighted subsystems", true);
+        mod.change_submod("Subsystem former", frag_mod(dimer, dimer_frags));
+        mod.change_submod("Weighter", weights);
+        mod.change_submod("Energy method", egy_mod);
+        mm.change_submod("Fragment Based Method", "Weighted subsystem former",
+                         ws_key);
+
+        mod.run_as<my_pt>(dimer);
+        REQUIRE(*n_calls == 1);
+    }
+
+    SECTION("Deferred capping") {
+        // Water dimer where only the first monomer survives weighting
+        chemical_system_type dimer(testing::water(2));
+        frag_mol_type dimer_mol(testing::water_fragmented_nuclei(2), 0, 1);
+        frag_sys_type dimer_frags(std::move(dimer_mol));
+        auto conns = testing::water_connectivity(2);
+
+        auto weights =
+          pluginplay::make_lambda<weights_pt>([=](auto&& frags_in) {
+              REQUIRE(frags_in == dimer_frags);
+              return std::vector<double>{2.0, 0.0};
+          });
+        auto conn_mod = pluginplay::make_lambda<conn_pt>([=](auto&& mol_in) {
+            REQUIRE(mol_in == dimer.molecule());
+            return conns;
+        });
+        auto bond_mod = pluginplay::make_lambda<broken_bonds_pt>(
+          [=](auto&& frags_in, auto&& conns_in) {
+              REQUIRE(frags_in.size() == 1);
+              REQUIRE(frags_in.nuclear_indices(0) ==
+                      dimer_frags.fragmented_molecule()
+                        .fragmented_nuclei()
+                        .nuclear_indices(0));
+              REQUIRE(conns_in == conns);
+              return FragmentBrokenBonds({0, 0}, {});
+          });
+        auto n_calls = std::make_shared<std::size_t>(0);
+        auto egy_mod = pluginplay::make_lambda<my_pt>([=](auto&& sys_in) {
+            REQUIRE(sys_in.molecule().size() == 3);
+            ++(*n_calls);
+            return egy_type(-75.123456);
+        });
+
+        mod.change_input("deferred capping", true);
+        mod.change_submod("Subsystem former", frag_mod(dimer, dimer_frags));
+        mod.change_submod("Weighter", weights);
+        mod.change_submod("Energy method", egy_mod);
+        mod.change_submod("Atomic connectivity", conn_mod);
+        mod.change_submod("Find broken bonds", bond_mod);
+        mm.add_module<CapStub>(cap_key);
+        mm.change_submod("Fragment Based Method", "Cap broken bonds", cap_key);
+
+        mod.run_as<my_pt>(dimer);
+        REQUIRE(*n_calls == 1);
+    }
+
+    SECTION("Deferred capping assembles the caps of each subsystem") {
+        using frags_type = typename pt::CappedFragmentsTraits::frags_type;
+        using cap_type   = typename frags_type::cap_set_type::value_type;
+
+        chemical_system_type dimer(testing::water(2));
+        frag_mol_type dimer_mol(testing::water_fragmented_nuclei(2), 0, 1);
+        frag_sys_type dimer_frags(std::move(dimer_mol));
+
+        // Only the first two caps belong to monomer 0 (so it stays a closed
+        // shell): the third is anchored outside of it and the fourth replaces
+        // an atom inside of it
+        mm.add_module<CapStub>(cap_key);
+        mm.change_input(cap_key, "caps",
+                        std::vector<std::size_t>{0, 3, 2, 4, 3, 0, 1, 2});
+
+        // What FragmentedMolecule gives for the capped monomer
+        frags_type corr_frags(testing::water_fragmented_nuclei(2));
+        auto monomer0 = corr_frags.nuclear_indices(0);
+        frags_type capped0(corr_frags.supersystem());
+        capped0.insert(monomer0.begin(), monomer0.end());
+        const auto& nuclei = capped0.supersystem();
+        capped0.add_cap(cap_type(0, 3, nuclei[3].as_nucleus()));
+        capped0.add_cap(cap_type(2, 4, nuclei[4].as_nucleus()));
+        capped0.add_cap(cap_type(3, 0, nuclei[0].as_nucleus()));
+        capped0.add_cap(cap_type(1, 2, nuclei[2].as_nucleus()));
+        const auto corr = frag_mol_type(capped0, 0, 1)[0].as_molecule();
+        REQUIRE(corr.size() == 5);
+
+        auto n_calls = std::make_shared<std::size_t>(0);
+        auto egy_mod = pluginplay::make_lambda<my_pt>([=](auto&& sys_in) {
+            REQUIRE(sys_in.molecule() == corr);
+            ++(*n_calls);
+            return egy_type(-75.123456);
+        });
+
+        mod.change_input("deferred capping", true);
+        mod.change_submod("Subsystem former", frag_mod(dimer, dimer_frags));
+        mod.change_submod(
+          "Weighter", pluginplay::make_lambda<weights_pt>([](auto&&) {
+              return std::vector<double>{2.0, 0.0};
+          }));
+        mod.change_submod("Energy method", egy_mod);
+        mod.change_submod(
+          "Atomic connectivity",
+          pluginplay::make_lambda<conn_pt>(
+            [](auto&&) { return testing::water_connectivity(2); }));
+        mod.change_submod(
+          "Find broken bonds",
+          pluginplay::make_lambda<broken_bonds_pt>([](auto&&, auto&&) {
+              return FragmentBrokenBonds({0, 0}, {});
+          }));
+        mm.change_submod("Fragment Based Method", "Cap broken bonds", cap_key);
+
+        mod.run_as<my_pt>(dimer);
+        REQUIRE(*n_calls == 1);
+    }
+
+    SECTION("Assembles the caps of each subsystem") {
+        using cap_type = typename cap_frags_type::cap_set_type::value_type;
+
+        chemical_system_type dimer(testing::water(2));
+        auto capped        = testing::water_fragmented_nuclei(2);
+        const auto& nuclei = capped.supersystem();
+        capped.add_cap(cap_type(0, 3, nuclei[3].as_nucleus()));
+        capped.add_cap(cap_type(3, 0, nuclei[0].as_nucleus()));
+        capped.add_cap(cap_type(2, 4, nuclei[4].as_nucleus()));
+        frag_mol_type dimer_mol(capped, 0, 1);
+        const auto corr0 = dimer_mol[0].as_molecule();
+        const auto corr1 = dimer_mol[1].as_molecule();
+        REQUIRE(corr0.size() == 5);
+        REQUIRE(corr1.size() == 4);
+        frag_sys_type dimer_frags(std::move(dimer_mol));
+
+        auto n_calls = std::make_shared<std::size_t>(0);
+        auto egy_mod = pluginplay::make_lambda<my_pt>([=](auto&& sys_in) {
+            const auto& mol = sys_in.molecule();
+            REQUIRE(mol == (mol.size() == 5 ? corr0 : corr1));
+            ++(*n_calls);
+            return egy_type(-75.123456);
+        });
+
+        mod.change_submod("Subsystem former", frag_mod(dimer, dimer_frags));
+        mod.change_submod("Weighter", weight_mod(dimer_frags));
+        mod.change_submod("Energy method", egy_mod);
+
+        mod.run_as<my_pt>(dimer);
+        REQUIRE(*n_calls == 2);
+    }
+
+    SECTION("Throws if the number of weights is wrong") {
+        mod.change_submod(
+          "Weighter", pluginplay::make_lambda<weights_pt>([](auto&&) {
+              return std::vector<double>{1.0, 1.0};
+          }));
+        REQUIRE_THROWS_AS(mod.run_as<my_pt>(water), std::runtime_error);
+    }
+
+    SECTION("Deferred capping throws if subsystems are already capped") {
+        using frags_type = typename pt::CappedFragmentsTraits::frags_type;
+        using cap_type   = typename frags_type::cap_set_type::value_type;
 
-    // std::cout << energy << " " << corr << std::endl;
+        auto capped = testing::water_fragmented_nuclei(1);
+        capped.add_cap(cap_type(0, 1, capped.supersystem()[1].as_nucleus()));
+        frag_sys_type capped_frags(frag_mol_type(capped, 0, 1));
 
-    // REQUIRE(approximately_equal(energy, corr, 0.000001));
+        mod.change_input("deferred capping", true);
+        mod.change_submod("Subsystem former", frag_mod(water, capped_frags));
+        mod.change_submod("Weighter", weight_mod(capped_frags));
+        REQUIRE_THROWS_AS(mod.run_as<my_pt>(water), std::runtime_error);
+    }
 }
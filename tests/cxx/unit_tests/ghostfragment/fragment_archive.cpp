@@ -0,0 +1,170 @@
+/*
+ * Copyright 2024 GhostFragment
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "test_ghostfragment.hpp"
+#include <fstream>
+#include <ghostfragment/fragment_archive.hpp>
+
+using namespace ghostfragment;
+
+/* Testing Strategy:
+ *
+ * We archive the capped monomers of propane, with and without the graph of
+ * the monomers, and check that everything comes back out. Rewriting an
+ * archive must not disturb archives which are already open. We then corrupt
+ * archives in several ways and check that opening them throws.
+ */
+
+TEST_CASE("FragmentArchive") {
+    using frags_type  = FragmentArchive::fragmented_nuclei;
+    using cap_type    = typename frags_type::cap_set_type::value_type;
+    using weight_list = FragmentArchive::weight_container;
+
+    const auto path = std::filesystem::temp_directory_path() /
+                      "ghostfragment_test_fragment_archive.bin";
+
+    auto nodes         = testing::hydrocarbon_fragmented_nuclei(3, 1);
+    const auto& nuclei = nodes.supersystem();
+    auto frags         = nodes;
+    frags.add_cap(cap_type(0, 1, nuclei[1].as_nucleus()));
+    frags.add_cap(cap_type(1, 0, nuclei[0].as_nucleus()));
+    const weight_list weights{1.0, -1.0, 0.5};
+
+    NuclearGraph::connectivity_type edges(3);
+    edges.add_bond(0, 1);
+    edges.add_bond(1, 2);
+    NuclearGraph graph(nodes, edges);
+
+    SECTION("Without a graph") {
+        FragmentArchive::write(path, frags, weights);
+        FragmentArchive archive(path);
+
+        REQUIRE(archive.natoms() == nuclei.size());
+        for(std::size_t i = 0; i < nuclei.size(); ++i) {
+            REQUIRE(archive.atomic_numbers()[i] == nuclei[i].Z());
+            REQUIRE(archive.x()[i] == nuclei[i].x());
+            REQUIRE(archive.y()[i] == nuclei[i].y());
+            REQUIRE(archive.z()[i] == nuclei[i].z());
+        }
+
+        REQUIRE(archive.size() == 3);
+        REQUIRE(archive.offsets().size() == 4);
+        REQUIRE(archive.members().size() == 11);
+        for(std::size_t i = 0; i < 3; ++i) {
+            const auto corr = frags.nuclear_indices(i);
+            const auto frag = archive.fragment(i);
+            REQUIRE(std::vector<std::size_t>(frag.begin(), frag.end()) ==
+                    std::vector<std::size_t>(corr.begin(), corr.end()));
+        }
+        REQUIRE_THROWS_AS(archive.fragment(3), std::out_of_range);
+
+        REQUIRE(archive.ncaps() == 2);
+        REQUIRE(archive.weight_list() == weights);
+        REQUIRE(archive.nodes_size() == 0);
+        REQUIRE(archive.edges().empty());
+
+        REQUIRE(archive.nuclei() == nuclei);
+        REQUIRE(archive.is_supersystem(nuclei));
+        REQUIRE_FALSE(archive.is_supersystem(testing::hydrocarbon(2).nuclei()));
+
+        auto from_archive = archive.fragments();
+        REQUIRE(from_archive == frags);
+        REQUIRE(are_caps_equal(from_archive.cap_set(), frags.cap_set()));
+        REQUIRE(archive.fragments(nuclei) == frags);
+        auto small = testing::hydrocarbon(1).nuclei().as_nuclei();
+        REQUIRE_THROWS_AS(archive.fragments(small), std::runtime_error);
+
+        FragmentArchive moved(std::move(archive));
+        REQUIRE(moved.size() == 3);
+    }
+
+    SECTION("With a graph") {
+        FragmentArchive::write(path, frags, weights, graph);
+        FragmentArchive archive(path);
+
+        REQUIRE(archive.nodes_size() == 3);
+        REQUIRE(archive.edges().size() == 4);
+        REQUIRE(archive.graph(nuclei) == graph);
+        REQUIRE(archive.fragments() == frags);
+    }
+
+    SECTION("Rewriting replaces the archive in one step") {
+        FragmentArchive::write(path, frags, weights);
+        FragmentArchive old_archive(path);
+
+        const weight_list new_weights{2.0, 2.0, 2.0};
+        FragmentArchive::write(path, frags, new_weights);
+        REQUIRE(old_archive.weight_list() == weights);
+        REQUIRE(FragmentArchive(path).weight_list() == new_weights);
+
+        // Nothing but the archive is left behind
+        std::size_t nfiles = 0;
+        const auto prefix  = path.filename().string();
+        for(const auto& entry :
+            std::filesystem::directory_iterator(path.parent_path()))
+            if(entry.path().filename().string().rfind(prefix, 0) == 0)
+                ++nfiles;
+        REQUIRE(nfiles == 1);
+    }
+
+    SECTION("Can't write") {
+        weight_list two_weights{1.0, 1.0};
+        REQUIRE_THROWS_AS(FragmentArchive::write(path, frags, two_weights),
+                          std::runtime_error);
+
+        NuclearGraph other(testing::hydrocarbon_fragmented_nuclei(2, 1),
+                           NuclearGraph::connectivity_type(2));
+        REQUIRE_THROWS_AS(FragmentArchive::write(path, frags, weights, other),
+                          std::runtime_error);
+    }
+
+    SECTION("Invalid archives") {
+        FragmentArchive::write(path, frags, weights);
+        const auto size = std::filesystem::file_size(path);
+
+        SECTION("Does not exist") {
+            std::filesystem::remove(path);
+            REQUIRE_THROWS_AS(FragmentArchive(path), std::runtime_error);
+        }
+
+        SECTION("Truncated") {
+            std::filesystem::resize_file(path, size - 8);
+            REQUIRE_THROWS_AS(FragmentArchive(path), std::runtime_error);
+        }
+
+        SECTION("Trailing bytes") {
+            std::filesystem::resize_file(path, size + 8);
+            REQUIRE_THROWS_AS(FragmentArchive(path), std::runtime_error);
+        }
+
+        SECTION("Different version") {
+            std::fstream f(path, std::ios::in | std::ios::out |
+                                   std::ios::binary);
+            const std::uint32_t version = FragmentArchive::format_version + 1;
+            f.seekp(8);
+            f.write(reinterpret_cast<const char*>(&version), sizeof(version));
+            f.close();
+            REQUIRE_THROWS_AS(FragmentArchive(path), std::runtime_error);
+        }
+
+        SECTION("Not an archive") {
+            std::ofstream(path, std::ios::binary) << "not a fragment archive";
+            REQUIRE_THROWS_AS(FragmentArchive(path), std::runtime_error);
+        }
+    }
+
+    std::filesystem::remove(path);
+}
@@ -0,0 +1,106 @@
+/*
+ * Copyright 2024 GhostFragment
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "test_ghostfragment.hpp"
+#include <ghostfragment/fragment_broken_bonds.hpp>
+#include <sstream>
+namespace ghostfragment {
+
+TEST_CASE("FragmentBrokenBonds") {
+    using offsets_t = FragmentBrokenBonds::offset_list_type;
+    using bonds_t   = FragmentBrokenBonds::bond_list_type;
+    using set_t     = FragmentBrokenBonds::bond_set_type;
+
+    // Propane fragmented into {C0, C1} and {C1, C2}
+    offsets_t offsets{0, 1, 2};
+    bonds_t bonds{{1, 2}, {1, 0}};
+
+    FragmentBrokenBonds defaulted;
+    FragmentBrokenBonds propane(offsets, bonds);
+
+    SECTION("CTors") {
+        SECTION("Default") {
+            REQUIRE(defaulted.size() == 0);
+            REQUIRE(defaulted.nbonds() == 0);
+            REQUIRE(defaulted.offsets() == offsets_t{0});
+        }
+
+        SECTION("Value") {
+            REQUIRE(propane.size() == 2);
+            REQUIRE(propane.nbonds() == 2);
+            REQUIRE(propane.offsets() == offsets);
+            REQUIRE(propane.bond_list() == bonds);
+        }
+
+        SECTION("Throws if offsets are inconsistent") {
+            using except_t = std::runtime_error;
+            REQUIRE_THROWS_AS(FragmentBrokenBonds(offsets_t{}, bonds_t{}),
+                              except_t);
+            REQUIRE_THROWS_AS(FragmentBrokenBonds(offsets_t{1, 2}, bonds),
+                              except_t);
+            REQUIRE_THROWS_AS(FragmentBrokenBonds(offsets_t{0, 2, 1}, bonds),
+                              except_t);
+            REQUIRE_THROWS_AS(FragmentBrokenBonds(offsets_t{0, 1}, bonds),
+                              except_t);
+        }
+    }
+
+    SECTION("bonds") {
+        auto b0 = propane.bonds(0);
+        REQUIRE(b0.size() == 1);
+        REQUIRE_FALSE(b0.empty());
+        REQUIRE(b0[0] == bonds[0]);
+
+        auto b1 = propane.bonds(1);
+        REQUIRE(bonds_t(b1.begin(), b1.end()) == bonds_t{{1, 0}});
+
+        REQUIRE_THROWS_AS(propane.bonds(2), std::out_of_range);
+        REQUIRE_THROWS_AS(defaulted.bonds(0), std::out_of_range);
+    }
+
+    SECTION("Empty fragment") {
+        FragmentBrokenBonds has_empty(offsets_t{0, 0, 2}, bonds);
+        REQUIRE(has_empty.bonds(0).empty());
+        REQUIRE(has_empty.bonds(1).size() == 2);
+    }
+
+    SECTION("unique_bonds") {
+        REQUIRE(defaulted.unique_bonds() == set_t{});
+        REQUIRE(propane.unique_bonds() == set_t{{1, 0}, {1, 2}});
+
+        // Repeats are only counted once
+        bonds_t repeated{{1, 0}, {1, 0}};
+        FragmentBrokenBonds repeats(offsets_t{0, 1, 2}, repeated);
+        REQUIRE(repeats.unique_bonds() == set_t{{1, 0}});
+    }
+
+    SECTION("Comparisons") {
+        REQUIRE(defaulted == FragmentBrokenBonds{});
+        REQUIRE(propane == FragmentBrokenBonds(offsets, bonds));
+        REQUIRE(propane != defaulted);
+
+        // Same bonds, different fragments
+        REQUIRE(propane != FragmentBrokenBonds(offsets_t{0, 2, 2}, bonds));
+    }
+
+    SECTION("print") {
+        std::stringstream ss;
+        ss << propane;
+        REQUIRE(ss.str() == "Fragment 0: (1, 2)\nFragment 1: (1, 0)\n");
+    }
+}
+
+} // namespace ghostfragment
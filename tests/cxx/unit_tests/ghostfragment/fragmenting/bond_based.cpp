@@ -236,6 +236,16 @@ TEST_CASE("Bond-Based Fragmenter") {
         const auto& rv = mod.run_as<my_pt>(input);
         return_t corr  = frag;
         REQUIRE(corr.operator==(rv));
+
+        // Modules are locked after running, so each thread count gets a
+        // module of its own
+        for(std::size_t nthreads : {1, 2, 3, 8}) {
+            auto thread_mm   = testing::initialize();
+            auto& thread_mod = thread_mm.at("Bond-Based Fragmenter");
+            thread_mod.change_input("nbonds", std::size_t(1));
+            thread_mod.change_input("nthreads", nthreads);
+            REQUIRE(corr.operator==(thread_mod.run_as<my_pt>(input)));
+        }
     }
 
     SECTION("Anthracene, nbonds = 7") {
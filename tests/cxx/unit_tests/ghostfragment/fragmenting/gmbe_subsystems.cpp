@@ -0,0 +1,180 @@
+/*
+ * Copyright 2024 GhostFragment
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../test_ghostfragment.hpp"
+#include <ghostfragment/property_types/fragmenting/weighted_subsystems.hpp>
+
+using namespace ghostfragment;
+
+using property_type    = pt::WeightedSubsystems;
+using traits_type      = pt::WeightedSubsystemsTraits;
+using fragments_type   = typename traits_type::fragments_type;
+using weight_container = typename traits_type::weight_container;
+
+/* Testing strategy:
+ *
+ * As for the GMBE Weights module we use four water molecules and treat each
+ * water as a pseudoatom. The weights of the subsystems which are returned are
+ * the GMBE weights, so we focus on the subsystems which are (not) returned.
+ */
+
+TEST_CASE("GMBE Subsystems") {
+    auto mm   = testing::initialize();
+    auto& mod = mm.at("GMBE Subsystems");
+
+    auto nuclei_mol = testing::water(4);
+    fragments_type frags(nuclei_mol.nuclei());
+    fragments_type corr(nuclei_mol.nuclei());
+
+    SECTION("No Fragments") {
+        const auto& [subsystems, weights] = mod.run_as<property_type>(frags);
+        REQUIRE(subsystems == corr);
+        REQUIRE(weights == weight_container{});
+    }
+
+    SECTION("Disjoint") {
+        frags.insert({0, 1, 2});
+        frags.insert({3, 4, 5});
+        frags.insert({6, 7, 8, 9, 10, 11});
+
+        const auto& [subsystems, weights] = mod.run_as<property_type>(frags);
+        REQUIRE(subsystems == frags);
+        REQUIRE(weights == weight_container{1.0, 1.0, 1.0});
+    }
+
+    SECTION("Pair-wise overlaps") {
+        frags.insert({0, 1, 2, 3, 4, 5});
+        frags.insert({3, 4, 5, 6, 7, 8});
+        frags.insert({0, 1, 2, 6, 7, 8, 9, 10, 11});
+
+        corr = frags;
+        corr.insert({0, 1, 2});
+        corr.insert({3, 4, 5});
+        corr.insert({6, 7, 8});
+
+        const auto& [subsystems, weights] = mod.run_as<property_type>(frags);
+        REQUIRE(subsystems == corr);
+        REQUIRE(weights == weight_container{1.0, 1.0, 1.0, -1.0, -1.0, -1.0});
+    }
+
+    SECTION("Zero weights are dropped") {
+        // The last two fragments and their intersection all cancel
+        frags.insert({0, 1, 2, 3, 4, 5, 6, 7, 8});
+        frags.insert({0, 1, 2, 3, 4, 5});
+        frags.insert({0, 1, 2, 6, 7, 8});
+
+        corr.insert({0, 1, 2, 3, 4, 5, 6, 7, 8});
+
+        const auto& [subsystems, weights] = mod.run_as<property_type>(frags);
+        REQUIRE(subsystems == corr);
+        REQUIRE(weights == weight_container{1.0});
+    }
+
+    SECTION("Contained fragments") {
+        // The second fragment is in the first one. Its intersection with the
+        // third one, {3, 4, 5}, cancels and is never formed.
+        frags.insert({0, 1, 2, 3, 4, 5, 6, 7, 8});
+        frags.insert({0, 1, 2, 3, 4, 5});
+        frags.insert({3, 4, 5, 6, 7, 8, 9, 10, 11});
+
+        corr.insert({0, 1, 2, 3, 4, 5, 6, 7, 8});
+        corr.insert({3, 4, 5, 6, 7, 8, 9, 10, 11});
+        corr.insert({3, 4, 5, 6, 7, 8});
+
+        const auto& [subsystems, weights] = mod.run_as<property_type>(frags);
+        REQUIRE(subsystems == corr);
+        REQUIRE(weights == weight_container{1.0, 1.0, -1.0});
+    }
+
+    SECTION("Contained fragments which are intersections keep their place") {
+        frags.insert({0, 1, 2, 3, 4, 5});
+        frags.insert({3, 4, 5});
+        frags.insert({3, 4, 5, 6, 7, 8});
+
+        corr = frags;
+
+        const auto& [subsystems, weights] = mod.run_as<property_type>(frags);
+        REQUIRE(subsystems == corr);
+        REQUIRE(weights == weight_container{1.0, -1.0, 1.0});
+    }
+
+    SECTION("Repeated fragments are used once") {
+        frags.insert({0, 1, 2, 3, 4, 5});
+        frags.insert({0, 1, 2, 3, 4, 5});
+
+        corr.insert({0, 1, 2, 3, 4, 5});
+
+        const auto& [subsystems, weights] = mod.run_as<property_type>(frags);
+        REQUIRE(subsystems == corr);
+        REQUIRE(weights == weight_container{1.0});
+    }
+
+    SECTION("Caps are kept") {
+        using cap_type = typename fragments_type::cap_set_type::value_type;
+        const auto& nuclei = frags.supersystem();
+        frags.insert({0, 1, 2, 3, 4, 5});
+        frags.insert({3, 4, 5, 6, 7, 8});
+        frags.add_cap(cap_type(5, 6, nuclei[6].as_nucleus()));
+        frags.add_cap(cap_type(6, 5, nuclei[5].as_nucleus()));
+
+        corr = frags;
+        corr.insert({3, 4, 5});
+
+        const auto& [subsystems, weights] = mod.run_as<property_type>(frags);
+        REQUIRE(subsystems == corr);
+        REQUIRE(subsystems.cap_set() == frags.cap_set());
+        REQUIRE(weights == weight_container{1.0, 1.0, -1.0});
+    }
+
+    SECTION("Three-body expansion") {
+        frags.insert({0, 1, 2, 3, 4, 5, 6, 7, 8});
+        frags.insert({0, 1, 2, 3, 4, 5, 9, 10, 11});
+        frags.insert({0, 1, 2, 6, 7, 8, 9, 10, 11});
+        frags.insert({3, 4, 5, 6, 7, 8, 9, 10, 11});
+
+        // Intersections come in the order of their nuclear indices
+        corr = frags;
+        corr.insert({0, 1, 2});
+        corr.insert({0, 1, 2, 3, 4, 5});
+        corr.insert({0, 1, 2, 6, 7, 8});
+        corr.insert({0, 1, 2, 9, 10, 11});
+        corr.insert({3, 4, 5});
+        corr.insert({3, 4, 5, 6, 7, 8});
+        corr.insert({3, 4, 5, 9, 10, 11});
+        corr.insert({6, 7, 8});
+        corr.insert({6, 7, 8, 9, 10, 11});
+        corr.insert({9, 10, 11});
+
+        weight_container corr_weights{1.0, 1.0,  1.0, 1.0,  1.0,  -1.0, -1.0,
+                                      -1.0, 1.0, -1.0, -1.0, 1.0, -1.0, 1.0};
+
+        const auto& [subsystems, weights] = mod.run_as<property_type>(frags);
+        REQUIRE(subsystems == corr);
+        REQUIRE(weights == corr_weights);
+
+        // Modules are locked after running, so each thread count gets a
+        // module of its own
+        for(std::size_t nthreads : {1, 2, 3, 8}) {
+            auto thread_mm   = testing::initialize();
+            auto& thread_mod = thread_mm.at("GMBE Subsystems");
+            thread_mod.change_input("nthreads", nthreads);
+            const auto& [subsystems_i, weights_i] =
+              thread_mod.run_as<property_type>(frags);
+            REQUIRE(subsystems_i == corr);
+            REQUIRE(weights_i == corr_weights);
+        }
+    }
+}
@@ -199,6 +199,42 @@ TEST_CASE("GMBE Weights") {
 
             auto weights = mod.run_as<property_type>(as_system(frags));
             REQUIRE(weights == corr);
+
+            // Modules are locked after running, so each thread count gets a
+            // module of its own. Weights must be exactly the same.
+            for(std::size_t nthreads : {1, 2, 3, 8}) {
+                auto thread_mm   = testing::initialize();
+                auto& thread_mod = thread_mm.at("GMBE Weights");
+                thread_mod.change_input("nthreads", nthreads);
+                auto system = as_system(frags);
+                REQUIRE(thread_mod.run_as<property_type>(system) == corr);
+            }
         }
     }
+
+    SECTION("Two-body expansion") {
+        frags.insert({0, 1, 2, 3, 4, 5});
+        frags.insert({0, 1, 2, 6, 7, 8});
+        frags.insert({0, 1, 2, 9, 10, 11});
+        frags.insert({3, 4, 5, 6, 7, 8});
+        frags.insert({3, 4, 5, 9, 10, 11});
+        frags.insert({6, 7, 8, 9, 10, 11});
+        frags.insert({0, 1, 2});
+        frags.insert({3, 4, 5});
+        frags.insert({6, 7, 8});
+        frags.insert({9, 10, 11});
+
+        // Dimers have weight 1, monomers -C(2, 1)
+        weight_container corr{1.0,  1.0,  1.0,  1.0,  1.0,
+                              1.0,  -2.0, -2.0, -2.0, -2.0};
+        auto weights = mod.run_as<property_type>(as_system(frags));
+        REQUIRE(weights == corr);
+
+        // Must agree with the general algorithm
+        auto general_mm   = testing::initialize();
+        auto& general_mod = general_mm.at("GMBE Weights");
+        general_mod.change_input("closed form", false);
+        auto system = as_system(frags);
+        REQUIRE(general_mod.run_as<property_type>(system) == corr);
+    }
 }
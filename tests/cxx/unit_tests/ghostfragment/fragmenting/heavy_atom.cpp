@@ -15,33 +15,20 @@
  */
 
 #include "../test_ghostfragment.hpp"
-#include <ghostfragment/property_types/fragmenting/fragmented_nuclei.hpp>
-#include <ghostfragment/property_types/topology/connectivity_table.hpp>
+#include <ghostfragment/property_types/fragmenting/fragmented_nuclei_from_connectivity.hpp>
 #include <iostream>
 
 using namespace ghostfragment;
 
-using my_pt      = pt::FragmentedNuclei;
-using connect_pt = pt::ConnectivityTable;
+using my_pt       = pt::FragmentedNucleiFromConnectivity;
+using traits_type = pt::FragmentedNucleiFromConnectivityTraits;
 
-using chemical_system_type = typename pt::FragmentedNucleiTraits::system_type;
+using chemical_system_type = typename traits_type::system_type;
 using molecule_type =
   typename chemical_system_type::molecule_traits::value_type;
 using atom_type   = typename molecule_type::atom_type;
-using result_type = pt::FragmentedNucleiTraits::result_type;
-using connect_t   = typename pt::ConnectivityTableTraits::result_type;
-
-namespace {
-
-// Used to test that HeavyAtom correctly calls the connectivity submodule
-auto make_lambda(molecule_type mol, const connect_t& conns) {
-    return pluginplay::make_lambda<connect_pt>([=](const auto& mol_in) {
-        REQUIRE(mol_in == mol);
-        return conns;
-    });
-}
-
-} // namespace
+using result_type = traits_type::result_type;
+using connect_t   = typename traits_type::connectivity_type;
 
 TEST_CASE("HeavyAtom") {
     auto mm   = testing::initialize();
@@ -50,10 +37,7 @@ TEST_CASE("HeavyAtom") {
     SECTION("Empty Molecule") {
         chemical_system_type sys;
 
-        auto lambda = make_lambda(sys.molecule(), connect_t{});
-        mod.change_submod("Connectivity", lambda);
-
-        const auto& test = mod.run_as<my_pt>(sys);
+        const auto& test = mod.run_as<my_pt>(sys, connect_t{});
 
         result_type corr(sys.molecule().nuclei());
         REQUIRE(corr == test);
@@ -73,9 +57,7 @@ TEST_CASE("HeavyAtom") {
         c.add_bond(0, 1);
         c.add_bond(0, 2);
 
-        mod.change_submod("Connectivity", make_lambda(mol, c));
-
-        REQUIRE_THROWS_AS(mod.run_as<my_pt>(system), std::runtime_error);
+        REQUIRE_THROWS_AS(mod.run_as<my_pt>(system, c), std::runtime_error);
     }
 
     SECTION("Throws if Z == 0") {
@@ -83,11 +65,8 @@ TEST_CASE("HeavyAtom") {
         mol.push_back(atom_type("Ez", 0, 1ul, 0, 0, 0));
         chemical_system_type system(mol);
 
-        auto lambda = make_lambda(mol, connect_t{1});
-
-        mod.change_submod("Connectivity", lambda);
-
-        REQUIRE_THROWS_AS(mod.run_as<my_pt>(system), std::runtime_error);
+        connect_t c(1);
+        REQUIRE_THROWS_AS(mod.run_as<my_pt>(system, c), std::runtime_error);
     }
 
     SECTION("H2 and H2O") {
@@ -109,8 +88,7 @@ TEST_CASE("HeavyAtom") {
         c.add_bond(2, 3);
         c.add_bond(3, 4);
 
-        mod.change_submod("Connectivity", make_lambda(mol, c));
-        const auto& test = mod.run_as<my_pt>(system);
+        const auto& test = mod.run_as<my_pt>(system, c);
         result_type corr(mol.nuclei());
         corr.insert({0, 1});
         corr.insert({3, 2, 4}); // Finds the Oxygen first
@@ -133,8 +111,7 @@ TEST_CASE("HeavyAtom") {
         c.add_bond(1, 2);
         c.add_bond(2, 3);
 
-        mod.change_submod("Connectivity", make_lambda(mol, c));
-        const auto& test = mod.run_as<my_pt>(system);
+        const auto& test = mod.run_as<my_pt>(system, c);
         result_type corr(mol.nuclei());
         corr.insert({0});
         corr.insert({2, 1, 3}); // Finds the Oxygen first
@@ -162,8 +139,7 @@ TEST_CASE("HeavyAtom") {
         c.add_bond(1, 2);
         c.add_bond(4, 5);
 
-        mod.change_submod("Connectivity", make_lambda(mol, c));
-        const auto& test = mod.run_as<my_pt>(system);
+        const auto& test = mod.run_as<my_pt>(system, c);
 
         result_type corr(mol.nuclei());
         corr.insert({0});
@@ -249,4 +249,16 @@ TEST_CASE("Bug associated with #62") {
 
     auto intersects = mod.run_as<property_type>(fragmented_nuclei);
     REQUIRE(intersects == corr);
+
+    SECTION("Thread count does not change the result") {
+        // Modules are locked after running, so each thread count gets a
+        // module of its own
+        for(std::size_t nthreads : {1, 2, 3, 8}) {
+            auto thread_mm   = testing::initialize();
+            auto& thread_mod = thread_mm.at("Intersections");
+            thread_mod.change_input("nthreads", nthreads);
+            REQUIRE(thread_mod.run_as<property_type>(fragmented_nuclei) ==
+                    corr);
+        }
+    }
 }
@@ -15,9 +15,11 @@
  */
 
 #include "../test_ghostfragment.hpp"
-#include <ghostfragment/property_types/fragmenting/nuclear_graph_to_fragments.hpp>
+#include <ghostfragment/property_types/fragmenting/nuclear_graph_to_nmers.hpp>
+#include <limits>
 
 using my_pt      = ghostfragment::pt::NuclearGraphToFragments;
+using nmers_pt   = ghostfragment::pt::NuclearGraphToNMers;
 using traits     = ghostfragment::pt::NuclearGraphToFragmentsTraits;
 using graph_type = typename traits::graph_type;
 using frags_type = typename traits::fragment_type;
@@ -108,6 +110,22 @@ TEST_CASE("NMers") {
                 REQUIRE(nmers == corr);
             }
 
+            SECTION("n as a property type input") {
+                frags_type dimers(monomers.supersystem().as_nuclei());
+                dimers.insert({0, 1, 2, 3, 4, 5});
+                dimers.insert({0, 1, 2, 6, 7, 8});
+                dimers.insert({3, 4, 5, 6, 7, 8});
+                frags_type trimers(monomers.supersystem().as_nuclei());
+                trimers.insert({0, 1, 2, 3, 4, 5, 6, 7, 8});
+
+                // The same instance serves every n
+                auto monomers_out = mod.run_as<nmers_pt>(graph, size_type{1});
+                REQUIRE(monomers_out == monomers);
+                REQUIRE(mod.run_as<nmers_pt>(graph, size_type{2}) == dimers);
+                REQUIRE(mod.run_as<nmers_pt>(graph, size_type{3}) == trimers);
+                REQUIRE(mod.run_as<nmers_pt>(graph, size_type{2}) == dimers);
+            }
+
             SECTION("trimers") {
                 mod.change_input("n", size_type{3});
                 frags_type corr(monomers.supersystem().as_nuclei());
@@ -209,6 +227,120 @@ TEST_CASE("NMers") {
         }
     }
 
+    SECTION("Distance screening") {
+        SECTION("Water 3") {
+            size_type n_waters = 3;
+            auto conns         = testing::water_connectivity(n_waters);
+            auto monomers      = testing::water_fragmented_nuclei(n_waters);
+
+            // Neighboring waters are 3 Bohr apart
+            graph_type graph(monomers, conns);
+            mod.change_submod("Monomer maker", make_monomers(graph, monomers));
+            mod.change_input("distance threshold", 3.5);
+            frags_type corr(monomers.supersystem().as_nuclei());
+
+            SECTION("dimers") {
+                mod.change_input("n", size_type{2});
+                corr.insert({0, 1, 2, 3, 4, 5});
+                corr.insert({3, 4, 5, 6, 7, 8});
+                auto nmers = mod.run_as<my_pt>(graph);
+                REQUIRE(nmers == corr);
+            }
+
+            SECTION("trimers") {
+                mod.change_input("n", size_type{3});
+                corr.insert({0, 1, 2, 3, 4, 5, 6, 7, 8});
+                auto nmers = mod.run_as<my_pt>(graph);
+                REQUIRE(nmers == corr);
+            }
+
+            SECTION("Isolated fragments are kept") {
+                mod.change_input("distance threshold", 2.0);
+                mod.change_input("n", size_type{2});
+                auto nmers = mod.run_as<my_pt>(graph);
+                REQUIRE(nmers == monomers);
+            }
+
+            SECTION("Periodic") {
+                // The first and last waters are 3 Bohr apart through the cell
+                std::vector<double> lattice{20.0, 0.0, 0.0, 0.0, 20.0,
+                                            0.0,  0.0, 0.0, 9.0};
+                mod.change_input("lattice vectors", lattice);
+                mod.change_input("n", size_type{2});
+
+                SECTION("dimers") {
+                    corr.insert({0, 1, 2, 3, 4, 5});
+                    corr.insert({0, 1, 2, 6, 7, 8});
+                    corr.insert({3, 4, 5, 6, 7, 8});
+                    auto nmers = mod.run_as<my_pt>(graph);
+                    REQUIRE(nmers == corr);
+                }
+
+                SECTION("Throws if the threshold exceeds half the cell") {
+                    mod.change_input("distance threshold", 5.0);
+                    REQUIRE_THROWS_AS(mod.run_as<my_pt>(graph),
+                                      std::runtime_error);
+                }
+            }
+        }
+
+        SECTION("Pentane") {
+            using testing::hydrocarbon_fragmented_nuclei;
+            size_type n_carbons = 5;
+            auto conns          = testing::hydrocarbon_connectivity(n_carbons);
+            auto monomers       = hydrocarbon_fragmented_nuclei(n_carbons, 2);
+
+            // Only fragments which share nuclei are within the threshold
+            graph_type graph(monomers, conns);
+            mod.change_submod("Monomer maker", make_monomers(graph, monomers));
+            mod.change_input("distance threshold", 0.5);
+            mod.change_input("n", size_type{2});
+
+            frags_type corr(monomers.supersystem().as_nuclei());
+            corr.insert({0, 1, 2, 5, 6, 7, 8, 9, 10, 11});
+            corr.insert({1, 2, 3, 8, 9, 10, 11, 12, 13});
+            corr.insert({2, 3, 4, 10, 11, 12, 13, 14, 15, 16});
+            auto nmers = mod.run_as<my_pt>(graph);
+            REQUIRE(nmers == corr);
+        }
+    }
+
+    SECTION("Thread count does not change the result") {
+        using testing::hydrocarbon_fragmented_nuclei;
+        size_type n_carbons = 5;
+        auto conns          = testing::hydrocarbon_connectivity(n_carbons);
+        auto monomers       = hydrocarbon_fragmented_nuclei(n_carbons, 2);
+        graph_type graph(monomers, conns);
+
+        frags_type dimers(monomers.supersystem().as_nuclei());
+        dimers.insert({0, 1, 2, 3, 5, 6, 7, 8, 9, 10, 11, 12, 13});
+        dimers.insert({0, 1, 3, 4, 5, 6, 7, 8, 9, 12, 13, 14, 15, 16});
+        dimers.insert({1, 2, 3, 4, 8, 9, 10, 11, 12, 13, 14, 15, 16});
+
+        frags_type screened(monomers.supersystem().as_nuclei());
+        screened.insert({0, 1, 2, 5, 6, 7, 8, 9, 10, 11});
+        screened.insert({1, 2, 3, 8, 9, 10, 11, 12, 13});
+        screened.insert({2, 3, 4, 10, 11, 12, 13, 14, 15, 16});
+
+        // Modules are locked after running, so each thread count gets its own
+        auto run = [&](std::size_t nthreads, double threshold) {
+            auto thread_mm   = testing::initialize();
+            auto& thread_mod = thread_mm.at("All nmers");
+            thread_mod.change_submod("Monomer maker",
+                                     make_monomers(graph, monomers));
+            thread_mod.change_input("n", size_type{2});
+            thread_mod.change_input("distance threshold", threshold);
+            thread_mod.change_input("nthreads", nthreads);
+            return thread_mod.run_as<my_pt>(graph);
+        };
+
+        const auto no_screening = std::numeric_limits<double>::max();
+        for(std::size_t nthreads : {1, 2, 3, 8}) {
+            REQUIRE(run(nthreads, no_screening) == dimers);
+            REQUIRE(run(nthreads, 0.5) == screened);
+        }
+    }
+
     SECTION("Throws if n > number-of-fragments") {
         auto conns    = testing::water_connectivity(1);
         auto monomers = testing::water_fragmented_nuclei(1);
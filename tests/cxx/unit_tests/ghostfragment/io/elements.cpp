@@ -0,0 +1,47 @@
+/*
+ * Copyright 2024 GhostFragment
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../test_ghostfragment.hpp"
+#include <ghostfragment/io/elements.hpp>
+
+using namespace ghostfragment::io;
+
+TEST_CASE("element_symbol") {
+    REQUIRE(element_symbol(1) == "H");
+    REQUIRE(element_symbol(26) == "Fe");
+    REQUIRE(element_symbol(n_elements) == "Og");
+}
+
+TEST_CASE("atomic_number") {
+    REQUIRE(atomic_number("H") == 1);
+    REQUIRE(atomic_number("Cl") == 17);
+    REQUIRE(atomic_number("CL") == 17);
+    REQUIRE(atomic_number("cl") == 17);
+    REQUIRE(atomic_number("Og") == n_elements);
+    REQUIRE(atomic_number("Xx") == 0);
+    REQUIRE(atomic_number("") == 0);
+
+    for(std::size_t z = 1; z <= n_elements; ++z)
+        REQUIRE(atomic_number(element_symbol(z)) == z);
+}
+
+TEST_CASE("atomic_mass") {
+    REQUIRE(atomic_mass(1) == Approx(1.008 * dalton_to_au));
+    REQUIRE(atomic_mass(6) == Approx(12.011 * dalton_to_au));
+    REQUIRE(atomic_mass(8) == Approx(15.999 * dalton_to_au));
+    for(std::size_t z = 2; z <= n_elements; ++z)
+        REQUIRE(atomic_mass(z) > atomic_mass(1));
+}
@@ -0,0 +1,105 @@
+/*
+ * Copyright 2024 GhostFragment
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../test_ghostfragment.hpp"
+#include <ghostfragment/io/elements.hpp>
+#include <ghostfragment/io/geometry_parser.hpp>
+
+using namespace ghostfragment::io;
+
+/* Testing Strategy:
+ *
+ * Every file is parsed with several thread counts (including more threads
+ * than lines) to make sure the chunking does not change the result.
+ */
+
+namespace {
+
+const std::vector<std::size_t> thread_counts{0, 1, 2, 3, 16};
+
+} // namespace
+
+TEST_CASE("parse_xyz") {
+    const auto a2b = angstrom_to_bohr;
+
+    SECTION("Valid file") {
+        const std::string xyz = "3\n"
+                                "water\n"
+                                "O 0.0 0.0 0.1\r\n"
+                                "h 1.0 0.0 0.0 ignored\n"
+                                "1 -1.0 0.0 +0.0\n"
+                                "2\n"
+                                "second frame\n";
+        for(const auto nthreads : thread_counts) {
+            const auto geom = parse_xyz(xyz, nthreads);
+            REQUIRE(geom.Z == std::vector<std::size_t>{8, 1, 1});
+            REQUIRE(geom.x == std::vector<double>{0.0, a2b, -a2b});
+            REQUIRE(geom.y == std::vector<double>{0.0, 0.0, 0.0});
+            REQUIRE(geom.z == std::vector<double>{0.1 * a2b, 0.0, 0.0});
+        }
+    }
+
+    SECTION("No atoms") { REQUIRE(parse_xyz("0\nempty\n", 4).size() == 0); }
+
+    SECTION("Invalid files") {
+        REQUIRE_THROWS_AS(parse_xyz("", 2), std::runtime_error);
+        REQUIRE_THROWS_AS(parse_xyz("x\n", 2), std::runtime_error);
+        REQUIRE_THROWS_AS(parse_xyz("2\n\nO 0 0 0\n", 2), std::runtime_error);
+        REQUIRE_THROWS_AS(parse_xyz("1\n\nXx 0 0 0\n", 2), std::runtime_error);
+        REQUIRE_THROWS_AS(parse_xyz("1\n\nO 0 a 0\n", 2), std::runtime_error);
+        REQUIRE_THROWS_AS(parse_xyz("1\n\nO 0 0\n", 2), std::runtime_error);
+    }
+}
+
+TEST_CASE("parse_pdb") {
+    const auto a2b = angstrom_to_bohr;
+
+    // The HB1 record has no element columns, so its element comes from the
+    // atom name. Records after ENDMDL are ignored, even if they are invalid.
+    const std::string pdb =
+      "HEADER    TEST\n"
+      "ATOM      1  N   ALA A   1      11.104   6.134  -6.504  1.00  0.00"
+      "           N\n"
+      "ATOM      2  CA  ALA A   1      11.639   6.071  -5.147  1.00  0.00"
+      "           C\n"
+      "HETATM    3 CA    CA A   2       1.000   2.000   3.000  1.00  0.00\n"
+      "ATOM      4  HB1 ALA A   1       0.000   0.000   0.000\n"
+      "ENDMDL\n"
+      "ATOM      5  N   ALA A   1      invalid\n";
+
+    SECTION("Valid file") {
+        for(const auto nthreads : thread_counts) {
+            const auto geom = parse_pdb(pdb, nthreads);
+            REQUIRE(geom.Z == std::vector<std::size_t>{7, 6, 20, 1});
+            REQUIRE(geom.x[0] == Approx(11.104 * a2b));
+            REQUIRE(geom.y[1] == Approx(6.071 * a2b));
+            REQUIRE(geom.z[0] == Approx(-6.504 * a2b));
+            REQUIRE(geom.y[2] == Approx(2.0 * a2b));
+        }
+    }
+
+    SECTION("No atoms") {
+        REQUIRE(parse_pdb("HEADER    TEST\n", 4).size() == 0);
+    }
+
+    SECTION("Invalid records") {
+        const std::string short_record = "ATOM      5  N   ALA A   1  1.0\n";
+        REQUIRE_THROWS_AS(parse_pdb(short_record, 2), std::runtime_error);
+        const std::string bad_coords =
+          "ATOM      1  N   ALA A   1      11.104   abcde  -6.504\n";
+        REQUIRE_THROWS_AS(parse_pdb(bad_coords, 2), std::runtime_error);
+    }
+}
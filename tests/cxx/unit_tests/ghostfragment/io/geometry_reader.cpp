@@ -0,0 +1,86 @@
+/*
+ * Copyright 2024 GhostFragment
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../test_ghostfragment.hpp"
+#include <fstream>
+#include <ghostfragment/io/elements.hpp>
+#include <ghostfragment/property_types/io/chemical_system_from_file.hpp>
+
+using namespace ghostfragment;
+
+using property_type = pt::ChemicalSystemFromFile;
+using system_type   = typename pt::ChemicalSystemFromFileTraits::result_type;
+using atom_type     = typename chemist::Molecule::atom_type;
+
+TEST_CASE("Geometry Reader") {
+    auto mm   = testing::initialize();
+    auto& mod = mm.at("Geometry Reader");
+
+    const auto dir = std::filesystem::temp_directory_path();
+    const auto xyz = (dir / "ghostfragment_test_geometry_reader.xyz").string();
+    const auto pdb = (dir / "ghostfragment_test_geometry_reader.pdb").string();
+    const auto txt = (dir / "ghostfragment_test_geometry_reader.txt").string();
+
+    std::ofstream(xyz) << "2\nOH\nO 0.0 0.0 0.0\nH 0.0 0.0 1.0\n";
+    std::ofstream(pdb)
+      << "HETATM    1  O   HOH A   1       0.000   0.000   0.000  1.00  0.00"
+      << "           O\n"
+      << "HETATM    2  H   HOH A   1       0.000   0.000   1.000  1.00  0.00"
+      << "           H\n";
+    std::ofstream(txt) << "2\nOH\nO 0.0 0.0 0.0\nH 0.0 0.0 1.0\n";
+
+    const auto r = io::angstrom_to_bohr;
+    chemist::Molecule corr;
+    corr.push_back(atom_type("O", 8ul, io::atomic_mass(8), 0.0, 0.0, 0.0));
+    corr.push_back(atom_type("H", 1ul, io::atomic_mass(1), 0.0, 0.0, r));
+
+    SECTION("XYZ") {
+        const auto& sys = mod.run_as<property_type>(xyz);
+        REQUIRE(sys == system_type(corr));
+    }
+
+    SECTION("PDB") {
+        const auto& sys = mod.run_as<property_type>(pdb);
+        REQUIRE(sys == system_type(corr));
+    }
+
+    SECTION("Charge and multiplicity") {
+        mod.change_input("charge", -1);
+        mod.change_input("multiplicity", std::size_t(2));
+        corr.set_charge(-1);
+        corr.set_multiplicity(2);
+        const auto& sys = mod.run_as<property_type>(xyz);
+        REQUIRE(sys == system_type(corr));
+    }
+
+    SECTION("Unknown extension") {
+        REQUIRE_THROWS_AS(mod.run_as<property_type>(txt), std::runtime_error);
+    }
+
+    SECTION("Format") {
+        mod.change_input("format", std::string("xyz"));
+        const auto& sys = mod.run_as<property_type>(txt);
+        REQUIRE(sys == system_type(corr));
+    }
+
+    SECTION("Missing file") {
+        auto missing = (dir / "ghostfragment_test_missing.xyz").string();
+        REQUIRE_THROWS_AS(mod.run_as<property_type>(missing),
+                          std::runtime_error);
+    }
+
+    for(const auto& path : {xyz, pdb, txt}) std::filesystem::remove(path);
+}
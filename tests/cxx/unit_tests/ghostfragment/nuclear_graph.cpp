@@ -78,6 +78,9 @@ TEST_CASE("NuclearGraph") {
         SECTION("Copy") {
             NuclearGraph copy(tetramer);
             REQUIRE(copy == tetramer);
+
+            // Copies share the (immutable) state
+            REQUIRE(&copy.edges() == &tetramer.edges());
         }
 
         SECTION("Move") {
@@ -91,6 +94,7 @@ TEST_CASE("NuclearGraph") {
             auto pcopy = &(copy = tetramer);
             REQUIRE(pcopy == &copy);
             REQUIRE(copy == tetramer);
+            REQUIRE(&copy.edges() == &tetramer.edges());
         }
 
         SECTION("Move Assignment") {
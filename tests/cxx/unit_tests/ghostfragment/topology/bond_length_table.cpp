@@ -0,0 +1,100 @@
+/*
+ * Copyright 2024 GhostFragment
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../test_ghostfragment.hpp"
+#include <ghostfragment/topology/bond_length_table.hpp>
+#include <ghostfragment/topology/covalent_radius.hpp>
+#include <cmath>
+
+using namespace ghostfragment::topology;
+
+TEST_CASE("BondLengthTable") {
+    SECTION("Empty system") {
+        NucleiSnapshot snapshot;
+        BondLengthTable table(snapshot, BondLengthTable::connectivity_type{});
+        REQUIRE(table.count(1, 1) == 0);
+        REQUIRE(table.average(1, 1) == 2.0 * covalent_radius(1));
+    }
+
+    SECTION("Elements without a covalent radius") {
+        NucleiSnapshot snapshot;
+        BondLengthTable table(snapshot, BondLengthTable::connectivity_type{});
+        const auto max_z = max_covalent_radius_z;
+        REQUIRE(table.average(0, 0) == 0.0);
+        REQUIRE(table.average(0, 1) == covalent_radius(1));
+        REQUIRE(table.average(max_z + 1, 1) == covalent_radius(1));
+        REQUIRE(table.average(max_z, max_z) == 2.0 * covalent_radius(max_z));
+
+        chemist::Molecule ghost;
+        ghost.push_back(chemist::Atom("Gh", 0, 0.0, 0.0, 0.0, 0.0));
+        NucleiSnapshot ghost_snapshot(ghost);
+        BondLengthTable::connectivity_type no_bonds(1);
+        REQUIRE_THROWS_AS(BondLengthTable(ghost_snapshot, no_bonds),
+                          std::runtime_error);
+    }
+
+    SECTION("Water dimer") {
+        auto water = testing::water(2);
+        NucleiSnapshot snapshot(water);
+        BondLengthTable table(snapshot, testing::water_connectivity(2));
+
+        REQUIRE(table.count(8, 1) == 4);
+        REQUIRE(table.count(1, 8) == 4);
+        REQUIRE(table.count(1, 1) == 0);
+        REQUIRE(table.count(8, 8) == 0);
+        REQUIRE(table.count(6, 1) == 0);
+
+        double corr = 0.0;
+        for(std::size_t o : {0, 3})
+            for(std::size_t h : {1, 2}) corr += snapshot.distance(o, o + h);
+        corr /= 4.0;
+        REQUIRE(table.average(8, 1) == Approx(corr));
+        REQUIRE(table.average(1, 8) == table.average(8, 1));
+
+        // No bonds, so falls back to the covalent radii
+        REQUIRE(table.average(8, 8) == 2.0 * covalent_radius(8));
+        REQUIRE(table.average(6, 1) == covalent_radius(6) + covalent_radius(1));
+    }
+
+    SECTION("Same element bonds") {
+        auto water = testing::water(1);
+        NucleiSnapshot snapshot(water);
+        BondLengthTable::connectivity_type conns(3);
+        conns.add_bond(1, 2);
+        BondLengthTable table(snapshot, conns);
+        REQUIRE(table.count(1, 1) == 1);
+        REQUIRE(table.average(1, 1) == Approx(snapshot.distance(1, 2)));
+    }
+
+    SECTION("Periodic") {
+        // The waters are 3 Bohr apart along z. In a cell 4 Bohr long along z
+        // the bond from the first oxygen to the second water's hydrogen is
+        // 1 Bohr (along z) through the cell face instead.
+        auto water = testing::water(2);
+        NucleiSnapshot snapshot(water);
+        UnitCell cell({20.0, 0.0, 0.0, 0.0, 20.0, 0.0, 0.0, 0.0, 4.0});
+        BondLengthTable::connectivity_type conns(6);
+        conns.add_bond(0, 4);
+        BondLengthTable table(snapshot, conns, cell);
+
+        const double dx = snapshot.x()[4] - snapshot.x()[0];
+        const double dy = snapshot.y()[4] - snapshot.y()[0];
+        const auto corr = std::sqrt(dx * dx + dy * dy + 1.0);
+        REQUIRE(table.count(8, 1) == 1);
+        REQUIRE(table.average(8, 1) == Approx(corr));
+        REQUIRE(corr < snapshot.distance(0, 4));
+    }
+}
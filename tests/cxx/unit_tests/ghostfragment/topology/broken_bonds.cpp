@@ -125,4 +125,19 @@ TEST_CASE("Broken Bonds") {
         result_type test = mod.run_as<pt>(frags, conns);
         REQUIRE(corr == test);
     }
+
+    SECTION("Thread count does not change the result") {
+        auto corr  = bonds_propane_one();
+        auto hc    = hydrocarbon_fragmented_nuclei(3, 1);
+        auto conns = hydrocarbon_connectivity(3);
+
+        // Modules are locked after running, so each thread count gets its own
+        for(std::size_t nthreads : {1, 2, 3, 8}) {
+            auto thread_mm   = testing::initialize();
+            auto& thread_mod = thread_mm.at("Broken Bonds");
+            thread_mod.change_input("nthreads", nthreads);
+            result_type test = thread_mod.run_as<pt>(hc, conns);
+            REQUIRE(corr == test);
+        }
+    }
 }
@@ -0,0 +1,95 @@
+/*
+ * Copyright 2024 GhostFragment
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../test_ghostfragment.hpp"
+#include <catch2/catch.hpp>
+#include <ghostfragment/property_types/topology/broken_bonds.hpp>
+#include <ghostfragment/property_types/topology/broken_bonds_by_fragment.hpp>
+
+using traits_type = ghostfragment::pt::BrokenBondsByFragmentTraits;
+using input_type  = typename traits_type::fragments_type;
+using conns_type  = typename traits_type::conns_type;
+using result_type = typename traits_type::result_type;
+using offsets_t   = typename result_type::offset_list_type;
+using bonds_t     = typename result_type::bond_list_type;
+
+TEST_CASE("Broken Bonds By Fragment") {
+    using pt = ghostfragment::pt::BrokenBondsByFragment;
+
+    auto mm   = testing::initialize();
+    auto& mod = mm.at("Broken Bonds By Fragment");
+
+    SECTION("Methane fragment (size 1)") {
+        result_type corr(offsets_t{0, 0}, bonds_t{});
+        auto hc          = testing::hydrocarbon_fragmented_nuclei(1, 1);
+        auto conns       = testing::hydrocarbon_connectivity(1);
+        result_type test = mod.run_as<pt>(hc, conns);
+        REQUIRE(corr == test);
+    }
+
+    SECTION("Propane fragment (size 1)") {
+        result_type corr(offsets_t{0, 1, 3, 4},
+                         bonds_t{{0, 1}, {1, 0}, {1, 2}, {2, 1}});
+        auto hc          = testing::hydrocarbon_fragmented_nuclei(3, 1);
+        auto conns       = testing::hydrocarbon_connectivity(3);
+        result_type test = mod.run_as<pt>(hc, conns);
+        REQUIRE(corr == test);
+    }
+
+    SECTION("Propane fragment (size 2)") {
+        result_type corr(offsets_t{0, 1, 2}, bonds_t{{1, 2}, {1, 0}});
+        auto hc          = testing::hydrocarbon_fragmented_nuclei(3, 2);
+        auto conns       = testing::hydrocarbon_connectivity(3);
+        result_type test = mod.run_as<pt>(hc, conns);
+        REQUIRE(corr == test);
+    }
+
+    SECTION("Pentane (size 2)") {
+        auto hc = testing::hydrocarbon(5);
+        input_type frags(hc.nuclei());
+        frags.insert({0, 1, 2, 3, 4, 5, 10, 11, 12});
+        frags.insert({0, 1, 2, 3, 4, 5, 6, 7, 8, 9});
+        frags.insert({0, 1, 2, 10, 11, 12, 13, 14, 15, 16});
+        frags.insert({0, 1, 2});
+        frags.insert({0, 1, 2, 3, 4, 5});
+        frags.insert({0, 1, 2, 10, 11, 12});
+
+        conns_type conns(17);
+        conns.add_bond(0, 3);
+        conns.add_bond(0, 10);
+        conns.add_bond(3, 6);
+        conns.add_bond(10, 13);
+
+        result_type corr(offsets_t{0, 2, 3, 4, 6, 8, 10},
+                         bonds_t{{3, 6},
+                                 {10, 13},
+                                 {0, 10},
+                                 {0, 3},
+                                 {0, 3},
+                                 {0, 10},
+                                 {0, 10},
+                                 {3, 6},
+                                 {0, 3},
+                                 {10, 13}});
+        result_type test = mod.run_as<pt>(frags, conns);
+        REQUIRE(corr == test);
+
+        // Consistent with the Broken Bonds module
+        using bb_pt     = ghostfragment::pt::BrokenBonds;
+        auto all_bonds = mm.at("Broken Bonds").run_as<bb_pt>(frags, conns);
+        REQUIRE(test.unique_bonds() == all_bonds);
+    }
+}
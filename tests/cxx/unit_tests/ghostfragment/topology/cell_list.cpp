@@ -0,0 +1,135 @@
+/*
+ * Copyright 2024 GhostFragment
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../test_ghostfragment.hpp"
+#include <ghostfragment/topology/cell_list.hpp>
+#include <algorithm>
+#include <set>
+#include <utility>
+#include <vector>
+
+using namespace ghostfragment::topology;
+
+namespace {
+
+using pair_set = std::set<std::pair<std::size_t, std::size_t>>;
+
+pair_set pairs_from(const CellList& cells) {
+    pair_set rv;
+    cells.for_each_pair([&](std::size_t i, std::size_t j, double) {
+        REQUIRE(i < j);
+        REQUIRE(rv.insert({i, j}).second); // Each pair only once
+    });
+    return rv;
+}
+
+} // namespace
+
+/* Testing Strategy:
+ *
+ * The waters made by testing::water are 3 Bohr apart along the z axis. We
+ * compare the pairs found by the cell list to those found by considering all
+ * pairs, for cutoffs small enough to split the system into several cells.
+ */
+
+TEST_CASE("CellList") {
+    auto water = testing::water(6);
+    NucleiSnapshot snapshot(water);
+    const auto natoms = snapshot.size();
+
+    SECTION("Isolated") {
+        for(double cutoff : {0.5, 2.0, 3.5, 100.0}) {
+            CellList cells(snapshot, cutoff);
+            REQUIRE_FALSE(cells.is_periodic());
+
+            pair_set corr;
+            for(std::size_t i = 0; i < natoms; ++i)
+                for(std::size_t j = i + 1; j < natoms; ++j)
+                    if(snapshot.distance(i, j) <= cutoff) corr.insert({i, j});
+            REQUIRE(pairs_from(cells) == corr);
+        }
+
+        SECTION("Several cells") {
+            CellList cells(snapshot, 2.0);
+            REQUIRE(cells.ncells() > 1);
+        }
+
+        SECTION("Empty") {
+            NucleiSnapshot empty;
+            CellList cells(empty, 1.0);
+            REQUIRE(cells.ncells() == 1);
+            REQUIRE(pairs_from(cells).empty());
+        }
+
+        SECTION("Throws if the cutoff is not positive") {
+            REQUIRE_THROWS_AS(CellList(snapshot, 0.0), std::runtime_error);
+        }
+    }
+
+    SECTION("Periodic") {
+        // Waters 0 and 5 are 3 Bohr apart through the boundary
+        std::vector<double> lattice{20.0, 0.0, 0.0, 0.0, 20.0,
+                                    0.0,  0.0, 0.0, 18.0};
+        UnitCell cell(lattice);
+
+        for(double cutoff : {0.5, 2.0, 3.5, 9.0}) {
+            CellList cells(snapshot, cutoff, cell);
+            REQUIRE(cells.is_periodic());
+
+            pair_set corr;
+            for(std::size_t i = 0; i < natoms; ++i)
+                for(std::size_t j = i + 1; j < natoms; ++j) {
+                    double dx = snapshot.x()[j] - snapshot.x()[i];
+                    double dy = snapshot.y()[j] - snapshot.y()[i];
+                    double dz = snapshot.z()[j] - snapshot.z()[i];
+                    cell.minimum_image(dx, dy, dz);
+                    if(dx * dx + dy * dy + dz * dz <= cutoff * cutoff)
+                        corr.insert({i, j});
+                }
+            REQUIRE(pairs_from(cells) == corr);
+        }
+
+        SECTION("Bonds through the boundary") {
+            CellList cells(snapshot, 3.5, cell);
+            REQUIRE(pairs_from(cells).count({0, 15}));
+        }
+
+        SECTION("Ranges of cells") {
+            using pair_list = std::vector<std::pair<std::size_t, std::size_t>>;
+            CellList cells(snapshot, 2.0, cell);
+
+            pair_list corr;
+            cells.for_each_pair([&](std::size_t i, std::size_t j, double) {
+                corr.emplace_back(i, j);
+            });
+
+            // Splitting the cells gives the same calls in the same order
+            const auto ncells = cells.ncells();
+            pair_list test;
+            for(std::size_t c = 0; c < ncells; c += 3)
+                cells.for_each_pair(c, std::min(c + 3, ncells),
+                                    [&](std::size_t i, std::size_t j, double) {
+                                        test.emplace_back(i, j);
+                                    });
+            REQUIRE(test == corr);
+        }
+
+        SECTION("Throws if the cutoff exceeds half the cell") {
+            REQUIRE_THROWS_AS(CellList(snapshot, 9.5, cell),
+                              std::runtime_error);
+        }
+    }
+}
@@ -128,4 +128,94 @@ TEST_CASE("CovRadii Module") {
 
         REQUIRE(ct == corr);
     }
+
+    SECTION("Thread count does not change the result") {
+        // Waters 3 Bohr apart, the last is 3 Bohr from the first through the
+        // boundary of the cell
+        auto h2o = testing::water(10);
+        std::vector<double> lattice{20.0, 0.0, 0.0, 0.0, 20.0,
+                                    0.0,  0.0, 0.0, 30.0};
+        ct_type corr(30);
+        for(std::size_t w = 0; w < 10; ++w) {
+            corr.add_bond(3 * w, 3 * w + 1);
+            corr.add_bond(3 * w, 3 * w + 2);
+        }
+
+        // Modules are locked after running, so each thread count gets its own
+        auto run = [&](std::size_t nthreads, bool periodic) {
+            auto thread_mm   = testing::initialize();
+            auto& thread_mod = thread_mm.at("Covalent Radius");
+            thread_mod.change_input("nthreads", nthreads);
+            if(periodic) thread_mod.change_input("lattice vectors", lattice);
+            return thread_mod.run_as<property_type>(h2o);
+        };
+
+        for(std::size_t nthreads : {1, 2, 3, 8}) {
+            REQUIRE(run(nthreads, false) == corr);
+            REQUIRE(run(nthreads, true) == corr);
+        }
+    }
+
+    SECTION("Periodic") {
+        const double l = 10.0;
+        std::vector<double> cubic{l, 0.0, 0.0, 0.0, l, 0.0, 0.0, 0.0, l};
+
+        atom_type h1(h0);
+        h1.z() = l - 0.9 * (sigma_h + sigma_h);
+        molecule_type h2{h0, h1};
+
+        SECTION("Too far apart without the lattice") {
+            REQUIRE(mod.run_as<property_type>(h2) == ct_type(2));
+        }
+
+        SECTION("Bonded through the boundary") {
+            mod.change_input("lattice vectors", cubic);
+            auto ct = mod.run_as<property_type>(h2);
+            ct_type corr(2);
+            corr.add_bond(0, 1);
+            REQUIRE(ct == corr);
+        }
+
+        SECTION("Nuclei outside of the cell") {
+            atom_type h2_far(h0);
+            h2_far.z() = 3.0 * l + 0.9 * (sigma_h + sigma_h);
+            molecule_type h2_out{h0, h2_far};
+
+            mod.change_input("lattice vectors", cubic);
+            auto ct = mod.run_as<property_type>(h2_out);
+            ct_type corr(2);
+            corr.add_bond(0, 1);
+            REQUIRE(ct == corr);
+        }
+
+        SECTION("Large cell is the same as isolated") {
+            auto h2o2 = testing::water(2);
+            ct_type corr(6);
+            corr.add_bond(0, 1);
+            corr.add_bond(0, 2);
+            corr.add_bond(3, 4);
+            corr.add_bond(3, 5);
+
+            std::vector<double> big{100.0, 0.0, 0.0, 0.0, 100.0,
+                                    0.0,   0.0, 0.0, 100.0};
+            mod.change_input("lattice vectors", big);
+            REQUIRE(mod.run_as<property_type>(h2o2) == corr);
+        }
+
+        SECTION("Throws if the cell is too small") {
+            std::vector<double> tiny{1.0, 0.0, 0.0, 0.0, 1.0,
+                                     0.0, 0.0, 0.0, 1.0};
+            mod.change_input("lattice vectors", tiny);
+            molecule_type h{h0};
+            REQUIRE_THROWS_AS(mod.run_as<property_type>(h),
+                              std::runtime_error);
+        }
+
+        SECTION("Throws if the lattice is malformed") {
+            mod.change_input("lattice vectors", std::vector<double>{l});
+            molecule_type h{h0};
+            REQUIRE_THROWS_AS(mod.run_as<property_type>(h),
+                              std::runtime_error);
+        }
+    }
 }
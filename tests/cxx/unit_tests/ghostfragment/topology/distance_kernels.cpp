@@ -0,0 +1,146 @@
+/*
+ * Copyright 2024 GhostFragment
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../test_ghostfragment.hpp"
+#include <cmath>
+#include <ghostfragment/topology/covalent_radius.hpp>
+#include <ghostfragment/topology/distance_kernels.hpp>
+#include <random>
+
+using namespace ghostfragment::topology;
+
+namespace {
+
+// A line of alternating C and H atoms spaced so that neighbors are bonded
+auto make_chain(std::size_t n) {
+    using molecule_type = chemist::Molecule;
+    using atom_type     = typename molecule_type::atom_type;
+    molecule_type rv;
+    const double dz = covalent_radius(6) + covalent_radius(1);
+    for(std::size_t i = 0; i < n; ++i) {
+        const double z = i * dz;
+        if(i % 2)
+            rv.push_back(atom_type("H", 1ul, 1837.289, 0.0, 0.1 * i, z));
+        else
+            rv.push_back(atom_type("C", 6ul, 21874.662, 0.0, 0.0, z));
+    }
+    return rv;
+}
+
+/* Pairs of carbons, each pair separated by (to within rounding) the bonding
+ * threshold, along a random direction. Whether such a pair is bonded depends
+ * on the last bit of the squared distance.
+ */
+auto make_threshold_pairs(std::size_t npairs, std::mt19937& gen) {
+    using molecule_type = chemist::Molecule;
+    using atom_type     = typename molecule_type::atom_type;
+    std::uniform_real_distribution<double> coord(-20.0, 20.0);
+    std::normal_distribution<double> normal;
+    const double d = 1.1 * 2.0 * covalent_radius(6);
+    molecule_type rv;
+    for(std::size_t i = 0; i < npairs; ++i) {
+        const double x = coord(gen), y = coord(gen), z = coord(gen);
+        double ux = normal(gen), uy = normal(gen), uz = normal(gen);
+        const double norm = std::sqrt(ux * ux + uy * uy + uz * uz);
+        ux *= d / norm;
+        uy *= d / norm;
+        uz *= d / norm;
+        rv.push_back(atom_type("C", 6ul, 21874.662, x, y, z));
+        rv.push_back(atom_type("C", 6ul, 21874.662, x + ux, y + uy, z + uz));
+    }
+    return rv;
+}
+
+const std::vector<DistanceKernel> all_kernels{
+  DistanceKernel::scalar, DistanceKernel::avx2, DistanceKernel::avx512};
+
+} // namespace
+
+TEST_CASE("DistanceKernel") {
+    REQUIRE(distance_kernel_supported(DistanceKernel::scalar));
+    REQUIRE(distance_kernel_supported(best_distance_kernel()));
+    REQUIRE(to_string(DistanceKernel::scalar) == "scalar");
+    REQUIRE(to_string(DistanceKernel::avx2) == "AVX2");
+    REQUIRE(to_string(DistanceKernel::avx512) == "AVX-512");
+}
+
+TEST_CASE("SquaredThresholdTable") {
+    const auto sigma_h = covalent_radius(1);
+    const auto sigma_o = covalent_radius(8);
+
+    NucleiSnapshot water(testing::water(2).nuclei());
+    SquaredThresholdTable table(water, 0.1);
+
+    REQUIRE(table.nkinds() == 2);
+    // Kinds are assigned by increasing atomic number
+    using kind_array = SquaredThresholdTable::kind_array;
+    REQUIRE(table.kinds() == kind_array{1, 0, 0, 1, 0, 0});
+
+    const auto oh = 1.1 * (sigma_o + sigma_h);
+    const auto hh = 1.1 * (sigma_h + sigma_h);
+    REQUIRE(table(0, 1) == Approx(oh * oh));
+    REQUIRE(table(1, 0) == table(0, 1));
+    REQUIRE(table(1, 2) == Approx(hh * hh));
+    REQUIRE(table.row(3)[0] == table(0, 1));
+}
+
+TEST_CASE("append_bonded_partners") {
+    // Long enough to exercise the vector bodies and the scalar remainders
+    const auto chain = make_chain(21);
+    NucleiSnapshot snapshot(chain);
+    SquaredThresholdTable table(snapshot, 0.1);
+
+    for(auto kernel : all_kernels) {
+        SECTION(to_string(kernel)) {
+            for(std::size_t i = 0; i < snapshot.size(); ++i) {
+                std::vector<std::size_t> partners{42};
+                append_bonded_partners(snapshot, table, i, i + 1,
+                                       snapshot.size(), partners, kernel);
+
+                // Compare to a brute force, square-root based, check
+                std::vector<std::size_t> corr{42};
+                for(auto j = i + 1; j < snapshot.size(); ++j) {
+                    const auto sigma =
+                      snapshot.radius()[i] + snapshot.radius()[j];
+                    if(snapshot.distance(i, j) <= 1.1 * sigma)
+                        corr.push_back(j);
+                }
+                REQUIRE(partners == corr);
+            }
+        }
+    }
+}
+
+TEST_CASE("Kernels agree with the scalar kernel") {
+    std::mt19937 gen(42);
+    const auto pairs = make_threshold_pairs(64, gen);
+    NucleiSnapshot snapshot(pairs);
+    SquaredThresholdTable table(snapshot, 0.1);
+    const auto n = snapshot.size();
+
+    for(auto kernel : all_kernels) {
+        SECTION(to_string(kernel)) {
+            for(std::size_t i = 0; i < n; ++i) {
+                std::vector<std::size_t> partners, corr;
+                append_bonded_partners(snapshot, table, i, 0, n, partners,
+                                       kernel);
+                append_bonded_partners(snapshot, table, i, 0, n, corr,
+                                       DistanceKernel::scalar);
+                REQUIRE(partners == corr);
+            }
+        }
+    }
+}
@@ -15,44 +15,39 @@
  */
 
 #include "../test_ghostfragment.hpp"
-#include <ghostfragment/property_types/fragmenting/fragmented_nuclei.hpp>
-#include <ghostfragment/property_types/topology/connectivity_table.hpp>
+#include <ghostfragment/property_types/fragmenting/fragmented_nuclei_from_connectivity.hpp>
 #include <ghostfragment/property_types/topology/nuclear_graph.hpp>
 
+using pseudoatom_traits =
+  ghostfragment::pt::FragmentedNucleiFromConnectivityTraits;
+using pseudoatom_pt = ghostfragment::pt::FragmentedNucleiFromConnectivity;
+
 using graph_traits         = ghostfragment::pt::NuclearGraphTraits;
-using pseudoatom_traits    = ghostfragment::pt::FragmentedNucleiTraits;
-using connectivity_traits  = ghostfragment::pt::ConnectivityTableTraits;
-using connectivity_pt      = ghostfragment::pt::ConnectivityTable;
-using pseudoatom_pt        = ghostfragment::pt::FragmentedNuclei;
 using chemical_system_type = graph_traits::input_type;
 using graph_type           = graph_traits::result_type;
-using conn_type            = connectivity_traits::result_type;
+using conn_type            = graph_traits::connectivity_type;
 using frags_type           = pseudoatom_traits::result_type;
 
 namespace {
 
-auto pseudoatoms_submod(chemical_system_type sys, frags_type frags) {
-    return pluginplay::make_lambda<pseudoatom_pt>([=](auto system) {
-        REQUIRE(system == sys);
-        return frags;
-    });
-}
-
-auto conns_submod(chemical_system_type sys, const conn_type& conns) {
-    return pluginplay::make_lambda<connectivity_pt>([=](auto mol) {
-        REQUIRE(sys.molecule() == mol);
-        return conns;
-    });
+auto nodes_submod(chemical_system_type sys, frags_type frags,
+                  const conn_type& conns) {
+    return pluginplay::make_lambda<pseudoatom_pt>(
+      [=](auto system, const auto& conns_in) {
+          REQUIRE(system == sys);
+          REQUIRE(conns_in == conns);
+          return frags;
+      });
 }
 
 } // namespace
 
 /* Testing Strategy:
  *
- * The module assumes that it's given a chemical system, and that the fragments
- * and connectivity it gets back from the submodules are correct. We test that
- * our module correctly calls the submodules and computes the correct nuclear
- * graph for the following situations:
+ * The module assumes that it's given a chemical system and its connectivity,
+ * and that the fragments it gets back from the submodule are correct. We test
+ * that our module correctly calls the submodule (forwarding the connectivity)
+ * and computes the correct nuclear graph for the following situations:
  *
  * - 0 nodes
  * - 1 node
@@ -63,6 +58,9 @@ auto conns_submod(chemical_system_type sys, const conn_type& conns) {
  * - 3 nodes, 2 connections
  * - 3 nodes, 3 connections
  *
+ * The last case is also run with several thread counts, which must not change
+ * the graph.
+ *
  * We use water molecules as nodes so that we get multi-atom nodes. If one
  * likes, then connections between nodes can be thought of as hydrogen bonds. In
  * reality the module doesn't care if there's any physical basis to the edges
@@ -80,11 +78,10 @@ TEST_CASE("NuclearGraph from Connectivity") {
         const auto nodes = testing::water_fragmented_nuclei(0);
         conn_type atom_cons(0);
 
-        mod.change_submod("Nodes", pseudoatoms_submod(sys, nodes));
-        mod.change_submod("Connectivity", conns_submod(sys, atom_cons));
+        mod.change_submod("Nodes", nodes_submod(sys, nodes, atom_cons));
 
         graph_type corr(nodes, atom_cons);
-        const auto& graph = mod.run_as<pt>(sys);
+        const auto& graph = mod.run_as<pt>(sys, atom_cons);
         REQUIRE(graph == corr);
     }
 
@@ -95,11 +92,10 @@ TEST_CASE("NuclearGraph from Connectivity") {
         atom_cons.add_bond(0, 1);
         atom_cons.add_bond(0, 2);
 
-        mod.change_submod("Nodes", pseudoatoms_submod(sys, nodes));
-        mod.change_submod("Connectivity", conns_submod(sys, atom_cons));
+        mod.change_submod("Nodes", nodes_submod(sys, nodes, atom_cons));
 
         graph_type corr(nodes, conn_type(1));
-        const auto& graph = mod.run_as<pt>(sys);
+        const auto& graph = mod.run_as<pt>(sys, atom_cons);
         REQUIRE(graph == corr);
     }
 
@@ -112,23 +108,21 @@ TEST_CASE("NuclearGraph from Connectivity") {
         atom_cons.add_bond(3, 4);
         atom_cons.add_bond(3, 5);
 
-        mod.change_submod("Nodes", pseudoatoms_submod(sys, nodes));
-
         SECTION("No connection") {
-            mod.change_submod("Connectivity", conns_submod(sys, atom_cons));
+            mod.change_submod("Nodes", nodes_submod(sys, nodes, atom_cons));
             graph_type corr(nodes, conn_type(2));
-            const auto& graph = mod.run_as<pt>(sys);
+            const auto& graph = mod.run_as<pt>(sys, atom_cons);
             REQUIRE(graph == corr);
         }
 
         SECTION("Connected") {
             atom_cons.add_bond(0, 3);
-            mod.change_submod("Connectivity", conns_submod(sys, atom_cons));
+            mod.change_submod("Nodes", nodes_submod(sys, nodes, atom_cons));
 
             conn_type corr_cons(2);
             corr_cons.add_bond(0, 1);
             graph_type corr(nodes, corr_cons);
-            const auto& graph = mod.run_as<pt>(sys);
+            const auto& graph = mod.run_as<pt>(sys, atom_cons);
             REQUIRE(graph == corr);
         }
     }
@@ -144,37 +138,35 @@ TEST_CASE("NuclearGraph from Connectivity") {
         atom_cons.add_bond(6, 7);
         atom_cons.add_bond(6, 8);
 
-        mod.change_submod("Nodes", pseudoatoms_submod(sys, nodes));
-
         SECTION("No connection") {
-            mod.change_submod("Connectivity", conns_submod(sys, atom_cons));
+            mod.change_submod("Nodes", nodes_submod(sys, nodes, atom_cons));
 
             graph_type corr(nodes, conn_type(3));
-            const auto& graph = mod.run_as<pt>(sys);
+            const auto& graph = mod.run_as<pt>(sys, atom_cons);
             REQUIRE(graph == corr);
         }
 
         SECTION("One connection") {
             atom_cons.add_bond(0, 3);
-            mod.change_submod("Connectivity", conns_submod(sys, atom_cons));
+            mod.change_submod("Nodes", nodes_submod(sys, nodes, atom_cons));
 
             conn_type corr_cons(3);
             corr_cons.add_bond(0, 1);
             graph_type corr(nodes, corr_cons);
-            const auto& graph = mod.run_as<pt>(sys);
+            const auto& graph = mod.run_as<pt>(sys, atom_cons);
             REQUIRE(graph == corr);
         }
 
         SECTION("Two connection") {
             atom_cons.add_bond(0, 3);
             atom_cons.add_bond(3, 6);
-            mod.change_submod("Connectivity", conns_submod(sys, atom_cons));
+            mod.change_submod("Nodes", nodes_submod(sys, nodes, atom_cons));
 
             conn_type corr_cons(3);
             corr_cons.add_bond(0, 1);
             corr_cons.add_bond(1, 2);
             graph_type corr(nodes, corr_cons);
-            const auto& graph = mod.run_as<pt>(sys);
+            const auto& graph = mod.run_as<pt>(sys, atom_cons);
             REQUIRE(graph == corr);
         }
 
@@ -182,15 +174,26 @@ TEST_CASE("NuclearGraph from Connectivity") {
             atom_cons.add_bond(0, 3);
             atom_cons.add_bond(3, 6);
             atom_cons.add_bond(6, 0);
-            mod.change_submod("Connectivity", conns_submod(sys, atom_cons));
+            mod.change_submod("Nodes", nodes_submod(sys, nodes, atom_cons));
 
             conn_type corr_cons(3);
             corr_cons.add_bond(0, 1);
             corr_cons.add_bond(0, 2);
             corr_cons.add_bond(1, 2);
             graph_type corr(nodes, corr_cons);
-            const auto& graph = mod.run_as<pt>(sys);
+            const auto& graph = mod.run_as<pt>(sys, atom_cons);
             REQUIRE(graph == corr);
+
+            // Modules are locked after running, so each thread count gets a
+            // module of its own
+            for(std::size_t nthreads : {1, 2, 3, 8}) {
+                auto thread_mm   = testing::initialize();
+                auto& thread_mod = thread_mm.at("Nuclear Graph");
+                thread_mod.change_submod("Nodes",
+                                         nodes_submod(sys, nodes, atom_cons));
+                thread_mod.change_input("nthreads", nthreads);
+                REQUIRE(thread_mod.run_as<pt>(sys, atom_cons) == corr);
+            }
         }
     }
 }
@@ -0,0 +1,72 @@
+/*
+ * Copyright 2024 GhostFragment
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../test_ghostfragment.hpp"
+#include <ghostfragment/topology/covalent_radius.hpp>
+#include <ghostfragment/topology/nuclei_snapshot.hpp>
+
+using namespace ghostfragment::topology;
+
+TEST_CASE("NucleiSnapshot") {
+    const auto sigma_h = covalent_radius(1);
+    const auto sigma_o = covalent_radius(8);
+
+    SECTION("Default ctor") {
+        NucleiSnapshot defaulted;
+        REQUIRE(defaulted.size() == 0);
+        REQUIRE(defaulted.empty());
+    }
+
+    SECTION("From Nuclei") {
+        auto water         = testing::water(1);
+        const auto& nuclei = water.nuclei();
+        NucleiSnapshot snapshot(nuclei);
+
+        REQUIRE(snapshot.size() == 3);
+        REQUIRE_FALSE(snapshot.empty());
+        REQUIRE(snapshot.Z() == NucleiSnapshot::atomic_number_array{8, 1, 1});
+        REQUIRE(snapshot.radius() ==
+                NucleiSnapshot::coord_array{sigma_o, sigma_h, sigma_h});
+        for(std::size_t i = 0; i < 3; ++i) {
+            REQUIRE(snapshot.x()[i] == nuclei[i].coord(0));
+            REQUIRE(snapshot.y()[i] == nuclei[i].coord(1));
+            REQUIRE(snapshot.z()[i] == nuclei[i].coord(2));
+            for(std::size_t q = 0; q < 3; ++q)
+                REQUIRE(snapshot.coord(i, q) == nuclei[i].coord(q));
+        }
+
+        auto r01 = (nuclei[0].as_nucleus() - nuclei[1].as_nucleus());
+        REQUIRE(snapshot.distance(0, 1) == Approx(r01.magnitude()));
+        REQUIRE(snapshot.distance(1, 0) == snapshot.distance(0, 1));
+        REQUIRE(snapshot.distance_squared(0, 0) == 0.0);
+    }
+
+    SECTION("From Molecule") {
+        auto water = testing::water(2);
+        NucleiSnapshot from_mol(water);
+        NucleiSnapshot from_nuclei(water.nuclei());
+        REQUIRE(from_mol == from_nuclei);
+        REQUIRE(from_mol.size() == 6);
+    }
+
+    SECTION("Comparisons") {
+        NucleiSnapshot water1(testing::water(1).nuclei());
+        NucleiSnapshot water2(testing::water(2).nuclei());
+        REQUIRE(water1 == NucleiSnapshot(testing::water(1).nuclei()));
+        REQUIRE(water1 != water2);
+        REQUIRE(water1 != NucleiSnapshot{});
+    }
+}
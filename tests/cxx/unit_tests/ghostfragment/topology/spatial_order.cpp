@@ -0,0 +1,87 @@
+/*
+ * Copyright 2024 GhostFragment
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../test_ghostfragment.hpp"
+#include <array>
+#include <cstdlib>
+#include <ghostfragment/topology/spatial_order.hpp>
+#include <map>
+
+using namespace ghostfragment::topology;
+
+TEST_CASE("hilbert_key") {
+    for(unsigned bits = 1; bits <= 3; ++bits) {
+        const std::uint32_t n = 1u << bits;
+        std::map<hilbert_key_type, std::array<int, 3>> curve;
+        for(std::uint32_t x = 0; x < n; ++x)
+            for(std::uint32_t y = 0; y < n; ++y)
+                for(std::uint32_t z = 0; z < n; ++z)
+                    curve[hilbert_key(x, y, z, bits)] = {int(x), int(y),
+                                                         int(z)};
+
+        // Every point gets a distinct key in [0, n^3)
+        REQUIRE(curve.size() == n * n * n);
+        REQUIRE(curve.rbegin()->first == n * n * n - 1);
+
+        // Consecutive points along the curve are adjacent
+        auto prev = curve.begin();
+        for(auto curr = std::next(prev); curr != curve.end(); ++curr) {
+            const auto& p = prev->second;
+            const auto& c = curr->second;
+            const auto d  = std::abs(c[0] - p[0]) + std::abs(c[1] - p[1]) +
+                           std::abs(c[2] - p[2]);
+            REQUIRE(d == 1);
+            prev = curr;
+        }
+    }
+}
+
+TEST_CASE("hilbert_order") {
+    using size_type  = NucleiSnapshot::size_type;
+    using order_type = std::vector<size_type>;
+
+    SECTION("Empty") { REQUIRE(hilbert_order(NucleiSnapshot{}).empty()); }
+
+    SECTION("Permutation") {
+        auto water = testing::water(4);
+        auto order = hilbert_order(NucleiSnapshot(water));
+        REQUIRE(order.size() == water.size());
+        std::sort(order.begin(), order.end());
+        for(size_type i = 0; i < order.size(); ++i) REQUIRE(order[i] == i);
+    }
+
+    SECTION("Groups nearby nuclei") {
+        // Atoms alternate between two far apart clusters
+        using molecule_type = chemist::Molecule;
+        using atom_type     = typename molecule_type::atom_type;
+        molecule_type mol;
+        for(int i = 0; i < 3; ++i) {
+            mol.push_back(atom_type("H", 1ul, 1837.289, 0.0, 0.0, i));
+            mol.push_back(atom_type("H", 1ul, 1837.289, 0.0, 0.0, 100.0 + i));
+        }
+        auto order = hilbert_order(NucleiSnapshot(mol));
+        REQUIRE(order == order_type{0, 2, 4, 1, 3, 5});
+    }
+
+    SECTION("Ties keep the input order") {
+        using molecule_type = chemist::Molecule;
+        using atom_type     = typename molecule_type::atom_type;
+        molecule_type mol;
+        for(int i = 0; i < 3; ++i)
+            mol.push_back(atom_type("H", 1ul, 1837.289, 1.0, 2.0, 3.0));
+        REQUIRE(hilbert_order(NucleiSnapshot(mol)) == order_type{0, 1, 2});
+    }
+}
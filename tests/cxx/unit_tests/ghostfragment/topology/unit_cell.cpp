@@ -0,0 +1,104 @@
+/*
+ * Copyright 2024 GhostFragment
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../test_ghostfragment.hpp"
+#include <cmath>
+#include <ghostfragment/topology/unit_cell.hpp>
+#include <limits>
+
+using namespace ghostfragment::topology;
+
+TEST_CASE("UnitCell") {
+    using vector_type = UnitCell::vector_type;
+    std::vector<double> cubic{10.0, 0.0, 0.0, 0.0, 10.0, 0.0, 0.0, 0.0, 10.0};
+    std::vector<double> skewed{10.0, 0.0, 0.0, 5.0, 8.0, 0.0, 1.0, 2.0, 9.0};
+
+    SECTION("Ctor") {
+        UnitCell cell(skewed);
+        REQUIRE(cell.lattice_vector(0) == vector_type{10.0, 0.0, 0.0});
+        REQUIRE(cell.lattice_vector(1) == vector_type{5.0, 8.0, 0.0});
+        REQUIRE(cell.lattice_vector(2) == vector_type{1.0, 2.0, 9.0});
+        REQUIRE(cell.volume() == Approx(720.0));
+        REQUIRE_FALSE(cell.is_orthorhombic());
+        REQUIRE(UnitCell(cubic).is_orthorhombic());
+
+        SECTION("Wrong number of components") {
+            std::vector<double> bad{1.0, 2.0, 3.0};
+            REQUIRE_THROWS_AS(UnitCell(bad), std::runtime_error);
+        }
+
+        SECTION("Linearly dependent") {
+            std::vector<double> bad{1.0, 0.0, 0.0, 2.0, 0.0,
+                                    0.0, 0.0, 0.0, 1.0};
+            REQUIRE_THROWS_AS(UnitCell(bad), std::runtime_error);
+        }
+    }
+
+    SECTION("width") {
+        UnitCell cell(skewed);
+        // Distance between the planes spanned by the other two vectors
+        REQUIRE(cell.width(2) == Approx(9.0));
+        const auto bxc = std::sqrt(72.0 * 72.0 + 45.0 * 45.0 + 2.0 * 2.0);
+        REQUIRE(cell.width(0) == Approx(720.0 / bxc));
+        REQUIRE(cell.min_width() == Approx(cell.width(1)));
+        REQUIRE(UnitCell(cubic).min_width() == Approx(10.0));
+    }
+
+    SECTION("to_fractional") {
+        UnitCell cell(skewed);
+        // 0.5 a + 0.25 b - 1 c
+        auto s = cell.to_fractional(5.0 + 1.25 - 1.0, 2.0 - 2.0, -9.0);
+        REQUIRE(s[0] == Approx(0.5));
+        REQUIRE(s[1] == Approx(0.25));
+        REQUIRE(s[2] == Approx(-1.0));
+    }
+
+    SECTION("minimum_image") {
+        SECTION("Orthorhombic") {
+            UnitCell cell(cubic);
+            double dx = 9.0, dy = -6.0, dz = 21.0;
+            cell.minimum_image(dx, dy, dz);
+            REQUIRE(dx == Approx(-1.0));
+            REQUIRE(dy == Approx(4.0));
+            REQUIRE(dz == Approx(1.0));
+        }
+
+        SECTION("Skewed") {
+            UnitCell cell(skewed);
+            double dx = -4.5, dy = 8.0, dz = 0.0;
+            cell.minimum_image(dx, dy, dz);
+            const auto r2 = dx * dx + dy * dy + dz * dz;
+
+            // Compare against a brute force search over images
+            double best = std::numeric_limits<double>::max();
+            for(int i = -2; i <= 2; ++i)
+                for(int j = -2; j <= 2; ++j)
+                    for(int k = -2; k <= 2; ++k) {
+                        const double x = -4.5 + 10.0 * i + 5.0 * j + 1.0 * k;
+                        const double y = 8.0 + 8.0 * j + 2.0 * k;
+                        const double z = 9.0 * k;
+                        best = std::min(best, x * x + y * y + z * z);
+                    }
+            REQUIRE(r2 == Approx(best));
+        }
+    }
+
+    SECTION("Comparisons") {
+        UnitCell cell(cubic);
+        REQUIRE(cell == UnitCell(cubic));
+        REQUIRE(cell != UnitCell(skewed));
+    }
+}
@@ -0,0 +1,105 @@
+/*
+ * Copyright 2024 GhostFragment
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../test_ghostfragment.hpp"
+#include <ghostfragment/property_types/topology/bond_changes.hpp>
+#include <ghostfragment/property_types/topology/connectivity_table.hpp>
+#include <ghostfragment/topology/covalent_radius.hpp>
+#include <ghostfragment/topology/topology.hpp>
+
+using namespace ghostfragment;
+
+TEST_CASE("VerletConnectivity Module") {
+    using property_type = pt::ConnectivityTable;
+    using changes_pt    = pt::BondChanges;
+    using molecule_type = pt::BondChangesTraits::input_type;
+    using atom_type     = typename molecule_type::atom_type;
+    using ct_type       = pt::BondChangesTraits::conns_type;
+    using bond_set_type = pt::BondChangesTraits::bond_set_type;
+
+    auto mm   = testing::initialize();
+    auto& mod = mm.at("Verlet Connectivity");
+
+    const auto r_h = 2.0 * topology::covalent_radius(1);
+    const atom_type h0("H", 1ul, 1837.289, 0.0, 0.0, 0.0);
+    atom_type h1(h0);
+    h1.z() = 0.9 * r_h;
+    const molecule_type bonded{h0, h1};
+    h1.z() = 1.2 * r_h;
+    const molecule_type apart{h0, h1};
+
+    ct_type corr(2);
+    corr.add_bond(0, 1);
+    const bond_set_type bond{{0, 1}};
+
+    SECTION("Same connectivity as CovRadii") {
+        auto& cov_radii = mm.at("Covalent Radius");
+        auto water      = testing::water(3);
+        auto ct         = mod.run_as<property_type>(water);
+        REQUIRE(ct == cov_radii.run_as<property_type>(water));
+        REQUIRE(mod.run_as<property_type>(bonded) == corr);
+    }
+
+    SECTION("Bond changes") {
+        auto [ct0, formed0, broken0] = mod.run_as<changes_pt>(bonded);
+        REQUIRE(ct0 == corr);
+        REQUIRE(formed0 == bond);
+        REQUIRE(broken0.empty());
+
+        auto [ct1, formed1, broken1] = mod.run_as<changes_pt>(apart);
+        REQUIRE(ct1 == ct_type(2));
+        REQUIRE(formed1.empty());
+        REQUIRE(broken1 == bond);
+
+        // Not memoized, the changes are relative to the previous call
+        auto [ct2, formed2, broken2] = mod.run_as<changes_pt>(bonded);
+        REQUIRE(ct2 == corr);
+        REQUIRE(formed2 == bond);
+        REQUIRE(broken2.empty());
+
+        auto [ct3, formed3, broken3] = mod.run_as<changes_pt>(bonded);
+        REQUIRE(formed3.empty());
+        REQUIRE(broken3.empty());
+    }
+
+    SECTION("Loading the module again gives it its own list") {
+        const auto key = "Another Verlet Connectivity";
+        mm.add_module<topology::VerletConnectivity>(key);
+        auto& other = mm.at(key);
+        other.turn_off_memoization();
+
+        mod.run_as<changes_pt>(bonded);
+
+        // The first call of other, so nothing formed or broke
+        auto [ct0, formed0, broken0] = other.run_as<changes_pt>(apart);
+        REQUIRE(formed0.empty());
+        REQUIRE(broken0.empty());
+
+        // Relative to mod's previous call, not other's
+        auto [ct1, formed1, broken1] = mod.run_as<changes_pt>(bonded);
+        REQUIRE(formed1.empty());
+        REQUIRE(broken1.empty());
+    }
+
+    SECTION("Periodic") {
+        h1.z() = 10.0 - 0.9 * r_h;
+        const molecule_type through_boundary{h0, h1};
+        std::vector<double> cubic{10.0, 0.0, 0.0, 0.0, 10.0,
+                                  0.0,  0.0, 0.0, 10.0};
+        mod.change_input("lattice vectors", cubic);
+        REQUIRE(mod.run_as<property_type>(through_boundary) == corr);
+    }
+}
@@ -0,0 +1,138 @@
+/*
+ * Copyright 2024 GhostFragment
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../test_ghostfragment.hpp"
+#include <ghostfragment/topology/covalent_radius.hpp>
+#include <ghostfragment/topology/verlet_neighbor_list.hpp>
+
+using namespace ghostfragment::topology;
+
+namespace {
+
+// Two H atoms, the second is @p z Bohr along the z axis from the first
+NucleiSnapshot h2(double z) {
+    using molecule_type = chemist::Molecule;
+    using atom_type     = typename molecule_type::atom_type;
+    molecule_type mol;
+    mol.push_back(atom_type("H", 1ul, 1837.289, 0.0, 0.0, 0.0));
+    mol.push_back(atom_type("H", 1ul, 1837.289, 0.0, 0.0, z));
+    return NucleiSnapshot(mol);
+}
+
+} // namespace
+
+/* Testing Strategy:
+ *
+ * With the default tau, two H atoms are bonded if they are no further apart
+ * than 1.1 times twice the covalent radius of H. We move the second H atom
+ * along the z axis and check the bonds, the reported changes, and whether the
+ * list was rebuilt. The skin is 1 Bohr, so moves of less than 0.5 Bohr from
+ * where the list was built must not trigger a rebuild.
+ */
+
+TEST_CASE("VerletNeighborList") {
+    using bond_list = VerletNeighborList::bond_list;
+    const auto r_h  = 2.0 * covalent_radius(1);
+    const bond_list bond{{0, 1}};
+
+    SECTION("Ctor") {
+        VerletNeighborList list(0.1, 1.0);
+        REQUIRE(list.tau() == 0.1);
+        REQUIRE(list.skin() == 1.0);
+        REQUIRE(list.nbuilds() == 0);
+        REQUIRE(list.npairs() == 0);
+        REQUIRE(list.bonds().empty());
+
+        REQUIRE_THROWS_AS(VerletNeighborList(0.1, -1.0), std::runtime_error);
+        std::vector<double> bad{1.0};
+        REQUIRE_THROWS_AS(VerletNeighborList(0.1, 1.0, bad),
+                          std::runtime_error);
+    }
+
+    SECTION("Isolated") {
+        VerletNeighborList list(0.1, 1.0);
+
+        // First frame always builds, every bond is new
+        auto changes = list.update(h2(0.9 * r_h));
+        REQUIRE(changes.rebuilt);
+        REQUIRE(changes.formed == bond);
+        REQUIRE(changes.broken.empty());
+        REQUIRE(list.bonds() == bond);
+        REQUIRE(list.npairs() == 1);
+
+        chemist::topology::ConnectivityTable corr(2);
+        corr.add_bond(0, 1);
+        REQUIRE(list.connectivity() == corr);
+
+        // Small move, still bonded
+        changes = list.update(h2(r_h));
+        REQUIRE_FALSE(changes.rebuilt);
+        REQUIRE(changes.formed.empty());
+        REQUIRE(changes.broken.empty());
+
+        // Small move, but too far apart now
+        changes = list.update(h2(1.2 * r_h));
+        REQUIRE_FALSE(changes.rebuilt);
+        REQUIRE(changes.formed.empty());
+        REQUIRE(changes.broken == bond);
+        REQUIRE(list.bonds().empty());
+        REQUIRE(list.connectivity() == chemist::topology::ConnectivityTable(2));
+
+        // Back within bonding distance
+        changes = list.update(h2(r_h));
+        REQUIRE_FALSE(changes.rebuilt);
+        REQUIRE(changes.formed == bond);
+        REQUIRE(list.nbuilds() == 1);
+
+        // Large move rebuilds, and the pair drops out of the list
+        changes = list.update(h2(r_h + 5.0));
+        REQUIRE(changes.rebuilt);
+        REQUIRE(changes.broken == bond);
+        REQUIRE(list.nbuilds() == 2);
+        REQUIRE(list.npairs() == 0);
+    }
+
+    SECTION("Different system") {
+        VerletNeighborList list(0.1, 1.0);
+        list.update(h2(0.9 * r_h));
+
+        using molecule_type = chemist::Molecule;
+        using atom_type     = typename molecule_type::atom_type;
+        molecule_type mol;
+        mol.push_back(atom_type("H", 1ul, 1837.289, 0.0, 0.0, 0.0));
+        auto changes = list.update(NucleiSnapshot(mol));
+        REQUIRE(changes.rebuilt);
+        REQUIRE(changes.broken == bond);
+        REQUIRE(list.bonds().empty());
+    }
+
+    SECTION("Periodic") {
+        std::vector<double> cubic{10.0, 0.0, 0.0, 0.0, 10.0,
+                                  0.0,  0.0, 0.0, 10.0};
+        VerletNeighborList list(0.1, 1.0, cubic);
+
+        // Bonded through the boundary
+        auto changes = list.update(h2(10.0 - 0.9 * r_h));
+        REQUIRE(changes.formed == bond);
+
+        // Wrapping the atom back into the cell is not a move
+        changes = list.update(h2(-0.9 * r_h));
+        REQUIRE_FALSE(changes.rebuilt);
+        REQUIRE(changes.formed.empty());
+        REQUIRE(changes.broken.empty());
+        REQUIRE(list.bonds() == bond);
+    }
+}
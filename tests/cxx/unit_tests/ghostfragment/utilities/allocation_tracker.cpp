@@ -0,0 +1,59 @@
+/*
+ * Copyright 2024 GhostFragment
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../test_ghostfragment.hpp"
+#include <ghostfragment/utilities/allocation_tracker.hpp>
+
+using namespace ghostfragment::utilities;
+
+/* Testing Strategy:
+ *
+ * Whether memory use is measured is a configure-time option, and also depends
+ * on the OS. When it is off all counters must stay at zero. When it is on we
+ * touch a large allocation inside a monitor and check that it is seen. Part
+ * of the allocation may reuse memory which is already resident, so we only
+ * require most of it to show up.
+ */
+
+TEST_CASE("AllocationTracker") {
+    const std::size_t nbytes = 64 * 1024 * 1024;
+
+    if(!AllocationTracker::is_enabled()) {
+        StageMemoryMonitor monitor;
+        std::vector<char> buffer(nbytes);
+        REQUIRE(AllocationTracker::current_bytes() == 0);
+        REQUIRE(AllocationTracker::peak_bytes() == 0);
+        REQUIRE(monitor.peak_bytes() == 0);
+        return;
+    }
+
+    SECTION("Stage sees its allocations") {
+        StageMemoryMonitor monitor;
+        { std::vector<char> buffer(nbytes); }
+        REQUIRE(monitor.peak_bytes() >= nbytes / 2);
+    }
+
+    SECTION("Nested stages") {
+        StageMemoryMonitor outer;
+        { std::vector<char> buffer(nbytes); }
+        {
+            StageMemoryMonitor inner;
+            REQUIRE(inner.peak_bytes() < nbytes);
+        }
+        // Inner monitor restores the outer high-water mark
+        REQUIRE(outer.peak_bytes() >= nbytes / 2);
+    }
+}
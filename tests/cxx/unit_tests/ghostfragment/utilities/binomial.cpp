@@ -0,0 +1,46 @@
+/*
+ * Copyright 2024 GhostFragment
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../test_ghostfragment.hpp"
+#include <ghostfragment/utilities/binomial.hpp>
+#include <limits>
+
+using namespace ghostfragment::utilities;
+
+TEST_CASE("binomial") {
+    SECTION("Trivial cases") {
+        REQUIRE(binomial(0, 0) == 1);
+        REQUIRE(binomial(5, 0) == 1);
+        REQUIRE(binomial(5, 5) == 1);
+        REQUIRE(binomial(3, 4) == 0);
+    }
+
+    SECTION("Small values") {
+        REQUIRE(binomial(4, 2) == 6);
+        REQUIRE(binomial(5, 3) == 10);
+        REQUIRE(binomial(10, 4) == 210);
+    }
+
+    SECTION("Large values are exact") {
+        REQUIRE(binomial(62, 31) == 465428353255261088ull);
+        REQUIRE(binomial(100000, 3) == 166661666700000ull);
+    }
+
+    SECTION("Overflow saturates") {
+        constexpr auto max = std::numeric_limits<std::size_t>::max();
+        REQUIRE(binomial(100, 50) == max);
+    }
+}
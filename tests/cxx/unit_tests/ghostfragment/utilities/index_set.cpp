@@ -0,0 +1,152 @@
+/*
+ * Copyright 2024 GhostFragment
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../test_ghostfragment.hpp"
+#include <ghostfragment/utilities/index_set.hpp>
+#include <set>
+#include <unordered_set>
+#include <vector>
+
+using namespace ghostfragment::utilities;
+
+namespace {
+
+// The elements of an IndexSet, for comparing to the expected ones
+auto elements(const IndexSet& set) {
+    return std::vector<std::size_t>(set.begin(), set.end());
+}
+
+// A set too large for the inline buffer
+auto large_set(std::size_t offset) {
+    std::vector<std::size_t> values;
+    for(std::size_t i = 0; i < 2 * IndexSet::inline_capacity; ++i)
+        values.push_back(offset + 2 * i);
+    return values;
+}
+
+} // namespace
+
+TEST_CASE("IndexSet") {
+    using vector_type = std::vector<std::size_t>;
+
+    IndexSet empty;
+    IndexSet small{3, 1, 2};
+    const auto values = large_set(0);
+    IndexSet large(values.rbegin(), values.rend());
+
+    SECTION("Construction") {
+        REQUIRE(empty.empty());
+        REQUIRE(empty.size() == 0);
+        REQUIRE(elements(small) == vector_type{1, 2, 3});
+        REQUIRE(elements(large) == values);
+
+        // Repeated elements are only stored once
+        REQUIRE(elements(IndexSet{2, 0, 2, 1, 0}) == vector_type{0, 1, 2});
+    }
+
+    SECTION("Copying and moving") {
+        for(const auto& set : {small, large}) {
+            IndexSet copy(set);
+            REQUIRE(copy == set);
+
+            IndexSet moved(std::move(copy));
+            REQUIRE(moved == set);
+            REQUIRE(copy.empty());
+
+            IndexSet assigned{42};
+            assigned = moved;
+            REQUIRE(assigned == set);
+
+            const auto other = large_set(1);
+            IndexSet move_assigned(other.begin(), other.end());
+            move_assigned = std::move(assigned);
+            REQUIRE(move_assigned == set);
+            REQUIRE(assigned.empty());
+        }
+    }
+
+    SECTION("contains") {
+        REQUIRE(small.contains(2));
+        REQUIRE_FALSE(small.contains(4));
+        REQUIRE(large.contains(30));
+        REQUIRE_FALSE(large.contains(31));
+        REQUIRE_FALSE(empty.contains(0));
+    }
+
+    SECTION("insert") {
+        REQUIRE(small.insert(0));
+        REQUIRE_FALSE(small.insert(2));
+        REQUIRE(elements(small) == vector_type{0, 1, 2, 3});
+
+        // Grows past the inline buffer
+        for(std::size_t i = 10; i > 4; --i) REQUIRE(small.insert(i));
+        REQUIRE(elements(small) == vector_type{0, 1, 2, 3, 5, 6, 7, 8, 9, 10});
+
+        vector_type more{11, 4, 3};
+        small.insert(more.begin(), more.end());
+        REQUIRE(small.size() == 12);
+        REQUIRE(small.contains(4));
+        REQUIRE(small.contains(11));
+    }
+
+    SECTION("clear") {
+        large.clear();
+        REQUIRE(large.empty());
+        REQUIRE(large == empty);
+    }
+
+    SECTION("Comparisons") {
+        REQUIRE(small == IndexSet{1, 2, 3});
+        REQUIRE(small != large);
+
+        // Same order as std::set
+        std::vector<IndexSet> sets{{1, 2, 3}, {0, 4}, {1, 2}, {}, {5}};
+        std::set<std::set<std::size_t>> std_sets;
+        for(const auto& set : sets) std_sets.emplace(set.begin(), set.end());
+        std::vector<vector_type> corr;
+        for(const auto& set : std_sets)
+            corr.emplace_back(set.begin(), set.end());
+
+        std::sort(sets.begin(), sets.end());
+        std::vector<vector_type> sorted;
+        for(const auto& set : sets) sorted.push_back(elements(set));
+        REQUIRE(sorted == corr);
+    }
+
+    SECTION("Hashing") {
+        REQUIRE(small.hash() == IndexSet{3, 2, 1}.hash());
+        std::unordered_set<IndexSet> sets{small, large, IndexSet{1, 2, 3}};
+        REQUIRE(sets.size() == 2);
+        REQUIRE(sets.count(large));
+    }
+
+    SECTION("includes") {
+        REQUIRE(includes(small, IndexSet{1, 3}));
+        REQUIRE(includes(small, empty));
+        REQUIRE(includes(small, small));
+        REQUIRE_FALSE(includes(small, IndexSet{0, 1}));
+        REQUIRE_FALSE(includes(small, large));
+    }
+
+    SECTION("set_intersection") {
+        REQUIRE(set_intersection(small, large) == IndexSet{2});
+        REQUIRE(set_intersection(small, empty).empty());
+        const auto odd = large_set(1);
+        REQUIRE(set_intersection(large, IndexSet(odd.begin(), odd.end()))
+                  .empty());
+        REQUIRE(set_intersection(large, large) == large);
+    }
+}
@@ -0,0 +1,59 @@
+/*
+ * Copyright 2024 GhostFragment
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../test_ghostfragment.hpp"
+#include <fstream>
+#include <ghostfragment/utilities/mapped_file.hpp>
+
+using namespace ghostfragment::utilities;
+
+TEST_CASE("MappedFile") {
+    const auto path = std::filesystem::temp_directory_path() /
+                      "ghostfragment_test_mapped_file.txt";
+
+    SECTION("Non-empty file") {
+        std::ofstream(path) << "hello\nworld\n";
+        MappedFile file(path);
+        REQUIRE(file.size() == 12);
+        REQUIRE(file.view() == "hello\nworld\n");
+        REQUIRE(file.data()[6] == 'w');
+
+        MappedFile moved(std::move(file));
+        REQUIRE(moved.view() == "hello\nworld\n");
+        REQUIRE(file.data() == nullptr);
+        REQUIRE(file.size() == 0);
+
+        std::ofstream(path.string() + "2") << "bye";
+        MappedFile other(path.string() + "2");
+        moved = std::move(other);
+        REQUIRE(moved.view() == "bye");
+        std::filesystem::remove(path.string() + "2");
+    }
+
+    SECTION("Empty file") {
+        std::ofstream{path};
+        MappedFile file(path);
+        REQUIRE(file.size() == 0);
+        REQUIRE(file.view().empty());
+    }
+
+    SECTION("File does not exist") {
+        std::filesystem::remove(path);
+        REQUIRE_THROWS_AS(MappedFile(path), std::runtime_error);
+    }
+
+    std::filesystem::remove(path);
+}
@@ -0,0 +1,73 @@
+/*
+ * Copyright 2024 GhostFragment
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../test_ghostfragment.hpp"
+#include <ghostfragment/utilities/memory_footprint.hpp>
+
+using namespace ghostfragment;
+using namespace ghostfragment::utilities;
+
+using frags_type   = NuclearGraph::fragmented_nuclei;
+using nucleus_type = typename frags_type::supersystem_type::value_type;
+using cap_type     = typename frags_type::cap_set_type::value_type;
+
+TEST_CASE("memory_footprint") {
+    const auto nucleus_bytes = sizeof(nucleus_type);
+
+    SECTION("nuclei_footprint") {
+        REQUIRE(nuclei_footprint(testing::water(0).nuclei()) == 0);
+        const auto water2 = testing::water(2).nuclei();
+        REQUIRE(nuclei_footprint(water2) == 6 * nucleus_bytes);
+    }
+
+    SECTION("fragments_footprint") {
+        auto water0 = testing::water_fragmented_nuclei(0);
+        REQUIRE(fragments_footprint(water0) == 0);
+
+        auto water2         = testing::water_fragmented_nuclei(2);
+        const auto no_frags = nuclei_footprint(water2.supersystem());
+        REQUIRE(fragments_footprint(water2) > no_frags);
+
+        // Adding a cap can only increase the footprint
+        const auto uncapped = fragments_footprint(water2);
+        water2.add_cap(cap_type(0, 3, nucleus_type("H", 1ul, 1.0, 0, 0, 0)));
+        REQUIRE(fragments_footprint(water2) > uncapped);
+    }
+
+    SECTION("graph_footprint") {
+        REQUIRE(graph_footprint(NuclearGraph{}) == 0);
+
+        auto water2 = testing::water_fragmented_nuclei(2);
+        NuclearGraph::connectivity_type conns(2);
+        NuclearGraph no_edges(water2, conns);
+        conns.add_bond(0, 1);
+        NuclearGraph one_edge(water2, conns);
+        REQUIRE(graph_footprint(no_edges) > 0);
+        REQUIRE(graph_footprint(one_edge) > graph_footprint(no_edges));
+    }
+
+    SECTION("vector_footprint") {
+        std::vector<double> weights(10, 1.0);
+        REQUIRE(vector_footprint(weights) == 10 * sizeof(double));
+    }
+
+    SECTION("format_bytes") {
+        REQUIRE(format_bytes(0) == "0 B");
+        REQUIRE(format_bytes(1023) == "1023 B");
+        REQUIRE(format_bytes(1024) == "1.00 KiB");
+        REQUIRE(format_bytes(3 * 1024 * 1024 / 2) == "1.50 MiB");
+    }
+}
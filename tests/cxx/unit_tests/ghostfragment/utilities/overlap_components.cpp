@@ -0,0 +1,56 @@
+/*
+ * Copyright 2024 GhostFragment
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../test_ghostfragment.hpp"
+#include <ghostfragment/utilities/overlap_components.hpp>
+#include <set>
+#include <vector>
+
+using namespace ghostfragment::utilities;
+
+TEST_CASE("overlap_components") {
+    using sets_type       = std::vector<std::set<std::size_t>>;
+    using components_type = std::vector<std::vector<std::size_t>>;
+
+    SECTION("No sets") {
+        REQUIRE(overlap_components(sets_type{}, 4) == components_type{});
+    }
+
+    SECTION("Disjoint sets") {
+        sets_type sets{{0, 1}, {2}, {3, 4}};
+        components_type corr{{0}, {1}, {2}};
+        REQUIRE(overlap_components(sets, 5) == corr);
+    }
+
+    SECTION("Direct overlaps") {
+        sets_type sets{{0, 1}, {4, 5}, {1, 2}, {5}};
+        components_type corr{{0, 2}, {1, 3}};
+        REQUIRE(overlap_components(sets, 6) == corr);
+    }
+
+    SECTION("Overlaps through other sets") {
+        // Sets 0 and 3 only share elements with set 2
+        sets_type sets{{0, 1}, {6, 7}, {1, 2, 3}, {3, 4}};
+        components_type corr{{0, 2, 3}, {1}};
+        REQUIRE(overlap_components(sets, 8) == corr);
+    }
+
+    SECTION("Empty sets are their own components") {
+        sets_type sets{{0, 1}, {}, {1, 2}, {}};
+        components_type corr{{0, 2}, {1}, {3}};
+        REQUIRE(overlap_components(sets, 3) == corr);
+    }
+}
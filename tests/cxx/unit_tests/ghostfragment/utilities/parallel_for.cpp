@@ -0,0 +1,134 @@
+/*
+ * Copyright 2024 GhostFragment
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../test_ghostfragment.hpp"
+#include <algorithm>
+#include <ghostfragment/utilities/parallel_for.hpp>
+#include <numeric>
+
+using namespace ghostfragment::utilities;
+
+TEST_CASE("default_nthreads") { REQUIRE(default_nthreads() >= 1); }
+
+TEST_CASE("parallel_for_chunks") {
+    using range_type = std::pair<std::size_t, std::size_t>;
+
+    // Records the range each chunk was given
+    auto chunks_of = [](std::size_t n, std::size_t nchunks) {
+        std::vector<range_type> ranges(std::max<std::size_t>(nchunks, 1));
+        std::vector<char> called(ranges.size(), false);
+        parallel_for_chunks(n, nchunks, [&](auto chunk, auto b, auto e) {
+            ranges[chunk] = range_type(b, e);
+            called[chunk] = true;
+        });
+        std::size_t ncalled = std::count(called.begin(), called.end(), true);
+        ranges.resize(ncalled);
+        return ranges;
+    };
+
+    SECTION("Even split") {
+        std::vector<range_type> corr{{0, 2}, {2, 4}, {4, 6}};
+        REQUIRE(chunks_of(6, 3) == corr);
+    }
+
+    SECTION("Uneven split") {
+        std::vector<range_type> corr{{0, 3}, {3, 5}, {5, 7}};
+        REQUIRE(chunks_of(7, 3) == corr);
+    }
+
+    SECTION("More chunks than items") {
+        std::vector<range_type> corr{{0, 1}, {1, 2}};
+        REQUIRE(chunks_of(2, 8) == corr);
+    }
+
+    SECTION("No items") {
+        std::vector<range_type> corr{{0, 0}};
+        REQUIRE(chunks_of(0, 4) == corr);
+        REQUIRE(chunks_of(0, 0) == corr);
+    }
+
+    SECTION("Every item is visited once") {
+        std::vector<int> visits(1000, 0);
+        parallel_for_chunks(visits.size(), 7, [&](auto, auto b, auto e) {
+            for(auto i = b; i < e; ++i) ++visits[i];
+        });
+        REQUIRE(std::accumulate(visits.begin(), visits.end(), 0) == 1000);
+        REQUIRE(std::count(visits.begin(), visits.end(), 1) == 1000);
+    }
+
+    SECTION("Exceptions are rethrown") {
+        auto throw_from_2 = [](auto chunk, auto, auto) {
+            if(chunk == 2) throw std::runtime_error("chunk 2");
+        };
+        REQUIRE_THROWS_WITH(parallel_for_chunks(10, 4, throw_from_2),
+                            "chunk 2");
+    }
+}
+
+TEST_CASE("weighted_chunk_bounds") {
+    using bounds_type = std::vector<std::size_t>;
+
+    SECTION("Balances the work, not the items") {
+        std::vector<double> work{6.0, 1.0, 1.0, 1.0, 1.0, 1.0, 1.0};
+        REQUIRE(weighted_chunk_bounds(work, 2) == bounds_type{0, 1, 7});
+    }
+
+    SECTION("Even work") {
+        std::vector<double> work(6, 1.0);
+        REQUIRE(weighted_chunk_bounds(work, 3) == bounds_type{0, 2, 4, 6});
+    }
+
+    SECTION("No items") {
+        REQUIRE(weighted_chunk_bounds({}, 4) == bounds_type{0, 0});
+    }
+}
+
+TEST_CASE("triangular_chunk_bounds") {
+    using bounds_type = std::vector<std::size_t>;
+
+    SECTION("Balances the work, not the rows") {
+        // Rows do 9, 8, ..., 0 units of work (45 in total)
+        REQUIRE(triangular_chunk_bounds(10, 3) == bounds_type{0, 2, 4, 10});
+    }
+
+    SECTION("One chunk") {
+        REQUIRE(triangular_chunk_bounds(10, 1) == bounds_type{0, 10});
+    }
+
+    SECTION("More chunks than rows") {
+        const auto bounds = triangular_chunk_bounds(3, 8);
+        REQUIRE(bounds.front() == 0);
+        REQUIRE(bounds.back() == 3);
+        REQUIRE(bounds.size() <= 4);
+    }
+
+    SECTION("No rows") {
+        REQUIRE(triangular_chunk_bounds(0, 4) == bounds_type{0, 0});
+        REQUIRE(triangular_chunk_bounds(0, 0) == bounds_type{0, 0});
+    }
+
+    SECTION("Boundaries are sorted") {
+        for(std::size_t n : {1, 2, 17, 1000}) {
+            for(std::size_t nchunks : {1, 2, 7, 64}) {
+                const auto bounds = triangular_chunk_bounds(n, nchunks);
+                REQUIRE(bounds.front() == 0);
+                REQUIRE(bounds.back() == n);
+                REQUIRE(std::is_sorted(bounds.begin(), bounds.end()));
+                REQUIRE(bounds.size() - 1 <= std::max<std::size_t>(nchunks, 1));
+            }
+        }
+    }
+}